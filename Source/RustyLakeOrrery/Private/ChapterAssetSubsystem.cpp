@@ -0,0 +1,507 @@
+// ChapterAssetSubsystem.cpp
+
+#include "ChapterAssetSubsystem.h"
+#include "RustyLakeOrrery.h"
+#include "DialogueBank.h"
+#include "InteractableComponent.h"
+#include "ItemDataAsset.h"
+#include "PuzzleBase.h"
+#include "RLOCSVReader.h"
+#include "Engine/AssetManager.h"
+#include "Engine/GameInstance.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+
+DECLARE_MEMORY_STAT(TEXT("Chapter 1 Resident"), STAT_RLO_Chapter1Resident, STATGROUP_RustyLakeOrrery);
+DECLARE_MEMORY_STAT(TEXT("Chapter 2 Resident"), STAT_RLO_Chapter2Resident, STATGROUP_RustyLakeOrrery);
+DECLARE_MEMORY_STAT(TEXT("Chapter 3 Resident"), STAT_RLO_Chapter3Resident, STATGROUP_RustyLakeOrrery);
+
+namespace
+{
+    FAutoConsoleCommandWithWorld ChapterDumpCommand(
+        TEXT("RLO.Chapters.Dump"),
+        TEXT("Print the asset manifest size, load state and resident memory of every chapter."),
+        FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+        {
+            if (UChapterAssetSubsystem* Subsystem = UChapterAssetSubsystem::Get(World))
+            {
+                Subsystem->DumpChapterStatus();
+            }
+        }));
+}
+
+UChapterAssetSubsystem* UChapterAssetSubsystem::Get(const UObject* WorldContextObject)
+{
+    UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContextObject);
+    return GameInstance ? GameInstance->GetSubsystem<UChapterAssetSubsystem>() : nullptr;
+}
+
+int32 UChapterAssetSubsystem::ParseChapterNumber(const FString& Name)
+{
+    static const FString ChapterTag = TEXT("Chapter");
+
+    const int32 ChapterPos = Name.Find(ChapterTag, ESearchCase::IgnoreCase);
+    if (ChapterPos == INDEX_NONE)
+    {
+        return 0;
+    }
+
+    return FMath::Max(FCString::Atoi(*Name.Mid(ChapterPos + ChapterTag.Len())), 0);
+}
+
+void UChapterAssetSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    BuildManifests();
+
+    PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UChapterAssetSubsystem::HandlePostLoadMap);
+    PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UChapterAssetSubsystem::UpdateResidentStats);
+}
+
+void UChapterAssetSubsystem::Deinitialize()
+{
+    FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+    FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+
+    for (TPair<int32, FChapterState>& Pair : Chapters)
+    {
+        EvictChapter(Pair.Key);
+    }
+    Chapters.Reset();
+    CurrentChapter = 0;
+
+    Super::Deinitialize();
+}
+
+// ========================================================================
+// 资源清单
+// ========================================================================
+
+void UChapterAssetSubsystem::BuildManifests()
+{
+    const FString DataDirectory = FPaths::Combine(FPaths::ProjectContentDir(), ChapterDataDirectory);
+
+    for (int32 Chapter = 1; Chapter <= NumChapters; ++Chapter)
+    {
+        FChapterState& State = Chapters.Add(Chapter);
+
+        AddItemTableAssets(State, FPaths::Combine(DataDirectory, FString::Printf(TEXT("DT_Items_Chapter%d.csv"), Chapter)));
+        AddDialogueTableAssets(State, FPaths::Combine(DataDirectory, FString::Printf(TEXT("DT_Dialogue_Chapter%d.csv"), Chapter)));
+
+        const FString BankPath = FPaths::Combine(FPaths::ProjectContentDir(), DialogueBankDirectory, FString::Printf(TEXT("Chapter%d.rldb"), Chapter));
+        if (FPaths::FileExists(BankPath))
+        {
+            State.DialogueBankPaths.Add(BankPath);
+        }
+    }
+
+    for (const FChapterAssetConfig& Config : ChapterConfigs)
+    {
+        if (FChapterState* State = Chapters.Find(Config.Chapter))
+        {
+            for (const FSoftObjectPath& Path : Config.ExtraAssets)
+            {
+                if (Path.IsValid())
+                {
+                    State->Assets.AddUnique(Path);
+                }
+            }
+        }
+    }
+
+    for (const TPair<int32, FChapterState>& Pair : Chapters)
+    {
+        UE_LOG(LogRLO, Log, TEXT("ChapterAssetSubsystem: Chapter %d manifest has %d assets, %d dialogue banks"),
+               Pair.Key, Pair.Value.Assets.Num(), Pair.Value.DialogueBankPaths.Num());
+    }
+}
+
+void UChapterAssetSubsystem::AddItemTableAssets(FChapterState& State, const FString& FilePath)
+{
+    FString Content;
+    if (!FFileHelper::LoadFileToString(Content, *FilePath))
+    {
+        UE_LOG(LogRLO, Warning, TEXT("ChapterAssetSubsystem: Item table not found: %s"), *FilePath);
+        return;
+    }
+
+    FRLOCSVReader Reader(Content);
+    if (!Reader.ReadHeader())
+    {
+        return;
+    }
+
+    const int32 IconColumn = Reader.FindColumn({ TEXT("ItemIconPath"), TEXT("IconPath") });
+    const int32 MeshColumn = Reader.FindColumn({ TEXT("ItemModelPath"), TEXT("ModelPath") });
+
+    FRLOCSVReader::EReadResult Result;
+    while ((Result = Reader.ReadRow()) != FRLOCSVReader::EReadResult::EndOfFile)
+    {
+        if (Result == FRLOCSVReader::EReadResult::Error)
+        {
+            continue;
+        }
+
+        for (const int32 Column : { IconColumn, MeshColumn })
+        {
+            if (Reader.HasField(Column))
+            {
+                const FString ObjectPath = FRLOCSVReader::ToObjectPath(Reader.GetField(Column));
+                if (!ObjectPath.IsEmpty())
+                {
+                    State.Assets.AddUnique(FSoftObjectPath(ObjectPath));
+                }
+            }
+        }
+    }
+}
+
+void UChapterAssetSubsystem::AddDialogueTableAssets(FChapterState& State, const FString& FilePath)
+{
+    FString Content;
+    if (!FFileHelper::LoadFileToString(Content, *FilePath))
+    {
+        UE_LOG(LogRLO, Warning, TEXT("ChapterAssetSubsystem: Dialogue table not found: %s"), *FilePath);
+        return;
+    }
+
+    FRLOCSVReader Reader(Content);
+    if (!Reader.ReadHeader())
+    {
+        return;
+    }
+
+    const int32 AudioColumn = Reader.FindColumn({ TEXT("AudioPath"), TEXT("VoicePath") });
+    if (AudioColumn == INDEX_NONE)
+    {
+        return;
+    }
+
+    FRLOCSVReader::EReadResult Result;
+    while ((Result = Reader.ReadRow()) != FRLOCSVReader::EReadResult::EndOfFile)
+    {
+        if (Result == FRLOCSVReader::EReadResult::Error || !Reader.HasField(AudioColumn))
+        {
+            continue;
+        }
+
+        const FString ObjectPath = FRLOCSVReader::ToObjectPath(Reader.GetField(AudioColumn));
+        if (!ObjectPath.IsEmpty())
+        {
+            State.Assets.AddUnique(FSoftObjectPath(ObjectPath));
+        }
+    }
+}
+
+void UChapterAssetSubsystem::AddItemAssets(int32 Chapter, const UItemDataAsset* Item)
+{
+    FChapterState* State = Chapters.Find(Chapter);
+    if (!State || !Item)
+    {
+        return;
+    }
+
+    TArray<FSoftObjectPath> ItemPaths;
+    Item->GetAssetPaths(EItemAssetGroup::All, ItemPaths);
+
+    TArray<FSoftObjectPath> NewPaths;
+    for (const FSoftObjectPath& Path : ItemPaths)
+    {
+        if (!State->Assets.Contains(Path))
+        {
+            State->Assets.Add(Path);
+            NewPaths.Add(Path);
+        }
+    }
+
+    // 章节已在加载时，新增的资源也立即加载
+    if (State->bRequested && NewPaths.Num() > 0)
+    {
+        const TAsyncLoadPriority Priority = Chapter == CurrentChapter ? FStreamableManager::AsyncLoadHighPriority : FStreamableManager::DefaultAsyncLoadPriority;
+        State->Handles.Add(UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(NewPaths), FStreamableDelegate(), Priority));
+    }
+}
+
+void UChapterAssetSubsystem::RegisterPlacedInteractable(const UInteractableComponent* Interactable)
+{
+    const AActor* Owner = Interactable ? Interactable->GetOwner() : nullptr;
+    if (!Owner)
+    {
+        return;
+    }
+
+    // 按可交互对象所在关卡判断章节，无法判断时归入当前章节
+    int32 Chapter = 0;
+    if (const ULevel* Level = Owner->GetLevel())
+    {
+        const FString PackageName = UWorld::RemovePIEPrefix(Level->GetOutermost()->GetName());
+        Chapter = GetChapterForLevel(FName(*FPackageName::GetShortName(PackageName)));
+    }
+    if (Chapter == 0)
+    {
+        Chapter = CurrentChapter;
+    }
+
+    AddItemAssets(Chapter, Interactable->PickupItemData);
+    AddItemAssets(Chapter, Interactable->RequiredItemData);
+
+    if (Interactable->TargetPuzzle)
+    {
+        AddItemAssets(Chapter, Interactable->TargetPuzzle->RewardItem);
+    }
+}
+
+const TArray<FSoftObjectPath>* UChapterAssetSubsystem::GetChapterManifest(int32 Chapter) const
+{
+    const FChapterState* State = Chapters.Find(Chapter);
+    return State ? &State->Assets : nullptr;
+}
+
+// ========================================================================
+// 章节切换
+// ========================================================================
+
+int32 UChapterAssetSubsystem::GetChapterForLevel(FName LevelName) const
+{
+    if (LevelName.IsNone())
+    {
+        return 0;
+    }
+
+    for (const FChapterAssetConfig& Config : ChapterConfigs)
+    {
+        if (Config.Levels.Contains(LevelName))
+        {
+            return Config.Chapter;
+        }
+    }
+
+    const int32 Chapter = ParseChapterNumber(LevelName.ToString());
+    return Chapters.Contains(Chapter) ? Chapter : 0;
+}
+
+void UChapterAssetSubsystem::SetCurrentChapter(int32 Chapter)
+{
+    if (Chapter == CurrentChapter || !Chapters.Contains(Chapter))
+    {
+        return;
+    }
+
+    UE_LOG(LogRLO, Log, TEXT("ChapterAssetSubsystem: Entering chapter %d (was %d)"), Chapter, CurrentChapter);
+    CurrentChapter = Chapter;
+
+    // 只保留当前章节和下一章，已完成的章节释放引用
+    for (TPair<int32, FChapterState>& Pair : Chapters)
+    {
+        if (Pair.Key != Chapter && Pair.Key != Chapter + 1)
+        {
+            EvictChapter(Pair.Key);
+        }
+    }
+
+    RequestChapter(Chapter, FStreamableManager::AsyncLoadHighPriority);
+}
+
+void UChapterAssetSubsystem::PrepareForLevel(FName LevelName)
+{
+    const int32 Chapter = GetChapterForLevel(LevelName);
+    if (Chapter > 0 && Chapter != CurrentChapter)
+    {
+        RequestChapter(Chapter, FStreamableManager::AsyncLoadHighPriority);
+    }
+}
+
+bool UChapterAssetSubsystem::IsChapterLoaded(int32 Chapter) const
+{
+    const FChapterState* State = Chapters.Find(Chapter);
+    if (!State || !State->bRequested)
+    {
+        return false;
+    }
+
+    for (const TSharedPtr<FStreamableHandle>& Handle : State->Handles)
+    {
+        if (Handle.IsValid() && Handle->IsLoadingInProgress())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void UChapterAssetSubsystem::RequestChapter(int32 Chapter, TAsyncLoadPriority Priority)
+{
+    FChapterState* State = Chapters.Find(Chapter);
+    if (!State)
+    {
+        return;
+    }
+
+    if (State->bRequested)
+    {
+        // 后台预加载中的下一章需要马上使用时提高优先级
+        for (const TSharedPtr<FStreamableHandle>& Handle : State->Handles)
+        {
+            if (Handle.IsValid() && Handle->IsLoadingInProgress())
+            {
+                Handle->ChangePriority(Priority);
+            }
+        }
+
+        if (Chapter == CurrentChapter && IsChapterLoaded(Chapter))
+        {
+            OnChapterLoaded(Chapter);
+        }
+        return;
+    }
+
+    State->bRequested = true;
+
+    // 对话库很小，直接同步加载（内存映射）
+    for (const FString& BankPath : State->DialogueBankPaths)
+    {
+        if (TSharedPtr<const FDialogueBank> Bank = FDialogueBank::FindOrLoad(BankPath))
+        {
+            State->DialogueBanks.Add(Bank);
+        }
+    }
+
+    if (State->Assets.Num() == 0)
+    {
+        OnChapterLoaded(Chapter);
+        return;
+    }
+
+    FStreamableDelegate OnLoaded = FStreamableDelegate::CreateWeakLambda(this, [this, Chapter]()
+    {
+        OnChapterLoaded(Chapter);
+    });
+
+    State->Handles.Add(UAssetManager::GetStreamableManager().RequestAsyncLoad(State->Assets, MoveTemp(OnLoaded), Priority));
+}
+
+void UChapterAssetSubsystem::EvictChapter(int32 Chapter)
+{
+    FChapterState* State = Chapters.Find(Chapter);
+    if (!State || !State->bRequested)
+    {
+        return;
+    }
+
+    for (const TSharedPtr<FStreamableHandle>& Handle : State->Handles)
+    {
+        if (Handle.IsValid())
+        {
+            Handle->ReleaseHandle();
+        }
+    }
+
+    State->Handles.Reset();
+    State->DialogueBanks.Reset();
+    State->bRequested = false;
+
+    UE_LOG(LogRLO, Log, TEXT("ChapterAssetSubsystem: Evicted chapter %d"), Chapter);
+}
+
+void UChapterAssetSubsystem::OnChapterLoaded(int32 Chapter)
+{
+    UE_LOG(LogRLO, Log, TEXT("ChapterAssetSubsystem: Chapter %d assets loaded (%.1f KB resident)"),
+           Chapter, GetChapterResidentBytes(Chapter) / 1024.0);
+
+    UpdateResidentStats();
+
+    // 本章加载完成后再预加载下一章，避免与本章争抢IO
+    if (bPrefetchNextChapter && Chapter == CurrentChapter && Chapters.Contains(Chapter + 1))
+    {
+        RequestChapter(Chapter + 1, FStreamableManager::DefaultAsyncLoadPriority);
+    }
+}
+
+void UChapterAssetSubsystem::HandlePostLoadMap(UWorld* LoadedWorld)
+{
+    if (!LoadedWorld || LoadedWorld->GetGameInstance() != GetGameInstance())
+    {
+        return;
+    }
+
+    const FString MapName = UWorld::RemovePIEPrefix(FPackageName::GetShortName(LoadedWorld->GetOutermost()->GetName()));
+    const int32 Chapter = GetChapterForLevel(FName(*MapName));
+    if (Chapter > 0)
+    {
+        SetCurrentChapter(Chapter);
+    }
+}
+
+// ========================================================================
+// 内存统计
+// ========================================================================
+
+int64 UChapterAssetSubsystem::GetChapterResidentBytes(int32 Chapter) const
+{
+    const FChapterState* State = Chapters.Find(Chapter);
+    if (!State)
+    {
+        return 0;
+    }
+
+    int64 Bytes = 0;
+    for (const FSoftObjectPath& Path : State->Assets)
+    {
+        if (UObject* Asset = Path.ResolveObject())
+        {
+            Bytes += Asset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+        }
+    }
+
+    for (const TSharedPtr<const FDialogueBank>& Bank : State->DialogueBanks)
+    {
+        Bytes += Bank->GetDataSize();
+    }
+
+    return Bytes;
+}
+
+void UChapterAssetSubsystem::UpdateResidentStats() const
+{
+#if STATS
+    SET_MEMORY_STAT(STAT_RLO_Chapter1Resident, GetChapterResidentBytes(1));
+    SET_MEMORY_STAT(STAT_RLO_Chapter2Resident, GetChapterResidentBytes(2));
+    SET_MEMORY_STAT(STAT_RLO_Chapter3Resident, GetChapterResidentBytes(3));
+#endif
+}
+
+void UChapterAssetSubsystem::DumpChapterStatus() const
+{
+    UE_LOG(LogRLO, Log, TEXT("========== Chapter Assets =========="));
+    UE_LOG(LogRLO, Log, TEXT("Current chapter: %d"), CurrentChapter);
+
+    for (const TPair<int32, FChapterState>& Pair : Chapters)
+    {
+        const FChapterState& State = Pair.Value;
+
+        int32 NumResident = 0;
+        for (const FSoftObjectPath& Path : State.Assets)
+        {
+            if (Path.ResolveObject())
+            {
+                NumResident++;
+            }
+        }
+
+        const TCHAR* Status = !State.bRequested ? TEXT("evicted") : (IsChapterLoaded(Pair.Key) ? TEXT("loaded") : TEXT("loading"));
+        UE_LOG(LogRLO, Log, TEXT("Chapter %d [%s]: %d/%d assets resident, %d dialogue banks, %.1f KB"),
+               Pair.Key, Status, NumResident, State.Assets.Num(), State.DialogueBanks.Num(),
+               GetChapterResidentBytes(Pair.Key) / 1024.0);
+    }
+
+    UE_LOG(LogRLO, Log, TEXT("===================================="));
+}
@@ -0,0 +1,399 @@
+// DialogueBank.cpp
+
+#include "DialogueBank.h"
+#include "RustyLakeOrrery.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+using namespace DialogueBankFormat;
+
+DECLARE_MEMORY_STAT(TEXT("Dialogue Banks Resident"), STAT_RLO_DialogueBankMemory, STATGROUP_RustyLakeOrrery);
+
+uint32 DialogueBankFormat::HashID(const TCHAR* Chars, int32 Len)
+{
+    // FNV-1a,按小写字符计算以匹配FName不区分大小写的比较
+    uint32 Hash = 2166136261u;
+    for (int32 i = 0; i < Len; i++)
+    {
+        Hash ^= static_cast<uint32>(FChar::ToLower(Chars[i]));
+        Hash *= 16777619u;
+    }
+    return Hash;
+}
+
+namespace
+{
+    /** 烘焙时向字符串表追加UTF-8字符串 */
+    FStringRef AppendString(TArray<uint8>& StringTable, const FString& Str)
+    {
+        FStringRef Ref = { 0, 0 };
+        if (Str.IsEmpty())
+        {
+            return Ref;
+        }
+
+        FTCHARToUTF8 Converted(*Str, Str.Len());
+        Ref.Offset = StringTable.Num();
+        Ref.Length = Converted.Length();
+        StringTable.Append(reinterpret_cast<const uint8*>(Converted.Get()), Converted.Length());
+        return Ref;
+    }
+
+    /** FName转字符串,None记为空字符串 */
+    FString NameToBankString(FName Name)
+    {
+        return Name.IsNone() ? FString() : Name.ToString();
+    }
+
+    /** 烘焙时向哈希表插入记录(重复键时第一个优先,与UDialogueDataAsset一致) */
+    void InsertSlot(TArray<uint32>& Slots, const TArray<FDialogueEntry>& Entries, int32 RecordIndex, FName FDialogueEntry::* Field)
+    {
+        const FName Key = Entries[RecordIndex].*Field;
+        const FString KeyString = NameToBankString(Key);
+        const uint32 Mask = Slots.Num() - 1;
+
+        uint32 Slot = HashID(*KeyString, KeyString.Len()) & Mask;
+        while (Slots[Slot] != EmptySlot)
+        {
+            if (Entries[Slots[Slot]].*Field == Key)
+            {
+                return;
+            }
+            Slot = (Slot + 1) & Mask;
+        }
+        Slots[Slot] = RecordIndex;
+    }
+
+    /** 已加载对话库缓存(按完整路径共享) */
+    TMap<FString, TWeakPtr<const FDialogueBank>>& GetBankCache()
+    {
+        static TMap<FString, TWeakPtr<const FDialogueBank>> Cache;
+        return Cache;
+    }
+}
+
+FDialogueBank::~FDialogueBank()
+{
+    DEC_MEMORY_STAT_BY(STAT_RLO_DialogueBankMemory, ReportedMemory);
+
+    // 先释放映射区域,再关闭文件句柄
+    MappedRegion.Reset();
+    MappedHandle.Reset();
+}
+
+bool FDialogueBank::Cook(const UDialogueDataAsset& Asset, TArray<uint8>& OutBytes)
+{
+    const TArray<FDialogueEntry>& Entries = Asset.DialogueEntries;
+    const int32 EntryCount = Entries.Num();
+    const uint32 HashSlotCount = FMath::RoundUpToPowerOfTwo(FMath::Max(2, EntryCount * 2));
+
+    TArray<FRecord> Records;
+    Records.SetNumZeroed(EntryCount);
+
+    TArray<uint8> StringTable;
+    for (int32 i = 0; i < EntryCount; i++)
+    {
+        const FDialogueEntry& Entry = Entries[i];
+        FRecord& Record = Records[i];
+        Record.DialogueID = AppendString(StringTable, NameToBankString(Entry.DialogueID));
+        Record.TriggerEvent = AppendString(StringTable, NameToBankString(Entry.TriggerEvent));
+        Record.NextDialogueID = AppendString(StringTable, NameToBankString(Entry.NextDialogueID));
+        Record.TextCN = AppendString(StringTable, Entry.TextCN.ToString());
+        Record.TextEN = AppendString(StringTable, Entry.TextEN.ToString());
+        Record.AudioPath = AppendString(StringTable, Entry.AudioPath);
+        Record.ChoiceOptions = AppendString(StringTable, Entry.ChoiceOptions);
+        Record.Duration = Entry.Duration;
+        Record.SpeakerType = static_cast<uint8>(Entry.SpeakerType);
+    }
+
+    TArray<uint32> IDSlots;
+    TArray<uint32> TriggerSlots;
+    IDSlots.Init(EmptySlot, HashSlotCount);
+    TriggerSlots.Init(EmptySlot, HashSlotCount);
+    for (int32 i = 0; i < EntryCount; i++)
+    {
+        InsertSlot(IDSlots, Entries, i, &FDialogueEntry::DialogueID);
+        InsertSlot(TriggerSlots, Entries, i, &FDialogueEntry::TriggerEvent);
+    }
+
+    FHeader Header;
+    FMemory::Memzero(Header);
+    Header.Magic = DialogueBankFormat::Magic;
+    Header.Version = DialogueBankFormat::Version;
+    Header.EntryCount = EntryCount;
+    Header.HashSlotCount = HashSlotCount;
+    Header.RecordsOffset = sizeof(FHeader);
+    Header.IDHashOffset = Header.RecordsOffset + EntryCount * sizeof(FRecord);
+    Header.TriggerHashOffset = Header.IDHashOffset + HashSlotCount * sizeof(uint32);
+    Header.StringTableOffset = Header.TriggerHashOffset + HashSlotCount * sizeof(uint32);
+    Header.StringTableSize = StringTable.Num();
+
+    OutBytes.Reset(Header.StringTableOffset + Header.StringTableSize);
+    OutBytes.Append(reinterpret_cast<const uint8*>(&Header), sizeof(FHeader));
+    OutBytes.Append(reinterpret_cast<const uint8*>(Records.GetData()), Records.Num() * sizeof(FRecord));
+    OutBytes.Append(reinterpret_cast<const uint8*>(IDSlots.GetData()), IDSlots.Num() * sizeof(uint32));
+    OutBytes.Append(reinterpret_cast<const uint8*>(TriggerSlots.GetData()), TriggerSlots.Num() * sizeof(uint32));
+    OutBytes.Append(StringTable);
+
+    return true;
+}
+
+TSharedPtr<const FDialogueBank> FDialogueBank::LoadFromFile(const FString& FilePath, bool bAllowMemoryMap)
+{
+    TSharedPtr<FDialogueBank> Bank(new FDialogueBank());
+
+    // 优先内存映射(松散文件可用;pak内的文件会映射失败,回退为一次性读取)
+    if (bAllowMemoryMap)
+    {
+        IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+        Bank->MappedHandle.Reset(PlatformFile.OpenMapped(*FilePath));
+        if (Bank->MappedHandle.IsValid())
+        {
+            Bank->MappedRegion.Reset(Bank->MappedHandle->MapRegion(0, Bank->MappedHandle->GetFileSize()));
+        }
+
+        if (Bank->MappedRegion.IsValid())
+        {
+            if (Bank->Initialize(Bank->MappedRegion->GetMappedPtr(), Bank->MappedRegion->GetMappedSize()))
+            {
+                UE_LOG(LogRLODialogue, Log, TEXT("DialogueBank: Memory mapped %s (%d entries, %lld bytes)"), *FilePath, Bank->Num(), Bank->DataSize);
+                return Bank;
+            }
+            return nullptr;
+        }
+
+        Bank->MappedHandle.Reset();
+    }
+
+    if (!FFileHelper::LoadFileToArray(Bank->OwnedData, *FilePath, FILEREAD_Silent))
+    {
+        UE_LOG(LogRLODialogue, Error, TEXT("DialogueBank: Failed to read %s"), *FilePath);
+        return nullptr;
+    }
+
+    if (!Bank->Initialize(Bank->OwnedData.GetData(), Bank->OwnedData.Num()))
+    {
+        return nullptr;
+    }
+
+    UE_LOG(LogRLODialogue, Log, TEXT("DialogueBank: Loaded %s (%d entries, %lld bytes)"), *FilePath, Bank->Num(), Bank->DataSize);
+    return Bank;
+}
+
+TSharedPtr<const FDialogueBank> FDialogueBank::LoadFromMemory(TArray<uint8>&& Bytes)
+{
+    TSharedPtr<FDialogueBank> Bank(new FDialogueBank());
+    Bank->OwnedData = MoveTemp(Bytes);
+
+    if (!Bank->Initialize(Bank->OwnedData.GetData(), Bank->OwnedData.Num()))
+    {
+        return nullptr;
+    }
+
+    return Bank;
+}
+
+TSharedPtr<const FDialogueBank> FDialogueBank::FindOrLoad(const FString& FilePath)
+{
+    check(IsInGameThread());
+
+    const FString FullPath = FPaths::ConvertRelativePathToFull(FilePath);
+    TMap<FString, TWeakPtr<const FDialogueBank>>& Cache = GetBankCache();
+
+    if (const TWeakPtr<const FDialogueBank>* Cached = Cache.Find(FullPath))
+    {
+        if (TSharedPtr<const FDialogueBank> Bank = Cached->Pin())
+        {
+            return Bank;
+        }
+    }
+
+    TSharedPtr<const FDialogueBank> Bank = LoadFromFile(FullPath);
+    if (Bank.IsValid())
+    {
+        Cache.Add(FullPath, Bank);
+    }
+    else
+    {
+        Cache.Remove(FullPath);
+    }
+
+    return Bank;
+}
+
+bool FDialogueBank::Initialize(const uint8* InData, int64 InSize)
+{
+    if (!InData || InSize < static_cast<int64>(sizeof(FHeader)))
+    {
+        UE_LOG(LogRLODialogue, Error, TEXT("DialogueBank: File too small"));
+        return false;
+    }
+
+    const FHeader* InHeader = reinterpret_cast<const FHeader*>(InData);
+    if (InHeader->Magic != DialogueBankFormat::Magic || InHeader->Version != DialogueBankFormat::Version)
+    {
+        UE_LOG(LogRLODialogue, Error, TEXT("DialogueBank: Bad magic or unsupported version %d"), InHeader->Version);
+        return false;
+    }
+
+    const uint64 RecordsEnd = static_cast<uint64>(InHeader->RecordsOffset) + static_cast<uint64>(InHeader->EntryCount) * sizeof(FRecord);
+    const uint64 HashBytes = static_cast<uint64>(InHeader->HashSlotCount) * sizeof(uint32);
+    const uint64 StringsEnd = static_cast<uint64>(InHeader->StringTableOffset) + InHeader->StringTableSize;
+
+    if (!FMath::IsPowerOfTwo(InHeader->HashSlotCount) || InHeader->HashSlotCount <= InHeader->EntryCount
+        || (InHeader->RecordsOffset % 4) != 0 || (InHeader->IDHashOffset % 4) != 0 || (InHeader->TriggerHashOffset % 4) != 0
+        || RecordsEnd > InHeader->IDHashOffset
+        || InHeader->IDHashOffset + HashBytes > InHeader->TriggerHashOffset
+        || InHeader->TriggerHashOffset + HashBytes > InHeader->StringTableOffset
+        || StringsEnd > static_cast<uint64>(InSize))
+    {
+        UE_LOG(LogRLODialogue, Error, TEXT("DialogueBank: Corrupt section table"));
+        return false;
+    }
+
+    Data = InData;
+    DataSize = InSize;
+    Header = InHeader;
+    Records = reinterpret_cast<const FRecord*>(InData + InHeader->RecordsOffset);
+    IDSlots = reinterpret_cast<const uint32*>(InData + InHeader->IDHashOffset);
+    TriggerSlots = reinterpret_cast<const uint32*>(InData + InHeader->TriggerHashOffset);
+    Strings = reinterpret_cast<const ANSICHAR*>(InData + InHeader->StringTableOffset);
+
+    // 一次性校验所有引用,之后的访问无需再做边界检查
+    for (uint32 i = 0; i < Header->EntryCount; i++)
+    {
+        const FRecord& Record = Records[i];
+        if (!IsValidStringRef(Record.DialogueID) || !IsValidStringRef(Record.TriggerEvent) || !IsValidStringRef(Record.NextDialogueID)
+            || !IsValidStringRef(Record.TextCN) || !IsValidStringRef(Record.TextEN)
+            || !IsValidStringRef(Record.AudioPath) || !IsValidStringRef(Record.ChoiceOptions))
+        {
+            UE_LOG(LogRLODialogue, Error, TEXT("DialogueBank: Record %u has an out-of-range string"), i);
+            return false;
+        }
+    }
+
+    for (uint32 i = 0; i < Header->HashSlotCount; i++)
+    {
+        if ((IDSlots[i] != EmptySlot && IDSlots[i] >= Header->EntryCount)
+            || (TriggerSlots[i] != EmptySlot && TriggerSlots[i] >= Header->EntryCount))
+        {
+            UE_LOG(LogRLODialogue, Error, TEXT("DialogueBank: Hash slot %u points outside the record table"), i);
+            return false;
+        }
+    }
+
+    ReportedMemory = DataSize;
+    INC_MEMORY_STAT_BY(STAT_RLO_DialogueBankMemory, ReportedMemory);
+    return true;
+}
+
+bool FDialogueBank::IsValidStringRef(const FStringRef& Ref) const
+{
+    return static_cast<uint64>(Ref.Offset) + Ref.Length <= Header->StringTableSize;
+}
+
+int32 FDialogueBank::FindByID(FName DialogueID) const
+{
+    return FindInTable(IDSlots, DialogueID, &FRecord::DialogueID);
+}
+
+int32 FDialogueBank::FindByTrigger(FName TriggerEvent) const
+{
+    return FindInTable(TriggerSlots, TriggerEvent, &FRecord::TriggerEvent);
+}
+
+int32 FDialogueBank::FindInTable(const uint32* Slots, FName Key, FStringRef FRecord::* Field) const
+{
+    // 在栈上取得名称字符串,不分配内存
+    TCHAR KeyChars[NAME_SIZE];
+    const int32 KeyLen = Key.IsNone() ? 0 : static_cast<int32>(Key.ToString(KeyChars, NAME_SIZE));
+
+    const uint32 Mask = Header->HashSlotCount - 1;
+    uint32 Slot = HashID(KeyChars, KeyLen) & Mask;
+
+    for (uint32 Probe = 0; Probe < Header->HashSlotCount; Probe++)
+    {
+        const uint32 RecordIndex = Slots[Slot];
+        if (RecordIndex == EmptySlot)
+        {
+            break;
+        }
+
+        const FStringRef& Ref = Records[RecordIndex].*Field;
+        if (KeyLen == 0)
+        {
+            if (Ref.Length == 0)
+            {
+                return RecordIndex;
+            }
+        }
+        else if (Ref.Length > 0)
+        {
+            FUTF8ToTCHAR Converted(Strings + Ref.Offset, Ref.Length);
+            if (Converted.Length() == KeyLen && FCString::Strnicmp(Converted.Get(), KeyChars, KeyLen) == 0)
+            {
+                return RecordIndex;
+            }
+        }
+
+        Slot = (Slot + 1) & Mask;
+    }
+
+    return INDEX_NONE;
+}
+
+FName FDialogueBank::ToName(const FStringRef& Ref) const
+{
+    if (Ref.Length == 0)
+    {
+        return NAME_None;
+    }
+
+    FUTF8ToTCHAR Converted(Strings + Ref.Offset, Ref.Length);
+    return FName(Converted.Length(), Converted.Get());
+}
+
+void FDialogueBank::DecodeString(const FStringRef& Ref, FString& Out) const
+{
+    Out.Reset();
+    if (Ref.Length == 0)
+    {
+        return;
+    }
+
+    FUTF8ToTCHAR Converted(Strings + Ref.Offset, Ref.Length);
+    Out.AppendChars(Converted.Get(), Converted.Length());
+}
+
+FName FDialogueBank::GetDialogueID(int32 Index) const
+{
+    return ToName(Records[Index].DialogueID);
+}
+
+FName FDialogueBank::GetNextDialogueID(int32 Index) const
+{
+    return ToName(Records[Index].NextDialogueID);
+}
+
+void FDialogueBank::GetText(int32 Index, bool bChinese, FString& OutText) const
+{
+    const FRecord& Record = Records[Index];
+    DecodeString(bChinese ? Record.TextCN : Record.TextEN, OutText);
+}
+
+void FDialogueBank::FillEntry(int32 Index, FDialogueEntry& OutEntry) const
+{
+    const FRecord& Record = Records[Index];
+    OutEntry.DialogueID = ToName(Record.DialogueID);
+    OutEntry.TriggerEvent = ToName(Record.TriggerEvent);
+    OutEntry.NextDialogueID = ToName(Record.NextDialogueID);
+    OutEntry.SpeakerType = static_cast<ESpeakerType>(Record.SpeakerType);
+    OutEntry.Duration = Record.Duration;
+    OutEntry.TextCN = FText::GetEmpty();
+    OutEntry.TextEN = FText::GetEmpty();
+    OutEntry.AudioAsset = nullptr;
+    DecodeString(Record.AudioPath, OutEntry.AudioPath);
+    DecodeString(Record.ChoiceOptions, OutEntry.ChoiceOptions);
+}
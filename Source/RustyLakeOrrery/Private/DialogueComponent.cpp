@@ -1,9 +1,17 @@
 // DialogueComponent.cpp
 
 #include "DialogueComponent.h"
+#include "RustyLakeOrrery.h"
+#include "RLOPerf.h"
 #include "Components/AudioComponent.h"
 #include "Sound/SoundBase.h"
 #include "Kismet/GameplayStatics.h"
+#include "Internationalization/BreakIterator.h"
+#include "DialogueBank.h"
+#include "SaveSubsystem.h"
+#include "Misc/Paths.h"
+
+DECLARE_CYCLE_STAT(TEXT("Dialogue Tick"), STAT_RLO_DialogueTick, STATGROUP_RustyLakeOrrery);
 
 UDialogueComponent::UDialogueComponent()
 {
@@ -21,10 +29,37 @@ void UDialogueComponent::BeginPlay()
     Super::BeginPlay();
     
     CurrentState = EDialogueState::Idle;
+
+    if (!DialogueBank.IsValid() && !DialogueBankPath.IsEmpty())
+    {
+        LoadDialogueBank(DialogueBankPath);
+    }
+
+    if (USaveSubsystem* SaveSubsystem = USaveSubsystem::Get(this))
+    {
+        SaveSubsystem->RegisterSaveable(this);
+    }
+}
+
+void UDialogueComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (USaveSubsystem* SaveSubsystem = USaveSubsystem::Get(this))
+    {
+        SaveSubsystem->UnregisterSaveable(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void UDialogueComponent::SerializeSaveRecord(FArchive& Ar)
+{
+    Ar << CompletedDialogueIDs;
 }
 
 void UDialogueComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
+    RLO_SCOPE_CYCLE(Dialogue, STAT_RLO_DialogueTick);
+
     Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
     if (CurrentState == EDialogueState::Playing)
@@ -53,39 +88,94 @@ void UDialogueComponent::TickComponent(float DeltaTime, ELevelTick TickType, FAc
     }
 }
 
+bool UDialogueComponent::LoadDialogueBank(const FString& BankPath)
+{
+    const FString FullPath = FPaths::IsRelative(BankPath) ? FPaths::Combine(FPaths::ProjectContentDir(), BankPath) : BankPath;
+    TSharedPtr<const FDialogueBank> LoadedBank = FDialogueBank::FindOrLoad(FullPath);
+    if (!LoadedBank.IsValid())
+    {
+        UE_LOG(LogRLODialogue, Error, TEXT("DialogueComponent: Failed to load dialogue bank: %s"), *FullPath);
+        return false;
+    }
+
+    SetDialogueBank(LoadedBank);
+    return true;
+}
+
+void UDialogueComponent::SetDialogueBank(TSharedPtr<const FDialogueBank> InDialogueBank)
+{
+    DialogueBank = MoveTemp(InDialogueBank);
+}
+
 bool UDialogueComponent::PlayDialogue(FName DialogueID)
 {
+    if (DialogueBank.IsValid())
+    {
+        const int32 RecordIndex = DialogueBank->FindByID(DialogueID);
+        if (RecordIndex != INDEX_NONE)
+        {
+            PlayBankDialogue(RecordIndex);
+            return true;
+        }
+    }
+
     if (!DialogueDataAsset)
     {
-        UE_LOG(LogTemp, Error, TEXT("DialogueComponent: DialogueDataAsset is not set"));
+        if (DialogueBank.IsValid())
+        {
+            UE_LOG(LogRLODialogue, Warning, TEXT("DialogueComponent: Dialogue ID '%s' not found"), *DialogueID.ToString());
+        }
+        else
+        {
+            UE_LOG(LogRLODialogue, Error, TEXT("DialogueComponent: DialogueDataAsset is not set"));
+        }
         return false;
     }
 
-    FDialogueEntry Entry;
-    if (!DialogueDataAsset->GetDialogueEntry(DialogueID, Entry))
+    const FDialogueEntry* Entry = DialogueDataAsset->FindDialogueEntry(DialogueID);
+    if (!Entry)
     {
+        UE_LOG(LogRLODialogue, Warning, TEXT("DialogueComponent: Dialogue ID '%s' not found"), *DialogueID.ToString());
         return false;
     }
 
-    PlayDialogueInternal(Entry);
+    PlayDialogueInternal(*Entry);
     return true;
 }
 
 bool UDialogueComponent::PlayDialogueByTrigger(FName TriggerEvent)
 {
+    if (DialogueBank.IsValid())
+    {
+        const int32 RecordIndex = DialogueBank->FindByTrigger(TriggerEvent);
+        if (RecordIndex != INDEX_NONE)
+        {
+            PlayBankDialogue(RecordIndex);
+            return true;
+        }
+    }
+
     if (!DialogueDataAsset)
     {
-        UE_LOG(LogTemp, Error, TEXT("DialogueComponent: DialogueDataAsset is not set"));
+        if (DialogueBank.IsValid())
+        {
+            UE_LOG(LogRLODialogue, Warning, TEXT("DialogueComponent: Trigger event '%s' not found"), *TriggerEvent.ToString());
+        }
+        else
+        {
+            UE_LOG(LogRLODialogue, Error, TEXT("DialogueComponent: DialogueDataAsset is not set"));
+        }
         return false;
     }
 
-    FDialogueEntry Entry;
-    if (!DialogueDataAsset->GetDialogueByTrigger(TriggerEvent, Entry))
+    const FDialogueEntry* Entry = DialogueDataAsset->FindDialogueByTrigger(TriggerEvent);
+    if (!Entry)
     {
+        UE_LOG(LogRLODialogue, Warning, TEXT("DialogueComponent: Trigger event '%s' not found"), *TriggerEvent.ToString());
         return false;
     }
 
-    PlayDialogueInternal(Entry);
+    PlayDialogueInternal(*Entry);
     return true;
 }
 
@@ -96,50 +186,131 @@ void UDialogueComponent::PlayDialogueInternal(const FDialogueEntry& Entry)
 
     // 设置新对话
     CurrentDialogue = Entry;
+
+    // 缓存完整文本和字素边界,播放过程中不再重复转换
+    CacheDisplayText(DialogueDataAsset ? DialogueDataAsset->GetDisplayText(CurrentDialogue) : FText::GetEmpty());
+
+    StartCurrentDialogue();
+}
+
+void UDialogueComponent::PlayBankDialogue(int32 RecordIndex)
+{
+    // 停止当前对话
+    StopDialogue();
+
+    // 直接从对话库解码到复用的成员中,不复制条目也不构造FText
+    DialogueBank->FillEntry(RecordIndex, CurrentDialogue);
+    DialogueBank->GetText(RecordIndex, bUseChineseText, CachedDisplayString);
+    bCachedDisplayTextValid = false;
+    CacheGraphemeBoundaries();
+
+    StartCurrentDialogue();
+}
+
+void UDialogueComponent::StartCurrentDialogue()
+{
     CurrentState = EDialogueState::Playing;
     TextProgress = 0.0f;
     DialogueTimer = 0.0f;
+    RevealedCharacters = 0.0f;
 
     // 启用Tick
     SetComponentTickEnabled(true);
 
     // 播放音频
-    PlayAudio(Entry);
+    PlayAudio(CurrentDialogue);
 
-    // 触发事件
-    OnDialogueStarted.Broadcast(Entry);
+    // 触发事件(广播自己的副本,不暴露数据资产内部存储)
+    OnDialogueStarted.Broadcast(CurrentDialogue);
+    SetVisibleCharacterCount(0, true);
 
-    UE_LOG(LogTemp, Log, TEXT("DialogueComponent: Started dialogue '%s'"), *Entry.DialogueID.ToString());
+    UE_LOG(LogRLODialogue, Log, TEXT("DialogueComponent: Started dialogue '%s'"), *CurrentDialogue.DialogueID.ToString());
 }
 
 void UDialogueComponent::UpdateTextDisplay(float DeltaTime)
 {
-    if (TextDisplaySpeed <= 0.0f)
+    if (TextDisplaySpeed <= 0.0f || TotalCharacterCount <= 0)
     {
         // 立即显示全部文本
+        RevealedCharacters = TotalCharacterCount;
         TextProgress = 1.0f;
     }
     else
     {
-        // 逐字显示
-        FText FullText = DialogueDataAsset->GetDisplayText(CurrentDialogue);
-        int32 TotalChars = FullText.ToString().Len();
-        
-        if (TotalChars > 0)
+        // 逐字显示(字符总数在对话开始时已缓存)
+        RevealedCharacters = FMath::Min(RevealedCharacters + TextDisplaySpeed * DeltaTime, static_cast<float>(TotalCharacterCount));
+        TextProgress = FMath::Clamp(RevealedCharacters / TotalCharacterCount, 0.0f, 1.0f);
+    }
+
+    // 只在可见字符数变化时通知监听者
+    SetVisibleCharacterCount(FMath::FloorToInt(RevealedCharacters));
+}
+
+void UDialogueComponent::CacheDisplayText(const FText& FullText)
+{
+    CachedDisplayText = FullText;
+    CachedDisplayString = FullText.ToString();
+    bCachedDisplayTextValid = true;
+
+    CacheGraphemeBoundaries();
+}
+
+void UDialogueComponent::CacheGraphemeBoundaries()
+{
+    GraphemeBoundaries.Reset();
+    GraphemeBoundaries.Add(0);
+
+    if (!CachedDisplayString.IsEmpty())
+    {
+        // 按字素(而非UTF-16码元)计数,避免把代理对或组合字符拆开显示
+        if (!GraphemeIterator.IsValid())
         {
-            float CharsPerSecond = TextDisplaySpeed;
-            float ProgressDelta = (CharsPerSecond / TotalChars) * DeltaTime;
-            TextProgress = FMath::Clamp(TextProgress + ProgressDelta, 0.0f, 1.0f);
+            GraphemeIterator = FBreakIterator::CreateCharacterBoundaryIterator();
         }
-        else
+
+        GraphemeIterator->SetString(CachedDisplayString);
+        for (int32 Boundary = GraphemeIterator->MoveToNext(); Boundary != INDEX_NONE; Boundary = GraphemeIterator->MoveToNext())
         {
-            TextProgress = 1.0f;
+            GraphemeBoundaries.Add(Boundary);
         }
+        GraphemeIterator->ClearString();
+
+        if (GraphemeBoundaries.Last() != CachedDisplayString.Len())
+        {
+            GraphemeBoundaries.Add(CachedDisplayString.Len());
+        }
+    }
+
+    TotalCharacterCount = GraphemeBoundaries.Num() - 1;
+    VisibleCharacterCount = 0;
+}
+
+void UDialogueComponent::SetVisibleCharacterCount(int32 NewCount, bool bForceBroadcast)
+{
+    NewCount = FMath::Clamp(NewCount, 0, TotalCharacterCount);
+    if (NewCount == VisibleCharacterCount && !bForceBroadcast)
+    {
+        return;
+    }
+
+    VisibleCharacterCount = NewCount;
+    OnDialogueRevealChanged.Broadcast(VisibleCharacterCount, TotalCharacterCount);
+
+    // 旧版文本事件需要构造新的FText,没有监听者时跳过
+    if (OnDialogueTextChanged.IsBound())
+    {
+        OnDialogueTextChanged.Broadcast(GetCurrentDisplayText(), TextProgress);
+    }
+}
+
+int32 UDialogueComponent::GetDisplayStringLength(int32 CharacterCount) const
+{
+    if (GraphemeBoundaries.Num() == 0)
+    {
+        return 0;
     }
 
-    // 触发文本更新事件
-    FText DisplayText = GetCurrentDisplayText();
-    OnDialogueTextChanged.Broadcast(DisplayText, TextProgress);
+    return GraphemeBoundaries[FMath::Clamp(CharacterCount, 0, GraphemeBoundaries.Num() - 1)];
 }
 
 void UDialogueComponent::CompleteCurrentDialogue()
@@ -147,7 +318,18 @@ void UDialogueComponent::CompleteCurrentDialogue()
     // 触发完成事件
     OnDialogueCompleted.Broadcast(CurrentDialogue);
 
-    UE_LOG(LogTemp, Log, TEXT("DialogueComponent: Completed dialogue '%s'"), *CurrentDialogue.DialogueID.ToString());
+    UE_LOG(LogRLODialogue, Log, TEXT("DialogueComponent: Completed dialogue '%s'"), *CurrentDialogue.DialogueID.ToString());
+
+    // 记录剧情进度,重复播放的对话不再写入存档
+    if (!CurrentDialogue.DialogueID.IsNone())
+    {
+        bool bAlreadyCompleted = false;
+        CompletedDialogueIDs.Add(CurrentDialogue.DialogueID, &bAlreadyCompleted);
+        if (!bAlreadyCompleted)
+        {
+            USaveSubsystem::MarkDirty(this);
+        }
+    }
 
     // 检查是否有选项
     if (!CurrentDialogue.ChoiceOptions.IsEmpty())
@@ -187,12 +369,14 @@ void UDialogueComponent::StopDialogue()
     CurrentState = EDialogueState::Idle;
     TextProgress = 0.0f;
     DialogueTimer = 0.0f;
+    RevealedCharacters = 0.0f;
+    VisibleCharacterCount = 0;
     bInInterval = false;
     
     SetComponentTickEnabled(false);
     StopAudio();
 
-    UE_LOG(LogTemp, Log, TEXT("DialogueComponent: Stopped dialogue"));
+    UE_LOG(LogRLODialogue, Log, TEXT("DialogueComponent: Stopped dialogue"));
 }
 
 void UDialogueComponent::SkipDialogue()
@@ -204,16 +388,16 @@ void UDialogueComponent::SkipDialogue()
 
     // 立即完成文本显示
     TextProgress = 1.0f;
+    RevealedCharacters = TotalCharacterCount;
     DialogueTimer = CurrentDialogue.Duration;
 
     // 更新显示
-    FText DisplayText = GetCurrentDisplayText();
-    OnDialogueTextChanged.Broadcast(DisplayText, TextProgress);
+    SetVisibleCharacterCount(TotalCharacterCount, true);
 
     // 完成对话
     CompleteCurrentDialogue();
 
-    UE_LOG(LogTemp, Log, TEXT("DialogueComponent: Skipped dialogue"));
+    UE_LOG(LogRLODialogue, Log, TEXT("DialogueComponent: Skipped dialogue"));
 }
 
 void UDialogueComponent::PlayNextDialogue()
@@ -232,7 +416,7 @@ void UDialogueComponent::SelectChoice(int32 ChoiceIndex)
 {
     if (CurrentState != EDialogueState::WaitingForInput)
     {
-        UE_LOG(LogTemp, Warning, TEXT("DialogueComponent: Not waiting for choice"));
+        UE_LOG(LogRLODialogue, Warning, TEXT("DialogueComponent: Not waiting for choice"));
         return;
     }
 
@@ -242,11 +426,11 @@ void UDialogueComponent::SelectChoice(int32 ChoiceIndex)
 
     if (!Choices.IsValidIndex(ChoiceIndex))
     {
-        UE_LOG(LogTemp, Error, TEXT("DialogueComponent: Invalid choice index %d"), ChoiceIndex);
+        UE_LOG(LogRLODialogue, Error, TEXT("DialogueComponent: Invalid choice index %d"), ChoiceIndex);
         return;
     }
 
-    UE_LOG(LogTemp, Log, TEXT("DialogueComponent: Selected choice %d: %s"), ChoiceIndex, *Choices[ChoiceIndex]);
+    UE_LOG(LogRLODialogue, Log, TEXT("DialogueComponent: Selected choice %d: %s"), ChoiceIndex, *Choices[ChoiceIndex]);
 
     // TODO: 根据选择播放不同的对话分支
     // 这里需要扩展DialogueDataAsset来支持分支对话
@@ -256,26 +440,26 @@ void UDialogueComponent::SelectChoice(int32 ChoiceIndex)
     SetComponentTickEnabled(false);
 }
 
-FText UDialogueComponent::GetCurrentDisplayText() const
+FText UDialogueComponent::GetFullDisplayText() const
 {
-    if (!DialogueDataAsset)
+    if (!bCachedDisplayTextValid)
     {
-        return FText::GetEmpty();
+        CachedDisplayText = FText::FromString(CachedDisplayString);
+        bCachedDisplayTextValid = true;
     }
 
-    FText FullText = DialogueDataAsset->GetDisplayText(CurrentDialogue);
-    
-    if (TextProgress >= 1.0f)
+    return CachedDisplayText;
+}
+
+FText UDialogueComponent::GetCurrentDisplayText() const
+{
+    if (VisibleCharacterCount >= TotalCharacterCount)
     {
-        return FullText;
+        return GetFullDisplayText();
     }
 
-    // 返回部分文本
-    FString FullString = FullText.ToString();
-    int32 CharCount = FMath::FloorToInt(FullString.Len() * TextProgress);
-    FString PartialString = FullString.Left(CharCount);
-    
-    return FText::FromString(PartialString);
+    // 返回部分文本(会分配新字符串,逐帧更新请使用OnDialogueRevealChanged)
+    return FText::FromString(CachedDisplayString.Left(GetDisplayStringLength(VisibleCharacterCount)));
 }
 
 void UDialogueComponent::PlayAudio(const FDialogueEntry& Entry)
@@ -289,7 +473,7 @@ void UDialogueComponent::PlayAudio(const FDialogueEntry& Entry)
     // TODO: 加载音频资源
     // 这需要实现异步资源加载
     // 暂时使用日志输出
-    UE_LOG(LogTemp, Log, TEXT("DialogueComponent: Would play audio: %s"), *Entry.AudioPath);
+    UE_LOG(LogRLODialogue, Log, TEXT("DialogueComponent: Would play audio: %s"), *Entry.AudioPath);
 
     // 示例代码(需要音频资源已加载):
     /*
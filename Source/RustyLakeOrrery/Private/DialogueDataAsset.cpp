@@ -1,11 +1,14 @@
 // DialogueDataAsset.cpp
 
 #include "DialogueDataAsset.h"
+#include "RustyLakeOrrery.h"
 #include "Sound/SoundBase.h"
 
 #if WITH_EDITOR
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
+#include "RLOCSVReader.h"
+#include "DialogueBank.h"
 #endif
 
 UDialogueDataAsset::UDialogueDataAsset()
@@ -13,33 +16,120 @@ UDialogueDataAsset::UDialogueDataAsset()
     bUseChinese = true;
 }
 
-bool UDialogueDataAsset::GetDialogueEntry(FName DialogueID, FDialogueEntry& OutEntry) const
+void UDialogueDataAsset::PostLoad()
+{
+    Super::PostLoad();
+
+    RebuildLookupIndex();
+}
+
+#if WITH_EDITOR
+void UDialogueDataAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+
+    // 编辑器中修改条目后立即重建索引
+    RebuildLookupIndex();
+}
+#endif
+
+void UDialogueDataAsset::RebuildLookupIndex()
+{
+    BuildLookupIndex();
+}
+
+void UDialogueDataAsset::BuildLookupIndex() const
+{
+    DialogueIDIndex.Reset();
+    TriggerEventIndex.Reset();
+    DialogueIDIndex.Reserve(DialogueEntries.Num());
+    TriggerEventIndex.Reserve(DialogueEntries.Num());
+
+    for (int32 i = 0; i < DialogueEntries.Num(); i++)
+    {
+        const FDialogueEntry& Entry = DialogueEntries[i];
+
+        // 与原线性查找保持一致:重复ID/触发事件时第一个条目优先
+        if (!DialogueIDIndex.Contains(Entry.DialogueID))
+        {
+            DialogueIDIndex.Add(Entry.DialogueID, i);
+        }
+        else
+        {
+            UE_LOG(LogRLODialogue, Warning, TEXT("DialogueDataAsset: Duplicate dialogue ID '%s' at index %d"), *Entry.DialogueID.ToString(), i);
+        }
+
+        if (!TriggerEventIndex.Contains(Entry.TriggerEvent))
+        {
+            TriggerEventIndex.Add(Entry.TriggerEvent, i);
+        }
+    }
+
+    IndexedEntryCount = DialogueEntries.Num();
+}
+
+int32 UDialogueDataAsset::FindIndexChecked(TMap<FName, int32>& Index, FName Key, FName FDialogueEntry::* Field) const
 {
-    for (const FDialogueEntry& Entry : DialogueEntries)
+    // DialogueEntries是公开属性,可能在运行时被直接修改,数量变化时先重建
+    if (IndexedEntryCount != DialogueEntries.Num())
+    {
+        BuildLookupIndex();
+    }
+
+    const int32* Found = Index.Find(Key);
+    if (Found && DialogueEntries.IsValidIndex(*Found) && DialogueEntries[*Found].*Field == Key)
+    {
+        return *Found;
+    }
+
+    // 命中校验失败(条目被原地修改),重建后再查一次
+    // 未命中直接返回:没有对话的触发事件在正常游戏中很常见,不能每次都重建
+    if (Found)
     {
-        if (Entry.DialogueID == DialogueID)
+        BuildLookupIndex();
+        Found = Index.Find(Key);
+        if (Found)
         {
-            OutEntry = Entry;
-            return true;
+            return *Found;
         }
     }
+
+    return INDEX_NONE;
+}
+
+const FDialogueEntry* UDialogueDataAsset::FindDialogueEntry(FName DialogueID) const
+{
+    const int32 Index = FindIndexChecked(DialogueIDIndex, DialogueID, &FDialogueEntry::DialogueID);
+    return Index != INDEX_NONE ? &DialogueEntries[Index] : nullptr;
+}
+
+const FDialogueEntry* UDialogueDataAsset::FindDialogueByTrigger(FName TriggerEvent) const
+{
+    const int32 Index = FindIndexChecked(TriggerEventIndex, TriggerEvent, &FDialogueEntry::TriggerEvent);
+    return Index != INDEX_NONE ? &DialogueEntries[Index] : nullptr;
+}
+
+bool UDialogueDataAsset::GetDialogueEntry(FName DialogueID, FDialogueEntry& OutEntry) const
+{
+    if (const FDialogueEntry* Entry = FindDialogueEntry(DialogueID))
+    {
+        OutEntry = *Entry;
+        return true;
+    }
     
-    UE_LOG(LogTemp, Warning, TEXT("DialogueDataAsset: Dialogue ID '%s' not found"), *DialogueID.ToString());
+    UE_LOG(LogRLODialogue, Warning, TEXT("DialogueDataAsset: Dialogue ID '%s' not found"), *DialogueID.ToString());
     return false;
 }
 
 bool UDialogueDataAsset::GetDialogueByTrigger(FName TriggerEvent, FDialogueEntry& OutEntry) const
 {
-    for (const FDialogueEntry& Entry : DialogueEntries)
+    if (const FDialogueEntry* Entry = FindDialogueByTrigger(TriggerEvent))
     {
-        if (Entry.TriggerEvent == TriggerEvent)
-        {
-            OutEntry = Entry;
-            return true;
-        }
+        OutEntry = *Entry;
+        return true;
     }
     
-    UE_LOG(LogTemp, Warning, TEXT("DialogueDataAsset: Trigger event '%s' not found"), *TriggerEvent.ToString());
+    UE_LOG(LogRLODialogue, Warning, TEXT("DialogueDataAsset: Trigger event '%s' not found"), *TriggerEvent.ToString());
     return false;
 }
 
@@ -49,99 +139,137 @@ FText UDialogueDataAsset::GetDisplayText(const FDialogueEntry& Entry) const
 }
 
 #if WITH_EDITOR
+namespace
+{
+    /** 将CSV中的说话者/类型列解析为ESpeakerType(兼容各章节的不同写法) */
+    ESpeakerType ParseSpeakerType(const FString& SpeakerStr, const FString& DialogueTypeStr)
+    {
+        if (DialogueTypeStr == TEXT("Sound") || SpeakerStr == TEXT("SoundEffect"))
+        {
+            return ESpeakerType::SoundEffect;
+        }
+        if (SpeakerStr.IsEmpty() || SpeakerStr == TEXT("Narrator") || SpeakerStr == TEXT("System"))
+        {
+            return ESpeakerType::Narrator;
+        }
+        if (SpeakerStr == TEXT("Player") || SpeakerStr == TEXT("Protagonist"))
+        {
+            return ESpeakerType::Player;
+        }
+        return ESpeakerType::NPC;
+    }
+}
+
 bool UDialogueDataAsset::ImportFromCSV(const FString& CSVFilePath)
 {
     // 读取CSV文件
     FString CSVContent;
     if (!FFileHelper::LoadFileToString(CSVContent, *CSVFilePath))
     {
-        UE_LOG(LogTemp, Error, TEXT("DialogueDataAsset: Failed to load CSV file: %s"), *CSVFilePath);
+        UE_LOG(LogRLODialogue, Error, TEXT("DialogueDataAsset: Failed to load CSV file: %s"), *CSVFilePath);
         return false;
     }
 
-    // 解析CSV
-    TArray<FString> Lines;
-    CSVContent.ParseIntoArrayLines(Lines);
+    // 单次扫描解析,支持引号内的逗号和换行
+    FRLOCSVReader Reader(CSVContent);
+    if (!Reader.ReadHeader())
+    {
+        UE_LOG(LogRLODialogue, Error, TEXT("DialogueDataAsset: CSV file is empty or invalid: %s"), *Reader.GetLastError());
+        return false;
+    }
 
-    if (Lines.Num() < 2)
+    // 按表头名称映射列(各章节表结构不同)
+    const int32 IDColumn = Reader.FindColumn({ TEXT("DialogueID") });
+    const int32 TriggerColumn = Reader.FindColumn({ TEXT("TriggerEvent"), TEXT("TriggerCondition") });
+    const int32 SpeakerColumn = Reader.FindColumn({ TEXT("SpeakerType"), TEXT("SpeakerEN"), TEXT("SpeakerNameEN") });
+    const int32 TypeColumn = Reader.FindColumn({ TEXT("DialogueType") });
+    const int32 TextCNColumn = Reader.FindColumn({ TEXT("Text_CN"), TEXT("TextCN"), TEXT("DialogueTextCN"), TEXT("DialogueText") });
+    const int32 TextENColumn = Reader.FindColumn({ TEXT("Text_EN"), TEXT("TextEN"), TEXT("DialogueTextEN") });
+    const int32 AudioColumn = Reader.FindColumn({ TEXT("AudioPath") });
+    const int32 DurationColumn = Reader.FindColumn({ TEXT("Duration") });
+    const int32 NextColumn = Reader.FindColumn({ TEXT("NextDialogueID") });
+    const int32 ChoiceColumn = Reader.FindColumn({ TEXT("ChoiceOptions") });
+
+    if (IDColumn == INDEX_NONE || (TextCNColumn == INDEX_NONE && TextENColumn == INDEX_NONE))
     {
-        UE_LOG(LogTemp, Error, TEXT("DialogueDataAsset: CSV file is empty or invalid"));
+        UE_LOG(LogRLODialogue, Error, TEXT("DialogueDataAsset: CSV header is missing DialogueID or dialogue text columns: %s"), *CSVFilePath);
         return false;
     }
 
     // 清空现有数据
     DialogueEntries.Empty();
 
-    // 跳过标题行,从第二行开始解析
-    for (int32 i = 1; i < Lines.Num(); i++)
+    int32 SkippedRows = 0;
+    while (true)
     {
-        const FString& Line = Lines[i];
-        
-        // 跳过空行
-        if (Line.TrimStartAndEnd().IsEmpty())
+        const FRLOCSVReader::EReadResult Result = Reader.ReadRow();
+        if (Result == FRLOCSVReader::EReadResult::EndOfFile)
         {
-            continue;
+            break;
         }
 
-        // 解析CSV行(使用逗号分隔)
-        TArray<FString> Fields;
-        Line.ParseIntoArray(Fields, TEXT(","), false);
-
-        if (Fields.Num() < 8)
+        if (Result == FRLOCSVReader::EReadResult::Error)
         {
-            UE_LOG(LogTemp, Warning, TEXT("DialogueDataAsset: Invalid CSV line %d, skipping"), i + 1);
+            UE_LOG(LogRLODialogue, Warning, TEXT("DialogueDataAsset: %s, skipping"), *Reader.GetLastError());
+            SkippedRows++;
             continue;
         }
 
-        // 创建对话条目
-        FDialogueEntry Entry;
-        Entry.DialogueID = FName(*Fields[0].TrimStartAndEnd());
-        Entry.TriggerEvent = FName(*Fields[1].TrimStartAndEnd());
-        
-        // 解析说话者类型
-        FString SpeakerStr = Fields[2].TrimStartAndEnd();
-        if (SpeakerStr == TEXT("Narrator"))
+        if (!Reader.HasField(IDColumn))
         {
-            Entry.SpeakerType = ESpeakerType::Narrator;
-        }
-        else if (SpeakerStr == TEXT("Player"))
-        {
-            Entry.SpeakerType = ESpeakerType::Player;
-        }
-        else if (SpeakerStr == TEXT("NPC"))
-        {
-            Entry.SpeakerType = ESpeakerType::NPC;
-        }
-        else if (SpeakerStr == TEXT("SoundEffect"))
-        {
-            Entry.SpeakerType = ESpeakerType::SoundEffect;
+            UE_LOG(LogRLODialogue, Warning, TEXT("DialogueDataAsset: line %d has no DialogueID, skipping"), Reader.GetRowLineNumber());
+            SkippedRows++;
+            continue;
         }
 
-        Entry.TextCN = FText::FromString(Fields[3].TrimStartAndEnd().Replace(TEXT("\""), TEXT("")));
-        Entry.TextEN = FText::FromString(Fields[4].TrimStartAndEnd().Replace(TEXT("\""), TEXT("")));
-        Entry.AudioPath = Fields[5].TrimStartAndEnd();
-        
-        // 解析持续时间
-        FString DurationStr = Fields[6].TrimStartAndEnd();
-        if (!DurationStr.IsEmpty() && DurationStr != TEXT("循环"))
+        // 创建对话条目
+        FDialogueEntry& Entry = DialogueEntries.AddDefaulted_GetRef();
+        Entry.DialogueID = FName(*Reader.GetField(IDColumn));
+        Entry.TriggerEvent = Reader.HasField(TriggerColumn) ? FName(*Reader.GetField(TriggerColumn)) : NAME_None;
+        Entry.SpeakerType = ParseSpeakerType(Reader.GetField(SpeakerColumn), Reader.GetField(TypeColumn));
+        Entry.TextCN = FText::FromString(Reader.GetField(TextCNColumn));
+        Entry.TextEN = FText::FromString(Reader.GetField(TextENColumn));
+        Entry.AudioPath = Reader.GetField(AudioColumn);
+
+        // 解析持续时间("循环"等非数字值保留默认值)
+        const FString& DurationStr = Reader.GetField(DurationColumn);
+        if (!DurationStr.IsEmpty() && DurationStr.IsNumeric())
         {
             Entry.Duration = FCString::Atof(*DurationStr);
         }
 
         // 下一条对话ID和选项
-        if (Fields.Num() > 7)
+        if (Reader.HasField(NextColumn))
         {
-            Entry.NextDialogueID = FName(*Fields[7].TrimStartAndEnd());
-        }
-        if (Fields.Num() > 8)
-        {
-            Entry.ChoiceOptions = Fields[8].TrimStartAndEnd();
+            Entry.NextDialogueID = FName(*Reader.GetField(NextColumn));
         }
+        Entry.ChoiceOptions = Reader.GetField(ChoiceColumn);
+    }
 
-        DialogueEntries.Add(Entry);
+    RebuildLookupIndex();
+
+    UE_LOG(LogRLODialogue, Log, TEXT("DialogueDataAsset: Successfully imported %d dialogue entries from CSV (%d rows skipped)"),
+        DialogueEntries.Num(), SkippedRows);
+    return true;
+}
+
+bool UDialogueDataAsset::ExportToDialogueBank(const FString& BankFilePath) const
+{
+    TArray<uint8> BankData;
+    if (!FDialogueBank::Cook(*this, BankData))
+    {
+        UE_LOG(LogRLODialogue, Error, TEXT("DialogueDataAsset: Failed to cook dialogue bank for %s"), *GetName());
+        return false;
+    }
+
+    if (!FFileHelper::SaveArrayToFile(BankData, *BankFilePath))
+    {
+        UE_LOG(LogRLODialogue, Error, TEXT("DialogueDataAsset: Failed to write dialogue bank: %s"), *BankFilePath);
+        return false;
     }
 
-    UE_LOG(LogTemp, Log, TEXT("DialogueDataAsset: Successfully imported %d dialogue entries from CSV"), DialogueEntries.Num());
+    UE_LOG(LogRLODialogue, Log, TEXT("DialogueDataAsset: Exported %d dialogue entries to %s (%d bytes)"),
+        DialogueEntries.Num(), *BankFilePath, BankData.Num());
     return true;
 }
 #endif
@@ -0,0 +1,237 @@
+// DialogueWidgetBase.cpp
+
+#include "DialogueWidgetBase.h"
+#include "RustyLakeOrrery.h"
+#include "RLOPerf.h"
+#include "DialogueComponent.h"
+#include "Components/Button.h"
+#include "Components/TextBlock.h"
+#include "Components/PanelWidget.h"
+#include "Components/InvalidationBox.h"
+
+DECLARE_CYCLE_STAT(TEXT("UI DialogueReveal"), STAT_RLO_UIDialogueReveal, STATGROUP_RustyLakeOrrery);
+DECLARE_CYCLE_STAT(TEXT("UI DialogueChoices"), STAT_RLO_UIDialogueChoices, STATGROUP_RustyLakeOrrery);
+
+// ========================================================================
+// UDialogueChoiceWidget
+// ========================================================================
+
+void UDialogueChoiceWidget::NativeOnInitialized()
+{
+    Super::NativeOnInitialized();
+
+    if (ChoiceButton)
+    {
+        ChoiceButton->OnClicked.AddUniqueDynamic(this, &UDialogueChoiceWidget::HandleButtonClicked);
+    }
+}
+
+void UDialogueChoiceWidget::SetChoice(int32 InChoiceIndex, const FText& ChoiceLabel)
+{
+    ChoiceIndex = InChoiceIndex;
+
+    if (ChoiceText)
+    {
+        ChoiceText->SetText(ChoiceLabel);
+    }
+
+    OnChoiceSet(InChoiceIndex, ChoiceLabel);
+}
+
+void UDialogueChoiceWidget::HandleButtonClicked()
+{
+    if (ChoiceIndex != INDEX_NONE)
+    {
+        OnChoiceClicked.Broadcast(ChoiceIndex);
+    }
+}
+
+// ========================================================================
+// UDialogueWidgetBase
+// ========================================================================
+
+void UDialogueWidgetBase::NativeOnInitialized()
+{
+    Super::NativeOnInitialized();
+
+    // 缓存文本的绘制结果,只在文本变化时重绘
+    if (RevealInvalidationBox)
+    {
+        RevealInvalidationBox->SetCanCache(true);
+    }
+}
+
+void UDialogueWidgetBase::NativeDestruct()
+{
+    UnbindFromDialogueComponent();
+
+    Super::NativeDestruct();
+}
+
+void UDialogueWidgetBase::BindToDialogueComponent(UDialogueComponent* InDialogueComponent)
+{
+    if (DialogueComponent.Get() == InDialogueComponent)
+    {
+        return;
+    }
+
+    UnbindFromDialogueComponent();
+
+    if (!InDialogueComponent)
+    {
+        return;
+    }
+
+    DialogueComponent = InDialogueComponent;
+    InDialogueComponent->OnDialogueStarted.AddUniqueDynamic(this, &UDialogueWidgetBase::HandleDialogueStarted);
+    InDialogueComponent->OnDialogueRevealChanged.AddUniqueDynamic(this, &UDialogueWidgetBase::HandleRevealChanged);
+    InDialogueComponent->OnDialogueCompleted.AddUniqueDynamic(this, &UDialogueWidgetBase::HandleDialogueCompleted);
+    InDialogueComponent->OnWaitingForChoice.AddUniqueDynamic(this, &UDialogueWidgetBase::HandleWaitingForChoice);
+
+    // 绑定时对话可能已经开始,先显示当前状态
+    if (InDialogueComponent->CurrentState != EDialogueState::Idle)
+    {
+        HandleDialogueStarted(InDialogueComponent->CurrentDialogue);
+        ApplyReveal(InDialogueComponent->VisibleCharacterCount, InDialogueComponent->TotalCharacterCount);
+
+        if (InDialogueComponent->CurrentState == EDialogueState::WaitingForInput)
+        {
+            TArray<FString> Choices;
+            InDialogueComponent->CurrentDialogue.ChoiceOptions.ParseIntoArray(Choices, TEXT("|"), true);
+            ShowChoices(Choices);
+        }
+    }
+
+    UE_LOG(LogRLOUI, Log, TEXT("DialogueWidget: Bound to %s"), *GetNameSafe(InDialogueComponent->GetOwner()));
+}
+
+void UDialogueWidgetBase::UnbindFromDialogueComponent()
+{
+    if (UDialogueComponent* Component = DialogueComponent.Get())
+    {
+        Component->OnDialogueStarted.RemoveDynamic(this, &UDialogueWidgetBase::HandleDialogueStarted);
+        Component->OnDialogueRevealChanged.RemoveDynamic(this, &UDialogueWidgetBase::HandleRevealChanged);
+        Component->OnDialogueCompleted.RemoveDynamic(this, &UDialogueWidgetBase::HandleDialogueCompleted);
+        Component->OnWaitingForChoice.RemoveDynamic(this, &UDialogueWidgetBase::HandleWaitingForChoice);
+    }
+    DialogueComponent.Reset();
+
+    HideChoices();
+    DisplayedCharacterCount = INDEX_NONE;
+}
+
+void UDialogueWidgetBase::HandleDialogueStarted(const FDialogueEntry& Dialogue)
+{
+    HideChoices();
+
+    // 新对话的文本不同,即使可见字符数相同也要更新
+    DisplayedCharacterCount = INDEX_NONE;
+
+    if (SpeakerText)
+    {
+        SpeakerText->SetText(StaticEnum<ESpeakerType>()->GetDisplayNameTextByValue(static_cast<int64>(Dialogue.SpeakerType)));
+    }
+
+    OnDialogueEntryStarted(Dialogue);
+}
+
+void UDialogueWidgetBase::HandleRevealChanged(int32 VisibleCharacters, int32 TotalCharacters)
+{
+    ApplyReveal(VisibleCharacters, TotalCharacters);
+}
+
+void UDialogueWidgetBase::HandleDialogueCompleted(const FDialogueEntry& Dialogue)
+{
+    OnDialogueEntryCompleted(Dialogue);
+}
+
+void UDialogueWidgetBase::HandleWaitingForChoice(const TArray<FString>& Choices)
+{
+    ShowChoices(Choices);
+}
+
+void UDialogueWidgetBase::HandleChoiceClicked(int32 ChoiceIndex)
+{
+    HideChoices();
+
+    if (UDialogueComponent* Component = DialogueComponent.Get())
+    {
+        Component->SelectChoice(ChoiceIndex);
+    }
+}
+
+void UDialogueWidgetBase::ApplyReveal(int32 VisibleCharacters, int32 TotalCharacters)
+{
+    RLO_SCOPE_CYCLE(UI, STAT_RLO_UIDialogueReveal);
+
+    UDialogueComponent* Component = DialogueComponent.Get();
+    if (!Component || !DialogueText || VisibleCharacters == DisplayedCharacterCount)
+    {
+        return;
+    }
+    DisplayedCharacterCount = VisibleCharacters;
+
+    // 文本变化会让所在的 InvalidationBox 重新缓存,字符数不变的帧不会重绘
+    const FString& FullString = Component->GetFullDisplayString();
+    RevealBuffer.Reset();
+    RevealBuffer.AppendChars(*FullString, Component->GetDisplayStringLength(VisibleCharacters));
+    DialogueText->SetText(FText::FromString(RevealBuffer));
+
+    OnRevealUpdated(VisibleCharacters, TotalCharacters);
+}
+
+void UDialogueWidgetBase::ShowChoices(const TArray<FString>& Choices)
+{
+    RLO_SCOPE_CYCLE(UI, STAT_RLO_UIDialogueChoices);
+
+    if (!ChoiceContainer || !ChoiceWidgetClass)
+    {
+        UE_LOG(LogRLOUI, Warning, TEXT("DialogueWidget: Cannot show %d choices, ChoiceContainer or ChoiceWidgetClass is not set"), Choices.Num());
+        return;
+    }
+
+    // 按钮不够时才创建,之后的选项复用
+    while (ChoiceWidgets.Num() < Choices.Num())
+    {
+        UDialogueChoiceWidget* ChoiceWidget = CreateWidget<UDialogueChoiceWidget>(this, ChoiceWidgetClass);
+        if (!ChoiceWidget)
+        {
+            break;
+        }
+
+        ChoiceWidget->OnChoiceClicked.AddUniqueDynamic(this, &UDialogueWidgetBase::HandleChoiceClicked);
+        ChoiceContainer->AddChild(ChoiceWidget);
+        ChoiceWidgets.Add(ChoiceWidget);
+    }
+
+    NumVisibleChoices = FMath::Min(Choices.Num(), ChoiceWidgets.Num());
+    for (int32 Index = 0; Index < ChoiceWidgets.Num(); Index++)
+    {
+        UDialogueChoiceWidget* ChoiceWidget = ChoiceWidgets[Index];
+        if (Index < NumVisibleChoices)
+        {
+            ChoiceWidget->SetChoice(Index, FText::FromString(Choices[Index]));
+            ChoiceWidget->SetVisibility(ESlateVisibility::Visible);
+        }
+        else
+        {
+            ChoiceWidget->SetVisibility(ESlateVisibility::Collapsed);
+        }
+    }
+
+    OnChoicesShown(NumVisibleChoices);
+}
+
+void UDialogueWidgetBase::HideChoices()
+{
+    if (NumVisibleChoices == 0)
+    {
+        return;
+    }
+
+    for (int32 Index = 0; Index < NumVisibleChoices; Index++)
+    {
+        ChoiceWidgets[Index]->SetVisibility(ESlateVisibility::Collapsed);
+    }
+    NumVisibleChoices = 0;
+}
@@ -1,6 +1,7 @@
 // InteractableComponent.cpp
 
 #include "InteractableComponent.h"
+#include "RustyLakeOrrery.h"
 #include "Components/MeshComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Components/SkeletalMeshComponent.h"
@@ -9,10 +10,16 @@
 #include "Kismet/GameplayStatics.h"
 #include "Engine/World.h"
 #include "InventoryComponent.h"
+#include "InteractableSubsystem.h"
+#include "ChapterAssetSubsystem.h"
+#include "RoomStreamingSubsystem.h"
+#include "SaveSubsystem.h"
 
 UInteractableComponent::UInteractableComponent()
 {
+    // 默认不Tick，只在长按等依赖时间的交互进行中启用
     PrimaryComponentTick.bCanEverTick = true;
+    PrimaryComponentTick.bStartWithTickEnabled = false;
 }
 
 void UInteractableComponent::BeginPlay()
@@ -38,16 +45,56 @@ void UInteractableComponent::BeginPlay()
             InitialRotation = CachedMeshComponent->GetRelativeRotation();
         }
     }
+
+    // 恢复存档状态，已被拾取的物品不再出现
+    if (USaveSubsystem* SaveSubsystem = USaveSubsystem::Get(this))
+    {
+        SaveSubsystem->RegisterSaveable(this);
+    }
+
+    if (bPickedUp && Owner)
+    {
+        Owner->Destroy();
+        return;
+    }
+
+    // 注册到可交互对象注册表，供InteractionComponent按命中结果直接查找
+    if (UInteractableSubsystem* Registry = UInteractableSubsystem::Get(this))
+    {
+        Registry->RegisterInteractable(this);
+    }
+}
+
+void UInteractableComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UInteractableSubsystem* Registry = UInteractableSubsystem::Get(this))
+    {
+        Registry->UnregisterInteractable(this);
+    }
+
+    if (USaveSubsystem* SaveSubsystem = USaveSubsystem::Get(this))
+    {
+        SaveSubsystem->UnregisterSaveable(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
 }
 
 void UInteractableComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
     Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-    // 如果正在旋转且是RotateObject类型，检查目标角度
-    if (bIsRotating && InteractionType == EInteractionType::RotateObject)
+    // 长按计时（由BeginLongPress传入Interactor时自动推进）
+    AActor* Interactor = LongPressInteractor.Get();
+    if (!bIsLongPressing || !Interactor)
     {
-        CheckTargetRotation();
+        SetComponentTickEnabled(false);
+        return;
+    }
+
+    if (UpdateLongPress(DeltaTime))
+    {
+        ExecuteInteraction(Interactor);
     }
 }
 
@@ -116,7 +163,7 @@ bool UInteractableComponent::HandleSwipe(const FVector2D& SwipeVector, AActor* I
     // 执行交互
     ExecuteInteraction(Interactor);
     
-    UE_LOG(LogTemp, Log, TEXT("InteractableComponent: Swipe handled, direction: %s"), 
+    UE_LOG(LogRLOInteraction, Log, TEXT("InteractableComponent: Swipe handled, direction: %s"), 
         *SwipeVector.ToString());
     
     return true;
@@ -132,7 +179,7 @@ void UInteractableComponent::BeginRotation()
     bIsRotating = true;
     bTargetAngleReached = false;
     
-    UE_LOG(LogTemp, Log, TEXT("InteractableComponent: Rotation started"));
+    UE_LOG(LogRLOInteraction, Log, TEXT("InteractableComponent: Rotation started"));
 }
 
 void UInteractableComponent::UpdateRotation(float DeltaRotation)
@@ -161,13 +208,15 @@ void UInteractableComponent::UpdateRotation(float DeltaRotation)
     }
 
     // 应用旋转到网格体
-    FRotator NewRotation = InitialRotation;
-    FQuat RotationQuat = FQuat(RotationAxis.GetSafeNormal(), FMath::DegreesToRadians(CurrentRotationAngle));
-    NewRotation = (RotationQuat * FQuat(InitialRotation)).Rotator();
-    
-    CachedMeshComponent->SetRelativeRotation(NewRotation);
+    ApplyMeshRotation();
+
+    UE_LOG(LogRLOInteraction, Verbose, TEXT("InteractableComponent: Rotation updated to %.2f degrees"), CurrentRotationAngle);
 
-    UE_LOG(LogTemp, Verbose, TEXT("InteractableComponent: Rotation updated to %.2f degrees"), CurrentRotationAngle);
+    // 角度只在这里变化，随更新检查目标角度，无需Tick
+    if (InteractionType == EInteractionType::RotateObject)
+    {
+        CheckTargetRotation();
+    }
 }
 
 void UInteractableComponent::EndRotation()
@@ -178,11 +227,14 @@ void UInteractableComponent::EndRotation()
     }
 
     bIsRotating = false;
+
+    // 松手时角度才算确定，拖动过程中不写入存档
+    USaveSubsystem::MarkDirty(this);
     
-    UE_LOG(LogTemp, Log, TEXT("InteractableComponent: Rotation ended at %.2f degrees"), CurrentRotationAngle);
+    UE_LOG(LogRLOInteraction, Log, TEXT("InteractableComponent: Rotation ended at %.2f degrees"), CurrentRotationAngle);
 }
 
-void UInteractableComponent::BeginLongPress()
+void UInteractableComponent::BeginLongPress(AActor* Interactor)
 {
     if (!bIsInteractable)
     {
@@ -191,8 +243,15 @@ void UInteractableComponent::BeginLongPress()
 
     bIsLongPressing = true;
     LongPressTimer = 0.0f;
+    LongPressInteractor = Interactor;
+
+    // 只在长按期间Tick
+    if (Interactor)
+    {
+        SetComponentTickEnabled(true);
+    }
     
-    UE_LOG(LogTemp, Log, TEXT("InteractableComponent: Long press started"));
+    UE_LOG(LogRLOInteraction, Log, TEXT("InteractableComponent: Long press started"));
 }
 
 bool UInteractableComponent::UpdateLongPress(float DeltaTime)
@@ -208,13 +267,43 @@ bool UInteractableComponent::UpdateLongPress(float DeltaTime)
     {
         // 长按完成
         bIsLongPressing = false;
-        UE_LOG(LogTemp, Log, TEXT("InteractableComponent: Long press completed"));
+        LongPressInteractor.Reset();
+        SetComponentTickEnabled(false);
+        UE_LOG(LogRLOInteraction, Log, TEXT("InteractableComponent: Long press completed"));
         return true;
     }
 
     return false;
 }
 
+void UInteractableComponent::SetLongPressProgress(float Progress)
+{
+    if (!bIsLongPressing)
+    {
+        return;
+    }
+
+    // 完成由外部计时决定，进度停在完成之前
+    LongPressTimer = FMath::Clamp(Progress, 0.0f, 1.0f) * LongPressDuration;
+}
+
+void UInteractableComponent::CompleteLongPress(AActor* Interactor)
+{
+    if (!bIsLongPressing)
+    {
+        return;
+    }
+
+    LongPressTimer = LongPressDuration;
+    bIsLongPressing = false;
+    LongPressInteractor.Reset();
+    SetComponentTickEnabled(false);
+
+    UE_LOG(LogRLOInteraction, Log, TEXT("InteractableComponent: Long press completed"));
+
+    ExecuteInteraction(Interactor);
+}
+
 void UInteractableComponent::CancelLongPress()
 {
     if (!bIsLongPressing)
@@ -224,8 +313,15 @@ void UInteractableComponent::CancelLongPress()
 
     bIsLongPressing = false;
     LongPressTimer = 0.0f;
+    LongPressInteractor.Reset();
+    SetComponentTickEnabled(false);
     
-    UE_LOG(LogTemp, Verbose, TEXT("InteractableComponent: Long press cancelled"));
+    UE_LOG(LogRLOInteraction, Verbose, TEXT("InteractableComponent: Long press cancelled"));
+}
+
+float UInteractableComponent::GetLongPressProgress() const
+{
+    return LongPressDuration > 0.0f ? FMath::Clamp(LongPressTimer / LongPressDuration, 0.0f, 1.0f) : 0.0f;
 }
 
 void UInteractableComponent::BeginFocus()
@@ -242,6 +338,20 @@ void UInteractableComponent::BeginFocus()
     {
         ApplyHighlight(true);
     }
+
+    // 场景切换对象获得焦点时后台预加载目标房间，点击时即可无缝切换
+    if (InteractionType == EInteractionType::Navigate && !TargetLevelName.IsNone())
+    {
+        if (URoomStreamingSubsystem* RoomStreaming = URoomStreamingSubsystem::Get(this))
+        {
+            RoomStreaming->PreloadRoom(TargetLevelName);
+        }
+
+        if (UChapterAssetSubsystem* ChapterAssets = UChapterAssetSubsystem::Get(this))
+        {
+            ChapterAssets->PrepareForLevel(TargetLevelName);
+        }
+    }
 }
 
 void UInteractableComponent::EndFocus()
@@ -278,12 +388,12 @@ void UInteractableComponent::HandleObserveInteraction(AActor* Interactor)
     if (ObserveDialogue)
     {
         // TODO: 调用DialogueComponent播放对话
-        UE_LOG(LogTemp, Log, TEXT("InteractableComponent: Playing dialogue asset (TODO: Integrate DialogueSystem)"));
+        UE_LOG(LogRLOInteraction, Log, TEXT("InteractableComponent: Playing dialogue asset (TODO: Integrate DialogueSystem)"));
     }
     else if (!ObserveText.IsEmpty())
     {
         // TODO: 显示简单文本UI
-        UE_LOG(LogTemp, Log, TEXT("InteractableComponent: Observe text: %s"), *ObserveText.ToString());
+        UE_LOG(LogRLOInteraction, Log, TEXT("InteractableComponent: Observe text: %s"), *ObserveText.ToString());
     }
 }
 
@@ -291,7 +401,7 @@ void UInteractableComponent::HandlePickupInteraction(AActor* Interactor)
 {
     if (!PickupItemData)
     {
-        UE_LOG(LogTemp, Warning, TEXT("InteractableComponent: Pickup interaction but no ItemData assigned!"));
+        UE_LOG(LogRLOInteraction, Warning, TEXT("InteractableComponent: Pickup interaction but no ItemData assigned!"));
         return;
     }
 
@@ -312,7 +422,7 @@ void UInteractableComponent::HandlePickupInteraction(AActor* Interactor)
             
             if (bSuccess)
             {
-                UE_LOG(LogTemp, Log, TEXT("InteractableComponent: Successfully picked up %s"), *PickupItemData->ItemName.ToString());
+                UE_LOG(LogRLOInteraction, Log, TEXT("InteractableComponent: Successfully picked up %s"), *PickupItemData->ItemName.ToString());
                 
                 // 播放拾取音效（InventoryComponent会自动播放，这里不需要重复）
                 // if (PickupSound)
@@ -326,18 +436,21 @@ void UInteractableComponent::HandlePickupInteraction(AActor* Interactor)
                     AActor* Owner = GetOwner();
                     if (Owner)
                     {
+                        // 销毁前标记，注销时写入存档
+                        bPickedUp = true;
+                        USaveSubsystem::MarkDirty(this);
                         Owner->Destroy();
                     }
                 }
             }
             else
             {
-                UE_LOG(LogTemp, Warning, TEXT("InteractableComponent: Failed to add item to inventory (full?)"));
+                UE_LOG(LogRLOInteraction, Warning, TEXT("InteractableComponent: Failed to add item to inventory (full?)"));
             }
         }
         else
         {
-            UE_LOG(LogTemp, Warning, TEXT("InteractableComponent: PlayerController has no InventoryComponent!"));
+            UE_LOG(LogRLOInteraction, Warning, TEXT("InteractableComponent: PlayerController has no InventoryComponent!"));
         }
     }
 }
@@ -346,19 +459,39 @@ void UInteractableComponent::HandleNavigateInteraction(AActor* Interactor)
 {
     if (TargetLevelName.IsNone())
     {
-        UE_LOG(LogTemp, Warning, TEXT("InteractableComponent: Navigate interaction but no TargetLevelName assigned!"));
+        UE_LOG(LogRLOInteraction, Warning, TEXT("InteractableComponent: Navigate interaction but no TargetLevelName assigned!"));
+        return;
+    }
+
+    // 提前加载目标关卡所属章节的资源
+    if (UChapterAssetSubsystem* ChapterAssets = UChapterAssetSubsystem::Get(this))
+    {
+        ChapterAssets->PrepareForLevel(TargetLevelName);
+    }
+
+    // 优先通过流式子关卡切换房间
+    URoomStreamingSubsystem* RoomStreaming = URoomStreamingSubsystem::Get(this);
+    if (RoomStreaming && RoomStreaming->NavigateToRoom(TargetLevelName, TransitionDuration, GetOwner()))
+    {
+        UE_LOG(LogRLOInteraction, Log, TEXT("InteractableComponent: Navigating to room: %s"), *TargetLevelName.ToString());
         return;
     }
 
-    // TODO: 集成CoreGame的关卡加载系统
-    UE_LOG(LogTemp, Log, TEXT("InteractableComponent: Navigating to level: %s (TODO: Integrate CoreGame)"), *TargetLevelName.ToString());
+    if (RoomStreaming && (RoomStreaming->IsTransitioning() || RoomStreaming->GetCurrentRoom() == TargetLevelName))
+    {
+        return;
+    }
+
+    // 目标不是可流式加载的房间（如其他持久关卡），只能整体切换关卡
+    UE_LOG(LogRLOInteraction, Warning, TEXT("InteractableComponent: %s is not a streamable room, falling back to OpenLevel"), *TargetLevelName.ToString());
+    UGameplayStatics::OpenLevel(this, TargetLevelName);
 }
 
 void UInteractableComponent::HandleUseItemInteraction(AActor* Interactor)
 {
     if (!RequiredItemData)
     {
-        UE_LOG(LogTemp, Warning, TEXT("InteractableComponent: UseItem interaction but no RequiredItemData assigned!"));
+        UE_LOG(LogRLOInteraction, Warning, TEXT("InteractableComponent: UseItem interaction but no RequiredItemData assigned!"));
         return;
     }
 
@@ -381,31 +514,31 @@ void UInteractableComponent::HandleUseItemInteraction(AActor* Interactor)
                 if (bConsumeItem)
                 {
                     Inventory->RemoveItem(RequiredItemData);
-                    UE_LOG(LogTemp, Log, TEXT("InteractableComponent: Consumed item %s"), *RequiredItemData->ItemName.ToString());
+                    UE_LOG(LogRLOInteraction, Log, TEXT("InteractableComponent: Consumed item %s"), *RequiredItemData->ItemName.ToString());
                 }
                 
                 // 显示成功文本
                 if (!OnItemUsedText.IsEmpty())
                 {
                     // TODO: 显示UI文本
-                    UE_LOG(LogTemp, Log, TEXT("InteractableComponent: Item used text: %s"), *OnItemUsedText.ToString());
+                    UE_LOG(LogRLOInteraction, Log, TEXT("InteractableComponent: Item used text: %s"), *OnItemUsedText.ToString());
                 }
                 
                 // 广播成功事件
                 OnItemUsedSuccessfully.Broadcast(RequiredItemData);
                 
                 // 使用物品后可以禁用交互
-                bIsInteractable = false;
+                SetInteractable(false);
             }
             else
             {
-                UE_LOG(LogTemp, Warning, TEXT("InteractableComponent: Player doesn't have required item %s"), *RequiredItemData->ItemName.ToString());
+                UE_LOG(LogRLOInteraction, Warning, TEXT("InteractableComponent: Player doesn't have required item %s"), *RequiredItemData->ItemName.ToString());
                 // TODO: 显示“需要XX物品”的提示
             }
         }
         else
         {
-            UE_LOG(LogTemp, Warning, TEXT("InteractableComponent: PlayerController has no InventoryComponent!"));
+            UE_LOG(LogRLOInteraction, Warning, TEXT("InteractableComponent: PlayerController has no InventoryComponent!"));
         }
     }
 }
@@ -414,12 +547,12 @@ void UInteractableComponent::HandlePuzzleInteraction(AActor* Interactor)
 {
     if (!TargetPuzzle)
     {
-        UE_LOG(LogTemp, Warning, TEXT("InteractableComponent: TriggerPuzzle interaction but no TargetPuzzle assigned!"));
+        UE_LOG(LogRLOInteraction, Warning, TEXT("InteractableComponent: TriggerPuzzle interaction but no TargetPuzzle assigned!"));
         return;
     }
 
     // TODO: 调用谜题的激活函数
-    UE_LOG(LogTemp, Log, TEXT("InteractableComponent: Triggered puzzle (TODO: Integrate PuzzleSystem)"));
+    UE_LOG(LogRLOInteraction, Log, TEXT("InteractableComponent: Triggered puzzle (TODO: Integrate PuzzleSystem)"));
 }
 
 void UInteractableComponent::HandleSwipeTriggerInteraction(AActor* Interactor)
@@ -428,7 +561,7 @@ void UInteractableComponent::HandleSwipeTriggerInteraction(AActor* Interactor)
     if (!OnSwipeText.IsEmpty())
     {
         // TODO: 显示UI文本
-        UE_LOG(LogTemp, Log, TEXT("InteractableComponent: Swipe trigger text: %s"), *OnSwipeText.ToString());
+        UE_LOG(LogRLOInteraction, Log, TEXT("InteractableComponent: Swipe trigger text: %s"), *OnSwipeText.ToString());
     }
 
     // 可以在这里触发其他逻辑，如播放动画、触发事件等
@@ -451,14 +584,14 @@ void UInteractableComponent::ApplyHighlight(bool bEnable)
         CachedMeshComponent->SetRenderCustomDepth(true);
         CachedMeshComponent->SetCustomDepthStencilValue(1);
 
-        UE_LOG(LogTemp, Verbose, TEXT("InteractableComponent: Highlight enabled"));
+        UE_LOG(LogRLOInteraction, Verbose, TEXT("InteractableComponent: Highlight enabled"));
     }
     else
     {
         // 禁用自定义深度渲染
         CachedMeshComponent->SetRenderCustomDepth(false);
         
-        UE_LOG(LogTemp, Verbose, TEXT("InteractableComponent: Highlight disabled"));
+        UE_LOG(LogRLOInteraction, Verbose, TEXT("InteractableComponent: Highlight disabled"));
     }
 }
 
@@ -515,7 +648,7 @@ bool UInteractableComponent::IsSwipeDirectionValid(const FVector2D& SwipeVector)
     // 检查是否在容差范围内
     bool bIsValid = AngleDiff <= SwipeAngleTolerance;
 
-    UE_LOG(LogTemp, Verbose, TEXT("InteractableComponent: Swipe angle: %.2f, Target: %.2f, Diff: %.2f, Valid: %s"),
+    UE_LOG(LogRLOInteraction, Verbose, TEXT("InteractableComponent: Swipe angle: %.2f, Target: %.2f, Diff: %.2f, Valid: %s"),
         SwipeAngle, TargetAngle, AngleDiff, bIsValid ? TEXT("Yes") : TEXT("No"));
 
     return bIsValid;
@@ -544,7 +677,43 @@ void UInteractableComponent::CheckTargetRotation()
         bTargetAngleReached = true;
         OnTargetRotationReached.Broadcast(CurrentRotationAngle);
         
-        UE_LOG(LogTemp, Log, TEXT("InteractableComponent: Target rotation reached! Current: %.2f, Target: %.2f"),
+        UE_LOG(LogRLOInteraction, Log, TEXT("InteractableComponent: Target rotation reached! Current: %.2f, Target: %.2f"),
             CurrentRotationAngle, TargetRotationAngle);
     }
 }
+
+void UInteractableComponent::ApplyMeshRotation()
+{
+    if (!CachedMeshComponent)
+    {
+        return;
+    }
+
+    FQuat RotationQuat = FQuat(RotationAxis.GetSafeNormal(), FMath::DegreesToRadians(CurrentRotationAngle));
+    CachedMeshComponent->SetRelativeRotation((RotationQuat * FQuat(InitialRotation)).Rotator());
+}
+
+void UInteractableComponent::SetInteractable(bool bInteractable)
+{
+    if (bIsInteractable == bInteractable)
+    {
+        return;
+    }
+
+    bIsInteractable = bInteractable;
+    USaveSubsystem::MarkDirty(this);
+}
+
+void UInteractableComponent::SerializeSaveRecord(FArchive& Ar)
+{
+    Ar << bIsInteractable;
+    Ar << bPickedUp;
+    Ar << CurrentRotationAngle;
+    Ar << bTargetAngleReached;
+
+    // 恢复旋转过的网格体（BeginPlay中已保存初始旋转）
+    if (Ar.IsLoading())
+    {
+        ApplyMeshRotation();
+    }
+}
@@ -0,0 +1,142 @@
+// InteractableSubsystem.cpp
+
+#include "InteractableSubsystem.h"
+#include "InteractableComponent.h"
+#include "ChapterAssetSubsystem.h"
+#include "Components/PrimitiveComponent.h"
+#include "GameFramework/Actor.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+
+UInteractableSubsystem* UInteractableSubsystem::Get(const UObject* WorldContextObject)
+{
+    UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+    return World ? World->GetSubsystem<UInteractableSubsystem>() : nullptr;
+}
+
+void UInteractableSubsystem::RegisterInteractable(UInteractableComponent* Interactable)
+{
+    AActor* Owner = Interactable ? Interactable->GetOwner() : nullptr;
+    if (!Owner || Interactables.Contains(Interactable))
+    {
+        return;
+    }
+
+    Interactables.Add(Interactable);
+
+    // 同一Actor上有多个可交互组件时第一个优先（与FindComponentByClass一致）
+    if (!ActorMap.Contains(Owner))
+    {
+        ActorMap.Add(Owner, Interactable);
+    }
+
+    TInlineComponentArray<UPrimitiveComponent*> Primitives(Owner);
+    for (UPrimitiveComponent* Primitive : Primitives)
+    {
+        if (!PrimitiveMap.Contains(Primitive))
+        {
+            PrimitiveMap.Add(Primitive, Interactable);
+        }
+    }
+
+    // 可交互对象引用的物品资源加入所在章节的预加载清单
+    if (UChapterAssetSubsystem* ChapterAssets = UChapterAssetSubsystem::Get(this))
+    {
+        ChapterAssets->RegisterPlacedInteractable(Interactable);
+    }
+}
+
+void UInteractableSubsystem::UnregisterInteractable(UInteractableComponent* Interactable)
+{
+    if (!Interactable || Interactables.RemoveSwap(Interactable) == 0)
+    {
+        return;
+    }
+
+    // Actor上如果还有其他已注册的可交互组件，改为指向它
+    UInteractableComponent* Replacement = nullptr;
+    AActor* Owner = Interactable->GetOwner();
+    if (Owner)
+    {
+        for (UInteractableComponent* Other : Interactables)
+        {
+            if (Other && Other->GetOwner() == Owner)
+            {
+                Replacement = Other;
+                break;
+            }
+        }
+    }
+
+    for (auto It = ActorMap.CreateIterator(); It; ++It)
+    {
+        if (It.Value() == Interactable)
+        {
+            if (Replacement)
+            {
+                It.Value() = Replacement;
+            }
+            else
+            {
+                It.RemoveCurrent();
+            }
+        }
+    }
+
+    for (auto It = PrimitiveMap.CreateIterator(); It; ++It)
+    {
+        if (It.Value() == Interactable || !It.Value().IsValid())
+        {
+            if (Replacement)
+            {
+                It.Value() = Replacement;
+            }
+            else
+            {
+                It.RemoveCurrent();
+            }
+        }
+    }
+}
+
+UInteractableComponent* UInteractableSubsystem::FindForHit(const FHitResult& HitResult) const
+{
+    if (UInteractableComponent* Interactable = FindForPrimitive(HitResult.GetComponent()))
+    {
+        return Interactable;
+    }
+
+    // 图元组件在注册之后才添加时，按Actor查找
+    return FindForActor(HitResult.GetActor());
+}
+
+UInteractableComponent* UInteractableSubsystem::FindForActor(const AActor* Actor) const
+{
+    if (!Actor)
+    {
+        return nullptr;
+    }
+
+    const TWeakObjectPtr<UInteractableComponent>* Found = ActorMap.Find(Actor);
+    return Found ? Found->Get() : nullptr;
+}
+
+UInteractableComponent* UInteractableSubsystem::FindForPrimitive(const UPrimitiveComponent* Primitive) const
+{
+    if (!Primitive)
+    {
+        return nullptr;
+    }
+
+    const TWeakObjectPtr<UInteractableComponent>* Found = PrimitiveMap.Find(Primitive);
+    return Found ? Found->Get() : nullptr;
+}
+
+void UInteractableSubsystem::Deinitialize()
+{
+    Interactables.Reset();
+    ActorMap.Reset();
+    PrimitiveMap.Reset();
+
+    Super::Deinitialize();
+}
@@ -1,11 +1,22 @@
 // InteractionComponent.cpp
 
 #include "InteractionComponent.h"
+#include "RustyLakeOrrery.h"
+#include "RLOPerf.h"
 #include "InteractableComponent.h"
+#include "InteractableSubsystem.h"
 #include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Components/InputComponent.h"
 #include "Engine/World.h"
 #include "DrawDebugHelpers.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Interaction Traces Performed"), STAT_RLO_InteractionTracesPerformed, STATGROUP_RustyLakeOrrery);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Interaction Traces Saved"), STAT_RLO_InteractionTracesSaved, STATGROUP_RustyLakeOrrery);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Interaction Traces Deferred"), STAT_RLO_InteractionTracesDeferred, STATGROUP_RustyLakeOrrery);
+DECLARE_CYCLE_STAT(TEXT("Interaction Tick"), STAT_RLO_InteractionTick, STATGROUP_RustyLakeOrrery);
+DECLARE_CYCLE_STAT(TEXT("Interaction Trace"), STAT_RLO_InteractionTrace, STATGROUP_RustyLakeOrrery);
+
 UInteractionComponent::UInteractionComponent()
 {
     PrimaryComponentTick.bCanEverTick = true;
@@ -20,26 +31,81 @@ void UInteractionComponent::BeginPlay()
     
     if (!CachedPlayerController)
     {
-        UE_LOG(LogTemp, Error, TEXT("InteractionComponent: Must be attached to a PlayerController!"));
+        UE_LOG(LogRLOInteraction, Error, TEXT("InteractionComponent: Must be attached to a PlayerController!"));
         return;
     }
 
+    InteractableRegistry = UInteractableSubsystem::Get(this);
+
     // 绑定输入
     BindInputActions();
 }
 
 void UInteractionComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
+    RLO_SCOPE_CYCLE(Interaction, STAT_RLO_InteractionTick);
+
     Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-    // 处理触控输入
-    HandleTouchInput(DeltaTime);
+    // InputComponent在BeginPlay时可能尚未创建
+    if (!bInputBound)
+    {
+        BindInputActions();
+    }
+
+    // 推进手势识别器的时间（长按），可交互对象只镜像识别器的进度用于显示
+    if (GestureRecognizer.IsTouching())
+    {
+        const double Now = GetWorld()->GetRealTimeSeconds();
+        GestureRecognizer.Advance(Now, PendingGestureEvents);
+        DispatchGestureEvents();
+
+        if (TouchStartInteractableComponent)
+        {
+            TouchStartInteractableComponent->SetLongPressProgress(GestureRecognizer.GetLongPressProgress(Now));
+        }
+    }
 
     // 如果没有触摸输入，执行常规的射线检测（用于鼠标输入）
-    if (CurrentTouchState == ETouchState::None)
+    if (GestureRecognizer.IsTouching())
+    {
+        return;
+    }
+
+    if (!bEventDrivenTrace)
     {
         PerformInteractionTrace();
+        return;
+    }
+
+    // 事件驱动：只在指针/视角变化、外部请求或超过强制间隔时检测
+    FTraceViewSnapshot Snapshot;
+    CaptureTraceSnapshot(Snapshot);
+
+    const float Now = GetWorld()->GetTimeSeconds();
+    const bool bIntervalElapsed = MaxTraceInterval > 0.0f && Now - LastHoverTraceTime >= MaxTraceInterval;
+
+    if (!bTraceRequested && !bIntervalElapsed && !HasTraceSnapshotChanged(Snapshot))
+    {
+        TotalTracesSaved++;
+        INC_DWORD_STAT(STAT_RLO_InteractionTracesSaved);
+        return;
     }
+
+    if (!ConsumeTraceBudget())
+    {
+        // 预算已用完，保留请求到下一帧
+        bTraceRequested = true;
+        INC_DWORD_STAT(STAT_RLO_InteractionTracesDeferred);
+        return;
+    }
+
+    LastTraceSnapshot = Snapshot;
+    bHasTraceSnapshot = true;
+    bTraceRequested = false;
+    LastHoverTraceTime = Now;
+
+    PerformInteractionTrace();
 }
 
 FText UInteractionComponent::GetCurrentPrompt() const
@@ -59,17 +125,71 @@ float UInteractionComponent::GetLongPressProgress() const
         return 0.0f;
     }
 
-    // 获取长按所需时间
-    // TODO: 从InteractableComponent获取LongPressDuration
-    float RequiredDuration = 1.0f; // 默认值
-    
-    return FMath::Clamp(TouchDuration / RequiredDuration, 0.0f, 1.0f);
+    return GestureRecognizer.GetLongPressProgress(GetWorld()->GetRealTimeSeconds());
 }
 
 // ============================================================================
 // 内部实现函数（完全封装的黑盒逻辑）
 // ============================================================================
 
+void UInteractionComponent::CaptureTraceSnapshot(FTraceViewSnapshot& OutSnapshot) const
+{
+    if (!CachedPlayerController)
+    {
+        return;
+    }
+
+    float MouseX, MouseY;
+    CachedPlayerController->GetMousePosition(MouseX, MouseY);
+    OutSnapshot.PointerPosition = FVector2D(MouseX, MouseY);
+
+    int32 ViewportX, ViewportY;
+    CachedPlayerController->GetViewportSize(ViewportX, ViewportY);
+    OutSnapshot.ViewportSize = FIntPoint(ViewportX, ViewportY);
+
+    if (CachedPlayerController->PlayerCameraManager)
+    {
+        const FMinimalViewInfo& View = CachedPlayerController->PlayerCameraManager->GetCameraCachePOV();
+        OutSnapshot.ViewLocation = View.Location;
+        OutSnapshot.ViewRotation = View.Rotation;
+        OutSnapshot.FOV = View.FOV;
+        OutSnapshot.OrthoWidth = View.OrthoWidth;
+    }
+}
+
+bool UInteractionComponent::HasTraceSnapshotChanged(const FTraceViewSnapshot& Snapshot) const
+{
+    if (!bHasTraceSnapshot)
+    {
+        return true;
+    }
+
+    const FTraceViewSnapshot& Last = LastTraceSnapshot;
+    return FVector2D::DistSquared(Snapshot.PointerPosition, Last.PointerPosition) > FMath::Square(PointerMoveThreshold)
+        || FVector::DistSquared(Snapshot.ViewLocation, Last.ViewLocation) > FMath::Square(ViewLocationThreshold)
+        || !Snapshot.ViewRotation.Equals(Last.ViewRotation, ViewRotationThreshold)
+        || !FMath::IsNearlyEqual(Snapshot.FOV, Last.FOV)
+        || !FMath::IsNearlyEqual(Snapshot.OrthoWidth, Last.OrthoWidth)
+        || Snapshot.ViewportSize != Last.ViewportSize;
+}
+
+bool UInteractionComponent::ConsumeTraceBudget()
+{
+    if (TraceBudgetFrame != GFrameCounter)
+    {
+        TraceBudgetFrame = GFrameCounter;
+        TracesThisFrame = 0;
+    }
+
+    if (MaxTracesPerFrame > 0 && TracesThisFrame >= MaxTracesPerFrame)
+    {
+        return false;
+    }
+
+    TracesThisFrame++;
+    return true;
+}
+
 void UInteractionComponent::PerformInteractionTrace()
 {
     if (!CachedPlayerController)
@@ -89,81 +209,189 @@ void UInteractionComponent::PerformInteractionTrace()
     
     if (bHit)
     {
-        AActor* HitActor = HitResult.GetActor();
-        if (HitActor)
+        // 检查是否有InteractableComponent
+        UInteractableComponent* InteractableComp = FindInteractable(HitResult);
+        if (InteractableComp && InteractableComp->CanInteract())
         {
-            // 检查是否有InteractableComponent
-            UInteractableComponent* InteractableComp = HitActor->FindComponentByClass<UInteractableComponent>();
-            if (InteractableComp && InteractableComp->CanInteract())
-            {
-                NewFocusedActor = HitActor;
-            }
+            NewFocusedActor = HitResult.GetActor();
         }
     }
 
     UpdateFocusedActor(NewFocusedActor);
 }
 
-void UInteractionComponent::HandleTouchInput(float DeltaTime)
+void UInteractionComponent::InjectTouchSample(const FRLOTouchSample& Sample)
 {
-    if (!CachedPlayerController)
+    FeedTouchSample(Sample);
+}
+
+void UInteractionComponent::HandleTouchPressed(ETouchIndex::Type FingerIndex, FVector Location)
+{
+    FeedTouchSample(FRLOTouchSample(static_cast<int32>(FingerIndex), ERLOTouchPhase::Began, FVector2D(Location), GetWorld()->GetRealTimeSeconds()));
+}
+
+void UInteractionComponent::HandleTouchMoved(ETouchIndex::Type FingerIndex, FVector Location)
+{
+    FeedTouchSample(FRLOTouchSample(static_cast<int32>(FingerIndex), ERLOTouchPhase::Moved, FVector2D(Location), GetWorld()->GetRealTimeSeconds()));
+}
+
+void UInteractionComponent::HandleTouchReleased(ETouchIndex::Type FingerIndex, FVector Location)
+{
+    FeedTouchSample(FRLOTouchSample(static_cast<int32>(FingerIndex), ERLOTouchPhase::Ended, FVector2D(Location), GetWorld()->GetRealTimeSeconds()));
+}
+
+void UInteractionComponent::FeedTouchSample(const FRLOTouchSample& Sample)
+{
+    if (!GestureRecognizer.IsTouching())
     {
-        return;
+        // 新的触摸序列开始前同步参数，运行时修改的配置也能生效
+        ApplyGestureConfig();
     }
 
-    // 获取触摸输入状态
-    float TouchX, TouchY;
-    bool bIsTouching = false;
-    CachedPlayerController->GetInputTouchState(ETouchIndex::Touch1, TouchX, TouchY, bIsTouching);
+    GestureRecognizer.ProcessSample(Sample, PendingGestureEvents);
+    DispatchGestureEvents();
+}
 
-    FVector2D CurrentScreenPosition(TouchX, TouchY);
+void UInteractionComponent::ApplyGestureConfig()
+{
+    FRLOGestureConfig& Config = GestureRecognizer.Config;
+    Config.TapSlop = TapMaxMovement;
+    Config.TapMaxDuration = TapMaxDuration;
+    Config.SwipeMinDistance = TapMaxMovement;
+    Config.SwipeMaxDuration = SwipeMaxDuration;
+    Config.FlingMinVelocity = FlingMinVelocity;
+    Config.PinchThreshold = PinchThreshold;
+    Config.RotateThresholdDegrees = TwoFingerRotateThreshold;
+
+    // 长按时间由按下时命中的对象决定，没有长按对象时不识别长按
+    Config.LongPressDuration = 0.0f;
+}
 
-    // 状态机处理触摸事件
-    if (bIsTouching)
+void UInteractionComponent::DispatchGestureEvents()
+{
+    // 处理过程中可能再次注入事件（如交互触发的逻辑），按索引遍历
+    for (int32 i = 0; i < PendingGestureEvents.Num(); i++)
     {
-        if (CurrentTouchState == ETouchState::None)
-        {
-            // 触摸开始
-            OnTouchBegan(CurrentScreenPosition);
-        }
-        else
-        {
-            // 触摸移动
-            OnTouchMoved(CurrentScreenPosition);
-            
-            // 更新触摸持续时间
-            TouchDuration += DeltaTime;
-        }
+        const FRLOGestureEvent Event = PendingGestureEvents[i];
+        HandleGesture(Event);
     }
-    else
+    PendingGestureEvents.Reset();
+}
+
+void UInteractionComponent::HandleGesture(const FRLOGestureEvent& Event)
+{
+    const EInteractionMode Mode = TouchStartInteractableComponent ? TouchStartInteractableComponent->InteractionMode : EInteractionMode::Tap;
+
+    switch (Event.Type)
     {
-        if (CurrentTouchState != ETouchState::None)
-        {
-            // 触摸结束
-            OnTouchEnded(CurrentScreenPosition);
-        }
+        case ERLOGestureType::Down:
+            OnTouchBegan(Event.Position);
+            break;
+
+        case ERLOGestureType::Tap:
+            // 点击模式：移动和时长已由识别器判定
+            if (TouchStartInteractableComponent && Mode == EInteractionMode::Tap)
+            {
+                ExecuteTapInteraction();
+            }
+            break;
+
+        case ERLOGestureType::LongPress:
+            // 长按模式：识别器在精确的到达时刻报告
+            if (TouchStartInteractableComponent && Mode == EInteractionMode::LongPress)
+            {
+                TouchStartInteractableComponent->CompleteLongPress(CachedPlayerController);
+            }
+            break;
+
+        case ERLOGestureType::PanBegan:
+            if (TouchStartInteractableComponent)
+            {
+                if (Mode == EInteractionMode::Rotate)
+                {
+                    // 开始旋转
+                    bIsRotating = true;
+                    TouchStartInteractableComponent->BeginRotation();
+                }
+                else if (Mode == EInteractionMode::LongPress)
+                {
+                    // 移动超出范围，取消长按
+                    TouchStartInteractableComponent->CancelLongPress();
+                }
+            }
+            break;
+
+        case ERLOGestureType::PanChanged:
+            if (bIsRotating && TouchStartInteractableComponent)
+            {
+                // 计算旋转增量（基于水平移动）
+                TouchStartInteractableComponent->UpdateRotation(Event.Delta.X * RotationSensitivity);
+            }
+            break;
+
+        case ERLOGestureType::PanEnded:
+            if (bIsRotating && TouchStartInteractableComponent)
+            {
+                TouchStartInteractableComponent->EndRotation();
+            }
+            bIsRotating = false;
+            break;
+
+        case ERLOGestureType::Swipe:
+            if (TouchStartInteractableComponent && Mode == EInteractionMode::Swipe)
+            {
+                ExecuteSwipeInteraction(Event.Delta);
+            }
+            break;
+
+        case ERLOGestureType::Fling:
+            OnFlingGesture.Broadcast(Event.Velocity, Event.Position);
+            break;
+
+        case ERLOGestureType::TwoFingerBegan:
+            CancelTouchInteraction();
+            OnTwoFingerGestureStateChanged.Broadcast(true);
+            break;
+
+        case ERLOGestureType::PinchChanged:
+            OnPinchGesture.Broadcast(Event.Scale, Event.ScaleDelta);
+            break;
+
+        case ERLOGestureType::RotateChanged:
+            OnTwoFingerRotateGesture.Broadcast(Event.RotationDegrees, Event.RotationDelta);
+            break;
+
+        case ERLOGestureType::TwoFingerEnded:
+            OnTwoFingerGestureStateChanged.Broadcast(false);
+            break;
+
+        case ERLOGestureType::Up:
+            OnTouchEnded();
+            break;
+    }
+
+    if (bShowGestureDebug && Event.Type != ERLOGestureType::PanChanged)
+    {
+        UE_LOG(LogRLOInteraction, Verbose, TEXT("InteractionComponent: Gesture %d at %s, Duration: %.2f, Pointers: %d"),
+            static_cast<int32>(Event.Type), *Event.Position.ToString(), Event.Duration, Event.PointerCount);
     }
 }
 
 void UInteractionComponent::OnTouchBegan(const FVector2D& TouchLocation)
 {
-    CurrentTouchState = ETouchState::Began;
-    TouchStartPosition = TouchLocation;
-    CurrentTouchPosition = TouchLocation;
-    LastTouchPosition = TouchLocation;
-    TouchStartTime = GetWorld()->GetTimeSeconds();
-    TouchDuration = 0.0f;
-    TouchTotalMovement = 0.0f;
     bIsRotating = false;
+    TouchStartFocusedActor = nullptr;
+    TouchStartInteractableComponent = nullptr;
 
-    // 执行射线检测，记录触摸开始时的聚焦对象
+    // 执行射线检测，记录触摸开始时的聚焦对象（触摸开始必须检测，只占用预算不受其限制）
+    ConsumeTraceBudget();
     FHitResult HitResult;
     if (TraceFromScreenPosition(TouchLocation, HitResult))
     {
         AActor* HitActor = HitResult.GetActor();
         if (HitActor)
         {
-            UInteractableComponent* InteractableComp = HitActor->FindComponentByClass<UInteractableComponent>();
+            UInteractableComponent* InteractableComp = FindInteractable(HitResult);
             if (InteractableComp && InteractableComp->CanInteract())
             {
                 TouchStartFocusedActor = HitActor;
@@ -172,148 +400,50 @@ void UInteractionComponent::OnTouchBegan(const FVector2D& TouchLocation)
                 // 更新聚焦状态
                 UpdateFocusedActor(HitActor);
                 
-                // 如果是长按模式，开始长按计时
+                // 如果是长按模式，开始长按（只由识别器计时，到达时报告LongPress，可交互对象不自行计时）
                 if (InteractableComp->InteractionMode == EInteractionMode::LongPress)
                 {
                     InteractableComp->BeginLongPress();
+                    GestureRecognizer.SetLongPressDuration(InteractableComp->LongPressDuration);
                 }
                 
                 if (bShowGestureDebug)
                 {
-                    UE_LOG(LogTemp, Log, TEXT("InteractionComponent: Touch began on %s"), *HitActor->GetName());
+                    UE_LOG(LogRLOInteraction, Verbose, TEXT("InteractionComponent: Touch began on %s"), *HitActor->GetName());
                 }
             }
         }
     }
 }
 
-void UInteractionComponent::OnTouchMoved(const FVector2D& TouchLocation)
+void UInteractionComponent::CancelTouchInteraction()
 {
-    CurrentTouchState = ETouchState::Moved;
-    
-    // 计算移动距离
-    FVector2D Movement = TouchLocation - LastTouchPosition;
-    float MovementDistance = Movement.Size();
-    TouchTotalMovement += MovementDistance;
-    
-    CurrentTouchPosition = TouchLocation;
-
     if (!TouchStartInteractableComponent)
     {
-        LastTouchPosition = TouchLocation;
         return;
     }
 
-    // 根据交互模式处理移动
-    switch (TouchStartInteractableComponent->InteractionMode)
+    // 如果正在旋转，结束旋转
+    if (bIsRotating)
     {
-        case EInteractionMode::Tap:
-            // 点击模式：如果移动距离超过阈值，取消点击
-            if (TouchTotalMovement > TapMaxMovement)
-            {
-                TouchStartInteractableComponent = nullptr;
-            }
-            break;
-
-        case EInteractionMode::Swipe:
-            // 滑动模式：不需要特殊处理，在触摸结束时识别
-            break;
-
-        case EInteractionMode::Rotate:
-            // 旋转模式：持续更新旋转
-            if (!bIsRotating && TouchTotalMovement > TapMaxMovement)
-            {
-                // 开始旋转
-                bIsRotating = true;
-                TouchStartInteractableComponent->BeginRotation();
-            }
-            
-            if (bIsRotating)
-            {
-                // 计算旋转增量（基于水平移动）
-                float DeltaRotation = Movement.X * RotationSensitivity;
-                TouchStartInteractableComponent->UpdateRotation(DeltaRotation);
-            }
-            break;
-
-        case EInteractionMode::LongPress:
-            // 长按模式：更新长按进度
-            if (TouchStartInteractableComponent->UpdateLongPress(GetWorld()->GetDeltaSeconds()))
-            {
-                // 长按完成，执行交互
-                TouchStartInteractableComponent->ExecuteInteraction(CachedPlayerController);
-                TouchStartInteractableComponent = nullptr;
-            }
-            break;
+        TouchStartInteractableComponent->EndRotation();
+        bIsRotating = false;
     }
 
-    LastTouchPosition = TouchLocation;
+    // 如果正在长按，取消长按
+    TouchStartInteractableComponent->CancelLongPress();
+
+    TouchStartInteractableComponent = nullptr;
 }
 
-void UInteractionComponent::OnTouchEnded(const FVector2D& TouchLocation)
+void UInteractionComponent::OnTouchEnded()
 {
-    if (bShowGestureDebug)
-    {
-        UE_LOG(LogTemp, Log, TEXT("InteractionComponent: Touch ended, Duration: %.2f, Movement: %.2f"), 
-            TouchDuration, TouchTotalMovement);
-    }
-
-    // 识别手势并执行相应交互
-    RecognizeGesture();
-
     // 重置状态
-    CurrentTouchState = ETouchState::None;
+    CancelTouchInteraction();
     TouchStartFocusedActor = nullptr;
-    
-    if (TouchStartInteractableComponent)
-    {
-        // 如果正在旋转，结束旋转
-        if (bIsRotating)
-        {
-            TouchStartInteractableComponent->EndRotation();
-        }
-        
-        // 如果正在长按，取消长按
-        TouchStartInteractableComponent->CancelLongPress();
-        
-        TouchStartInteractableComponent = nullptr;
-    }
-    
-    bIsRotating = false;
-}
 
-void UInteractionComponent::RecognizeGesture()
-{
-    if (!TouchStartInteractableComponent)
-    {
-        return;
-    }
-
-    EInteractionMode Mode = TouchStartInteractableComponent->InteractionMode;
-
-    switch (Mode)
-    {
-        case EInteractionMode::Tap:
-            // 检查是否是有效的点击
-            if (TouchTotalMovement <= TapMaxMovement && TouchDuration <= TapMaxDuration)
-            {
-                ExecuteTapInteraction();
-            }
-            break;
-
-        case EInteractionMode::Swipe:
-            // 检查是否是有效的滑动
-            ExecuteSwipeInteraction();
-            break;
-
-        case EInteractionMode::Rotate:
-            // 旋转在OnTouchMoved中持续处理，这里不需要额外操作
-            break;
-
-        case EInteractionMode::LongPress:
-            // 长按在OnTouchMoved中处理，这里不需要额外操作
-            break;
-    }
+    // 手指抬起后聚焦可能变化，下一帧重新检测
+    bTraceRequested = true;
 }
 
 void UInteractionComponent::ExecuteTapInteraction()
@@ -327,32 +457,31 @@ void UInteractionComponent::ExecuteTapInteraction()
     
     if (bShowGestureDebug)
     {
-        UE_LOG(LogTemp, Log, TEXT("InteractionComponent: Tap interaction executed"));
+        UE_LOG(LogRLOInteraction, Log, TEXT("InteractionComponent: Tap interaction executed"));
     }
 }
 
-void UInteractionComponent::ExecuteSwipeInteraction()
+void UInteractionComponent::ExecuteSwipeInteraction(const FVector2D& SwipeVector)
 {
     if (!TouchStartInteractableComponent)
     {
         return;
     }
 
-    // 计算滑动向量
-    FVector2D SwipeVector = CurrentTouchPosition - TouchStartPosition;
-    
     // 尝试处理滑动
     bool bSwipeHandled = TouchStartInteractableComponent->HandleSwipe(SwipeVector, CachedPlayerController);
     
     if (bShowGestureDebug)
     {
-        UE_LOG(LogTemp, Log, TEXT("InteractionComponent: Swipe interaction, Vector: %s, Handled: %s"),
+        UE_LOG(LogRLOInteraction, Log, TEXT("InteractionComponent: Swipe interaction, Vector: %s, Handled: %s"),
             *SwipeVector.ToString(), bSwipeHandled ? TEXT("Yes") : TEXT("No"));
     }
 }
 
 bool UInteractionComponent::TraceFromScreenPosition(const FVector2D& ScreenPosition, FHitResult& OutHitResult)
 {
+    RLO_SCOPE_CYCLE(Interaction, STAT_RLO_InteractionTrace);
+
     if (!CachedPlayerController)
     {
         return false;
@@ -360,18 +489,16 @@ bool UInteractionComponent::TraceFromScreenPosition(const FVector2D& ScreenPosit
 
     // 将屏幕坐标转换为世界射线
     FVector WorldLocation, WorldDirection;
-    bool bSuccess = CachedPlayerController->DeprojectScreenPositionToWorld(
-        ScreenPosition.X,
-        ScreenPosition.Y,
-        WorldLocation,
-        WorldDirection
-    );
+    bool bSuccess = DeprojectScreenPosition(ScreenPosition, WorldLocation, WorldDirection);
 
     if (!bSuccess)
     {
         return false;
     }
 
+    TotalTracesPerformed++;
+    INC_DWORD_STAT(STAT_RLO_InteractionTracesPerformed);
+
     // 计算射线终点
     FVector TraceEnd = WorldLocation + (WorldDirection * InteractionDistance);
 
@@ -402,6 +529,54 @@ bool UInteractionComponent::TraceFromScreenPosition(const FVector2D& ScreenPosit
     return bHit;
 }
 
+bool UInteractionComponent::DeprojectScreenPosition(const FVector2D& ScreenPosition, FVector& OutWorldLocation, FVector& OutWorldDirection) const
+{
+    if (CachedPlayerController->DeprojectScreenPositionToWorld(ScreenPosition.X, ScreenPosition.Y, OutWorldLocation, OutWorldDirection))
+    {
+        return true;
+    }
+
+    // 没有本地玩家视口（-nullrhi），按镜头POV做透视反投影
+    if (SyntheticViewportSize.X <= 0.0f || SyntheticViewportSize.Y <= 0.0f || !CachedPlayerController->PlayerCameraManager)
+    {
+        return false;
+    }
+
+    const FMinimalViewInfo& View = CachedPlayerController->PlayerCameraManager->GetCameraCachePOV();
+    const float TanHalfFOV = FMath::Tan(FMath::DegreesToRadians(View.FOV * 0.5f));
+    const float AspectRatio = SyntheticViewportSize.X / SyntheticViewportSize.Y;
+    const float NormalizedX = 2.0f * ScreenPosition.X / SyntheticViewportSize.X - 1.0f;
+    const float NormalizedY = 1.0f - 2.0f * ScreenPosition.Y / SyntheticViewportSize.Y;
+
+    const FRotationMatrix ViewRotation(View.Rotation);
+    OutWorldLocation = View.Location;
+    OutWorldDirection = (ViewRotation.GetUnitAxis(EAxis::X)
+        + ViewRotation.GetUnitAxis(EAxis::Y) * (NormalizedX * TanHalfFOV)
+        + ViewRotation.GetUnitAxis(EAxis::Z) * (NormalizedY * TanHalfFOV / AspectRatio)).GetSafeNormal();
+    return true;
+}
+
+UInteractableComponent* UInteractionComponent::FindInteractable(const FHitResult& HitResult) const
+{
+    if (InteractableRegistry)
+    {
+        return InteractableRegistry->FindForHit(HitResult);
+    }
+
+    AActor* HitActor = HitResult.GetActor();
+    return HitActor ? HitActor->FindComponentByClass<UInteractableComponent>() : nullptr;
+}
+
+UInteractableComponent* UInteractionComponent::FindInteractable(AActor* Actor) const
+{
+    if (InteractableRegistry)
+    {
+        return InteractableRegistry->FindForActor(Actor);
+    }
+
+    return Actor ? Actor->FindComponentByClass<UInteractableComponent>() : nullptr;
+}
+
 void UInteractionComponent::UpdateFocusedActor(AActor* NewFocusedActor)
 {
     if (CurrentFocusedActor == NewFocusedActor)
@@ -423,14 +598,14 @@ void UInteractionComponent::UpdateFocusedActor(AActor* NewFocusedActor)
     // 开始新对象的聚焦
     if (CurrentFocusedActor)
     {
-        CurrentInteractableComponent = CurrentFocusedActor->FindComponentByClass<UInteractableComponent>();
+        CurrentInteractableComponent = FindInteractable(CurrentFocusedActor);
         if (CurrentInteractableComponent)
         {
             CurrentInteractableComponent->BeginFocus();
             
             if (bShowGestureDebug)
             {
-                UE_LOG(LogTemp, Verbose, TEXT("InteractionComponent: Focused on %s"), *CurrentFocusedActor->GetName());
+                UE_LOG(LogRLOInteraction, Verbose, TEXT("InteractionComponent: Focused on %s"), *CurrentFocusedActor->GetName());
             }
         }
     }
@@ -443,12 +618,20 @@ void UInteractionComponent::BindInputActions()
         return;
     }
 
-    // 对于触控游戏，主要依赖触摸输入，不需要绑定额外的输入动作
-    // 触摸输入通过GetInputTouchState在Tick中自动处理
-    
-    // 如果需要支持鼠标点击（PC测试），可以在这里绑定
-    // TODO: 根据项目需求决定是否绑定鼠标输入
+    UInputComponent* Input = CachedPlayerController->InputComponent;
+    if (!Input)
+    {
+        return;
+    }
+
+    // 按事件接收所有手指的触摸（PC测试时开启"Use Mouse for Touch"即可用鼠标模拟）
+    // 不消耗输入，Pawn和UI仍可收到触摸事件
+    Input->BindTouch(IE_Pressed, this, &UInteractionComponent::HandleTouchPressed).bConsumeInput = false;
+    Input->BindTouch(IE_Repeat, this, &UInteractionComponent::HandleTouchMoved).bConsumeInput = false;
+    Input->BindTouch(IE_Released, this, &UInteractionComponent::HandleTouchReleased).bConsumeInput = false;
+
+    ApplyGestureConfig();
     
     bInputBound = true;
-    UE_LOG(LogTemp, Log, TEXT("InteractionComponent: Touch input system initialized"));
+    UE_LOG(LogRLOInteraction, Log, TEXT("InteractionComponent: Touch input system initialized"));
 }
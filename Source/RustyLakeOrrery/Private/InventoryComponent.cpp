@@ -1,8 +1,18 @@
 // InventoryComponent.cpp
 
 #include "InventoryComponent.h"
+#include "RustyLakeOrrery.h"
+#include "RLOPerf.h"
 #include "Kismet/GameplayStatics.h"
 #include "GameFramework/PlayerController.h"
+#include "TimerManager.h"
+#include "Engine/AssetManager.h"
+#include "Sound/SoundBase.h"
+#include "SaveSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Inventory AddItem"), STAT_RLO_InventoryAddItem, STATGROUP_RustyLakeOrrery);
+DECLARE_CYCLE_STAT(TEXT("Inventory RemoveItem"), STAT_RLO_InventoryRemoveItem, STATGROUP_RustyLakeOrrery);
+DECLARE_CYCLE_STAT(TEXT("Inventory Broadcast"), STAT_RLO_InventoryBroadcast, STATGROUP_RustyLakeOrrery);
 
 UInventoryComponent::UInventoryComponent()
 {
@@ -15,32 +25,112 @@ void UInventoryComponent::BeginPlay()
 	
 	// 初始化背包
 	InventorySlots.Empty();
+	ItemSlotIndices.Empty();
+	ItemIDSlotIndices.Empty();
+	PendingOldQuantities.Empty();
+	PendingFirstMovedSlot = INDEX_NONE;
+	bPendingRestored = false;
+	ItemSoundHandles.Empty();
 	
 	if (bShowDebugInfo)
 	{
-		UE_LOG(LogTemp, Log, TEXT("[InventoryComponent] Initialized with MaxCapacity=%d"), MaxCapacity);
+		UE_LOG(LogRLOInventory, Log, TEXT("[InventoryComponent] Initialized with MaxCapacity=%d"), MaxCapacity);
+	}
+	
+	// 切换关卡后PlayerController重新创建，从存档恢复物品
+	if (USaveSubsystem* SaveSubsystem = USaveSubsystem::Get(this))
+	{
+		SaveSubsystem->RegisterSaveable(this);
 	}
 }
 
+void UInventoryComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (USaveSubsystem* SaveSubsystem = USaveSubsystem::Get(this))
+	{
+		SaveSubsystem->UnregisterSaveable(this);
+	}
+	
+	Super::EndPlay(EndPlayReason);
+}
+
+void UInventoryComponent::SerializeSaveRecord(FArchive& Ar)
+{
+	int32 NumSlots = InventorySlots.Num();
+	Ar << NumSlots;
+	
+	if (Ar.IsSaving())
+	{
+		for (const FInventorySlot& Slot : InventorySlots)
+		{
+			FString ItemPath = FSoftObjectPath(Slot.ItemData).ToString();
+			int32 Quantity = Slot.Quantity;
+			Ar << ItemPath;
+			Ar << Quantity;
+		}
+		return;
+	}
+	
+	// 读取：替换当前内容，作为一次槽位全部移动的变化广播，并标记为恢复（不是拾取）
+	for (const FInventorySlot& Slot : InventorySlots)
+	{
+		RecordItemChange(Slot.ItemData);
+	}
+	RecordSlotsMoved(0);
+	bPendingRestored = true;
+	
+	InventorySlots.Reset();
+	ItemSlotIndices.Reset();
+	ItemIDSlotIndices.Reset();
+	ItemSoundHandles.Reset();
+	
+	for (int32 i = 0; i < NumSlots && !Ar.IsError(); ++i)
+	{
+		FString ItemPath;
+		int32 Quantity = 0;
+		Ar << ItemPath;
+		Ar << Quantity;
+		
+		// 物品数据资产很小，图标和音效仍按需异步加载
+		UItemDataAsset* ItemData = Cast<UItemDataAsset>(FSoftObjectPath(ItemPath).TryLoad());
+		if (!ItemData || Quantity <= 0 || ItemSlotIndices.Contains(ItemData))
+		{
+			UE_LOG(LogRLOInventory, Warning, TEXT("[InventoryComponent] Skipping saved item %s x%d"), *ItemPath, Quantity);
+			continue;
+		}
+		
+		RecordItemChange(ItemData);
+		ItemSlotIndices.Add(ItemData, InventorySlots.Num());
+		InventorySlots.Emplace(ItemData, Quantity);
+	}
+	
+	UpdateSlotIndices(0);
+	BroadcastInventoryUpdated();
+	
+	UE_LOG(LogRLOInventory, Log, TEXT("[InventoryComponent] Restored %d items from save"), InventorySlots.Num());
+}
+
 bool UInventoryComponent::AddItem(UItemDataAsset* ItemData, int32 Quantity)
 {
+	RLO_SCOPE_CYCLE(Inventory, STAT_RLO_InventoryAddItem);
+	
 	// 验证输入
 	if (!ItemData || Quantity <= 0)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[InventoryComponent] AddItem failed: Invalid ItemData or Quantity"));
+		UE_LOG(LogRLOInventory, Warning, TEXT("[InventoryComponent] AddItem failed: Invalid ItemData or Quantity"));
 		return false;
 	}
 	
 	if (!ItemData->IsValid())
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[InventoryComponent] AddItem failed: ItemData is not valid"));
+		UE_LOG(LogRLOInventory, Warning, TEXT("[InventoryComponent] AddItem failed: ItemData is not valid"));
 		return false;
 	}
 	
 	// 检查背包是否已满
 	if (IsFull() && !HasItem(ItemData))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[InventoryComponent] Inventory is full, cannot add %s"), *ItemData->ItemName.ToString());
+		UE_LOG(LogRLOInventory, Warning, TEXT("[InventoryComponent] Inventory is full, cannot add %s"), *ItemData->ItemName.ToString());
 		OnInventoryFull.Broadcast(ItemData);
 		return false;
 	}
@@ -53,6 +143,8 @@ bool UInventoryComponent::AddItem(UItemDataAsset* ItemData, int32 Quantity)
 		// 物品已存在，检查是否可堆叠
 		if (bAutoStack && ItemData->bStackable)
 		{
+			RecordItemChange(ItemData);
+			
 			FInventorySlot& Slot = InventorySlots[SlotIndex];
 			int32 NewQuantity = Slot.Quantity + Quantity;
 			
@@ -60,7 +152,7 @@ bool UInventoryComponent::AddItem(UItemDataAsset* ItemData, int32 Quantity)
 			if (NewQuantity > ItemData->MaxStackSize)
 			{
 				Slot.Quantity = ItemData->MaxStackSize;
-				UE_LOG(LogTemp, Warning, TEXT("[InventoryComponent] Item %s reached max stack size %d"), 
+				UE_LOG(LogRLOInventory, Warning, TEXT("[InventoryComponent] Item %s reached max stack size %d"), 
 					*ItemData->ItemName.ToString(), ItemData->MaxStackSize);
 			}
 			else
@@ -71,7 +163,7 @@ bool UInventoryComponent::AddItem(UItemDataAsset* ItemData, int32 Quantity)
 		else
 		{
 			// 不可堆叠，无法添加更多
-			UE_LOG(LogTemp, Warning, TEXT("[InventoryComponent] Item %s is not stackable"), *ItemData->ItemName.ToString());
+			UE_LOG(LogRLOInventory, Warning, TEXT("[InventoryComponent] Item %s is not stackable"), *ItemData->ItemName.ToString());
 			return false;
 		}
 	}
@@ -86,31 +178,37 @@ bool UInventoryComponent::AddItem(UItemDataAsset* ItemData, int32 Quantity)
 			NewSlot.Quantity = ItemData->MaxStackSize;
 		}
 		
+		RecordItemChange(ItemData);
 		InventorySlots.Add(NewSlot);
+		UpdateSlotIndices(InventorySlots.Num() - 1);
+		
+		// 拾取时预加载物品音效，物品移出背包时释放
+		ItemSoundHandles.Add(ItemData, ItemData->PreloadAssets(EItemAssetGroup::Sounds));
 	}
 	
 	// 播放拾取音效
 	if (bPlayPickupSound)
 	{
-		USoundBase* SoundToPlay = ItemData->PickupSound ? ItemData->PickupSound : DefaultPickupSound;
-		PlayItemSound(SoundToPlay);
+		PlayItemSound(ItemData->PickupSound.IsNull() ? TSoftObjectPtr<USoundBase>(DefaultPickupSound) : ItemData->PickupSound);
 	}
 	
 	// 广播事件
-	OnItemAdded.Broadcast(ItemData, Quantity);
+	BroadcastItemEvent(ItemData, Quantity, true);
 	BroadcastInventoryUpdated();
 	
-	UE_LOG(LogTemp, Log, TEXT("[InventoryComponent] Added %d x %s"), Quantity, *ItemData->ItemName.ToString());
+	UE_LOG(LogRLOInventory, Log, TEXT("[InventoryComponent] Added %d x %s"), Quantity, *ItemData->ItemName.ToString());
 	
 	return true;
 }
 
 bool UInventoryComponent::RemoveItem(UItemDataAsset* ItemData, int32 Quantity)
 {
+	RLO_SCOPE_CYCLE(Inventory, STAT_RLO_InventoryRemoveItem);
+	
 	// 验证输入
 	if (!ItemData || Quantity <= 0)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[InventoryComponent] RemoveItem failed: Invalid ItemData or Quantity"));
+		UE_LOG(LogRLOInventory, Warning, TEXT("[InventoryComponent] RemoveItem failed: Invalid ItemData or Quantity"));
 		return false;
 	}
 	
@@ -118,7 +216,7 @@ bool UInventoryComponent::RemoveItem(UItemDataAsset* ItemData, int32 Quantity)
 	int32 SlotIndex = FindSlotIndex(ItemData);
 	if (SlotIndex == INDEX_NONE)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[InventoryComponent] RemoveItem failed: Item %s not found"), *ItemData->ItemName.ToString());
+		UE_LOG(LogRLOInventory, Warning, TEXT("[InventoryComponent] RemoveItem failed: Item %s not found"), *ItemData->ItemName.ToString());
 		return false;
 	}
 	
@@ -127,25 +225,27 @@ bool UInventoryComponent::RemoveItem(UItemDataAsset* ItemData, int32 Quantity)
 	// 检查数量是否足够
 	if (Slot.Quantity < Quantity)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[InventoryComponent] RemoveItem failed: Not enough quantity (has %d, need %d)"), 
+		UE_LOG(LogRLOInventory, Warning, TEXT("[InventoryComponent] RemoveItem failed: Not enough quantity (has %d, need %d)"), 
 			Slot.Quantity, Quantity);
 		return false;
 	}
 	
 	// 减少数量
+	RecordItemChange(ItemData);
 	Slot.Quantity -= Quantity;
 	
 	// 如果数量为0，移除槽位
 	if (Slot.Quantity <= 0)
 	{
-		InventorySlots.RemoveAt(SlotIndex);
+		RemoveSlotAt(SlotIndex);
+		RecordSlotsMoved(SlotIndex);
 	}
 	
 	// 广播事件
-	OnItemRemoved.Broadcast(ItemData, Quantity);
+	BroadcastItemEvent(ItemData, Quantity, false);
 	BroadcastInventoryUpdated();
 	
-	UE_LOG(LogTemp, Log, TEXT("[InventoryComponent] Removed %d x %s"), Quantity, *ItemData->ItemName.ToString());
+	UE_LOG(LogRLOInventory, Log, TEXT("[InventoryComponent] Removed %d x %s"), Quantity, *ItemData->ItemName.ToString());
 	
 	return true;
 }
@@ -187,29 +287,28 @@ bool UInventoryComponent::UseItem(UItemDataAsset* ItemData)
 	// 验证输入
 	if (!ItemData)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[InventoryComponent] UseItem failed: Invalid ItemData"));
+		UE_LOG(LogRLOInventory, Warning, TEXT("[InventoryComponent] UseItem failed: Invalid ItemData"));
 		return false;
 	}
 	
 	// 检查物品是否可使用
 	if (!ItemData->bUsableFromInventory)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[InventoryComponent] Item %s is not usable from inventory"), *ItemData->ItemName.ToString());
+		UE_LOG(LogRLOInventory, Warning, TEXT("[InventoryComponent] Item %s is not usable from inventory"), *ItemData->ItemName.ToString());
 		return false;
 	}
 	
 	// 检查是否拥有该物品
 	if (!HasItem(ItemData))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[InventoryComponent] UseItem failed: Don't have %s"), *ItemData->ItemName.ToString());
+		UE_LOG(LogRLOInventory, Warning, TEXT("[InventoryComponent] UseItem failed: Don't have %s"), *ItemData->ItemName.ToString());
 		return false;
 	}
 	
 	// 播放使用音效
 	if (bPlayUseSound)
 	{
-		USoundBase* SoundToPlay = ItemData->UseSound ? ItemData->UseSound : DefaultUseSound;
-		PlayItemSound(SoundToPlay);
+		PlayItemSound(ItemData->UseSound.IsNull() ? TSoftObjectPtr<USoundBase>(DefaultUseSound) : ItemData->UseSound);
 	}
 	
 	// 广播使用事件
@@ -221,17 +320,31 @@ bool UInventoryComponent::UseItem(UItemDataAsset* ItemData)
 		RemoveItem(ItemData, 1);
 	}
 	
-	UE_LOG(LogTemp, Log, TEXT("[InventoryComponent] Used item: %s"), *ItemData->ItemName.ToString());
+	UE_LOG(LogRLOInventory, Log, TEXT("[InventoryComponent] Used item: %s"), *ItemData->ItemName.ToString());
 	
 	return true;
 }
 
 void UInventoryComponent::ClearInventory()
 {
+	if (InventorySlots.Num() == 0)
+	{
+		return;
+	}
+	
+	for (const FInventorySlot& Slot : InventorySlots)
+	{
+		RecordItemChange(Slot.ItemData);
+	}
+	RecordSlotsMoved(0);
+	
 	InventorySlots.Empty();
+	ItemSlotIndices.Empty();
+	ItemIDSlotIndices.Empty();
+	ItemSoundHandles.Empty();
 	BroadcastInventoryUpdated();
 	
-	UE_LOG(LogTemp, Log, TEXT("[InventoryComponent] Inventory cleared"));
+	UE_LOG(LogRLOInventory, Log, TEXT("[InventoryComponent] Inventory cleared"));
 }
 
 bool UInventoryComponent::IsFull() const
@@ -261,15 +374,8 @@ TArray<FInventorySlot> UInventoryComponent::GetItemsByType(EItemType ItemType) c
 
 UItemDataAsset* UInventoryComponent::FindItemByID(FName ItemID) const
 {
-	for (const FInventorySlot& Slot : InventorySlots)
-	{
-		if (Slot.ItemData && Slot.ItemData->ItemID == ItemID)
-		{
-			return Slot.ItemData;
-		}
-	}
-	
-	return nullptr;
+	const int32* SlotIndex = ItemIDSlotIndices.Find(ItemID);
+	return SlotIndex ? InventorySlots[*SlotIndex].ItemData : nullptr;
 }
 
 bool UInventoryComponent::SwapItems(int32 IndexA, int32 IndexB)
@@ -277,12 +383,14 @@ bool UInventoryComponent::SwapItems(int32 IndexA, int32 IndexB)
 	// 验证索引
 	if (!InventorySlots.IsValidIndex(IndexA) || !InventorySlots.IsValidIndex(IndexB))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[InventoryComponent] SwapItems failed: Invalid indices"));
+		UE_LOG(LogRLOInventory, Warning, TEXT("[InventoryComponent] SwapItems failed: Invalid indices"));
 		return false;
 	}
 	
 	// 交换
 	InventorySlots.Swap(IndexA, IndexB);
+	UpdateSlotIndices(FMath::Min(IndexA, IndexB));
+	RecordSlotsMoved(FMath::Min(IndexA, IndexB));
 	BroadcastInventoryUpdated();
 	
 	return true;
@@ -317,19 +425,150 @@ void UInventoryComponent::SortInventory(bool bSortByType)
 		});
 	}
 	
+	UpdateSlotIndices(0);
+	RecordSlotsMoved(0);
 	BroadcastInventoryUpdated();
 	
-	UE_LOG(LogTemp, Log, TEXT("[InventoryComponent] Inventory sorted by %s"), bSortByType ? TEXT("type") : TEXT("name"));
+	UE_LOG(LogRLOInventory, Log, TEXT("[InventoryComponent] Inventory sorted by %s"), bSortByType ? TEXT("type") : TEXT("name"));
+}
+
+bool UInventoryComponent::AddItems(const TArray<FInventorySlot>& Items, bool bAllOrNothing)
+{
+	FScopedInventoryTransaction Transaction(this);
+	bool bAllAdded = true;
+	
+	for (const FInventorySlot& Item : Items)
+	{
+		if (!AddItem(Item.ItemData, Item.Quantity))
+		{
+			bAllAdded = false;
+			
+			if (bAllOrNothing)
+			{
+				Transaction.Cancel();
+				break;
+			}
+		}
+	}
+	
+	return bAllAdded;
+}
+
+void UInventoryComponent::BeginTransaction()
+{
+	if (TransactionDepth++ > 0)
+	{
+		return;
+	}
+	
+	// 保存事务开始前的状态，用于回滚
+	bTransactionCancelled = false;
+	TransactionSlots = InventorySlots;
+	TransactionOldQuantities = PendingOldQuantities;
+	TransactionFirstMovedSlot = PendingFirstMovedSlot;
+	bTransactionRestored = bPendingRestored;
+	TransactionItemEvents.Reset();
+	TransactionSound.Reset();
+	TransactionSoundHandles = ItemSoundHandles;
+}
+
+void UInventoryComponent::EndTransaction(bool bCommit)
+{
+	if (TransactionDepth <= 0)
+	{
+		UE_LOG(LogRLOInventory, Warning, TEXT("[InventoryComponent] EndTransaction called without BeginTransaction"));
+		return;
+	}
+	
+	if (!bCommit)
+	{
+		bTransactionCancelled = true;
+	}
+	
+	if (--TransactionDepth > 0)
+	{
+		return;
+	}
+	
+	if (bTransactionCancelled)
+	{
+		// 回滚：恢复物品槽和变化记录，丢弃推迟的事件
+		InventorySlots = MoveTemp(TransactionSlots);
+		ItemSlotIndices.Reset();
+		ItemIDSlotIndices.Reset();
+		UpdateSlotIndices(0);
+		
+		PendingOldQuantities = MoveTemp(TransactionOldQuantities);
+		PendingFirstMovedSlot = TransactionFirstMovedSlot;
+		bPendingRestored = bTransactionRestored;
+		TransactionItemEvents.Reset();
+		TransactionSound.Reset();
+		
+		// 事务中移除的物品恢复原来的句柄，新加入的物品释放句柄
+		ItemSoundHandles = MoveTemp(TransactionSoundHandles);
+		TransactionSoundHandles.Reset();
+		
+		UE_LOG(LogRLOInventory, Log, TEXT("[InventoryComponent] Transaction rolled back"));
+		return;
+	}
+	
+	TransactionSlots.Reset();
+	TransactionOldQuantities.Reset();
+	TransactionSoundHandles.Reset();
+	
+	if (!TransactionSound.IsNull())
+	{
+		const TSoftObjectPtr<USoundBase> Sound = TransactionSound;
+		TransactionSound.Reset();
+		PlayItemSound(Sound);
+	}
+	
+	// 监听者可能再次修改背包，先取出事件列表
+	TArray<FPendingItemEvent> ItemEvents = MoveTemp(TransactionItemEvents);
+	for (const FPendingItemEvent& Event : ItemEvents)
+	{
+		BroadcastItemEvent(Event.ItemData, Event.Quantity, Event.bAdded);
+	}
+	
+	BroadcastInventoryUpdated();
+}
+
+void UInventoryComponent::FlushInventoryChanges()
+{
+	RLO_SCOPE_CYCLE(Inventory, STAT_RLO_InventoryBroadcast);
+	
+	bFlushScheduled = false;
+	
+	// 事务中的修改在提交后再广播
+	if (IsInTransaction())
+	{
+		return;
+	}
+	
+	const FInventoryDelta Delta = ConsumePendingChanges();
+	if (Delta.IsEmpty())
+	{
+		return;
+	}
+	
+	OnInventoryUpdated.Broadcast();
+	OnInventoryChanged.Broadcast(Delta);
+	USaveSubsystem::MarkDirty(this);
+	
+	if (bShowDebugInfo)
+	{
+		PrintInventoryToLog();
+	}
 }
 
 void UInventoryComponent::PrintInventoryToLog() const
 {
-	UE_LOG(LogTemp, Log, TEXT("========== Inventory Contents =========="));
-	UE_LOG(LogTemp, Log, TEXT("Capacity: %d/%d"), InventorySlots.Num(), MaxCapacity > 0 ? MaxCapacity : 999);
+	UE_LOG(LogRLOInventory, Log, TEXT("========== Inventory Contents =========="));
+	UE_LOG(LogRLOInventory, Log, TEXT("Capacity: %d/%d"), InventorySlots.Num(), MaxCapacity > 0 ? MaxCapacity : 999);
 	
 	if (InventorySlots.Num() == 0)
 	{
-		UE_LOG(LogTemp, Log, TEXT("(Empty)"));
+		UE_LOG(LogRLOInventory, Log, TEXT("(Empty)"));
 	}
 	else
 	{
@@ -338,7 +577,7 @@ void UInventoryComponent::PrintInventoryToLog() const
 			const FInventorySlot& Slot = InventorySlots[i];
 			if (Slot.ItemData)
 			{
-				UE_LOG(LogTemp, Log, TEXT("[%d] %s x%d (ID: %s, Type: %s)"), 
+				UE_LOG(LogRLOInventory, Log, TEXT("[%d] %s x%d (ID: %s, Type: %s)"), 
 					i,
 					*Slot.ItemData->ItemName.ToString(),
 					Slot.Quantity,
@@ -349,7 +588,7 @@ void UInventoryComponent::PrintInventoryToLog() const
 		}
 	}
 	
-	UE_LOG(LogTemp, Log, TEXT("========================================"));
+	UE_LOG(LogRLOInventory, Log, TEXT("========================================"));
 }
 
 int32 UInventoryComponent::FindSlotIndex(UItemDataAsset* ItemData) const
@@ -359,24 +598,183 @@ int32 UInventoryComponent::FindSlotIndex(UItemDataAsset* ItemData) const
 		return INDEX_NONE;
 	}
 	
+	const int32* SlotIndex = ItemSlotIndices.Find(ItemData);
+	return SlotIndex ? *SlotIndex : INDEX_NONE;
+}
+
+void UInventoryComponent::RecordItemChange(UItemDataAsset* ItemData)
+{
+	if (ItemData && !PendingOldQuantities.Contains(ItemData))
+	{
+		PendingOldQuantities.Add(ItemData, GetItemQuantity(ItemData));
+	}
+}
+
+void UInventoryComponent::RecordSlotsMoved(int32 FirstIndex)
+{
+	if (PendingFirstMovedSlot == INDEX_NONE || FirstIndex < PendingFirstMovedSlot)
+	{
+		PendingFirstMovedSlot = FirstIndex;
+	}
+}
+
+FInventoryDelta UInventoryComponent::ConsumePendingChanges()
+{
+	FInventoryDelta Delta;
+	Delta.FirstMovedSlot = PendingFirstMovedSlot;
+	Delta.bRestored = bPendingRestored;
+	
+	for (const TPair<TWeakObjectPtr<UItemDataAsset>, int32>& Pair : PendingOldQuantities)
+	{
+		UItemDataAsset* ItemData = Pair.Key.Get();
+		if (!ItemData)
+		{
+			continue;
+		}
+		
+		// 同一帧内先加后减等没有净变化的物品不报告
+		const int32 NewQuantity = GetItemQuantity(ItemData);
+		if (NewQuantity == Pair.Value)
+		{
+			continue;
+		}
+		
+		FInventoryItemChange& Change = Delta.ChangedItems.AddDefaulted_GetRef();
+		Change.ItemData = ItemData;
+		Change.OldQuantity = Pair.Value;
+		Change.NewQuantity = NewQuantity;
+		Change.SlotIndex = FindSlotIndex(ItemData);
+	}
+	
+	PendingOldQuantities.Reset();
+	PendingFirstMovedSlot = INDEX_NONE;
+	bPendingRestored = false;
+	
+	return Delta;
+}
+
+void UInventoryComponent::UpdateSlotIndices(int32 FirstIndex)
+{
+	FirstIndex = FMath::Max(FirstIndex, 0);
+	
+	// 先移除区间内物品ID的旧索引（指向区间之前的重复ID保持不变）
+	for (int32 i = FirstIndex; i < InventorySlots.Num(); ++i)
+	{
+		const UItemDataAsset* ItemData = InventorySlots[i].ItemData;
+		if (!ItemData)
+		{
+			continue;
+		}
+		
+		const int32* Existing = ItemIDSlotIndices.Find(ItemData->ItemID);
+		if (Existing && *Existing >= FirstIndex)
+		{
+			ItemIDSlotIndices.Remove(ItemData->ItemID);
+		}
+	}
+	
+	for (int32 i = FirstIndex; i < InventorySlots.Num(); ++i)
+	{
+		UItemDataAsset* ItemData = InventorySlots[i].ItemData;
+		if (!ItemData)
+		{
+			continue;
+		}
+		
+		ItemSlotIndices.Add(ItemData, i);
+		
+		if (!ItemData->ItemID.IsNone() && !ItemIDSlotIndices.Contains(ItemData->ItemID))
+		{
+			ItemIDSlotIndices.Add(ItemData->ItemID, i);
+		}
+	}
+}
+
+void UInventoryComponent::RemoveSlotAt(int32 SlotIndex)
+{
+	UItemDataAsset* ItemData = InventorySlots[SlotIndex].ItemData;
+	if (ItemData)
+	{
+		ItemSlotIndices.Remove(ItemData);
+		ItemSoundHandles.Remove(ItemData);
+		
+		const int32* Existing = ItemIDSlotIndices.Find(ItemData->ItemID);
+		if (Existing && *Existing == SlotIndex)
+		{
+			ItemIDSlotIndices.Remove(ItemData->ItemID);
+		}
+	}
+	
+	InventorySlots.RemoveAt(SlotIndex);
+	UpdateSlotIndices(SlotIndex);
+}
+
+bool UInventoryComponent::VerifySlotIndices() const
+{
+	bool bValid = true;
+	int32 NumItems = 0;
+	TSet<FName> SeenIDs;
+	
 	for (int32 i = 0; i < InventorySlots.Num(); ++i)
 	{
-		if (InventorySlots[i].ItemData == ItemData)
+		UItemDataAsset* ItemData = InventorySlots[i].ItemData;
+		if (!ItemData)
+		{
+			continue;
+		}
+		
+		NumItems++;
+		
+		const int32* SlotIndex = ItemSlotIndices.Find(ItemData);
+		if (!SlotIndex || *SlotIndex != i)
+		{
+			UE_LOG(LogRLOInventory, Error, TEXT("[InventoryComponent] Slot index mismatch for %s: slot %d, index %d"),
+				*ItemData->GetName(), i, SlotIndex ? *SlotIndex : INDEX_NONE);
+			bValid = false;
+		}
+		
+		// ItemID索引应指向该ID的第一个槽位
+		if (!ItemData->ItemID.IsNone() && !SeenIDs.Contains(ItemData->ItemID))
 		{
-			return i;
+			SeenIDs.Add(ItemData->ItemID);
+			
+			const int32* IDIndex = ItemIDSlotIndices.Find(ItemData->ItemID);
+			if (!IDIndex || *IDIndex != i)
+			{
+				UE_LOG(LogRLOInventory, Error, TEXT("[InventoryComponent] ItemID index mismatch for %s: slot %d, index %d"),
+					*ItemData->ItemID.ToString(), i, IDIndex ? *IDIndex : INDEX_NONE);
+				bValid = false;
+			}
 		}
 	}
 	
-	return INDEX_NONE;
+	if (ItemSlotIndices.Num() != NumItems || ItemIDSlotIndices.Num() != SeenIDs.Num())
+	{
+		UE_LOG(LogRLOInventory, Error, TEXT("[InventoryComponent] Stale slot indices: %d item entries for %d items, %d ID entries for %d IDs"),
+			ItemSlotIndices.Num(), NumItems, ItemIDSlotIndices.Num(), SeenIDs.Num());
+		bValid = false;
+	}
+	
+	return bValid;
 }
 
-void UInventoryComponent::PlayItemSound(USoundBase* Sound)
+void UInventoryComponent::PlayItemSound(const TSoftObjectPtr<USoundBase>& Sound)
 {
-	if (!Sound)
+	if (Sound.IsNull())
 	{
 		return;
 	}
 	
+	// 事务中只记录第一个音效，提交时播放
+	if (IsInTransaction())
+	{
+		if (TransactionSound.IsNull())
+		{
+			TransactionSound = Sound;
+		}
+		return;
+	}
+	
 	// 获取PlayerController
 	APlayerController* PC = Cast<APlayerController>(GetOwner());
 	if (!PC)
@@ -385,15 +783,59 @@ void UInventoryComponent::PlayItemSound(USoundBase* Sound)
 	}
 	
 	// 播放2D音效
-	UGameplayStatics::PlaySound2D(GetWorld(), Sound);
+	if (USoundBase* LoadedSound = Sound.Get())
+	{
+		UGameplayStatics::PlaySound2D(GetWorld(), LoadedSound);
+		return;
+	}
+	
+	// 尚未加载（如刚拾取），加载完成后播放
+	UAssetManager::GetStreamableManager().RequestAsyncLoad(Sound.ToSoftObjectPath(), FStreamableDelegate::CreateWeakLambda(this, [this, Sound]()
+	{
+		if (USoundBase* LoadedSound = Sound.Get())
+		{
+			UGameplayStatics::PlaySound2D(GetWorld(), LoadedSound);
+		}
+	}), FStreamableManager::AsyncLoadHighPriority);
+}
+
+void UInventoryComponent::BroadcastItemEvent(UItemDataAsset* ItemData, int32 Quantity, bool bAdded)
+{
+	if (IsInTransaction())
+	{
+		TransactionItemEvents.Add({ ItemData, Quantity, bAdded });
+		return;
+	}
+	
+	if (bAdded)
+	{
+		OnItemAdded.Broadcast(ItemData, Quantity);
+	}
+	else
+	{
+		OnItemRemoved.Broadcast(ItemData, Quantity);
+	}
 }
 
 void UInventoryComponent::BroadcastInventoryUpdated()
 {
-	OnInventoryUpdated.Broadcast();
+	checkSlow(VerifySlotIndices());
 	
-	if (bShowDebugInfo)
+	// 事务中的修改在提交时广播
+	if (IsInTransaction() || bFlushScheduled)
 	{
-		PrintInventoryToLog();
+		return;
+	}
+	
+	// 同一帧内的多次修改合并到下一帧广播一次
+	UWorld* World = GetWorld();
+	if (World && World->IsGameWorld())
+	{
+		bFlushScheduled = true;
+		World->GetTimerManager().SetTimerForNextTick(this, &UInventoryComponent::FlushInventoryChanges);
+	}
+	else
+	{
+		FlushInventoryChanges();
 	}
 }
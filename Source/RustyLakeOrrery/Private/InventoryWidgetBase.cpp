@@ -0,0 +1,275 @@
+// InventoryWidgetBase.cpp
+
+#include "InventoryWidgetBase.h"
+#include "RustyLakeOrrery.h"
+#include "RLOPerf.h"
+#include "ItemDataAsset.h"
+#include "Components/ListView.h"
+#include "Components/Image.h"
+#include "Components/TextBlock.h"
+#include "Engine/Texture2D.h"
+
+DECLARE_CYCLE_STAT(TEXT("UI InventoryView Rebuild"), STAT_RLO_UIInventoryViewRebuild, STATGROUP_RustyLakeOrrery);
+DECLARE_CYCLE_STAT(TEXT("UI InventoryView Delta"), STAT_RLO_UIInventoryViewDelta, STATGROUP_RustyLakeOrrery);
+
+// ========================================================================
+// UInventoryEntryWidget
+// ========================================================================
+
+void UInventoryEntryWidget::NativeOnListItemObjectSet(UObject* ListItemObject)
+{
+    ListItem = Cast<UInventoryListItem>(ListItemObject);
+    RefreshEntry();
+}
+
+void UInventoryEntryWidget::NativeOnEntryReleased()
+{
+    // 条目被回收,不再需要保持图标加载
+    ReleaseIconHandle();
+    IconItem = nullptr;
+    ListItem = nullptr;
+}
+
+void UInventoryEntryWidget::RefreshEntry()
+{
+    if (!ListItem || !ListItem->ItemData)
+    {
+        return;
+    }
+
+    if (NameText)
+    {
+        NameText->SetText(ListItem->ItemData->ItemName);
+    }
+
+    if (QuantityText)
+    {
+        if (ListItem->Quantity > 1)
+        {
+            QuantityText->SetText(FText::AsNumber(ListItem->Quantity));
+            QuantityText->SetVisibility(ESlateVisibility::HitTestInvisible);
+        }
+        else
+        {
+            QuantityText->SetVisibility(ESlateVisibility::Collapsed);
+        }
+    }
+
+    // 数量变化时物品不变,不需要重新设置图标
+    if (IconItem != ListItem->ItemData)
+    {
+        RequestIcon();
+    }
+
+    OnEntryRefreshed(ListItem);
+}
+
+void UInventoryEntryWidget::RequestIcon()
+{
+    ReleaseIconHandle();
+    IconItem = ListItem ? ListItem->ItemData : nullptr;
+
+    if (!IconImage || !IconItem)
+    {
+        return;
+    }
+
+    if (UTexture2D* Icon = IconItem->ItemIcon.Get())
+    {
+        IconImage->SetBrushFromTexture(Icon);
+        return;
+    }
+
+    IconImage->SetBrushFromTexture(PlaceholderIcon);
+
+    const UItemDataAsset* RequestedItem = IconItem;
+    IconHandle = IconItem->PreloadAssets(EItemAssetGroup::Icons, FStreamableDelegate::CreateWeakLambda(this, [this, RequestedItem]()
+    {
+        // 加载期间条目可能已被复用给其他物品
+        if (IconItem != RequestedItem || !IconImage)
+        {
+            return;
+        }
+
+        if (UTexture2D* Icon = IconItem->ItemIcon.Get())
+        {
+            IconImage->SetBrushFromTexture(Icon);
+        }
+    }), FStreamableManager::AsyncLoadHighPriority);
+}
+
+void UInventoryEntryWidget::ReleaseIconHandle()
+{
+    if (IconHandle.IsValid())
+    {
+        IconHandle->ReleaseHandle();
+        IconHandle.Reset();
+    }
+}
+
+// ========================================================================
+// UInventoryWidgetBase
+// ========================================================================
+
+void UInventoryWidgetBase::NativeDestruct()
+{
+    UnbindFromInventory();
+
+    Super::NativeDestruct();
+}
+
+void UInventoryWidgetBase::BindToInventory(UInventoryComponent* InInventory)
+{
+    if (Inventory.Get() != InInventory)
+    {
+        UnbindFromInventory();
+
+        // 换了背包,旧的数据对象不能复用
+        ItemsByData.Reset();
+        ListItems.Reset();
+    }
+
+    if (!InInventory)
+    {
+        return;
+    }
+
+    Inventory = InInventory;
+    InInventory->OnInventoryChanged.AddUniqueDynamic(this, &UInventoryWidgetBase::ApplyInventoryDelta);
+
+    RebuildFromInventory();
+}
+
+void UInventoryWidgetBase::UnbindFromInventory()
+{
+    if (UInventoryComponent* BoundInventory = Inventory.Get())
+    {
+        BoundInventory->OnInventoryChanged.RemoveDynamic(this, &UInventoryWidgetBase::ApplyInventoryDelta);
+    }
+    Inventory.Reset();
+}
+
+void UInventoryWidgetBase::RebuildFromInventory()
+{
+    RLO_SCOPE_CYCLE(UI, STAT_RLO_UIInventoryViewRebuild);
+
+    UInventoryComponent* BoundInventory = Inventory.Get();
+    if (!BoundInventory || !ItemListView)
+    {
+        return;
+    }
+
+    // 丢弃已不在背包中的物品,其余数据对象保留,Slate继续使用它们已有的条目
+    for (auto It = ItemsByData.CreateIterator(); It; ++It)
+    {
+        if (BoundInventory->GetItemQuantity(It.Key()) == 0)
+        {
+            It.RemoveCurrent();
+        }
+    }
+
+    for (const FInventorySlot& Slot : BoundInventory->GetAllItems())
+    {
+        UInventoryListItem** Existing = ItemsByData.Find(Slot.ItemData);
+        if (Existing && (*Existing)->Quantity != Slot.Quantity)
+        {
+            (*Existing)->Quantity = Slot.Quantity;
+            RefreshVisibleEntry(*Existing);
+        }
+    }
+
+    SyncListOrder(0);
+}
+
+void UInventoryWidgetBase::ApplyInventoryDelta(const FInventoryDelta& Delta)
+{
+    RLO_SCOPE_CYCLE(UI, STAT_RLO_UIInventoryViewDelta);
+
+    if (!Inventory.IsValid() || !ItemListView)
+    {
+        return;
+    }
+
+    int32 FirstChangedSlot = Delta.FirstMovedSlot == INDEX_NONE ? MAX_int32 : Delta.FirstMovedSlot;
+
+    for (const FInventoryItemChange& Change : Delta.ChangedItems)
+    {
+        if (!Change.ItemData)
+        {
+            continue;
+        }
+
+        UInventoryListItem* Item = ItemsByData.FindRef(Change.ItemData);
+        if (Change.NewQuantity <= 0)
+        {
+            // 移除:从它原来的槽位开始重排
+            if (Item)
+            {
+                FirstChangedSlot = FMath::Min(FirstChangedSlot, FMath::Max(Item->SlotIndex, 0));
+                ItemsByData.Remove(Change.ItemData);
+            }
+        }
+        else if (!Item)
+        {
+            // 新增:数据对象在重排时创建
+            FirstChangedSlot = FMath::Min(FirstChangedSlot, FMath::Max(Change.SlotIndex, 0));
+        }
+        else
+        {
+            // 只有数量变化:只刷新这个物品的条目
+            Item->Quantity = Change.NewQuantity;
+            RefreshVisibleEntry(Item);
+        }
+    }
+
+    if (FirstChangedSlot != MAX_int32)
+    {
+        SyncListOrder(FirstChangedSlot);
+    }
+}
+
+UInventoryListItem* UInventoryWidgetBase::FindOrAddListItem(UItemDataAsset* ItemData)
+{
+    UInventoryListItem*& Item = ItemsByData.FindOrAdd(ItemData);
+    if (!Item)
+    {
+        Item = NewObject<UInventoryListItem>(this);
+        Item->ItemData = ItemData;
+    }
+    return Item;
+}
+
+void UInventoryWidgetBase::SyncListOrder(int32 FirstSlot)
+{
+    const TArray<FInventorySlot>& Slots = Inventory->GetAllItems();
+    FirstSlot = FMath::Clamp(FirstSlot, 0, FMath::Min(Slots.Num(), ListItems.Num()));
+
+    ListItems.SetNum(Slots.Num());
+    for (int32 SlotIndex = FirstSlot; SlotIndex < Slots.Num(); SlotIndex++)
+    {
+        const FInventorySlot& Slot = Slots[SlotIndex];
+        UInventoryListItem* Item = FindOrAddListItem(Slot.ItemData);
+
+        if (Item->Quantity != Slot.Quantity)
+        {
+            Item->Quantity = Slot.Quantity;
+            RefreshVisibleEntry(Item);
+        }
+        Item->SlotIndex = SlotIndex;
+        ListItems[SlotIndex] = Item;
+    }
+
+    // 列表视图只为可见的物品生成条目,仍在列表中的物品保留原有条目
+    ItemListView->SetListItems(ListItems);
+
+    UE_LOG(LogRLOUI, Verbose, TEXT("InventoryView: Synced %d items from slot %d"), ListItems.Num(), FirstSlot);
+    OnInventoryViewUpdated(ListItems.Num());
+}
+
+void UInventoryWidgetBase::RefreshVisibleEntry(UInventoryListItem* Item)
+{
+    if (UInventoryEntryWidget* Entry = ItemListView->GetEntryWidgetFromItem<UInventoryEntryWidget>(Item))
+    {
+        Entry->RefreshEntry();
+    }
+}
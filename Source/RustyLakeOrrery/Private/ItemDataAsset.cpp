@@ -1,6 +1,51 @@
 // ItemDataAsset.cpp
 
 #include "ItemDataAsset.h"
+#include "RustyLakeOrrery.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Texture2D.h"
+#include "Engine/StaticMesh.h"
+#include "Sound/SoundBase.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+
+#if WITH_EDITOR
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/PackageName.h"
+#include "RLOCSVReader.h"
+#include "ChapterAssetSubsystem.h"
+#endif
+
+namespace
+{
+	/** 已测量的资源大小（资源加载后记录，卸载后用于估算节省的内存） */
+	TMap<FSoftObjectPath, int64>& GetMeasuredAssetSizes()
+	{
+		static TMap<FSoftObjectPath, int64> MeasuredSizes;
+		return MeasuredSizes;
+	}
+
+	/** 记录已加载资源的大小 */
+	void RecordAssetSizes(const TArray<FSoftObjectPath>& Paths)
+	{
+		for (const FSoftObjectPath& Path : Paths)
+		{
+			if (UObject* Asset = Path.ResolveObject())
+			{
+				GetMeasuredAssetSizes().Add(Path, Asset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal));
+			}
+		}
+	}
+
+	FAutoConsoleCommand ItemMemoryReportCommand(
+		TEXT("RLO.Items.MemoryReport"),
+		TEXT("Report per-chapter memory of item icons, meshes and sounds. Pass 'measure' to load unmeasured assets."),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			UItemDataAsset::ReportAssetMemory(Args.Contains(TEXT("measure")));
+		}));
+}
 
 FText UItemDataAsset::GetDisplayInfo() const
 {
@@ -44,6 +89,186 @@ FText UItemDataAsset::GetItemTypeName() const
 	}
 }
 
+void UItemDataAsset::GetAssetPaths(EItemAssetGroup Groups, TArray<FSoftObjectPath>& OutPaths) const
+{
+	auto AddPath = [&OutPaths](const FSoftObjectPath& Path)
+	{
+		if (Path.IsValid())
+		{
+			OutPaths.AddUnique(Path);
+		}
+	};
+	
+	if (EnumHasAnyFlags(Groups, EItemAssetGroup::Icons))
+	{
+		AddPath(ItemIcon.ToSoftObjectPath());
+		AddPath(ItemThumbnail.ToSoftObjectPath());
+	}
+	
+	if (EnumHasAnyFlags(Groups, EItemAssetGroup::Mesh))
+	{
+		AddPath(ItemMesh.ToSoftObjectPath());
+	}
+	
+	if (EnumHasAnyFlags(Groups, EItemAssetGroup::Sounds))
+	{
+		AddPath(PickupSound.ToSoftObjectPath());
+		AddPath(UseSound.ToSoftObjectPath());
+		AddPath(DropSound.ToSoftObjectPath());
+	}
+	
+	if (EnumHasAnyFlags(Groups, EItemAssetGroup::Document))
+	{
+		AddPath(DocumentImage.ToSoftObjectPath());
+	}
+}
+
+bool UItemDataAsset::AreAssetsLoaded(EItemAssetGroup Groups) const
+{
+	TArray<FSoftObjectPath> Paths;
+	GetAssetPaths(Groups, Paths);
+	
+	for (const FSoftObjectPath& Path : Paths)
+	{
+		if (!Path.ResolveObject())
+		{
+			return false;
+		}
+	}
+	
+	return true;
+}
+
+TSharedPtr<FStreamableHandle> UItemDataAsset::PreloadAssets(EItemAssetGroup Groups, FStreamableDelegate OnLoaded, TAsyncLoadPriority Priority) const
+{
+	UItemDataAsset* const Item = const_cast<UItemDataAsset*>(this);
+	return PreloadAssetsForItems(MakeArrayView(&Item, 1), Groups, MoveTemp(OnLoaded), Priority);
+}
+
+TSharedPtr<FStreamableHandle> UItemDataAsset::PreloadAssetsForItems(TArrayView<UItemDataAsset* const> Items, EItemAssetGroup Groups, FStreamableDelegate OnLoaded, TAsyncLoadPriority Priority)
+{
+	TArray<FSoftObjectPath> Paths;
+	for (const UItemDataAsset* Item : Items)
+	{
+		if (Item)
+		{
+			Item->GetAssetPaths(Groups, Paths);
+		}
+	}
+	
+	if (Paths.Num() == 0)
+	{
+		OnLoaded.ExecuteIfBound();
+		return nullptr;
+	}
+	
+	// 加载完成时记录资源大小，用于内存统计
+	FStreamableDelegate OnLoadedWithStats = FStreamableDelegate::CreateLambda([Paths, OnLoaded]()
+	{
+		RecordAssetSizes(Paths);
+		OnLoaded.ExecuteIfBound();
+	});
+	
+	return UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(Paths), MoveTemp(OnLoadedWithStats), Priority);
+}
+
+void UItemDataAsset::ReportAssetMemory(bool bMeasureUnloaded)
+{
+	struct FChapterStats
+	{
+		int32 NumItems = 0;
+		int32 NumAssets = 0;
+		int32 NumResident = 0;
+		int32 NumUnmeasured = 0;
+		int64 ResidentBytes = 0;
+		int64 DeferredBytes = 0;
+		TSet<FSoftObjectPath> CountedPaths;
+	};
+	
+	TMap<int32, FChapterStats> ChapterStats;
+	TMap<FSoftObjectPath, int64>& MeasuredSizes = GetMeasuredAssetSizes();
+	
+	// 先收集物品，测量时会加载新对象
+	TArray<const UItemDataAsset*> Items;
+	for (TObjectIterator<UItemDataAsset> It; It; ++It)
+	{
+		if (!It->HasAnyFlags(RF_ClassDefaultObject))
+		{
+			Items.Add(*It);
+		}
+	}
+	
+	for (const UItemDataAsset* Item : Items)
+	{
+		FChapterStats& Stats = ChapterStats.FindOrAdd(Item->Chapter);
+		Stats.NumItems++;
+		
+		TArray<FSoftObjectPath> Paths;
+		Item->GetAssetPaths(EItemAssetGroup::All, Paths);
+		
+		for (const FSoftObjectPath& Path : Paths)
+		{
+			// 同一章节中多个物品共用的资源只统计一次
+			bool bAlreadyCounted = false;
+			Stats.CountedPaths.Add(Path, &bAlreadyCounted);
+			if (bAlreadyCounted)
+			{
+				continue;
+			}
+			
+			Stats.NumAssets++;
+			
+			if (UObject* Asset = Path.ResolveObject())
+			{
+				const int64 Size = Asset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+				MeasuredSizes.Add(Path, Size);
+				Stats.NumResident++;
+				Stats.ResidentBytes += Size;
+			}
+			else if (bMeasureUnloaded)
+			{
+				// 测量后不保留引用，下次GC时卸载
+				UObject* LoadedAsset = Path.TryLoad();
+				if (LoadedAsset)
+				{
+					const int64 Size = LoadedAsset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+					MeasuredSizes.Add(Path, Size);
+					Stats.DeferredBytes += Size;
+				}
+				else
+				{
+					Stats.NumUnmeasured++;
+				}
+			}
+			else if (const int64* Size = MeasuredSizes.Find(Path))
+			{
+				Stats.DeferredBytes += *Size;
+			}
+			else
+			{
+				Stats.NumUnmeasured++;
+			}
+		}
+	}
+	
+	ChapterStats.KeySort(TLess<int32>());
+	
+	UE_LOG(LogRLOInventory, Log, TEXT("========== Item Asset Memory =========="));
+	for (const TPair<int32, FChapterStats>& Pair : ChapterStats)
+	{
+		const FChapterStats& Stats = Pair.Value;
+		UE_LOG(LogRLOInventory, Log, TEXT("Chapter %d: %d items, %d assets (%d resident), resident %.1f KB, saved %.1f KB, %d unmeasured"),
+			Pair.Key,
+			Stats.NumItems,
+			Stats.NumAssets,
+			Stats.NumResident,
+			Stats.ResidentBytes / 1024.0,
+			Stats.DeferredBytes / 1024.0,
+			Stats.NumUnmeasured);
+	}
+	UE_LOG(LogRLOInventory, Log, TEXT("======================================="));
+}
+
 #if WITH_EDITOR
 void UItemDataAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
@@ -98,4 +323,173 @@ void UItemDataAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChang
 		}
 	}
 }
+
+namespace
+{
+	/** 将CSV中的物品类型字符串解析为EItemType */
+	bool ParseItemType(const FString& TypeStr, EItemType& OutType)
+	{
+		if (TypeStr == TEXT("Key") || TypeStr == TEXT("Key Item") || TypeStr == TEXT("QuestItem"))
+		{
+			OutType = EItemType::Key;
+		}
+		else if (TypeStr == TEXT("Tool"))
+		{
+			OutType = EItemType::Tool;
+		}
+		else if (TypeStr == TEXT("Consumable") || TypeStr == TEXT("Seed") || TypeStr == TEXT("Currency"))
+		{
+			OutType = EItemType::Consumable;
+		}
+		else if (TypeStr == TEXT("Collectible") || TypeStr == TEXT("Symbol"))
+		{
+			OutType = EItemType::Collectible;
+		}
+		else if (TypeStr == TEXT("Document") || TypeStr == TEXT("Clue"))
+		{
+			OutType = EItemType::Document;
+		}
+		else
+		{
+			return false;
+		}
+		return true;
+	}
+}
+
+bool UItemDataAsset::ImportFromCSV(const FString& CSVFilePath, bool bUseChinese)
+{
+	FString CSVContent;
+	if (!FFileHelper::LoadFileToString(CSVContent, *CSVFilePath))
+	{
+		UE_LOG(LogRLOInventory, Error, TEXT("ItemDataAsset: Failed to load CSV file: %s"), *CSVFilePath);
+		return false;
+	}
+
+	FRLOCSVReader Reader(CSVContent);
+	if (!Reader.ReadHeader())
+	{
+		UE_LOG(LogRLOInventory, Error, TEXT("ItemDataAsset: CSV file is empty or invalid: %s"), *Reader.GetLastError());
+		return false;
+	}
+
+	// 按表头名称映射列(第二章使用 _CN/_EN 后缀,第一、三章使用 EN 后缀)
+	const int32 IDColumn = Reader.FindColumn({ TEXT("ItemID") });
+	const int32 NameColumn = bUseChinese
+		? Reader.FindColumn({ TEXT("ItemName_CN"), TEXT("ItemName") })
+		: Reader.FindColumn({ TEXT("ItemName_EN"), TEXT("ItemNameEN") });
+	const int32 DescriptionColumn = bUseChinese
+		? Reader.FindColumn({ TEXT("Description_CN"), TEXT("ItemDescription") })
+		: Reader.FindColumn({ TEXT("Description_EN"), TEXT("ItemDescriptionEN") });
+	const int32 TypeColumn = Reader.FindColumn({ TEXT("ItemType") });
+	const int32 IconColumn = Reader.FindColumn({ TEXT("ItemIconPath"), TEXT("IconPath") });
+	const int32 MeshColumn = Reader.FindColumn({ TEXT("ItemModelPath"), TEXT("ModelPath") });
+	const int32 UsableColumn = Reader.FindColumn({ TEXT("IsUsable") });
+	const int32 MeaningColumn = bUseChinese
+		? Reader.FindColumn({ TEXT("SymbolicMeaning_CN"), TEXT("SymbolicMeaning") })
+		: Reader.FindColumn({ TEXT("SymbolicMeaning_EN"), TEXT("SymbolicMeaning") });
+
+	if (IDColumn == INDEX_NONE)
+	{
+		UE_LOG(LogRLOInventory, Error, TEXT("ItemDataAsset: CSV header has no ItemID column: %s"), *CSVFilePath);
+		return false;
+	}
+
+	// ItemID为空时从资产名称生成(与PostEditChangeProperty一致)
+	if (ItemID.IsNone())
+	{
+		FString AssetName = GetName();
+		AssetName.RemoveFromStart(TEXT("DA_"));
+		ItemID = FName(*AssetName);
+	}
+	const FString ItemIDString = ItemID.ToString();
+
+	// 从文件名(DT_Items_Chapter2.csv)获取章节
+	const int32 FileChapter = UChapterAssetSubsystem::ParseChapterNumber(FPaths::GetBaseFilename(CSVFilePath));
+
+	while (true)
+	{
+		const FRLOCSVReader::EReadResult Result = Reader.ReadRow();
+		if (Result == FRLOCSVReader::EReadResult::EndOfFile)
+		{
+			break;
+		}
+
+		if (Result == FRLOCSVReader::EReadResult::Error)
+		{
+			UE_LOG(LogRLOInventory, Warning, TEXT("ItemDataAsset: %s, skipping"), *Reader.GetLastError());
+			continue;
+		}
+
+		if (Reader.GetField(IDColumn) != ItemIDString)
+		{
+			continue;
+		}
+
+		Modify();
+
+		if (FileChapter > 0)
+		{
+			Chapter = FileChapter;
+		}
+
+		ItemName = FText::FromString(Reader.GetField(NameColumn));
+		ItemDescription = FText::FromString(Reader.GetField(DescriptionColumn));
+
+		EItemType ParsedType;
+		if (ParseItemType(Reader.GetField(TypeColumn), ParsedType))
+		{
+			ItemType = ParsedType;
+		}
+		else if (Reader.HasField(TypeColumn))
+		{
+			UE_LOG(LogRLOInventory, Warning, TEXT("ItemDataAsset: Unknown item type '%s' for %s, keeping %s"),
+				*Reader.GetField(TypeColumn), *ItemIDString, *GetItemTypeName().ToString());
+		}
+
+		if (ItemType == EItemType::Document)
+		{
+			bUsableFromInventory = true;
+			bConsumeOnUse = false;
+		}
+		else if (Reader.HasField(UsableColumn))
+		{
+			bUsableFromInventory = Reader.GetField(UsableColumn).ToBool();
+		}
+
+		// 只记录路径，不加载资源（导入整章物品时不把所有图标和模型载入内存）
+		if (Reader.HasField(IconColumn))
+		{
+			const FString IconPath = FRLOCSVReader::ToObjectPath(Reader.GetField(IconColumn));
+			ItemIcon = FSoftObjectPath(IconPath);
+			if (!FPackageName::DoesPackageExist(ItemIcon.GetLongPackageName()))
+			{
+				UE_LOG(LogRLOInventory, Warning, TEXT("ItemDataAsset: Icon '%s' for %s not found"), *IconPath, *ItemIDString);
+			}
+		}
+
+		if (Reader.HasField(MeshColumn))
+		{
+			const FString MeshPath = FRLOCSVReader::ToObjectPath(Reader.GetField(MeshColumn));
+			ItemMesh = FSoftObjectPath(MeshPath);
+			if (!FPackageName::DoesPackageExist(ItemMesh.GetLongPackageName()))
+			{
+				UE_LOG(LogRLOInventory, Warning, TEXT("ItemDataAsset: Mesh '%s' for %s not found"), *MeshPath, *ItemIDString);
+			}
+		}
+
+		if (Reader.HasField(MeaningColumn))
+		{
+			DeveloperNotes = Reader.GetField(MeaningColumn);
+		}
+
+		MarkPackageDirty();
+
+		UE_LOG(LogRLOInventory, Log, TEXT("ItemDataAsset: Imported %s from %s (line %d)"), *ItemIDString, *CSVFilePath, Reader.GetRowLineNumber());
+		return true;
+	}
+
+	UE_LOG(LogRLOInventory, Warning, TEXT("ItemDataAsset: Item '%s' not found in %s"), *ItemIDString, *CSVFilePath);
+	return false;
+}
 #endif
@@ -0,0 +1,73 @@
+// ItemPopupWidgetBase.cpp
+
+#include "ItemPopupWidgetBase.h"
+#include "ItemDataAsset.h"
+#include "Components/Image.h"
+#include "Components/TextBlock.h"
+#include "Engine/Texture2D.h"
+
+void UItemPopupWidgetBase::SetItem(UItemDataAsset* InItem)
+{
+    Item = InItem;
+
+    if (NameText)
+    {
+        NameText->SetText(Item ? Item->ItemName : FText::GetEmpty());
+    }
+
+    RequestIcon();
+    OnItemSet(Item);
+}
+
+void UItemPopupWidgetBase::NativeDestruct()
+{
+    ReleaseIconHandle();
+
+    Super::NativeDestruct();
+}
+
+void UItemPopupWidgetBase::RequestIcon()
+{
+    ReleaseIconHandle();
+
+    if (!IconImage)
+    {
+        return;
+    }
+
+    if (UTexture2D* Icon = Item ? Item->ItemIcon.Get() : nullptr)
+    {
+        IconImage->SetBrushFromTexture(Icon);
+        return;
+    }
+
+    IconImage->SetBrushFromTexture(PlaceholderIcon);
+    if (!Item)
+    {
+        return;
+    }
+
+    const UItemDataAsset* RequestedItem = Item;
+    IconHandle = Item->PreloadAssets(EItemAssetGroup::Icons, FStreamableDelegate::CreateWeakLambda(this, [this, RequestedItem]()
+    {
+        // 加载期间弹窗可能已被复用给其他物品
+        if (Item != RequestedItem || !IconImage)
+        {
+            return;
+        }
+
+        if (UTexture2D* Icon = Item->ItemIcon.Get())
+        {
+            IconImage->SetBrushFromTexture(Icon);
+        }
+    }), FStreamableManager::AsyncLoadHighPriority);
+}
+
+void UItemPopupWidgetBase::ReleaseIconHandle()
+{
+    if (IconHandle.IsValid())
+    {
+        IconHandle->ReleaseHandle();
+        IconHandle.Reset();
+    }
+}
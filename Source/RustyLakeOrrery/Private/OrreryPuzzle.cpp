@@ -0,0 +1,444 @@
+// OrreryPuzzle.cpp
+
+#include "OrreryPuzzle.h"
+#include "RustyLakeOrrery.h"
+#include "RLOPerf.h"
+#include "SaveSubsystem.h"
+#include "Components/SceneComponent.h"
+#include "Async/Async.h"
+
+DECLARE_CYCLE_STAT(TEXT("Orrery Solve"), STAT_RLO_OrrerySolve, STATGROUP_RustyLakeOrrery);
+
+namespace
+{
+    int32 WrapStep(int64 Step, int32 NumSteps)
+    {
+        const int32 Result = static_cast<int32>(Step % NumSteps);
+        return Result < 0 ? Result + NumSteps : Result;
+    }
+}
+
+AOrreryPuzzle::AOrreryPuzzle()
+{
+    PrimaryActorTick.bCanEverTick = false;
+
+    // 创建根组件
+    USceneComponent* Root = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+    SetRootComponent(Root);
+}
+
+void AOrreryPuzzle::OnConstruction(const FTransform& Transform)
+{
+    Super::OnConstruction(Transform);
+
+    // 编辑器中预览初始状态
+    for (int32 RingIndex = 0; RingIndex < Rings.Num(); RingIndex++)
+    {
+        ApplyRingRotation(RingIndex, Rings[RingIndex].InitialStep);
+    }
+}
+
+void AOrreryPuzzle::PostInitializeComponents()
+{
+    Super::PostInitializeComponents();
+
+    // 在BeginPlay之前初始化,bAutoActivate时基类在BeginPlay中就会激活
+    TArray<int32> InitialSteps;
+    BuildDefinition(Definition, InitialSteps, TargetSteps);
+    CurrentSteps = InitialSteps;
+    MoveCount = 0;
+    bSolutionDirty = true;
+
+    FString Error;
+    bValidDefinition = FRLOOrrerySolver::Validate(Definition, &Error);
+    if (!bValidDefinition)
+    {
+        UE_LOG(LogRLOPuzzle, Error, TEXT("OrreryPuzzle: '%s' is invalid: %s"), *PuzzleName.ToString(), *Error);
+    }
+}
+
+bool AOrreryPuzzle::TurnRing(int32 RingIndex, bool bReverse)
+{
+    if (!IsActive() || !bValidDefinition)
+    {
+        UE_LOG(LogRLOPuzzle, Verbose, TEXT("OrreryPuzzle: Ignoring turn, puzzle '%s' is not active"), *PuzzleName.ToString());
+        return false;
+    }
+
+    if (!Rings.IsValidIndex(RingIndex) || !Rings[RingIndex].bCanTurn || (bReverse && !bAllowReverse))
+    {
+        UE_LOG(LogRLOPuzzle, Warning, TEXT("OrreryPuzzle: Ring %d cannot be turned%s"), RingIndex, bReverse ? TEXT(" in reverse") : TEXT(""));
+        return false;
+    }
+
+    const int32 Direction = bReverse ? -1 : 1;
+    const int32 NumRings = Rings.Num();
+    for (int32 Other = 0; Other < NumRings; Other++)
+    {
+        const int32 Coupling = Definition.Coupling[RingIndex * NumRings + Other];
+        if (Coupling != 0)
+        {
+            CurrentSteps[Other] = WrapStep(static_cast<int64>(CurrentSteps[Other]) + Direction * Coupling, Definition.NumSteps[Other]);
+            ApplyRingRotation(Other, CurrentSteps[Other]);
+        }
+    }
+    MoveCount++;
+    USaveSubsystem::MarkDirty(this);
+
+    // 沿最优解走了一步时剩余的解仍然最优,不需要重新求解
+    if (!bSolutionDirty && SolutionMoveCount > 0 && SolutionTurns[RingIndex] * Direction > 0)
+    {
+        SolutionTurns[RingIndex] -= Direction;
+        SolutionMoveCount--;
+        UpdateCachedProgress();
+    }
+    else
+    {
+        RequestSolution();
+    }
+
+    OnRingTurned.Broadcast(RingIndex, bReverse);
+
+    UE_LOG(LogRLOPuzzle, Verbose, TEXT("OrreryPuzzle: Turned ring %d%s (move %d)"), RingIndex, bReverse ? TEXT(" in reverse") : TEXT(""), MoveCount);
+
+    if (IsSolved())
+    {
+        CompletePuzzle();
+    }
+    return true;
+}
+
+bool AOrreryPuzzle::IsSolved() const
+{
+    return CurrentSteps.Num() > 0 && CurrentSteps == TargetSteps;
+}
+
+int32 AOrreryPuzzle::GetRemainingMoveCount() const
+{
+    return SolutionMoveCount;
+}
+
+bool AOrreryPuzzle::GetNextMove(int32& OutRingIndex, bool& bOutReverse) const
+{
+    // 上一次的解不一定适用于当前状态
+    for (int32 RingIndex = 0; !bSolutionDirty && RingIndex < SolutionTurns.Num(); RingIndex++)
+    {
+        if (SolutionTurns[RingIndex] != 0)
+        {
+            OutRingIndex = RingIndex;
+            bOutReverse = SolutionTurns[RingIndex] < 0;
+            return true;
+        }
+    }
+
+    OutRingIndex = INDEX_NONE;
+    bOutReverse = false;
+    return false;
+}
+
+float AOrreryPuzzle::GetProgress_Implementation() const
+{
+    if (IsCompleted())
+    {
+        return 1.0f;
+    }
+
+    // 求解进行中时返回上一次的进度
+    return IsActive() ? CachedProgress : 0.0f;
+}
+
+void AOrreryPuzzle::OnPuzzleActivatedEvent_Implementation()
+{
+    Super::OnPuzzleActivatedEvent_Implementation();
+
+    // 激活时开始求解,完成后记录 StartMoveCount
+    bStartMoveCountPending = true;
+    RequestSolution();
+}
+
+void AOrreryPuzzle::OnPuzzleResetEvent_Implementation()
+{
+    Super::OnPuzzleResetEvent_Implementation();
+
+    // 所有环回到初始步
+    if (bValidDefinition)
+    {
+        for (int32 RingIndex = 0; RingIndex < Rings.Num(); RingIndex++)
+        {
+            CurrentSteps[RingIndex] = WrapStep(Rings[RingIndex].InitialStep, Definition.NumSteps[RingIndex]);
+            ApplyRingRotation(RingIndex, CurrentSteps[RingIndex]);
+        }
+    }
+    MoveCount = 0;
+    bSolutionDirty = true;
+    bStartMoveCountPending = false;
+    CachedProgress = 0.0f;
+
+    UE_LOG(LogRLOPuzzle, Log, TEXT("OrreryPuzzle: Reset"));
+}
+
+bool AOrreryPuzzle::HasNextHint() const
+{
+    int32 RingIndex;
+    bool bReverse;
+    return IsActive() && GetNextMove(RingIndex, bReverse);
+}
+
+FText AOrreryPuzzle::GetNextHintText() const
+{
+    int32 RingIndex;
+    bool bReverse;
+    GetNextMove(RingIndex, bReverse);
+
+    const FText RingName = Rings[RingIndex].DisplayName.IsEmpty()
+        ? FText::AsNumber(RingIndex + 1)
+        : Rings[RingIndex].DisplayName;
+
+    FFormatNamedArguments Arguments;
+    Arguments.Add(TEXT("Ring"), RingName);
+    Arguments.Add(TEXT("Direction"), bReverse ? ReverseText : ForwardText);
+    Arguments.Add(TEXT("Remaining"), SolutionMoveCount);
+    return FText::Format(MoveHintFormat, Arguments);
+}
+
+void AOrreryPuzzle::BuildDefinition(FRLOOrreryDefinition& OutDefinition, TArray<int32>& OutInitialSteps, TArray<int32>& OutTargetSteps) const
+{
+    const int32 NumRings = Rings.Num();
+    OutDefinition.NumSteps.Reset(NumRings);
+    OutDefinition.Turnable.Reset(NumRings);
+    OutDefinition.Coupling.Init(0, NumRings * NumRings);
+    OutDefinition.bAllowReverse = bAllowReverse;
+    OutInitialSteps.Reset(NumRings);
+    OutTargetSteps.Reset(NumRings);
+
+    for (int32 RingIndex = 0; RingIndex < NumRings; RingIndex++)
+    {
+        const FOrreryRing& Ring = Rings[RingIndex];
+        const int32 NumSteps = FMath::Max(Ring.NumSteps, 1);
+        OutDefinition.NumSteps.Add(Ring.NumSteps);
+        OutDefinition.Turnable.Add(Ring.bCanTurn);
+        OutInitialSteps.Add(WrapStep(Ring.InitialStep, NumSteps));
+        OutTargetSteps.Add(WrapStep(Ring.TargetStep, NumSteps));
+
+        if (Ring.Coupling.Num() == 0)
+        {
+            OutDefinition.Coupling[RingIndex * NumRings + RingIndex] = 1;
+        }
+        for (int32 Other = 0; Other < NumRings && Other < Ring.Coupling.Num(); Other++)
+        {
+            OutDefinition.Coupling[RingIndex * NumRings + Other] = Ring.Coupling[Other];
+        }
+    }
+}
+
+void AOrreryPuzzle::SerializePuzzleSaveState(FArchive& Ar)
+{
+    TArray<int32> SavedSteps = CurrentSteps;
+    Ar << SavedSteps;
+    Ar << MoveCount;
+    Ar << StartMoveCount;
+
+    if (!Ar.IsLoading())
+    {
+        return;
+    }
+
+    // 关卡中修改了环的配置后,旧存档的步数不再适用
+    if (!bValidDefinition || SavedSteps.Num() != Rings.Num())
+    {
+        UE_LOG(LogRLOPuzzle, Warning, TEXT("OrreryPuzzle: Saved state of '%s' has %d rings, expected %d; keeping the initial state"),
+               *PuzzleName.ToString(), SavedSteps.Num(), Rings.Num());
+        MoveCount = 0;
+        return;
+    }
+
+    for (int32 RingIndex = 0; RingIndex < Rings.Num(); RingIndex++)
+    {
+        CurrentSteps[RingIndex] = WrapStep(SavedSteps[RingIndex], Definition.NumSteps[RingIndex]);
+        ApplyRingRotation(RingIndex, CurrentSteps[RingIndex]);
+    }
+
+    // StartMoveCount 已从存档恢复
+    bStartMoveCountPending = false;
+    RequestSolution();
+}
+
+void AOrreryPuzzle::ApplyRingRotation(int32 RingIndex, int32 Step)
+{
+    const FOrreryRing& Ring = Rings[RingIndex];
+    if (!Ring.RingComponent || Ring.NumSteps <= 0)
+    {
+        return;
+    }
+
+    FRotator Rotation = Ring.RingComponent->GetRelativeRotation();
+    Rotation.Yaw = 360.0f * WrapStep(Step, Ring.NumSteps) / Ring.NumSteps;
+    Ring.RingComponent->SetRelativeRotation(Rotation);
+}
+
+void AOrreryPuzzle::RequestSolution()
+{
+    bSolutionDirty = true;
+
+    // 正在求解时等它完成,取回结果时发现状态已变化会按新状态重新求解
+    if (!bValidDefinition || PendingSolution.IsValid())
+    {
+        return;
+    }
+
+    // 8环×24步离目标很远时需要几十毫秒,在线程池中求解;任务只持有数据的副本
+    TWeakObjectPtr<AOrreryPuzzle> WeakThis(this);
+    PendingSolution = Async(EAsyncExecution::ThreadPool, [SolveDefinition = Definition, FromSteps = CurrentSteps, ToSteps = TargetSteps]()
+    {
+        SCOPE_CYCLE_COUNTER(STAT_RLO_OrrerySolve);
+
+        FOrrerySolution Solution;
+        Solution.Steps = FromSteps;
+        Solution.Result = FRLOOrrerySolver::Solve(SolveDefinition, FromSteps, ToSteps, Solution.Turns, Solution.NumMoves);
+        return Solution;
+    }, [WeakThis]()
+    {
+        AsyncTask(ENamedThreads::GameThread, [WeakThis]()
+        {
+            if (AOrreryPuzzle* Puzzle = WeakThis.Get())
+            {
+                Puzzle->ApplySolution();
+            }
+        });
+    });
+}
+
+void AOrreryPuzzle::ApplySolution()
+{
+    if (!PendingSolution.IsValid() || !PendingSolution.IsReady())
+    {
+        return;
+    }
+
+    const FOrrerySolution Solution = PendingSolution.Get();
+    PendingSolution = TFuture<FOrrerySolution>();
+
+    const bool bSolved = Solution.Result == ERLOOrrerySolveResult::Solved;
+    if (!bSolved)
+    {
+        UE_LOG(LogRLOPuzzle, Warning, TEXT("OrreryPuzzle: Cannot solve '%s' from the current state: %s"),
+               *PuzzleName.ToString(), FRLOOrrerySolver::GetResultName(Solution.Result));
+    }
+
+    // 激活时的状态,求解期间玩家转动了环也适用
+    if (bStartMoveCountPending)
+    {
+        bStartMoveCountPending = false;
+        StartMoveCount = bSolved ? Solution.NumMoves : 0;
+        UE_LOG(LogRLOPuzzle, Log, TEXT("OrreryPuzzle: Activated, %d moves from the solution"), StartMoveCount);
+    }
+
+    if (Solution.Steps != CurrentSteps)
+    {
+        RequestSolution();
+        return;
+    }
+
+    SolutionTurns = bSolved ? Solution.Turns : TArray<int32>();
+    SolutionMoveCount = bSolved ? Solution.NumMoves : INDEX_NONE;
+    bSolutionDirty = false;
+    UpdateCachedProgress();
+}
+
+void AOrreryPuzzle::WaitForSolution()
+{
+    while (PendingSolution.IsValid())
+    {
+        PendingSolution.Wait();
+        ApplySolution();
+    }
+}
+
+void AOrreryPuzzle::UpdateCachedProgress()
+{
+    if (SolutionMoveCount < 0)
+    {
+        CachedProgress = 0.0f;
+        return;
+    }
+
+    // 走偏时剩余步数可能超过激活时的步数
+    const int32 Total = FMath::Max(StartMoveCount, SolutionMoveCount);
+    CachedProgress = Total > 0 ? 1.0f - static_cast<float>(SolutionMoveCount) / Total : 1.0f;
+}
+
+#if WITH_EDITOR
+ERLOOrrerySolveResult AOrreryPuzzle::UpdateMinimalMoveCount(FString& OutError)
+{
+    FRLOOrreryDefinition EditorDefinition;
+    TArray<int32> InitialSteps;
+    TArray<int32> EditorTargetSteps;
+    BuildDefinition(EditorDefinition, InitialSteps, EditorTargetSteps);
+
+    if (!FRLOOrrerySolver::Validate(EditorDefinition, &OutError))
+    {
+        MinimalMoveCount = INDEX_NONE;
+        return ERLOOrrerySolveResult::InvalidDefinition;
+    }
+
+    TArray<int32> Turns;
+    int32 NumMoves = 0;
+    const ERLOOrrerySolveResult Result = FRLOOrrerySolver::Solve(EditorDefinition, InitialSteps, EditorTargetSteps, Turns, NumMoves);
+    MinimalMoveCount = Result == ERLOOrrerySolveResult::Solved ? NumMoves : INDEX_NONE;
+    if (Result != ERLOOrrerySolveResult::Solved)
+    {
+        OutError = Result == ERLOOrrerySolveResult::Unsolvable
+            ? TEXT("the target cannot be reached from the initial steps")
+            : TEXT("the state space is too large for the solver");
+    }
+    return Result;
+}
+
+void AOrreryPuzzle::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+
+    // 每次修改都重新求解,在细节面板中显示最少操作数
+    FString Error;
+    if (UpdateMinimalMoveCount(Error) != ERLOOrrerySolveResult::Solved)
+    {
+        UE_LOG(LogRLOPuzzle, Warning, TEXT("OrreryPuzzle: '%s' %s"), *GetName(), *Error);
+    }
+}
+
+void AOrreryPuzzle::PreSave(const ITargetPlatform* TargetPlatform)
+{
+    Super::PreSave(TargetPlatform);
+
+    // 烘焙时(TargetPlatform不为空)不可解的谜题让烘焙失败
+    FString Error;
+    if (UpdateMinimalMoveCount(Error) != ERLOOrrerySolveResult::Solved)
+    {
+        if (TargetPlatform)
+        {
+            UE_LOG(LogRLOPuzzle, Error, TEXT("OrreryPuzzle: '%s' in %s cannot be cooked: %s"), *GetName(), *GetPathName(), *Error);
+        }
+        else
+        {
+            UE_LOG(LogRLOPuzzle, Warning, TEXT("OrreryPuzzle: '%s' %s"), *GetName(), *Error);
+        }
+    }
+    else
+    {
+        UE_LOG(LogRLOPuzzle, Log, TEXT("OrreryPuzzle: '%s' is solvable in %d moves"), *GetName(), MinimalMoveCount);
+    }
+}
+
+EDataValidationResult AOrreryPuzzle::IsDataValid(TArray<FText>& ValidationErrors)
+{
+    EDataValidationResult Result = Super::IsDataValid(ValidationErrors);
+
+    FString Error;
+    if (UpdateMinimalMoveCount(Error) != ERLOOrrerySolveResult::Solved)
+    {
+        ValidationErrors.Add(FText::FromString(FString::Printf(TEXT("%s: %s"), *GetName(), *Error)));
+        Result = EDataValidationResult::Invalid;
+    }
+    return Result;
+}
+#endif
@@ -1,8 +1,11 @@
 // PuzzleBase.cpp
 
 #include "PuzzleBase.h"
+#include "RustyLakeOrrery.h"
 #include "ItemDataAsset.h"
+#include "PuzzleComponent.h"
 #include "InventoryComponent.h"
+#include "SaveSubsystem.h"
 #include "Kismet/GameplayStatics.h"
 
 APuzzleBase::APuzzleBase()
@@ -21,42 +24,85 @@ void APuzzleBase::BeginPlay()
     CurrentState = EPuzzleState::Inactive;
     CurrentHintIndex = 0;
 
-    if (bAutoActivate)
+    // 有存档时恢复状态,已激活或完成的谜题不再自动激活
+    if (USaveSubsystem* SaveSubsystem = USaveSubsystem::Get(this))
+    {
+        SaveSubsystem->RegisterSaveable(this);
+    }
+
+    if (bAutoActivate && CurrentState == EPuzzleState::Inactive)
     {
         ActivatePuzzle();
     }
 
-    UE_LOG(LogTemp, Log, TEXT("PuzzleBase: '%s' initialized"), *PuzzleName.ToString());
+    UE_LOG(LogRLOPuzzle, Log, TEXT("PuzzleBase: '%s' initialized"), *PuzzleName.ToString());
+}
+
+void APuzzleBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (USaveSubsystem* SaveSubsystem = USaveSubsystem::Get(this))
+    {
+        SaveSubsystem->UnregisterSaveable(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void APuzzleBase::SerializeSaveRecord(FArchive& Ar)
+{
+    uint8 State = static_cast<uint8>(CurrentState);
+    Ar << State;
+    Ar << CurrentHintIndex;
+
+    if (Ar.IsLoading())
+    {
+        CurrentState = State <= static_cast<uint8>(EPuzzleState::Failed) ? static_cast<EPuzzleState>(State) : EPuzzleState::Inactive;
+        CurrentHintIndex = FMath::Max(CurrentHintIndex, 0);
+
+        // 动态生成的提示无法重建,只恢复配置中的提示文本
+        CurrentHintText = HintTexts.IsValidIndex(CurrentHintIndex - 1) ? HintTexts[CurrentHintIndex - 1] : FText::GetEmpty();
+    }
+
+    SerializePuzzleSaveState(Ar);
+
+    if (Ar.IsLoading() && !Ar.IsError())
+    {
+        UE_LOG(LogRLOPuzzle, Log, TEXT("PuzzleBase: Puzzle '%s' restored as %s"),
+               *PuzzleName.ToString(), *StaticEnum<EPuzzleState>()->GetNameStringByValue(static_cast<int64>(CurrentState)));
+        OnPuzzleStateRestored();
+    }
 }
 
 void APuzzleBase::ActivatePuzzle()
 {
     if (CurrentState != EPuzzleState::Inactive)
     {
-        UE_LOG(LogTemp, Warning, TEXT("PuzzleBase: Puzzle '%s' is already activated"), *PuzzleName.ToString());
+        UE_LOG(LogRLOPuzzle, Warning, TEXT("PuzzleBase: Puzzle '%s' is already activated"), *PuzzleName.ToString());
         return;
     }
 
     CurrentState = EPuzzleState::Active;
     StartTime = GetWorld()->GetTimeSeconds();
+    USaveSubsystem::MarkDirty(this);
 
     // 触发激活事件
     OnPuzzleActivated.Broadcast(this);
     OnPuzzleActivatedEvent_Implementation();
 
-    UE_LOG(LogTemp, Log, TEXT("PuzzleBase: Puzzle '%s' activated"), *PuzzleName.ToString());
+    UE_LOG(LogRLOPuzzle, Log, TEXT("PuzzleBase: Puzzle '%s' activated"), *PuzzleName.ToString());
 }
 
 void APuzzleBase::CompletePuzzle()
 {
     if (CurrentState == EPuzzleState::Completed)
     {
-        UE_LOG(LogTemp, Warning, TEXT("PuzzleBase: Puzzle '%s' is already completed"), *PuzzleName.ToString());
+        UE_LOG(LogRLOPuzzle, Warning, TEXT("PuzzleBase: Puzzle '%s' is already completed"), *PuzzleName.ToString());
         return;
     }
 
     CurrentState = EPuzzleState::Completed;
     CompletionTime = GetWorld()->GetTimeSeconds() - StartTime;
+    USaveSubsystem::MarkDirty(this);
 
     // 给予奖励
     GiveReward();
@@ -65,7 +111,7 @@ void APuzzleBase::CompletePuzzle()
     OnPuzzleCompleted.Broadcast(this);
     OnPuzzleSolved_Implementation();
 
-    UE_LOG(LogTemp, Log, TEXT("PuzzleBase: Puzzle '%s' completed in %.2f seconds"), 
+    UE_LOG(LogRLOPuzzle, Log, TEXT("PuzzleBase: Puzzle '%s' completed in %.2f seconds"), 
            *PuzzleName.ToString(), CompletionTime);
 }
 
@@ -73,95 +119,134 @@ void APuzzleBase::FailPuzzle()
 {
     if (CurrentState == EPuzzleState::Completed)
     {
-        UE_LOG(LogTemp, Warning, TEXT("PuzzleBase: Cannot fail completed puzzle '%s'"), *PuzzleName.ToString());
+        UE_LOG(LogRLOPuzzle, Warning, TEXT("PuzzleBase: Cannot fail completed puzzle '%s'"), *PuzzleName.ToString());
         return;
     }
 
     CurrentState = EPuzzleState::Failed;
+    USaveSubsystem::MarkDirty(this);
 
     // 触发失败事件
     OnPuzzleFailed.Broadcast(this);
     OnPuzzleFailedEvent_Implementation();
 
-    UE_LOG(LogTemp, Log, TEXT("PuzzleBase: Puzzle '%s' failed"), *PuzzleName.ToString());
+    UE_LOG(LogRLOPuzzle, Log, TEXT("PuzzleBase: Puzzle '%s' failed"), *PuzzleName.ToString());
 }
 
 void APuzzleBase::ResetPuzzle()
 {
     if (!bAllowReset)
     {
-        UE_LOG(LogTemp, Warning, TEXT("PuzzleBase: Puzzle '%s' does not allow reset"), *PuzzleName.ToString());
+        UE_LOG(LogRLOPuzzle, Warning, TEXT("PuzzleBase: Puzzle '%s' does not allow reset"), *PuzzleName.ToString());
         return;
     }
 
     CurrentState = EPuzzleState::Inactive;
     CurrentHintIndex = 0;
+    CurrentHintText = FText::GetEmpty();
     StartTime = 0.0f;
     CompletionTime = 0.0f;
+    USaveSubsystem::MarkDirty(this);
 
     // 触发重置事件
     OnPuzzleReset.Broadcast(this);
     OnPuzzleResetEvent_Implementation();
 
-    UE_LOG(LogTemp, Log, TEXT("PuzzleBase: Puzzle '%s' reset"), *PuzzleName.ToString());
+    UE_LOG(LogRLOPuzzle, Log, TEXT("PuzzleBase: Puzzle '%s' reset"), *PuzzleName.ToString());
 }
 
 FText APuzzleBase::ShowNextHint()
 {
-    if (!bHasHints || HintTexts.Num() == 0)
+    if (!bHasHints)
     {
-        UE_LOG(LogTemp, Warning, TEXT("PuzzleBase: Puzzle '%s' has no hints"), *PuzzleName.ToString());
+        UE_LOG(LogRLOPuzzle, Warning, TEXT("PuzzleBase: Puzzle '%s' has no hints"), *PuzzleName.ToString());
         return FText::GetEmpty();
     }
 
-    if (CurrentHintIndex >= HintTexts.Num())
+    if (!HasNextHint())
     {
-        UE_LOG(LogTemp, Warning, TEXT("PuzzleBase: No more hints for puzzle '%s'"), *PuzzleName.ToString());
+        UE_LOG(LogRLOPuzzle, Warning, TEXT("PuzzleBase: No more hints for puzzle '%s'"), *PuzzleName.ToString());
         return FText::GetEmpty();
     }
 
-    FText HintText = HintTexts[CurrentHintIndex];
+    FText HintText = GetNextHintText();
     CurrentHintIndex++;
+    CurrentHintText = HintText;
+    USaveSubsystem::MarkDirty(this);
 
     // 触发提示事件
     OnHintShown.Broadcast(this, HintText);
 
-    UE_LOG(LogTemp, Log, TEXT("PuzzleBase: Showing hint %d/%d for puzzle '%s'"), 
-           CurrentHintIndex, HintTexts.Num(), *PuzzleName.ToString());
+    UE_LOG(LogRLOPuzzle, Log, TEXT("PuzzleBase: Showing hint %d for puzzle '%s': %s"), 
+           CurrentHintIndex, *PuzzleName.ToString(), *HintText.ToString());
 
     return HintText;
 }
 
 FText APuzzleBase::GetCurrentHint() const
 {
-    if (!bHasHints || HintTexts.Num() == 0 || CurrentHintIndex == 0)
+    return bHasHints ? CurrentHintText : FText::GetEmpty();
+}
+
+bool APuzzleBase::HasMoreHints() const
+{
+    return bHasHints && HasNextHint();
+}
+
+bool APuzzleBase::HasNextHint() const
+{
+    return CurrentHintIndex < HintTexts.Num();
+}
+
+FText APuzzleBase::GetNextHintText() const
+{
+    return HintTexts[CurrentHintIndex];
+}
+
+void APuzzleBase::RegisterPuzzleComponent(const UPuzzleComponent* Component)
+{
+    if (Component && Component->bIsRequired)
     {
-        return FText::GetEmpty();
+        RequiredComponentCount++;
+        if (Component->bIsCompleted)
+        {
+            CompletedComponentCount++;
+        }
     }
+}
 
-    int32 Index = FMath::Clamp(CurrentHintIndex - 1, 0, HintTexts.Num() - 1);
-    return HintTexts[Index];
+void APuzzleBase::UnregisterPuzzleComponent(const UPuzzleComponent* Component)
+{
+    if (Component && Component->bIsRequired)
+    {
+        RequiredComponentCount--;
+        if (Component->bIsCompleted)
+        {
+            CompletedComponentCount--;
+        }
+        check(RequiredComponentCount >= 0 && CompletedComponentCount >= 0);
+    }
 }
 
-bool APuzzleBase::HasMoreHints() const
+void APuzzleBase::NotifyPuzzleComponentChanged(const UPuzzleComponent* Component)
 {
-    return bHasHints && CurrentHintIndex < HintTexts.Num();
+    if (Component && Component->bIsRequired)
+    {
+        CompletedComponentCount += Component->bIsCompleted ? 1 : -1;
+        check(CompletedComponentCount >= 0 && CompletedComponentCount <= RequiredComponentCount);
+    }
 }
 
 float APuzzleBase::GetProgress_Implementation() const
 {
-    // 默认实现:根据状态返回进度
+    // 默认实现:已完成的必需组件比例
     switch (CurrentState)
     {
-        case EPuzzleState::Inactive:
-            return 0.0f;
-        case EPuzzleState::Active:
-        case EPuzzleState::Solving:
-            return 0.5f;
         case EPuzzleState::Completed:
             return 1.0f;
-        case EPuzzleState::Failed:
-            return 0.0f;
+        case EPuzzleState::Active:
+        case EPuzzleState::Solving:
+            return RequiredComponentCount > 0 ? static_cast<float>(CompletedComponentCount) / RequiredComponentCount : 0.0f;
         default:
             return 0.0f;
     }
@@ -170,25 +255,25 @@ float APuzzleBase::GetProgress_Implementation() const
 void APuzzleBase::OnPuzzleActivatedEvent_Implementation()
 {
     // 默认实现为空,子类可以重写
-    UE_LOG(LogTemp, Log, TEXT("PuzzleBase: OnPuzzleActivatedEvent called for '%s'"), *PuzzleName.ToString());
+    UE_LOG(LogRLOPuzzle, Log, TEXT("PuzzleBase: OnPuzzleActivatedEvent called for '%s'"), *PuzzleName.ToString());
 }
 
 void APuzzleBase::OnPuzzleSolved_Implementation()
 {
     // 默认实现为空,子类可以重写
-    UE_LOG(LogTemp, Log, TEXT("PuzzleBase: OnPuzzleSolved called for '%s'"), *PuzzleName.ToString());
+    UE_LOG(LogRLOPuzzle, Log, TEXT("PuzzleBase: OnPuzzleSolved called for '%s'"), *PuzzleName.ToString());
 }
 
 void APuzzleBase::OnPuzzleFailedEvent_Implementation()
 {
     // 默认实现为空,子类可以重写
-    UE_LOG(LogTemp, Log, TEXT("PuzzleBase: OnPuzzleFailedEvent called for '%s'"), *PuzzleName.ToString());
+    UE_LOG(LogRLOPuzzle, Log, TEXT("PuzzleBase: OnPuzzleFailedEvent called for '%s'"), *PuzzleName.ToString());
 }
 
 void APuzzleBase::OnPuzzleResetEvent_Implementation()
 {
     // 默认实现为空,子类可以重写
-    UE_LOG(LogTemp, Log, TEXT("PuzzleBase: OnPuzzleResetEvent called for '%s'"), *PuzzleName.ToString());
+    UE_LOG(LogRLOPuzzle, Log, TEXT("PuzzleBase: OnPuzzleResetEvent called for '%s'"), *PuzzleName.ToString());
 }
 
 void APuzzleBase::GiveReward()
@@ -202,26 +287,26 @@ void APuzzleBase::GiveReward()
     APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(this, 0);
     if (!PlayerPawn)
     {
-        UE_LOG(LogTemp, Error, TEXT("PuzzleBase: Failed to get player pawn"));
+        UE_LOG(LogRLOPuzzle, Error, TEXT("PuzzleBase: Failed to get player pawn"));
         return;
     }
 
     UInventoryComponent* Inventory = PlayerPawn->FindComponentByClass<UInventoryComponent>();
     if (!Inventory)
     {
-        UE_LOG(LogTemp, Error, TEXT("PuzzleBase: Player has no InventoryComponent"));
+        UE_LOG(LogRLOPuzzle, Error, TEXT("PuzzleBase: Player has no InventoryComponent"));
         return;
     }
 
     // 添加奖励物品
     if (Inventory->AddItem(RewardItem))
     {
-        UE_LOG(LogTemp, Log, TEXT("PuzzleBase: Gave reward item '%s' to player"), 
+        UE_LOG(LogRLOPuzzle, Log, TEXT("PuzzleBase: Gave reward item '%s' to player"), 
                *RewardItem->ItemName.ToString());
     }
     else
     {
-        UE_LOG(LogTemp, Warning, TEXT("PuzzleBase: Failed to give reward item '%s'"), 
+        UE_LOG(LogRLOPuzzle, Warning, TEXT("PuzzleBase: Failed to give reward item '%s'"), 
                *RewardItem->ItemName.ToString());
     }
 }
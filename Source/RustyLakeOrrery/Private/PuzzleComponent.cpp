@@ -1,6 +1,7 @@
 // PuzzleComponent.cpp
 
 #include "PuzzleComponent.h"
+#include "RustyLakeOrrery.h"
 
 UPuzzleComponent::UPuzzleComponent()
 {
@@ -20,37 +21,56 @@ void UPuzzleComponent::BeginPlay()
         ComponentID = FName(*GetName());
     }
 
-    UE_LOG(LogTemp, Log, TEXT("PuzzleComponent: '%s' initialized"), *ComponentID.ToString());
+    SyncPuzzleRegistration();
+
+    UE_LOG(LogRLOPuzzle, Log, TEXT("PuzzleComponent: '%s' initialized"), *ComponentID.ToString());
+}
+
+void UPuzzleComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (IsValid(RegisteredPuzzle))
+    {
+        RegisteredPuzzle->UnregisterPuzzleComponent(this);
+    }
+    RegisteredPuzzle = nullptr;
+
+    Super::EndPlay(EndPlayReason);
 }
 
 void UPuzzleComponent::ActivateComponent()
 {
     if (bIsCompleted)
     {
-        UE_LOG(LogTemp, Warning, TEXT("PuzzleComponent: '%s' is already completed"), *ComponentID.ToString());
+        UE_LOG(LogRLOPuzzle, Warning, TEXT("PuzzleComponent: '%s' is already completed"), *ComponentID.ToString());
         return;
     }
 
     // 触发激活事件
     OnPuzzleComponentActivated.Broadcast(this);
 
-    UE_LOG(LogTemp, Log, TEXT("PuzzleComponent: '%s' activated"), *ComponentID.ToString());
+    UE_LOG(LogRLOPuzzle, Log, TEXT("PuzzleComponent: '%s' activated"), *ComponentID.ToString());
 }
 
 void UPuzzleComponent::CompleteComponent()
 {
     if (bIsCompleted)
     {
-        UE_LOG(LogTemp, Warning, TEXT("PuzzleComponent: '%s' is already completed"), *ComponentID.ToString());
+        UE_LOG(LogRLOPuzzle, Warning, TEXT("PuzzleComponent: '%s' is already completed"), *ComponentID.ToString());
         return;
     }
 
+    // 先以旧状态登记(PuzzleActor可能在蓝图中直接赋值),再修改状态并通知,计数才不会重复
+    SyncPuzzleRegistration();
     bIsCompleted = true;
+    if (RegisteredPuzzle)
+    {
+        RegisteredPuzzle->NotifyPuzzleComponentChanged(this);
+    }
 
     // 触发完成事件
     OnComponentCompleted.Broadcast(this);
 
-    UE_LOG(LogTemp, Log, TEXT("PuzzleComponent: '%s' completed"), *ComponentID.ToString());
+    UE_LOG(LogRLOPuzzle, Log, TEXT("PuzzleComponent: '%s' completed"), *ComponentID.ToString());
 
     // 检查整个谜题是否完成
     CheckPuzzleCompletion();
@@ -58,61 +78,71 @@ void UPuzzleComponent::CompleteComponent()
 
 void UPuzzleComponent::ResetComponent()
 {
-    bIsCompleted = false;
+    if (bIsCompleted)
+    {
+        SyncPuzzleRegistration();
+        bIsCompleted = false;
+        if (RegisteredPuzzle)
+        {
+            RegisteredPuzzle->NotifyPuzzleComponentChanged(this);
+        }
+    }
 
     // 触发重置事件
     OnComponentReset.Broadcast(this);
 
-    UE_LOG(LogTemp, Log, TEXT("PuzzleComponent: '%s' reset"), *ComponentID.ToString());
+    UE_LOG(LogRLOPuzzle, Log, TEXT("PuzzleComponent: '%s' reset"), *ComponentID.ToString());
 }
 
-void UPuzzleComponent::CheckPuzzleCompletion()
+void UPuzzleComponent::SetRequired(bool bRequired)
 {
-    if (!PuzzleActor)
+    if (bIsRequired == bRequired)
     {
-        UE_LOG(LogTemp, Warning, TEXT("PuzzleComponent: No PuzzleActor set for '%s'"), *ComponentID.ToString());
         return;
     }
 
-    // 如果谜题已经完成,不需要再检查
-    if (PuzzleActor->IsCompleted())
+    // 以旧状态注销、新状态重新登记,保持计数一致
+    SyncPuzzleRegistration();
+    if (RegisteredPuzzle)
     {
-        return;
+        RegisteredPuzzle->UnregisterPuzzleComponent(this);
+    }
+    bIsRequired = bRequired;
+    if (RegisteredPuzzle)
+    {
+        RegisteredPuzzle->RegisterPuzzleComponent(this);
+    }
+
+    // 移除最后一个未完成的必需组件也可能完成谜题
+    if (RegisteredPuzzle && !bIsRequired)
+    {
+        CheckPuzzleCompletion();
     }
+}
 
-    // 获取所有PuzzleComponent
-    AActor* Owner = PuzzleActor;
-    TArray<UPuzzleComponent*> AllComponents;
-    Owner->GetComponents<UPuzzleComponent>(AllComponents);
+void UPuzzleComponent::CheckPuzzleCompletion()
+{
+    SyncPuzzleRegistration();
 
-    // 检查所有必需组件是否都完成
-    bool bAllCompleted = true;
-    int32 CompletedCount = 0;
-    int32 RequiredCount = 0;
+    if (!PuzzleActor)
+    {
+        UE_LOG(LogRLOPuzzle, Warning, TEXT("PuzzleComponent: No PuzzleActor set for '%s'"), *ComponentID.ToString());
+        return;
+    }
 
-    for (UPuzzleComponent* Component : AllComponents)
+    // 如果谜题已经完成,不需要再检查
+    if (PuzzleActor->IsCompleted())
     {
-        if (Component && Component->bIsRequired)
-        {
-            RequiredCount++;
-            if (Component->bIsCompleted)
-            {
-                CompletedCount++;
-            }
-            else
-            {
-                bAllCompleted = false;
-            }
-        }
+        return;
     }
 
-    UE_LOG(LogTemp, Log, TEXT("PuzzleComponent: Puzzle completion check - %d/%d required components completed"), 
-           CompletedCount, RequiredCount);
+    UE_LOG(LogRLOPuzzle, Verbose, TEXT("PuzzleComponent: Puzzle completion check - %d/%d required components completed"), 
+           PuzzleActor->GetCompletedComponentCount(), PuzzleActor->GetRequiredComponentCount());
 
     // 如果所有必需组件都完成,完成谜题
-    if (bAllCompleted && RequiredCount > 0)
+    if (PuzzleActor->AreRequiredComponentsCompleted())
     {
-        UE_LOG(LogTemp, Log, TEXT("PuzzleComponent: All required components completed, completing puzzle"));
+        UE_LOG(LogRLOPuzzle, Log, TEXT("PuzzleComponent: All required components completed, completing puzzle"));
         PuzzleActor->CompletePuzzle();
     }
 }
@@ -120,7 +150,28 @@ void UPuzzleComponent::CheckPuzzleCompletion()
 void UPuzzleComponent::SetPuzzleActor(APuzzleBase* NewPuzzleActor)
 {
     PuzzleActor = NewPuzzleActor;
-    UE_LOG(LogTemp, Log, TEXT("PuzzleComponent: '%s' linked to puzzle '%s'"), 
+    SyncPuzzleRegistration();
+    UE_LOG(LogRLOPuzzle, Log, TEXT("PuzzleComponent: '%s' linked to puzzle '%s'"), 
            *ComponentID.ToString(), 
            PuzzleActor ? *PuzzleActor->PuzzleName.ToString() : TEXT("None"));
 }
+
+void UPuzzleComponent::SyncPuzzleRegistration()
+{
+    // 只有开始游戏后才计数,编辑器中的组件不登记
+    APuzzleBase* Target = HasBegunPlay() ? PuzzleActor : nullptr;
+    if (Target == RegisteredPuzzle)
+    {
+        return;
+    }
+
+    if (IsValid(RegisteredPuzzle))
+    {
+        RegisteredPuzzle->UnregisterPuzzleComponent(this);
+    }
+    RegisteredPuzzle = Target;
+    if (RegisteredPuzzle)
+    {
+        RegisteredPuzzle->RegisterPuzzleComponent(this);
+    }
+}
@@ -0,0 +1,411 @@
+// RLOBenchmarkCommandlet.cpp
+
+#include "RLOBenchmarkCommandlet.h"
+#include "RustyLakeOrrery.h"
+#include "RLOPerf.h"
+#include "InteractionComponent.h"
+#include "InteractableComponent.h"
+#include "RotationPuzzle.h"
+#include "DialogueComponent.h"
+#include "DialogueDataAsset.h"
+#include "Components/BoxComponent.h"
+#include "Components/InputComponent.h"
+#include "Dom/JsonObject.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/MemoryBase.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace
+{
+    constexpr int32 NumSubsystems = static_cast<int32>(ERLOPerfSubsystem::Count);
+
+    /** 可交互对象所在平面到镜头的距离 */
+    constexpr float TargetDistance = 1000.0f;
+
+    /** 一个手势占用的帧数 */
+    constexpr int32 GestureFrames = 12;
+
+    /**
+     * @brief 统计分配次数的GMalloc代理
+     *
+     * 只计数不改变分配行为；游戏线程上的分配按当前 RLO_SCOPE_CYCLE 子系统归类。
+     */
+    class FRLOCountingMalloc final : public FMalloc
+    {
+    public:
+        explicit FRLOCountingMalloc(FMalloc* InInner)
+            : Inner(InInner)
+        {
+        }
+
+        void SetEnabled(bool bInEnabled) { bEnabled = bInEnabled; }
+
+        int64 GetTotalAllocations() const { return TotalAllocations; }
+
+        int64 GetSubsystemAllocations(int32 Index) const { return SubsystemAllocations[Index]; }
+
+        virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+        {
+            CountAllocation();
+            return Inner->Malloc(Count, Alignment);
+        }
+
+        virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+        {
+            if (Count > 0)
+            {
+                CountAllocation();
+            }
+            return Inner->Realloc(Original, Count, Alignment);
+        }
+
+        virtual void Free(void* Original) override { Inner->Free(Original); }
+        virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+        virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+        virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+        virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+        virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+        virtual void InitializeStatsMetadata() override { Inner->InitializeStatsMetadata(); }
+        virtual void UpdateStats() override { Inner->UpdateStats(); }
+        virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+        virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+        virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+        virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+        virtual const TCHAR* GetDescriptiveName() override { return TEXT("RLOCountingMalloc"); }
+
+    private:
+        void CountAllocation()
+        {
+            if (!bEnabled)
+            {
+                return;
+            }
+
+            FPlatformAtomics::InterlockedIncrement(&TotalAllocations);
+
+            if (IsInGameThread())
+            {
+                const int32 Index = static_cast<int32>(FRLOPerf::GetActiveSubsystem());
+                if (Index < NumSubsystems)
+                {
+                    SubsystemAllocations[Index]++;
+                }
+            }
+        }
+
+        FMalloc* Inner;
+        volatile bool bEnabled = false;
+        volatile int64 TotalAllocations = 0;
+        int64 SubsystemAllocations[NumSubsystems] = {};
+    };
+
+    /** 本模块的日志分类（基准测试期间降级） */
+    FLogCategoryBase* const ModuleLogCategories[] = { &LogRLO, &LogRLODialogue, &LogRLOInteraction, &LogRLOInventory, &LogRLOPuzzle, &LogRLOUI, &LogRLOSave };
+}
+
+FRLOScopedBenchmarkLogs::FRLOScopedBenchmarkLogs(bool bKeepLogs)
+{
+    // 日志输出不计入游戏逻辑耗时
+    for (FLogCategoryBase* Category : ModuleLogCategories)
+    {
+        SavedVerbosity.Add(Category->GetVerbosity());
+        if (!bKeepLogs)
+        {
+            Category->SetVerbosity(ELogVerbosity::Warning);
+        }
+    }
+}
+
+FRLOScopedBenchmarkLogs::~FRLOScopedBenchmarkLogs()
+{
+    for (int32 Index = 0; Index < SavedVerbosity.Num(); Index++)
+    {
+        ModuleLogCategories[Index]->SetVerbosity(SavedVerbosity[Index]);
+    }
+}
+
+URLOBenchmarkCommandlet::URLOBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsEditor = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 URLOBenchmarkCommandlet::Main(const FString& Params)
+{
+    FParse::Value(*Params, TEXT("Interactables="), NumInteractables);
+    FParse::Value(*Params, TEXT("Puzzles="), NumPuzzles);
+    FParse::Value(*Params, TEXT("Dialogues="), NumDialogues);
+    FParse::Value(*Params, TEXT("Frames="), NumFrames);
+    FParse::Value(*Params, TEXT("Warmup="), NumWarmupFrames);
+
+    NumInteractables = FMath::Max(NumInteractables, 1);
+    NumPuzzles = FMath::Max(NumPuzzles, 0);
+    NumDialogues = FMath::Max(NumDialogues, 0);
+    NumFrames = FMath::Max(NumFrames, 1);
+    NumWarmupFrames = FMath::Max(NumWarmupFrames, 0);
+
+    FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks/RLOBenchmark.json");
+    FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+    const FRLOScopedBenchmarkLogs ScopedLogs(FParse::Param(*Params, TEXT("KeepLogs")));
+
+    UWorld* World = CreateBenchmarkWorld();
+    if (!World)
+    {
+        UE_LOG(LogRLO, Error, TEXT("RLOBenchmark: Failed to create benchmark world"));
+        return 1;
+    }
+
+    SpawnScenario(World);
+
+    // 分配计数代理在测试结束后不再删除，避免释放期间仍有线程持有旧指针
+    FMalloc* OriginalMalloc = GMalloc;
+    FRLOCountingMalloc* CountingMalloc = new FRLOCountingMalloc(OriginalMalloc);
+    GMalloc = CountingMalloc;
+
+    const float DeltaTime = 1.0f / 60.0f;
+    double FrameMsTotal = 0.0;
+    double FrameMsPeak = 0.0;
+    int32 TracesAtStart = 0;
+
+    for (int32 Frame = 0; Frame < NumWarmupFrames + NumFrames; Frame++)
+    {
+        const bool bMeasuring = Frame >= NumWarmupFrames;
+        if (Frame == NumWarmupFrames)
+        {
+            FRLOPerf::Reset();
+            TracesAtStart = Interaction->GetTotalTracesPerformed();
+            CountingMalloc->SetEnabled(true);
+        }
+
+        FApp::SetDeltaTime(DeltaTime);
+        FApp::SetCurrentTime(FApp::GetCurrentTime() + DeltaTime);
+
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+
+        DriveInput(Frame, World->GetRealTimeSeconds());
+        DrivePuzzles(Frame);
+        World->Tick(LEVELTICK_All, DeltaTime);
+
+        if (bMeasuring)
+        {
+            const double FrameMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+            FrameMsTotal += FrameMs;
+            FrameMsPeak = FMath::Max(FrameMsPeak, FrameMs);
+        }
+
+        GFrameCounter++;
+    }
+
+    CountingMalloc->SetEnabled(false);
+    GMalloc = OriginalMalloc;
+
+    // 汇总结果
+    const double Frames = static_cast<double>(NumFrames);
+    const double PerfFrames = static_cast<double>(FRLOPerf::GetNumFrames());
+    int64 AttributedAllocations = 0;
+
+    TSharedRef<FJsonObject> Subsystems = MakeShared<FJsonObject>();
+    for (int32 Index = 0; Index < NumSubsystems; Index++)
+    {
+        const ERLOPerfSubsystem Subsystem = static_cast<ERLOPerfSubsystem>(Index);
+        const FRLOPerf::FSubsystemStats Stats = FRLOPerf::GetStats(Subsystem);
+        const int64 Allocations = CountingMalloc->GetSubsystemAllocations(Index);
+        const int32 Traces = Subsystem == ERLOPerfSubsystem::Interaction ? Interaction->GetTotalTracesPerformed() - TracesAtStart : 0;
+        AttributedAllocations += Allocations;
+
+        TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+        Entry->SetNumberField(TEXT("ms_per_frame"), Stats.AverageMs * PerfFrames / Frames);
+        Entry->SetNumberField(TEXT("ms_peak"), Stats.PeakMs);
+        Entry->SetNumberField(TEXT("budget_ms"), Stats.BudgetMs);
+        Entry->SetNumberField(TEXT("calls_per_frame"), Stats.NumCalls / Frames);
+        Entry->SetNumberField(TEXT("allocs_per_frame"), Allocations / Frames);
+        Entry->SetNumberField(TEXT("traces_per_frame"), Traces / Frames);
+        Subsystems->SetObjectField(FRLOPerf::GetSubsystemName(Subsystem), Entry);
+    }
+
+    TSharedRef<FJsonObject> Scenario = MakeShared<FJsonObject>();
+    Scenario->SetNumberField(TEXT("interactables"), NumInteractables);
+    Scenario->SetNumberField(TEXT("puzzles"), NumPuzzles);
+    Scenario->SetNumberField(TEXT("dialogues"), NumDialogues);
+    Scenario->SetNumberField(TEXT("frames"), NumFrames);
+    Scenario->SetNumberField(TEXT("warmup_frames"), NumWarmupFrames);
+
+    TSharedRef<FJsonObject> FrameTotals = MakeShared<FJsonObject>();
+    FrameTotals->SetNumberField(TEXT("ms_per_frame"), FrameMsTotal / Frames);
+    FrameTotals->SetNumberField(TEXT("ms_peak"), FrameMsPeak);
+    FrameTotals->SetNumberField(TEXT("allocs_per_frame"), CountingMalloc->GetTotalAllocations() / Frames);
+    FrameTotals->SetNumberField(TEXT("unattributed_allocs_per_frame"), (CountingMalloc->GetTotalAllocations() - AttributedAllocations) / Frames);
+
+    TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+    Root->SetObjectField(TEXT("scenario"), Scenario);
+    Root->SetObjectField(TEXT("frame"), FrameTotals);
+    Root->SetObjectField(TEXT("subsystems"), Subsystems);
+
+    FString Json;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+    FJsonSerializer::Serialize(Root, Writer);
+
+    DestroyBenchmarkWorld(World);
+
+    UE_LOG(LogRLO, Display, TEXT("RLOBenchmark results:\n%s"), *Json);
+
+    if (!FFileHelper::SaveStringToFile(Json, *OutputPath))
+    {
+        UE_LOG(LogRLO, Error, TEXT("RLOBenchmark: Failed to write %s"), *OutputPath);
+        return 1;
+    }
+
+    UE_LOG(LogRLO, Display, TEXT("RLOBenchmark: Wrote %s"), *OutputPath);
+    return 0;
+}
+
+UWorld* URLOBenchmarkCommandlet::CreateBenchmarkWorld()
+{
+    UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("RLOBenchmarkWorld"));
+    if (!World)
+    {
+        return nullptr;
+    }
+
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(World);
+
+    // 没有GameMode，直接开始游戏，之后生成的Actor在生成时BeginPlay
+    World->InitializeActorsForPlay(FURL());
+    World->GetWorldSettings()->NotifyBeginPlay();
+    return World;
+}
+
+void URLOBenchmarkCommandlet::DestroyBenchmarkWorld(UWorld* World)
+{
+    if (World)
+    {
+        GEngine->DestroyWorldContext(World);
+        World->DestroyWorld(false);
+    }
+}
+
+void URLOBenchmarkCommandlet::SpawnScenario(UWorld* World)
+{
+    // 玩家控制器位于原点朝向+X，镜头POV默认与之相同（FOV 90）
+    APlayerController* PlayerController = World->SpawnActor<APlayerController>();
+    PlayerController->InputComponent = NewObject<UInputComponent>(PlayerController, TEXT("PC_InputComponent0"));
+    PlayerController->InputComponent->RegisterComponent();
+
+    Interaction = NewObject<UInteractionComponent>(PlayerController, TEXT("InteractionComponent"));
+    Interaction->SetSyntheticViewportSize(ViewportSize);
+    Interaction->RegisterComponent();
+
+    // 可交互对象铺满视口，每个对象对应一个屏幕格子
+    const int32 Columns = FMath::CeilToInt(FMath::Sqrt(NumInteractables * ViewportSize.X / ViewportSize.Y));
+    const int32 Rows = FMath::DivideAndRoundUp(NumInteractables, Columns);
+    const float CellWorldSize = 2.0f * TargetDistance * FMath::Tan(FMath::DegreesToRadians(FieldOfView * 0.5f)) / Columns;
+
+    TargetScreenPositions.Reset(NumInteractables);
+    for (int32 Index = 0; Index < NumInteractables; Index++)
+    {
+        const FVector2D ScreenPosition(
+            (Index % Columns + 0.5f) * ViewportSize.X / Columns,
+            (Index / Columns + 0.5f) * ViewportSize.Y / Rows);
+        TargetScreenPositions.Add(ScreenPosition);
+
+        AActor* Actor = World->SpawnActor<AActor>();
+        UBoxComponent* Box = NewObject<UBoxComponent>(Actor, TEXT("Box"));
+        Box->SetBoxExtent(FVector(CellWorldSize * 0.4f));
+        Box->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+        Actor->SetRootComponent(Box);
+        Box->SetWorldLocation(ScreenToWorld(ScreenPosition, TargetDistance));
+        Box->RegisterComponent();
+
+        UInteractableComponent* Interactable = NewObject<UInteractableComponent>(Actor, TEXT("Interactable"));
+        Interactable->InteractionType = EInteractionType::Observe;
+        Interactable->ObserveText = FText::FromString(FString::Printf(TEXT("Benchmark object %d"), Index));
+        Interactable->RegisterComponent();
+    }
+
+    // 谜题放在镜头后方，不挡住射线；目标角度在推动范围之外，整个测试中保持激活
+    Puzzles.Reset(NumPuzzles);
+    for (int32 Index = 0; Index < NumPuzzles; Index++)
+    {
+        const FTransform Transform(FVector(-TargetDistance, Index * 100.0f, 0.0f));
+        ARotationPuzzle* Puzzle = World->SpawnActorDeferred<ARotationPuzzle>(ARotationPuzzle::StaticClass(), Transform);
+        Puzzle->TargetRotation = 180.0f;
+        Puzzle->FinishSpawning(Transform);
+        Puzzle->ActivatePuzzle();
+        Puzzles.Add(Puzzle);
+    }
+
+    // 循环对话链
+    if (NumDialogues > 0)
+    {
+        UDialogueDataAsset* DialogueData = NewObject<UDialogueDataAsset>(GetTransientPackage());
+        for (int32 Index = 0; Index < NumDialogues; Index++)
+        {
+            FDialogueEntry& Entry = DialogueData->DialogueEntries.AddDefaulted_GetRef();
+            Entry.DialogueID = *FString::Printf(TEXT("Bench_%03d"), Index);
+            Entry.NextDialogueID = *FString::Printf(TEXT("Bench_%03d"), (Index + 1) % NumDialogues);
+            Entry.TextCN = FText::FromString(FString::Printf(TEXT("第%d句：星盘缓缓转动。"), Index));
+            Entry.TextEN = FText::FromString(FString::Printf(TEXT("Line %d: the orrery slowly turns."), Index));
+            Entry.Duration = 0.5f;
+        }
+        DialogueData->RebuildLookupIndex();
+
+        AActor* Speaker = World->SpawnActor<AActor>();
+        Dialogue = NewObject<UDialogueComponent>(Speaker, TEXT("Dialogue"));
+        Dialogue->DialogueDataAsset = DialogueData;
+        Dialogue->RegisterComponent();
+        Dialogue->PlayDialogue(DialogueData->DialogueEntries[0].DialogueID);
+    }
+}
+
+void URLOBenchmarkCommandlet::DriveInput(int32 Frame, double Timestamp)
+{
+    // 偶数手势为点击，奇数手势为向右滑动，依次落在不同的可交互对象上
+    const int32 Gesture = Frame / GestureFrames;
+    const int32 Phase = Frame % GestureFrames;
+    const bool bSwipe = (Gesture % 2) == 1;
+    const FVector2D Start = TargetScreenPositions[Gesture % TargetScreenPositions.Num()];
+    const FVector2D SwipeStep(40.0f, 0.0f);
+
+    if (Phase == 0)
+    {
+        Interaction->InjectTouchSample(FRLOTouchSample(0, ERLOTouchPhase::Began, Start, Timestamp));
+    }
+    else if (bSwipe && Phase <= 5)
+    {
+        Interaction->InjectTouchSample(FRLOTouchSample(0, ERLOTouchPhase::Moved, Start + SwipeStep * Phase, Timestamp));
+    }
+    else if (Phase == (bSwipe ? 6 : 2))
+    {
+        Interaction->InjectTouchSample(FRLOTouchSample(0, ERLOTouchPhase::Ended, bSwipe ? Start + SwipeStep * 6 : Start, Timestamp));
+    }
+}
+
+void URLOBenchmarkCommandlet::DrivePuzzles(int32 Frame)
+{
+    // 每帧推动一部分谜题，模拟玩家轮流拨动
+    for (int32 Index = Frame % 4; Index < Puzzles.Num(); Index += 4)
+    {
+        Puzzles[Index]->SetRotation(30.0f * FMath::Sin(Frame * 0.1f + Index));
+    }
+}
+
+FVector URLOBenchmarkCommandlet::ScreenToWorld(const FVector2D& ScreenPosition, float Distance) const
+{
+    const float TanHalfFOV = FMath::Tan(FMath::DegreesToRadians(FieldOfView * 0.5f));
+    const float NormalizedX = 2.0f * ScreenPosition.X / ViewportSize.X - 1.0f;
+    const float NormalizedY = 1.0f - 2.0f * ScreenPosition.Y / ViewportSize.Y;
+
+    return FVector(Distance, NormalizedX * TanHalfFOV * Distance, NormalizedY * TanHalfFOV * Distance * ViewportSize.Y / ViewportSize.X);
+}
@@ -0,0 +1,278 @@
+// RLOCSVReader.cpp
+
+#include "RLOCSVReader.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+    /** 字段内的空白(不含换行) */
+    FORCEINLINE bool IsFieldWhitespace(TCHAR Char)
+    {
+        return Char == TEXT(' ') || Char == TEXT('\t');
+    }
+}
+
+FRLOCSVReader::FRLOCSVReader(const FString& InBuffer)
+    : FRLOCSVReader(*InBuffer, InBuffer.Len())
+{
+}
+
+FRLOCSVReader::FRLOCSVReader(const TCHAR* InData, int32 InLength)
+    : Data(InData)
+    , Length(InLength)
+{
+    // 跳过UTF-8 BOM(LoadFileToString通常已经去掉,这里做兜底)
+    if (Length > 0 && Data[0] == 0xFEFF)
+    {
+        Position = 1;
+    }
+}
+
+bool FRLOCSVReader::ReadHeader()
+{
+    HeaderColumns.Reset();
+    ColumnIndex.Reset();
+
+    // 表头行不做字段数校验
+    const bool bSavedRequireCount = bRequireHeaderFieldCount;
+    bRequireHeaderFieldCount = false;
+    const EReadResult Result = ReadRow();
+    bRequireHeaderFieldCount = bSavedRequireCount;
+
+    if (Result != EReadResult::Row)
+    {
+        if (Result == EReadResult::EndOfFile)
+        {
+            LastError = TEXT("CSV is empty, no header row");
+        }
+        return false;
+    }
+
+    HeaderColumns.Reserve(NumFields);
+    for (int32 i = 0; i < NumFields; i++)
+    {
+        HeaderColumns.Add(Fields[i]);
+
+        // 重复列名时第一个优先
+        if (!Fields[i].IsEmpty() && !ColumnIndex.Contains(Fields[i]))
+        {
+            ColumnIndex.Add(Fields[i], i);
+        }
+    }
+
+    return true;
+}
+
+FRLOCSVReader::EReadResult FRLOCSVReader::ReadRow()
+{
+    NumFields = 0;
+
+    // 跳过空行
+    while (Position < Length && ConsumeLineBreak())
+    {
+    }
+
+    if (Position >= Length)
+    {
+        return EReadResult::EndOfFile;
+    }
+
+    RowLineNumber = LineNumber;
+
+    const EReadResult Result = ScanRecord();
+    if (Result != EReadResult::Row)
+    {
+        return Result;
+    }
+
+    if (bRequireHeaderFieldCount && HeaderColumns.Num() > 0 && NumFields != HeaderColumns.Num())
+    {
+        LastError = FString::Printf(TEXT("line %d: expected %d fields, found %d"), RowLineNumber, HeaderColumns.Num(), NumFields);
+        return EReadResult::Error;
+    }
+
+    return EReadResult::Row;
+}
+
+FRLOCSVReader::EReadResult FRLOCSVReader::ScanRecord()
+{
+    while (true)
+    {
+        FString& Field = NextFieldSlot();
+
+        // 未加引号时跳过前导空白,以便识别 ` "..."` 这样的字段
+        int32 FieldStart = Position;
+        if (bTrimUnquotedFields)
+        {
+            while (FieldStart < Length && IsFieldWhitespace(Data[FieldStart]))
+            {
+                FieldStart++;
+            }
+        }
+
+        if (FieldStart < Length && Data[FieldStart] == TEXT('"'))
+        {
+            // 引号字段:按片段追加,"" 转义为单个引号
+            Position = FieldStart + 1;
+            int32 SegmentStart = Position;
+            bool bClosed = false;
+
+            while (Position < Length)
+            {
+                const TCHAR Char = Data[Position];
+                if (Char == TEXT('"'))
+                {
+                    Field.AppendChars(Data + SegmentStart, Position - SegmentStart);
+
+                    if (Position + 1 < Length && Data[Position + 1] == TEXT('"'))
+                    {
+                        Field.AppendChar(TEXT('"'));
+                        Position += 2;
+                        SegmentStart = Position;
+                        continue;
+                    }
+
+                    Position++;
+                    bClosed = true;
+                    break;
+                }
+
+                if (Char == TEXT('\n') || (Char == TEXT('\r') && (Position + 1 >= Length || Data[Position + 1] != TEXT('\n'))))
+                {
+                    LineNumber++;
+                }
+                Position++;
+            }
+
+            if (!bClosed)
+            {
+                LastError = FString::Printf(TEXT("line %d: unterminated quoted field %d"), RowLineNumber, NumFields);
+                Position = Length;
+                return EReadResult::Error;
+            }
+
+            // 结束引号之后只允许空白、逗号或换行
+            while (Position < Length && IsFieldWhitespace(Data[Position]))
+            {
+                Position++;
+            }
+
+            if (Position < Length && Data[Position] != TEXT(',') && !IsAtLineEnd())
+            {
+                LastError = FString::Printf(TEXT("line %d: unexpected character '%c' after closing quote in field %d"),
+                    RowLineNumber, Data[Position], NumFields);
+                SkipToNextLine();
+                return EReadResult::Error;
+            }
+        }
+        else
+        {
+            // 普通字段:扫描到逗号或换行
+            Position = FieldStart;
+            while (Position < Length && Data[Position] != TEXT(',') && Data[Position] != TEXT('\n') && Data[Position] != TEXT('\r'))
+            {
+                Position++;
+            }
+
+            int32 FieldEnd = Position;
+            if (bTrimUnquotedFields)
+            {
+                while (FieldEnd > FieldStart && IsFieldWhitespace(Data[FieldEnd - 1]))
+                {
+                    FieldEnd--;
+                }
+            }
+            Field.AppendChars(Data + FieldStart, FieldEnd - FieldStart);
+        }
+
+        if (Position < Length && Data[Position] == TEXT(','))
+        {
+            Position++;
+            continue;
+        }
+
+        // 行尾或文件尾
+        ConsumeLineBreak();
+        return EReadResult::Row;
+    }
+}
+
+FString& FRLOCSVReader::NextFieldSlot()
+{
+    if (NumFields == Fields.Num())
+    {
+        Fields.AddDefaulted();
+    }
+
+    // Reset保留容量,后续行不再重新分配
+    FString& Field = Fields[NumFields++];
+    Field.Reset();
+    return Field;
+}
+
+void FRLOCSVReader::SkipToNextLine()
+{
+    while (Position < Length && !ConsumeLineBreak())
+    {
+        Position++;
+    }
+}
+
+bool FRLOCSVReader::ConsumeLineBreak()
+{
+    if (Position >= Length)
+    {
+        return false;
+    }
+
+    if (Data[Position] == TEXT('\r'))
+    {
+        Position++;
+        if (Position < Length && Data[Position] == TEXT('\n'))
+        {
+            Position++;
+        }
+        LineNumber++;
+        return true;
+    }
+
+    if (Data[Position] == TEXT('\n'))
+    {
+        Position++;
+        LineNumber++;
+        return true;
+    }
+
+    return false;
+}
+
+bool FRLOCSVReader::IsAtLineEnd() const
+{
+    return Position >= Length || Data[Position] == TEXT('\n') || Data[Position] == TEXT('\r');
+}
+
+int32 FRLOCSVReader::FindColumn(std::initializer_list<const TCHAR*> Names) const
+{
+    for (const TCHAR* Name : Names)
+    {
+        if (const int32* Found = ColumnIndex.Find(FString(Name)))
+        {
+            return *Found;
+        }
+    }
+
+    return INDEX_NONE;
+}
+
+const FString& FRLOCSVReader::GetField(int32 Column) const
+{
+    static const FString EmptyField;
+    return (Column >= 0 && Column < NumFields) ? Fields[Column] : EmptyField;
+}
+
+FString FRLOCSVReader::ToObjectPath(const FString& AssetPath)
+{
+    const FString PackagePath = FPaths::GetBaseFilename(AssetPath, false);
+    const FString AssetName = FPaths::GetBaseFilename(PackagePath);
+    return AssetName.IsEmpty() ? FString() : FString::Printf(TEXT("%s.%s"), *PackagePath, *AssetName);
+}
@@ -0,0 +1,434 @@
+// RLOGestureRecognizer.cpp
+
+#include "RLOGestureRecognizer.h"
+
+namespace
+{
+    /** 两指之间的距离 */
+    FORCEINLINE float PairDistance(const FVector2D& A, const FVector2D& B)
+    {
+        return FVector2D::Distance(A, B);
+    }
+
+    /** 两指连线的角度（度） */
+    FORCEINLINE float PairAngle(const FVector2D& A, const FVector2D& B)
+    {
+        const FVector2D Dir = B - A;
+        return FMath::RadiansToDegrees(FMath::Atan2(Dir.Y, Dir.X));
+    }
+}
+
+void FRLOGestureRecognizer::FPointer::AddHistory(const FVector2D& InPosition, double Time)
+{
+    HistoryPositions[HistoryHead] = InPosition;
+    HistoryTimes[HistoryHead] = Time;
+    HistoryHead = (HistoryHead + 1) % HistorySize;
+    HistoryCount = FMath::Min(HistoryCount + 1, HistorySize);
+}
+
+FVector2D FRLOGestureRecognizer::FPointer::EstimateVelocity(double Now, float Window) const
+{
+    if (HistoryCount < 2)
+    {
+        return FVector2D::ZeroVector;
+    }
+
+    // 最新的采样
+    const int32 NewestSlot = (HistoryHead + HistorySize - 1) % HistorySize;
+
+    // 时间窗口内最早的采样
+    int32 OldestSlot = NewestSlot;
+    for (int32 i = 1; i < HistoryCount; i++)
+    {
+        const int32 Slot = (HistoryHead + HistorySize - 1 - i) % HistorySize;
+        if (Now - HistoryTimes[Slot] > Window)
+        {
+            break;
+        }
+        OldestSlot = Slot;
+    }
+
+    const double DeltaTime = HistoryTimes[NewestSlot] - HistoryTimes[OldestSlot];
+    if (DeltaTime <= KINDA_SMALL_NUMBER)
+    {
+        return FVector2D::ZeroVector;
+    }
+
+    return (HistoryPositions[NewestSlot] - HistoryPositions[OldestSlot]) / static_cast<float>(DeltaTime);
+}
+
+void FRLOGestureRecognizer::ProcessSample(const FRLOTouchSample& Sample, TArray<FRLOGestureEvent>& OutEvents)
+{
+    if (Sample.PointerIndex < 0 || Sample.PointerIndex >= MaxPointers)
+    {
+        return;
+    }
+
+    // 先推进到事件时间，保证长按在之后的事件之前被识别
+    Advance(Sample.Timestamp, OutEvents);
+
+    const int32 Index = Sample.PointerIndex;
+    switch (Sample.Phase)
+    {
+        case ERLOTouchPhase::Began:
+            if (Pointers[Index].bActive)
+            {
+                // 重复的按下事件按移动处理
+                OnPointerMove(Index, Sample, OutEvents);
+            }
+            else
+            {
+                OnPointerDown(Index, Sample, OutEvents);
+            }
+            break;
+
+        case ERLOTouchPhase::Moved:
+            if (Pointers[Index].bActive)
+            {
+                OnPointerMove(Index, Sample, OutEvents);
+            }
+            break;
+
+        case ERLOTouchPhase::Ended:
+        case ERLOTouchPhase::Cancelled:
+            if (Pointers[Index].bActive)
+            {
+                OnPointerUp(Index, Sample, Sample.Phase == ERLOTouchPhase::Cancelled, OutEvents);
+            }
+            break;
+    }
+}
+
+void FRLOGestureRecognizer::Advance(double Now, TArray<FRLOGestureEvent>& OutEvents)
+{
+    if (Mode != EMode::Single || bPanning || bLongPressFired || PrimaryIndex == INDEX_NONE)
+    {
+        return;
+    }
+
+    const float LongPressDuration = GetLongPressDuration();
+    if (LongPressDuration <= 0.0f)
+    {
+        return;
+    }
+
+    const FPointer& Primary = Pointers[PrimaryIndex];
+    const double FireTime = Primary.StartTime + LongPressDuration;
+    if (Now >= FireTime)
+    {
+        bLongPressFired = true;
+
+        // 使用精确的到达时刻而不是调用时间，结果与帧率无关
+        FRLOGestureEvent& Event = AddEvent(OutEvents, ERLOGestureType::LongPress, FireTime);
+        Event.Position = Primary.Position;
+        Event.StartPosition = Primary.StartPosition;
+        Event.Duration = LongPressDuration;
+    }
+}
+
+void FRLOGestureRecognizer::Reset()
+{
+    for (FPointer& Pointer : Pointers)
+    {
+        Pointer = FPointer();
+    }
+
+    ActivePointerCount = 0;
+    Mode = EMode::Idle;
+    PrimaryIndex = INDEX_NONE;
+    bPanning = false;
+    bLongPressFired = false;
+    SequenceLongPressDuration = -1.0f;
+    PairIndexA = INDEX_NONE;
+    PairIndexB = INDEX_NONE;
+    bPinching = false;
+    bTwoFingerRotating = false;
+}
+
+float FRLOGestureRecognizer::GetLongPressProgress(double Now) const
+{
+    if (Mode != EMode::Single || bPanning || PrimaryIndex == INDEX_NONE)
+    {
+        return 0.0f;
+    }
+
+    const float LongPressDuration = GetLongPressDuration();
+    if (LongPressDuration <= 0.0f)
+    {
+        return 0.0f;
+    }
+
+    if (bLongPressFired)
+    {
+        return 1.0f;
+    }
+
+    return FMath::Clamp(static_cast<float>((Now - Pointers[PrimaryIndex].StartTime) / LongPressDuration), 0.0f, 1.0f);
+}
+
+void FRLOGestureRecognizer::Replay(const FRLOGestureConfig& InConfig, TArrayView<const FRLOTouchSample> Samples, TArray<FRLOGestureEvent>& OutEvents, double EndTime)
+{
+    FRLOGestureRecognizer Recognizer;
+    Recognizer.Config = InConfig;
+
+    double LastTime = 0.0;
+    for (const FRLOTouchSample& Sample : Samples)
+    {
+        Recognizer.ProcessSample(Sample, OutEvents);
+        LastTime = Sample.Timestamp;
+    }
+
+    Recognizer.Advance(FMath::Max(EndTime, LastTime), OutEvents);
+}
+
+void FRLOGestureRecognizer::OnPointerDown(int32 Index, const FRLOTouchSample& Sample, TArray<FRLOGestureEvent>& OutEvents)
+{
+    FPointer& Pointer = Pointers[Index];
+    Pointer.bActive = true;
+    Pointer.StartPosition = Sample.Position;
+    Pointer.Position = Sample.Position;
+    Pointer.StartTime = Sample.Timestamp;
+    Pointer.HistoryCount = 0;
+    Pointer.HistoryHead = 0;
+    Pointer.AddHistory(Sample.Position, Sample.Timestamp);
+    ActivePointerCount++;
+
+    if (Mode == EMode::Idle)
+    {
+        // 新的触摸序列
+        Mode = EMode::Single;
+        PrimaryIndex = Index;
+        bPanning = false;
+        bLongPressFired = false;
+        LastPanPosition = Sample.Position;
+
+        FRLOGestureEvent& Event = AddEvent(OutEvents, ERLOGestureType::Down, Sample.Timestamp);
+        Event.Position = Sample.Position;
+        Event.StartPosition = Sample.Position;
+    }
+    else if (Mode == EMode::Single)
+    {
+        // 第二根手指按下：取消单指手势，开始双指手势
+        if (bPanning)
+        {
+            const FPointer& Primary = Pointers[PrimaryIndex];
+            FRLOGestureEvent& Event = AddEvent(OutEvents, ERLOGestureType::PanEnded, Sample.Timestamp);
+            Event.Position = Primary.Position;
+            Event.StartPosition = Primary.StartPosition;
+            Event.Duration = static_cast<float>(Sample.Timestamp - Primary.StartTime);
+            bPanning = false;
+        }
+
+        BeginTwoFinger(PrimaryIndex, Index, Sample.Timestamp, OutEvents);
+    }
+}
+
+void FRLOGestureRecognizer::OnPointerMove(int32 Index, const FRLOTouchSample& Sample, TArray<FRLOGestureEvent>& OutEvents)
+{
+    FPointer& Pointer = Pointers[Index];
+    Pointer.Position = Sample.Position;
+    Pointer.AddHistory(Sample.Position, Sample.Timestamp);
+
+    if (Mode == EMode::Single && Index == PrimaryIndex)
+    {
+        if (!bPanning)
+        {
+            if (FVector2D::DistSquared(Pointer.Position, Pointer.StartPosition) <= FMath::Square(Config.TapSlop))
+            {
+                return;
+            }
+
+            // 超过点击范围，开始拖动（长按未触发时不再识别长按）
+            bPanning = true;
+            FRLOGestureEvent& Event = AddEvent(OutEvents, ERLOGestureType::PanBegan, Sample.Timestamp);
+            Event.Position = Pointer.Position;
+            Event.StartPosition = Pointer.StartPosition;
+            Event.Delta = Pointer.Position - Pointer.StartPosition;
+            Event.Duration = static_cast<float>(Sample.Timestamp - Pointer.StartTime);
+            LastPanPosition = Pointer.Position;
+            return;
+        }
+
+        FRLOGestureEvent& Event = AddEvent(OutEvents, ERLOGestureType::PanChanged, Sample.Timestamp);
+        Event.Position = Pointer.Position;
+        Event.StartPosition = Pointer.StartPosition;
+        Event.Delta = Pointer.Position - LastPanPosition;
+        Event.Velocity = Pointer.EstimateVelocity(Sample.Timestamp, Config.VelocityWindow);
+        Event.Duration = static_cast<float>(Sample.Timestamp - Pointer.StartTime);
+        LastPanPosition = Pointer.Position;
+    }
+    else if (Mode == EMode::TwoFinger && (Index == PairIndexA || Index == PairIndexB))
+    {
+        UpdateTwoFinger(Sample.Timestamp, OutEvents);
+    }
+}
+
+void FRLOGestureRecognizer::OnPointerUp(int32 Index, const FRLOTouchSample& Sample, bool bCancelled, TArray<FRLOGestureEvent>& OutEvents)
+{
+    FPointer& Pointer = Pointers[Index];
+
+    if (Mode == EMode::Single && Index == PrimaryIndex)
+    {
+        Pointer.Position = Sample.Position;
+        Pointer.AddHistory(Sample.Position, Sample.Timestamp);
+
+        const float Duration = static_cast<float>(Sample.Timestamp - Pointer.StartTime);
+        const FVector2D Velocity = Pointer.EstimateVelocity(Sample.Timestamp, Config.VelocityWindow);
+
+        if (bPanning)
+        {
+            FRLOGestureEvent& Ended = AddEvent(OutEvents, ERLOGestureType::PanEnded, Sample.Timestamp);
+            Ended.Position = Pointer.Position;
+            Ended.StartPosition = Pointer.StartPosition;
+            Ended.Velocity = Velocity;
+            Ended.Duration = Duration;
+
+            if (!bCancelled)
+            {
+                const FVector2D Total = Pointer.Position - Pointer.StartPosition;
+                if (Total.SizeSquared() >= FMath::Square(Config.SwipeMinDistance) && Duration <= Config.SwipeMaxDuration)
+                {
+                    FRLOGestureEvent& Swipe = AddEvent(OutEvents, ERLOGestureType::Swipe, Sample.Timestamp);
+                    Swipe.Position = Pointer.Position;
+                    Swipe.StartPosition = Pointer.StartPosition;
+                    Swipe.Delta = Total;
+                    Swipe.Velocity = Velocity;
+                    Swipe.Duration = Duration;
+                }
+
+                if (Velocity.SizeSquared() >= FMath::Square(Config.FlingMinVelocity))
+                {
+                    FRLOGestureEvent& Fling = AddEvent(OutEvents, ERLOGestureType::Fling, Sample.Timestamp);
+                    Fling.Position = Pointer.Position;
+                    Fling.StartPosition = Pointer.StartPosition;
+                    Fling.Delta = Total;
+                    Fling.Velocity = Velocity;
+                    Fling.Duration = Duration;
+                }
+            }
+        }
+        else if (!bCancelled && !bLongPressFired && Duration <= Config.TapMaxDuration)
+        {
+            FRLOGestureEvent& Tap = AddEvent(OutEvents, ERLOGestureType::Tap, Sample.Timestamp);
+            Tap.Position = Pointer.Position;
+            Tap.StartPosition = Pointer.StartPosition;
+            Tap.Duration = Duration;
+        }
+
+        Mode = EMode::Finished;
+        bPanning = false;
+    }
+    else if (Mode == EMode::TwoFinger && (Index == PairIndexA || Index == PairIndexB))
+    {
+        // 双指手势以最后一次移动的位置为准（抬起事件的位置不参与缩放和旋转）
+        const FPointer& A = Pointers[PairIndexA];
+        const FPointer& B = Pointers[PairIndexB];
+        FRLOGestureEvent& Event = AddEvent(OutEvents, ERLOGestureType::TwoFingerEnded, Sample.Timestamp);
+        Event.Position = (A.Position + B.Position) * 0.5f;
+        Event.StartPosition = PairStartCentroid;
+        Event.Scale = PairStartDistance > 0.0f ? PairDistance(A.Position, B.Position) / PairStartDistance : 1.0f;
+        Event.RotationDegrees = PairRotation;
+        Event.Duration = static_cast<float>(Sample.Timestamp - PairStartTime);
+
+        Mode = EMode::Finished;
+    }
+
+    Pointer.bActive = false;
+    ActivePointerCount--;
+
+    if (ActivePointerCount == 0)
+    {
+        FRLOGestureEvent& Event = AddEvent(OutEvents, ERLOGestureType::Up, Sample.Timestamp);
+        Event.Position = Pointer.Position;
+        Event.StartPosition = Pointer.StartPosition;
+
+        // 触摸序列结束
+        Mode = EMode::Idle;
+        PrimaryIndex = INDEX_NONE;
+        PairIndexA = INDEX_NONE;
+        PairIndexB = INDEX_NONE;
+        bLongPressFired = false;
+        SequenceLongPressDuration = -1.0f;
+    }
+}
+
+void FRLOGestureRecognizer::BeginTwoFinger(int32 IndexA, int32 IndexB, double Timestamp, TArray<FRLOGestureEvent>& OutEvents)
+{
+    Mode = EMode::TwoFinger;
+    PairIndexA = IndexA;
+    PairIndexB = IndexB;
+
+    const FPointer& A = Pointers[IndexA];
+    const FPointer& B = Pointers[IndexB];
+    PairStartDistance = FMath::Max(PairDistance(A.Position, B.Position), 1.0f);
+    PairLastAngle = PairAngle(A.Position, B.Position);
+    PairRotation = 0.0f;
+    LastReportedScale = 1.0f;
+    LastReportedRotation = 0.0f;
+    bPinching = false;
+    bTwoFingerRotating = false;
+    PairStartCentroid = (A.Position + B.Position) * 0.5f;
+    PairStartTime = Timestamp;
+
+    FRLOGestureEvent& Event = AddEvent(OutEvents, ERLOGestureType::TwoFingerBegan, Timestamp);
+    Event.Position = PairStartCentroid;
+    Event.StartPosition = PairStartCentroid;
+}
+
+void FRLOGestureRecognizer::UpdateTwoFinger(double Timestamp, TArray<FRLOGestureEvent>& OutEvents)
+{
+    const FPointer& A = Pointers[PairIndexA];
+    const FPointer& B = Pointers[PairIndexB];
+    const FVector2D Centroid = (A.Position + B.Position) * 0.5f;
+
+    // 累计角度变化，跨越±180度时不跳变
+    const float Angle = PairAngle(A.Position, B.Position);
+    PairRotation += FMath::FindDeltaAngleDegrees(PairLastAngle, Angle);
+    PairLastAngle = Angle;
+
+    const float Scale = PairDistance(A.Position, B.Position) / PairStartDistance;
+    const float Duration = static_cast<float>(Timestamp - PairStartTime);
+
+    if (!bPinching && FMath::Abs(Scale - 1.0f) >= Config.PinchThreshold)
+    {
+        bPinching = true;
+    }
+
+    if (bPinching && Scale != LastReportedScale)
+    {
+        FRLOGestureEvent& Event = AddEvent(OutEvents, ERLOGestureType::PinchChanged, Timestamp);
+        Event.Position = Centroid;
+        Event.StartPosition = PairStartCentroid;
+        Event.Scale = Scale;
+        Event.ScaleDelta = LastReportedScale > 0.0f ? Scale / LastReportedScale : 1.0f;
+        Event.RotationDegrees = PairRotation;
+        Event.Duration = Duration;
+        LastReportedScale = Scale;
+    }
+
+    if (!bTwoFingerRotating && FMath::Abs(PairRotation) >= Config.RotateThresholdDegrees)
+    {
+        bTwoFingerRotating = true;
+    }
+
+    if (bTwoFingerRotating && PairRotation != LastReportedRotation)
+    {
+        FRLOGestureEvent& Event = AddEvent(OutEvents, ERLOGestureType::RotateChanged, Timestamp);
+        Event.Position = Centroid;
+        Event.StartPosition = PairStartCentroid;
+        Event.Scale = Scale;
+        Event.RotationDegrees = PairRotation;
+        Event.RotationDelta = PairRotation - LastReportedRotation;
+        Event.Duration = Duration;
+        LastReportedRotation = PairRotation;
+    }
+}
+
+FRLOGestureEvent& FRLOGestureRecognizer::AddEvent(TArray<FRLOGestureEvent>& OutEvents, ERLOGestureType Type, double Timestamp) const
+{
+    FRLOGestureEvent& Event = OutEvents.AddDefaulted_GetRef();
+    Event.Type = Type;
+    Event.Timestamp = Timestamp;
+    Event.PointerCount = ActivePointerCount;
+    return Event;
+}
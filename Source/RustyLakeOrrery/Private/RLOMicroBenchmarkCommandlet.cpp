@@ -0,0 +1,376 @@
+// RLOMicroBenchmarkCommandlet.cpp
+
+#include "RLOMicroBenchmarkCommandlet.h"
+#include "RustyLakeOrrery.h"
+#include "RLOBenchmarkCommandlet.h"
+#include "DialogueDataAsset.h"
+#include "InventoryComponent.h"
+#include "ItemDataAsset.h"
+#include "InteractableComponent.h"
+#include "PuzzleComponent.h"
+#include "RotationPuzzle.h"
+#include "UIManager.h"
+#include "Dom/JsonObject.h"
+#include "Engine/World.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace
+{
+    /** 基线配置所在的节 */
+    const TCHAR* BaselineSection = TEXT("RLO.MicroBenchmarkBaselines");
+
+    /** 相对发行数据规模的倍数 */
+    const int32 Scales[] = { 10, 100, 1000 };
+
+    /**
+     * @brief 重复运行并返回最短耗时（毫秒），Setup 不计时
+     */
+    template <typename SetupType, typename BodyType>
+    double MeasureBestMs(int32 Repeats, SetupType&& Setup, BodyType&& Body)
+    {
+        double BestMs = TNumericLimits<double>::Max();
+        for (int32 Run = 0; Run < Repeats; Run++)
+        {
+            Setup();
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+            Body();
+            BestMs = FMath::Min(BestMs, FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+        }
+        return BestMs;
+    }
+
+    FName MakeIndexedName(const TCHAR* Prefix, int32 Index)
+    {
+        return FName(*FString::Printf(TEXT("%s_%d"), Prefix, Index));
+    }
+}
+
+URLOMicroBenchmarkCommandlet::URLOMicroBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsEditor = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 URLOMicroBenchmarkCommandlet::Main(const FString& Params)
+{
+    FParse::Value(*Params, TEXT("Repeats="), Repeats);
+    Repeats = FMath::Max(Repeats, 1);
+
+    FString Filter;
+    FParse::Value(*Params, TEXT("Filter="), Filter);
+
+    FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks/RLOMicroBenchmarks.json");
+    FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+    float Tolerance = 0.25f;
+    float AbsoluteToleranceMs = 0.1f;
+    GConfig->GetFloat(BaselineSection, TEXT("Tolerance"), Tolerance, GGameIni);
+    GConfig->GetFloat(BaselineSection, TEXT("AbsoluteToleranceMs"), AbsoluteToleranceMs, GGameIni);
+
+    const FRLOScopedBenchmarkLogs ScopedLogs(FParse::Param(*Params, TEXT("KeepLogs")));
+
+    struct FBenchmark
+    {
+        const TCHAR* Name;
+
+        /** 发行数据中对应的规模（每章对话约40条、物品约11个、一次滑动约100个采样、多部件谜题约4个部件、每帧约10次UI查找） */
+        int32 ShippedSize;
+
+        FBenchmarkFunction Function;
+    };
+
+    const FBenchmark Benchmarks[] =
+    {
+        { TEXT("DialogueLookup"), 40, &URLOMicroBenchmarkCommandlet::RunDialogueLookup },
+#if WITH_EDITOR
+        // CSV导入只在编辑器中可用，-game 或打包版本中不计入
+        { TEXT("DialogueCSVImport"), 40, &URLOMicroBenchmarkCommandlet::RunDialogueCSVImport },
+#endif
+        { TEXT("InventoryOperations"), 11, &URLOMicroBenchmarkCommandlet::RunInventoryOperations },
+        { TEXT("SwipeValidation"), 100, &URLOMicroBenchmarkCommandlet::RunSwipeValidation },
+        { TEXT("PuzzleCompletion"), 4, &URLOMicroBenchmarkCommandlet::RunPuzzleCompletion },
+        { TEXT("UIManagerLookup"), 10, &URLOMicroBenchmarkCommandlet::RunUIManagerLookup },
+    };
+
+    World = URLOBenchmarkCommandlet::CreateBenchmarkWorld();
+    if (!World)
+    {
+        UE_LOG(LogRLO, Error, TEXT("RLOMicroBenchmark: Failed to create benchmark world"));
+        return 1;
+    }
+
+    bool bAllPassed = true;
+    TArray<TSharedPtr<FJsonValue>> Results;
+    FString MeasuredBaselines = FString::Printf(TEXT("[%s]\n"), BaselineSection);
+
+    for (const FBenchmark& Benchmark : Benchmarks)
+    {
+        if (!Filter.IsEmpty() && !FCString::Stristr(Benchmark.Name, *Filter))
+        {
+            continue;
+        }
+
+        for (const int32 Scale : Scales)
+        {
+            const FString Key = FString::Printf(TEXT("%s_x%d"), Benchmark.Name, Scale);
+            const int32 Size = Benchmark.ShippedSize * Scale;
+
+            double Ms = 0.0;
+            const bool bChecksPassed = (this->*Benchmark.Function)(Size, Ms);
+
+            float BaselineMs = 0.0f;
+            const bool bHasBaseline = GConfig->GetFloat(BaselineSection, *Key, BaselineMs, GGameIni);
+            const bool bWithinBaseline = !bHasBaseline || Ms <= BaselineMs * (1.0f + Tolerance) + AbsoluteToleranceMs;
+            const bool bPassed = bChecksPassed && bWithinBaseline;
+            bAllPassed &= bPassed;
+
+            UE_LOG(LogRLO, Display, TEXT("RLOMicroBenchmark: %-28s size %7d  %10.3f ms  baseline %s  %s"),
+                   *Key, Size, Ms, bHasBaseline ? *FString::Printf(TEXT("%.3f ms"), BaselineMs) : TEXT("none"),
+                   !bChecksPassed ? TEXT("CHECK FAILED") : (bWithinBaseline ? TEXT("ok") : TEXT("REGRESSED")));
+
+            MeasuredBaselines += FString::Printf(TEXT("%s=%.3f\n"), *Key, Ms);
+
+            TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+            Result->SetStringField(TEXT("name"), Benchmark.Name);
+            Result->SetNumberField(TEXT("scale"), Scale);
+            Result->SetNumberField(TEXT("size"), Size);
+            Result->SetNumberField(TEXT("ms"), Ms);
+            if (bHasBaseline)
+            {
+                Result->SetNumberField(TEXT("baseline_ms"), BaselineMs);
+            }
+            Result->SetBoolField(TEXT("checks_passed"), bChecksPassed);
+            Result->SetBoolField(TEXT("passed"), bPassed);
+            Results.Add(MakeShared<FJsonValueObject>(Result));
+        }
+    }
+
+    URLOBenchmarkCommandlet::DestroyBenchmarkWorld(World);
+    World = nullptr;
+
+    TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+    Root->SetNumberField(TEXT("repeats"), Repeats);
+    Root->SetNumberField(TEXT("tolerance"), Tolerance);
+    Root->SetArrayField(TEXT("results"), Results);
+    Root->SetBoolField(TEXT("passed"), bAllPassed);
+
+    FString Json;
+    FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&Json));
+    if (!FFileHelper::SaveStringToFile(Json, *OutputPath))
+    {
+        UE_LOG(LogRLO, Error, TEXT("RLOMicroBenchmark: Failed to write %s"), *OutputPath);
+        bAllPassed = false;
+    }
+
+    UE_LOG(LogRLO, Display, TEXT("RLOMicroBenchmark: Measured baselines on this machine:\n%s"), *MeasuredBaselines);
+    UE_LOG(LogRLO, Display, TEXT("RLOMicroBenchmark: %s"), bAllPassed ? TEXT("PASSED") : TEXT("FAILED"));
+    return bAllPassed ? 0 : 1;
+}
+
+bool URLOMicroBenchmarkCommandlet::RunDialogueLookup(int32 Size, double& OutMs)
+{
+    UDialogueDataAsset* Asset = NewObject<UDialogueDataAsset>(GetTransientPackage());
+    TArray<FName> IDs;
+    TArray<FName> Triggers;
+    for (int32 Index = 0; Index < Size; Index++)
+    {
+        FDialogueEntry& Entry = Asset->DialogueEntries.AddDefaulted_GetRef();
+        Entry.DialogueID = MakeIndexedName(TEXT("Line"), Index);
+        Entry.TriggerEvent = MakeIndexedName(TEXT("OnTrigger"), Index);
+        IDs.Add(Entry.DialogueID);
+        Triggers.Add(Entry.TriggerEvent);
+    }
+    Asset->RebuildLookupIndex();
+
+    int32 Found = 0;
+    OutMs = MeasureBestMs(Repeats, [&Found]() { Found = 0; }, [&]()
+    {
+        for (int32 Index = 0; Index < Size; Index++)
+        {
+            Found += Asset->FindDialogueEntry(IDs[Index]) != nullptr;
+            Found += Asset->FindDialogueByTrigger(Triggers[Index]) != nullptr;
+        }
+    });
+
+    return Found == Size * 2 || Fail(TEXT("DialogueLookup"), TEXT("timed pass missed entries"));
+}
+
+#if WITH_EDITOR
+bool URLOMicroBenchmarkCommandlet::RunDialogueCSVImport(int32 Size, double& OutMs)
+{
+    // 与发行表格相同的表头和引号、逗号写法
+    FString CSV = TEXT("RowName,DialogueID,Speaker,SpeakerEN,DialogueText,DialogueTextEN,TriggerEvent,DialogueType,AudioPath,Duration\n");
+    for (int32 Index = 0; Index < Size; Index++)
+    {
+        CSV += FString::Printf(TEXT("%d,Line_%d,主角,Protagonist,\"第%d句,星盘缓缓转动。\",\"Line %d, the orrery slowly turns.\",OnTrigger_%d,Monologue,/Game/Audio/VO/Line_%d,3.0\n"),
+                               Index + 1, Index, Index, Index, Index, Index);
+    }
+
+    const FString FilePath = FPaths::ProjectSavedDir() / FString::Printf(TEXT("Benchmarks/Dialogue_%d.csv"), Size);
+    if (!FFileHelper::SaveStringToFile(CSV, *FilePath, FFileHelper::EEncodingOptions::ForceUTF8))
+    {
+        return Fail(TEXT("DialogueCSVImport"), FString::Printf(TEXT("cannot write %s"), *FilePath));
+    }
+
+    UDialogueDataAsset* Asset = nullptr;
+    bool bImported = true;
+    OutMs = MeasureBestMs(Repeats, [&]() { Asset = NewObject<UDialogueDataAsset>(GetTransientPackage()); }, [&]()
+    {
+        bImported &= Asset->ImportFromCSV(FilePath);
+    });
+
+    if (!bImported || Asset->DialogueEntries.Num() != Size)
+    {
+        return Fail(TEXT("DialogueCSVImport"), FString::Printf(TEXT("imported %d of %d rows"), Asset->DialogueEntries.Num(), Size));
+    }
+
+    return true;
+}
+#endif
+
+bool URLOMicroBenchmarkCommandlet::RunInventoryOperations(int32 Size, double& OutMs)
+{
+    TArray<UItemDataAsset*> Items;
+    for (int32 Index = 0; Index < Size; Index++)
+    {
+        UItemDataAsset* Item = NewObject<UItemDataAsset>(GetTransientPackage());
+        Item->ItemID = MakeIndexedName(TEXT("BenchItem"), Index);
+        Item->ItemName = FText::FromString(Item->ItemID.ToString());
+        Items.Add(Item);
+    }
+
+    auto CreateInventory = [this, Size]()
+    {
+        UInventoryComponent* Inventory = NewObject<UInventoryComponent>(GetTransientPackage());
+        Inventory->MaxCapacity = Size;
+        Inventory->bPlayPickupSound = false;
+        return Inventory;
+    };
+
+    UInventoryComponent* Inventory = nullptr;
+
+    // 计时：按拾取顺序添加、查找、移除（从最早的槽位开始移除，后面的槽位都要前移）
+    int32 Found = 0;
+    OutMs = MeasureBestMs(Repeats, [&]() { Inventory = CreateInventory(); Found = 0; }, [&]()
+    {
+        for (UItemDataAsset* Item : Items)
+        {
+            Inventory->AddItem(Item, 1);
+        }
+        for (UItemDataAsset* Item : Items)
+        {
+            Found += Inventory->FindItemByID(Item->ItemID) == Item;
+        }
+        for (UItemDataAsset* Item : Items)
+        {
+            Inventory->RemoveItem(Item, 1);
+        }
+    });
+
+    if (Found != Size || !Inventory->IsEmpty())
+    {
+        return Fail(TEXT("InventoryOperations"), TEXT("timed pass left the inventory inconsistent"));
+    }
+    return true;
+}
+
+bool URLOMicroBenchmarkCommandlet::RunSwipeValidation(int32 Size, double& OutMs)
+{
+    UInteractableComponent* Interactable = NewObject<UInteractableComponent>(GetTransientPackage());
+    Interactable->MinSwipeDistance = 50.0f;
+    Interactable->SwipeAngleTolerance = 30.0f;
+
+    FRandomStream Stream(Size);
+    TArray<FVector2D> Vectors;
+    Vectors.Reserve(Size);
+    for (int32 Index = 0; Index < Size; Index++)
+    {
+        const float Angle = Stream.FRandRange(0.0f, 2.0f * PI);
+        const float Length = Stream.FRandRange(0.0f, 200.0f);
+        Vectors.Add(FVector2D(FMath::Cos(Angle), FMath::Sin(Angle)) * Length);
+    }
+
+    Interactable->RequiredSwipeDirection = ESwipeDirection::Right;
+    int32 NumValid = 0;
+    OutMs = MeasureBestMs(Repeats, [&NumValid]() { NumValid = 0; }, [&]()
+    {
+        for (const FVector2D& Vector : Vectors)
+        {
+            NumValid += Interactable->IsSwipeDirectionValid(Vector);
+        }
+    });
+
+    // 约 1/6 的方向 × 3/4 的长度满足条件
+    return (NumValid > 0 && NumValid < Size) || Fail(TEXT("SwipeValidation"), FString::Printf(TEXT("%d of %d random swipes valid"), NumValid, Size));
+}
+
+bool URLOMicroBenchmarkCommandlet::RunPuzzleCompletion(int32 Size, double& OutMs)
+{
+    ARotationPuzzle* Puzzle = nullptr;
+    TArray<UPuzzleComponent*> Parts;
+
+    auto CreatePuzzle = [&]()
+    {
+        if (Puzzle)
+        {
+            Puzzle->Destroy();
+        }
+
+        Puzzle = World->SpawnActor<ARotationPuzzle>();
+        Parts.Reset(Size);
+        for (int32 Index = 0; Index < Size; Index++)
+        {
+            UPuzzleComponent* Part = NewObject<UPuzzleComponent>(Puzzle, MakeIndexedName(TEXT("Part"), Index));
+            Part->RegisterComponent();
+            Part->SetPuzzleActor(Puzzle);
+            Parts.Add(Part);
+        }
+        Puzzle->ActivatePuzzle();
+    };
+
+    OutMs = MeasureBestMs(Repeats, CreatePuzzle, [&]()
+    {
+        for (UPuzzleComponent* Part : Parts)
+        {
+            Part->CompleteComponent();
+        }
+    });
+
+    const bool bCompleted = Puzzle->IsCompleted();
+    Puzzle->Destroy();
+    return bCompleted || Fail(TEXT("PuzzleCompletion"), TEXT("timed pass did not complete the puzzle"));
+}
+
+bool URLOMicroBenchmarkCommandlet::RunUIManagerLookup(int32 Size, double& OutMs)
+{
+    AUIManager* Manager = World->SpawnActor<AUIManager>();
+    if (AUIManager::GetUIManager(World) != Manager)
+    {
+        Manager->Destroy();
+        return Fail(TEXT("UIManagerLookup"), TEXT("spawned UIManager was not registered"));
+    }
+
+    int32 NumFound = 0;
+    OutMs = MeasureBestMs(Repeats, [&]() { NumFound = 0; }, [&]()
+    {
+        for (int32 Index = 0; Index < Size; Index++)
+        {
+            NumFound += AUIManager::GetUIManager(Manager) == Manager ? 1 : 0;
+        }
+    });
+
+    Manager->Destroy();
+    return NumFound == Size || Fail(TEXT("UIManagerLookup"), TEXT("timed lookups returned the wrong UIManager"));
+}
+
+bool URLOMicroBenchmarkCommandlet::Fail(const TCHAR* Benchmark, const FString& Message)
+{
+    UE_LOG(LogRLO, Error, TEXT("RLOMicroBenchmark: %s: %s"), Benchmark, *Message);
+    return false;
+}
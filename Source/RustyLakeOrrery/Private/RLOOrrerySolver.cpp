@@ -0,0 +1,523 @@
+// RLOOrrerySolver.cpp
+
+#include "RLOOrrerySolver.h"
+
+namespace
+{
+    /** 先只搜索每一半操作数不超过此值的组合,接近完成时无需完整枚举 */
+    constexpr int32 InitialCostBudget = 12;
+
+    constexpr uint64 EmptyKey = MAX_uint64;
+
+    int32 PositiveMod(int64 Value, int32 Modulus)
+    {
+        const int32 Result = static_cast<int32>(Value % Modulus);
+        return Result < 0 ? Result + Modulus : Result;
+    }
+
+    int64 GreatestCommonDivisor(int64 A, int64 B)
+    {
+        while (B != 0)
+        {
+            const int64 Remainder = A % B;
+            A = B;
+            B = Remainder;
+        }
+        return A;
+    }
+
+    /**
+     * @brief 打包状态的逐环模加
+     *
+     * 每环占8位,值小于 NumSteps(≤64),两值之和小于128;
+     * 加上 128-NumSteps 后第7位为1表示和 ≥ NumSteps,需要减去 NumSteps。
+     */
+    struct FPackedSteps
+    {
+        uint64 Moduli = 0;
+        uint64 Bias = 0;
+
+        static constexpr uint64 HighBits = 0x8080808080808080ull;
+
+        explicit FPackedSteps(const TArray<int32>& NumSteps)
+        {
+            for (int32 Ring = 0; Ring < NumSteps.Num(); Ring++)
+            {
+                Moduli |= static_cast<uint64>(NumSteps[Ring]) << (8 * Ring);
+                Bias |= static_cast<uint64>(128 - NumSteps[Ring]) << (8 * Ring);
+            }
+        }
+
+        FORCEINLINE uint64 Add(uint64 A, uint64 B) const
+        {
+            const uint64 Sum = A + B;
+            const uint64 Overflow = (((Sum + Bias) & HighBits) >> 7) * 0xFF;
+            return Sum - (Overflow & Moduli);
+        }
+
+        FORCEINLINE uint64 Subtract(uint64 A, uint64 B) const
+        {
+            // NumSteps - B 在 (0, NumSteps] 内,和仍小于128
+            return Add(A, Moduli - B);
+        }
+    };
+
+    /** 分到同一半的环和它们可能的转动次数 */
+    struct FSearchHalf
+    {
+        TArray<int32> Rings;
+
+        /** 每个环的转动次数,按绝对值升序,剪枝依赖这个顺序 */
+        TArray<TArray<int32>> Turns;
+
+        /** 每个转动次数对应的打包状态偏移 */
+        TArray<TArray<uint64>> Offsets;
+
+        uint64 NumCombinations = 1;
+        int32 MaxCost = 0;
+    };
+
+    /**
+     * @brief 深度优先枚举一半的转动组合,跳过操作数超过 MaxCost 的组合
+     * @param Visitor (uint64 State, int32 Cost, const TArray<int32>& TurnIndices)
+     */
+    template <typename VisitorType>
+    void EnumerateHalf(const FSearchHalf& Half, const FPackedSteps& Packed, int32 MaxCost, int32 Digit, uint64 State, int32 Cost,
+                       TArray<int32>& TurnIndices, VisitorType& Visitor)
+    {
+        if (Digit < 0)
+        {
+            Visitor(State, Cost, TurnIndices);
+            return;
+        }
+
+        const int32* Turns = Half.Turns[Digit].GetData();
+        const uint64* Offsets = Half.Offsets[Digit].GetData();
+        const int32 NumTurns = Half.Turns[Digit].Num();
+        for (int32 Index = 0; Index < NumTurns; Index++)
+        {
+            const int32 NewCost = Cost + FMath::Abs(Turns[Index]);
+            if (NewCost > MaxCost)
+            {
+                break;
+            }
+
+            TurnIndices[Digit] = Index;
+            EnumerateHalf(Half, Packed, MaxCost, Digit - 1, Packed.Add(State, Offsets[Index]), NewCost, TurnIndices, Visitor);
+        }
+    }
+
+    template <typename VisitorType>
+    void EnumerateHalf(const FSearchHalf& Half, const FPackedSteps& Packed, int32 MaxCost, VisitorType&& Visitor)
+    {
+        TArray<int32> TurnIndices;
+        TurnIndices.SetNumZeroed(Half.Rings.Num());
+        EnumerateHalf(Half, Packed, MaxCost, Half.Rings.Num() - 1, 0, 0, TurnIndices, Visitor);
+    }
+
+    /** 状态偏移 → 达到它的最少操作数,线性探测 */
+    class FOffsetTable
+    {
+    public:
+        void Reset(uint64 NumEntries)
+        {
+            const uint64 Capacity = FMath::RoundUpToPowerOfTwo64(FMath::Max<uint64>(NumEntries + NumEntries / 2, 16));
+            Shift = 64 - FMath::FloorLog2_64(Capacity);
+            Mask = Capacity - 1;
+            Keys.Init(EmptyKey, static_cast<int32>(Capacity));
+            Costs.SetNumUninitialized(static_cast<int32>(Capacity));
+        }
+
+        FORCEINLINE void AddMin(uint64 Key, int32 Cost)
+        {
+            for (uint64 Slot = Hash(Key);; Slot = (Slot + 1) & Mask)
+            {
+                if (Keys[Slot] == EmptyKey)
+                {
+                    Keys[Slot] = Key;
+                    Costs[Slot] = Cost;
+                    return;
+                }
+                if (Keys[Slot] == Key)
+                {
+                    Costs[Slot] = FMath::Min(Costs[Slot], Cost);
+                    return;
+                }
+            }
+        }
+
+        /** @return 最少操作数,不存在时返回-1 */
+        FORCEINLINE int32 Find(uint64 Key) const
+        {
+            for (uint64 Slot = Hash(Key);; Slot = (Slot + 1) & Mask)
+            {
+                if (Keys[Slot] == Key)
+                {
+                    return Costs[Slot];
+                }
+                if (Keys[Slot] == EmptyKey)
+                {
+                    return -1;
+                }
+            }
+        }
+
+    private:
+        FORCEINLINE uint64 Hash(uint64 Key) const
+        {
+            return (Key * 0x9E3779B97F4A7C15ull) >> Shift;
+        }
+
+        TArray<uint64> Keys;
+        TArray<int32> Costs;
+        int32 Shift = 64;
+        uint64 Mask = 0;
+    };
+
+    /**
+     * @brief 广度优先搜索状态偏移空间(状态数较少时)
+     *
+     * 操作可交换且与起点无关,从零偏移搜索到目标偏移即可。
+     */
+    ERLOOrrerySolveResult SolveBreadthFirst(const FRLOOrreryDefinition& Definition, const FPackedSteps& Packed, uint64 Target, int32 NumStates,
+                                            TArray<int32>& OutTurns, int32& OutNumMoves)
+    {
+        const int32 NumRings = Definition.GetNumRings();
+
+        struct FMove
+        {
+            int32 Ring;
+            int32 Direction;
+            uint64 Offset;
+        };
+        TArray<FMove> Moves;
+        for (int32 Ring = 0; Ring < NumRings; Ring++)
+        {
+            if (!Definition.Turnable[Ring])
+            {
+                continue;
+            }
+
+            uint64 Offset = 0;
+            for (int32 Other = 0; Other < NumRings; Other++)
+            {
+                Offset |= static_cast<uint64>(PositiveMod(Definition.Coupling[Ring * NumRings + Other], Definition.NumSteps[Other])) << (8 * Other);
+            }
+            if (Offset == 0)
+            {
+                continue;
+            }
+
+            Moves.Add({ Ring, 1, Offset });
+            if (Definition.bAllowReverse)
+            {
+                Moves.Add({ Ring, -1, Packed.Subtract(0, Offset) });
+            }
+        }
+
+        int32 Radix[FRLOOrrerySolver::MaxRings];
+        int32 StateCount = 1;
+        for (int32 Ring = 0; Ring < NumRings; Ring++)
+        {
+            Radix[Ring] = StateCount;
+            StateCount *= Definition.NumSteps[Ring];
+        }
+
+        auto ToIndex = [&Radix, NumRings](uint64 State)
+        {
+            int32 Index = 0;
+            for (int32 Ring = 0; Ring < NumRings; Ring++)
+            {
+                Index += static_cast<int32>((State >> (8 * Ring)) & 0xFF) * Radix[Ring];
+            }
+            return Index;
+        };
+
+        // 到达每个状态的最后一步,未访问为-1
+        TArray<int8> ReachedBy;
+        ReachedBy.Init(-1, NumStates);
+        ReachedBy[0] = static_cast<int8>(Moves.Num());
+
+        TArray<uint64> Queue;
+        Queue.Add(0);
+        for (int32 Head = 0; Head < Queue.Num(); Head++)
+        {
+            const uint64 State = Queue[Head];
+            for (int32 MoveIndex = 0; MoveIndex < Moves.Num(); MoveIndex++)
+            {
+                const uint64 Next = Packed.Add(State, Moves[MoveIndex].Offset);
+                int8& NextReachedBy = ReachedBy[ToIndex(Next)];
+                if (NextReachedBy >= 0)
+                {
+                    continue;
+                }
+                NextReachedBy = static_cast<int8>(MoveIndex);
+
+                if (Next == Target)
+                {
+                    for (uint64 PathState = Target; PathState != 0; OutNumMoves++)
+                    {
+                        const FMove& Move = Moves[ReachedBy[ToIndex(PathState)]];
+                        OutTurns[Move.Ring] += Move.Direction;
+                        PathState = Packed.Subtract(PathState, Move.Offset);
+                    }
+                    return ERLOOrrerySolveResult::Solved;
+                }
+                Queue.Add(Next);
+            }
+        }
+
+        return ERLOOrrerySolveResult::Unsolvable;
+    }
+
+    /**
+     * @brief 在各环转动次数上中间相遇(状态数较多时)
+     */
+    ERLOOrrerySolveResult SolveMeetInTheMiddle(const FRLOOrreryDefinition& Definition, const FPackedSteps& Packed, uint64 Target,
+                                               TArray<int32>& OutTurns, int32& OutNumMoves)
+    {
+        const int32 NumRings = Definition.GetNumRings();
+
+        // 每个可转动的环转动 Order 次后回到原状态,只需枚举 Order 种转动次数
+        struct FRingOrder
+        {
+            int32 Ring;
+            int64 Order;
+        };
+        TArray<FRingOrder> Orders;
+        for (int32 Ring = 0; Ring < NumRings; Ring++)
+        {
+            if (!Definition.Turnable[Ring])
+            {
+                continue;
+            }
+
+            int64 Order = 1;
+            for (int32 Other = 0; Other < NumRings; Other++)
+            {
+                const int32 Steps = Definition.NumSteps[Other];
+                const int64 Period = Steps / GreatestCommonDivisor(PositiveMod(Definition.Coupling[Ring * NumRings + Other], Steps), Steps);
+                Order = Order / GreatestCommonDivisor(Order, Period) * Period;
+                if (Order > static_cast<int64>(FRLOOrrerySolver::MaxCombinationsPerHalf))
+                {
+                    return ERLOOrrerySolveResult::TooLarge;
+                }
+            }
+
+            // 转动后不改变任何环的操作没有意义
+            if (Order > 1)
+            {
+                Orders.Add({ Ring, Order });
+            }
+        }
+
+        // 按周期从大到小放进组合数较少的一半,使两半大小接近
+        Orders.Sort([](const FRingOrder& A, const FRingOrder& B) { return A.Order > B.Order; });
+
+        FSearchHalf Halves[2];
+        for (const FRingOrder& RingOrder : Orders)
+        {
+            FSearchHalf& Half = Halves[0].NumCombinations <= Halves[1].NumCombinations ? Halves[0] : Halves[1];
+            Half.NumCombinations *= RingOrder.Order;
+            if (Half.NumCombinations > FRLOOrrerySolver::MaxCombinationsPerHalf)
+            {
+                return ERLOOrrerySolveResult::TooLarge;
+            }
+
+            TArray<int32>& Turns = Half.Turns.AddDefaulted_GetRef();
+            Turns.Reserve(static_cast<int32>(RingOrder.Order));
+            Turns.Add(0);
+            for (int32 Count = 1; Turns.Num() < RingOrder.Order; Count++)
+            {
+                Turns.Add(Count);
+                if (Definition.bAllowReverse && Turns.Num() < RingOrder.Order)
+                {
+                    Turns.Add(-Count);
+                }
+            }
+
+            TArray<uint64>& Offsets = Half.Offsets.AddDefaulted_GetRef();
+            Offsets.Reserve(Turns.Num());
+            for (const int32 Turn : Turns)
+            {
+                uint64 Offset = 0;
+                for (int32 Other = 0; Other < NumRings; Other++)
+                {
+                    const int64 Steps = static_cast<int64>(Turn) * Definition.Coupling[RingOrder.Ring * NumRings + Other];
+                    Offset |= static_cast<uint64>(PositiveMod(Steps, Definition.NumSteps[Other])) << (8 * Other);
+                }
+                Offsets.Add(Offset);
+            }
+
+            Half.Rings.Add(RingOrder.Ring);
+            Half.MaxCost += FMath::Abs(Turns.Last());
+        }
+
+        // 较小的一半建表,另一半查找
+        const FSearchHalf& TableHalf = Halves[0].NumCombinations <= Halves[1].NumCombinations ? Halves[0] : Halves[1];
+        const FSearchHalf& ProbeHalf = &TableHalf == &Halves[0] ? Halves[1] : Halves[0];
+        const int32 MaxCost = FMath::Max(TableHalf.MaxCost, ProbeHalf.MaxCost);
+
+        FOffsetTable Table;
+        int32 Budget = FMath::Min(InitialCostBudget, MaxCost);
+        for (;;)
+        {
+            uint64 NumEntries = TableHalf.NumCombinations;
+            if (Budget < TableHalf.MaxCost)
+            {
+                NumEntries = 0;
+                EnumerateHalf(TableHalf, Packed, Budget, [&NumEntries](uint64, int32, const TArray<int32>&) { NumEntries++; });
+            }
+
+            Table.Reset(NumEntries);
+            EnumerateHalf(TableHalf, Packed, Budget, [&Table](uint64 State, int32 Cost, const TArray<int32>&)
+            {
+                Table.AddMin(State, Cost);
+            });
+
+            int32 BestCost = MAX_int32;
+            int32 BestTableCost = 0;
+            uint64 BestTableState = 0;
+            TArray<int32> BestProbeTurns;
+            EnumerateHalf(ProbeHalf, Packed, Budget, [&](uint64 State, int32 Cost, const TArray<int32>& TurnIndices)
+            {
+                if (Cost >= BestCost)
+                {
+                    return;
+                }
+
+                const uint64 Needed = Packed.Subtract(Target, State);
+                const int32 TableCost = Table.Find(Needed);
+                if (TableCost >= 0 && TableCost + Cost < BestCost)
+                {
+                    BestCost = TableCost + Cost;
+                    BestTableCost = TableCost;
+                    BestTableState = Needed;
+                    BestProbeTurns = TurnIndices;
+                }
+            });
+
+            // 更优的解每一半的操作数都不超过 BestCost-1,在预算内时已经被枚举到
+            const bool bExhaustive = Budget >= MaxCost;
+            if (BestCost != MAX_int32 && (BestCost - 1 <= Budget || bExhaustive))
+            {
+                // 表中只存了操作数,再枚举一次找出对应的转动次数
+                TArray<int32> BestTableTurns;
+                EnumerateHalf(TableHalf, Packed, BestTableCost, [&](uint64 State, int32 Cost, const TArray<int32>& TurnIndices)
+                {
+                    if (BestTableTurns.Num() == 0 && Cost == BestTableCost && State == BestTableState)
+                    {
+                        BestTableTurns = TurnIndices;
+                    }
+                });
+                check(BestTableTurns.Num() == TableHalf.Rings.Num());
+
+                for (int32 Digit = 0; Digit < TableHalf.Rings.Num(); Digit++)
+                {
+                    OutTurns[TableHalf.Rings[Digit]] = TableHalf.Turns[Digit][BestTableTurns[Digit]];
+                }
+                for (int32 Digit = 0; Digit < ProbeHalf.Rings.Num(); Digit++)
+                {
+                    OutTurns[ProbeHalf.Rings[Digit]] = ProbeHalf.Turns[Digit][BestProbeTurns[Digit]];
+                }
+                OutNumMoves = BestCost;
+                return ERLOOrrerySolveResult::Solved;
+            }
+
+            if (bExhaustive)
+            {
+                return ERLOOrrerySolveResult::Unsolvable;
+            }
+            Budget = MaxCost;
+        }
+    }
+}
+
+bool FRLOOrrerySolver::Validate(const FRLOOrreryDefinition& Definition, FString* OutError)
+{
+    auto Fail = [OutError](const FString& Error)
+    {
+        if (OutError)
+        {
+            *OutError = Error;
+        }
+        return false;
+    };
+
+    const int32 NumRings = Definition.GetNumRings();
+    if (NumRings < 1 || NumRings > MaxRings)
+    {
+        return Fail(FString::Printf(TEXT("ring count %d is outside 1..%d"), NumRings, MaxRings));
+    }
+    if (Definition.Coupling.Num() != NumRings * NumRings || Definition.Turnable.Num() != NumRings)
+    {
+        return Fail(TEXT("coupling matrix or turnable flags do not match the ring count"));
+    }
+    for (int32 Ring = 0; Ring < NumRings; Ring++)
+    {
+        if (Definition.NumSteps[Ring] < 2 || Definition.NumSteps[Ring] > MaxSteps)
+        {
+            return Fail(FString::Printf(TEXT("ring %d has %d steps, expected 2..%d"), Ring, Definition.NumSteps[Ring], MaxSteps));
+        }
+    }
+    return true;
+}
+
+ERLOOrrerySolveResult FRLOOrrerySolver::Solve(const FRLOOrreryDefinition& Definition, const TArray<int32>& FromSteps, const TArray<int32>& ToSteps,
+                                              TArray<int32>& OutTurns, int32& OutNumMoves, ERLOOrrerySolveMethod Method)
+{
+    OutNumMoves = 0;
+
+    const int32 NumRings = Definition.GetNumRings();
+    if (!Validate(Definition) || FromSteps.Num() != NumRings || ToSteps.Num() != NumRings)
+    {
+        return ERLOOrrerySolveResult::InvalidDefinition;
+    }
+
+    OutTurns.Init(0, NumRings);
+
+    const FPackedSteps Packed(Definition.NumSteps);
+    uint64 Target = 0;
+    uint64 NumStates = 1;
+    for (int32 Ring = 0; Ring < NumRings; Ring++)
+    {
+        Target |= static_cast<uint64>(PositiveMod(static_cast<int64>(ToSteps[Ring]) - FromSteps[Ring], Definition.NumSteps[Ring])) << (8 * Ring);
+        NumStates *= Definition.NumSteps[Ring];
+    }
+    if (Target == 0)
+    {
+        return ERLOOrrerySolveResult::Solved;
+    }
+
+    if (Method == ERLOOrrerySolveMethod::Auto)
+    {
+        Method = NumStates <= MaxBreadthFirstStates ? ERLOOrrerySolveMethod::BreadthFirst : ERLOOrrerySolveMethod::MeetInTheMiddle;
+    }
+
+    if (Method == ERLOOrrerySolveMethod::BreadthFirst)
+    {
+        if (NumStates > MaxBreadthFirstStates)
+        {
+            return ERLOOrrerySolveResult::TooLarge;
+        }
+        return SolveBreadthFirst(Definition, Packed, Target, static_cast<int32>(NumStates), OutTurns, OutNumMoves);
+    }
+    return SolveMeetInTheMiddle(Definition, Packed, Target, OutTurns, OutNumMoves);
+}
+
+const TCHAR* FRLOOrrerySolver::GetResultName(ERLOOrrerySolveResult Result)
+{
+    switch (Result)
+    {
+        case ERLOOrrerySolveResult::Solved:
+            return TEXT("Solved");
+        case ERLOOrrerySolveResult::Unsolvable:
+            return TEXT("Unsolvable");
+        case ERLOOrrerySolveResult::InvalidDefinition:
+            return TEXT("InvalidDefinition");
+        case ERLOOrrerySolveResult::TooLarge:
+            return TEXT("TooLarge");
+        default:
+            return TEXT("Unknown");
+    }
+}
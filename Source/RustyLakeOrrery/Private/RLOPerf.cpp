@@ -0,0 +1,169 @@
+// RLOPerf.cpp
+
+#include "RLOPerf.h"
+#include "RustyLakeOrrery.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ConfigCacheIni.h"
+
+int32 FRLOPerf::ScopeDepth[static_cast<int32>(ERLOPerfSubsystem::Count)] = {};
+ERLOPerfSubsystem FRLOPerf::ActiveSubsystem = ERLOPerfSubsystem::Count;
+
+namespace
+{
+    constexpr int32 NumSubsystems = static_cast<int32>(ERLOPerfSubsystem::Count);
+
+    /** 预算配置所在的节 */
+    const TCHAR* BudgetSection = TEXT("RLO.Budgets");
+
+    /** 未配置时的默认预算（毫秒/帧，按60帧的16.6ms分配） */
+    constexpr float DefaultBudgetMs[NumSubsystems] = { 0.5f, 0.25f, 0.25f, 0.1f, 0.5f, 1.0f };
+
+    const TCHAR* SubsystemNames[NumSubsystems] = { TEXT("Interaction"), TEXT("Dialogue"), TEXT("Puzzle"), TEXT("Inventory"), TEXT("UI"), TEXT("Save") };
+
+    /** 单个子系统的累计值 */
+    struct FAccumulator
+    {
+        uint64 TotalCycles = 0;
+        uint64 FrameCycles = 0;
+        uint64 LastFrameCycles = 0;
+        uint64 PeakFrameCycles = 0;
+        uint64 NumCalls = 0;
+        uint64 Frame = 0;
+    };
+
+    FAccumulator Accumulators[NumSubsystems];
+
+    /** 统计窗口开始的帧 */
+    uint64 WindowStartFrame = 0;
+
+    /** 当前帧之前的帧已结束，把帧内耗时计入峰值和最近一帧 */
+    void RollFrame(FAccumulator& Accumulator)
+    {
+        if (Accumulator.Frame != GFrameCounter)
+        {
+            if (Accumulator.FrameCycles > 0)
+            {
+                Accumulator.LastFrameCycles = Accumulator.FrameCycles;
+                Accumulator.PeakFrameCycles = FMath::Max(Accumulator.PeakFrameCycles, Accumulator.FrameCycles);
+            }
+            Accumulator.FrameCycles = 0;
+            Accumulator.Frame = GFrameCounter;
+        }
+    }
+
+    FAutoConsoleCommand DumpBudgetsCommand(
+        TEXT("RLO.Budget.Dump"),
+        TEXT("Prints per-subsystem frame time (average, peak, last frame) against the budgets in [RLO.Budgets]. Pass 'reset' to restart the window."),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            FRLOPerf::DumpBudgets(*GLog);
+            if (Args.Contains(TEXT("reset")))
+            {
+                FRLOPerf::Reset();
+            }
+        }));
+
+    FAutoConsoleCommand ResetBudgetsCommand(
+        TEXT("RLO.Budget.Reset"),
+        TEXT("Restarts the per-subsystem frame time window used by RLO.Budget.Dump."),
+        FConsoleCommandDelegate::CreateStatic(&FRLOPerf::Reset));
+}
+
+void FRLOPerf::AddCycles(ERLOPerfSubsystem Subsystem, uint64 Cycles)
+{
+    check(IsInGameThread());
+
+    FAccumulator& Accumulator = Accumulators[static_cast<int32>(Subsystem)];
+    RollFrame(Accumulator);
+
+    Accumulator.TotalCycles += Cycles;
+    Accumulator.FrameCycles += Cycles;
+    Accumulator.NumCalls++;
+}
+
+FRLOPerf::FSubsystemStats FRLOPerf::GetStats(ERLOPerfSubsystem Subsystem)
+{
+    FAccumulator& Accumulator = Accumulators[static_cast<int32>(Subsystem)];
+    RollFrame(Accumulator);
+
+    // 当前帧尚未结束，峰值包含当前帧已累计的部分
+    const uint64 PeakCycles = FMath::Max(Accumulator.PeakFrameCycles, Accumulator.FrameCycles);
+
+    FSubsystemStats Stats;
+    Stats.AverageMs = FPlatformTime::ToMilliseconds64(Accumulator.TotalCycles) / static_cast<double>(GetNumFrames());
+    Stats.PeakMs = FPlatformTime::ToMilliseconds64(PeakCycles);
+    Stats.LastFrameMs = FPlatformTime::ToMilliseconds64(Accumulator.LastFrameCycles);
+    Stats.NumCalls = Accumulator.NumCalls;
+    Stats.BudgetMs = GetBudgetMs(Subsystem);
+    return Stats;
+}
+
+uint64 FRLOPerf::GetNumFrames()
+{
+    return FMath::Max<uint64>(GFrameCounter - WindowStartFrame + 1, 1);
+}
+
+const TCHAR* FRLOPerf::GetSubsystemName(ERLOPerfSubsystem Subsystem)
+{
+    const int32 Index = static_cast<int32>(Subsystem);
+    return Index < NumSubsystems ? SubsystemNames[Index] : TEXT("Unknown");
+}
+
+float FRLOPerf::GetBudgetMs(ERLOPerfSubsystem Subsystem)
+{
+    const int32 Index = static_cast<int32>(Subsystem);
+    float BudgetMs = DefaultBudgetMs[Index];
+    if (GConfig)
+    {
+        GConfig->GetFloat(BudgetSection, SubsystemNames[Index], BudgetMs, GGameIni);
+    }
+    return BudgetMs;
+}
+
+void FRLOPerf::Reset()
+{
+    for (FAccumulator& Accumulator : Accumulators)
+    {
+        Accumulator = FAccumulator();
+        Accumulator.Frame = GFrameCounter;
+    }
+    WindowStartFrame = GFrameCounter;
+}
+
+void FRLOPerf::DumpBudgets(FOutputDevice& Ar)
+{
+#if RLO_PERF_BUDGETS
+    Ar.Logf(TEXT("RLO budgets over %llu frames:"), GetNumFrames());
+    Ar.Logf(TEXT("  %-12s %10s %10s %10s %10s %10s"), TEXT("Subsystem"), TEXT("Avg ms"), TEXT("Peak ms"), TEXT("Last ms"), TEXT("Budget ms"), TEXT("Calls"));
+
+    for (int32 Index = 0; Index < NumSubsystems; Index++)
+    {
+        const ERLOPerfSubsystem Subsystem = static_cast<ERLOPerfSubsystem>(Index);
+        const FSubsystemStats Stats = GetStats(Subsystem);
+        Ar.Logf(TEXT("  %-12s %10.3f %10.3f %10.3f %10.3f %10llu%s"),
+                GetSubsystemName(Subsystem), Stats.AverageMs, Stats.PeakMs, Stats.LastFrameMs, Stats.BudgetMs, Stats.NumCalls,
+                Stats.PeakMs > Stats.BudgetMs ? TEXT("  OVER BUDGET") : TEXT(""));
+    }
+#else
+    Ar.Logf(TEXT("RLO budgets are not tracked in Shipping builds"));
+#endif
+}
+
+FRLOPerf::FScope::FScope(ERLOPerfSubsystem InSubsystem)
+    : Subsystem(InSubsystem)
+    , PreviousSubsystem(FRLOPerf::ActiveSubsystem)
+    , StartCycles(FPlatformTime::Cycles64())
+    , bOutermost(FRLOPerf::ScopeDepth[static_cast<int32>(InSubsystem)]++ == 0)
+{
+    FRLOPerf::ActiveSubsystem = InSubsystem;
+}
+
+FRLOPerf::FScope::~FScope()
+{
+    FRLOPerf::ActiveSubsystem = PreviousSubsystem;
+    FRLOPerf::ScopeDepth[static_cast<int32>(Subsystem)]--;
+    if (bOutermost)
+    {
+        FRLOPerf::AddCycles(Subsystem, FPlatformTime::Cycles64() - StartCycles);
+    }
+}
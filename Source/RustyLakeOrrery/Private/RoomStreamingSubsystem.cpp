@@ -0,0 +1,372 @@
+// RoomStreamingSubsystem.cpp
+
+#include "RoomStreamingSubsystem.h"
+#include "RustyLakeOrrery.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/Engine.h"
+#include "Engine/Level.h"
+#include "Engine/LevelStreaming.h"
+#include "Engine/LevelStreamingDynamic.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/PackageName.h"
+#include "TimerManager.h"
+
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Room Transition Latency (ms)"), STAT_RLO_RoomTransitionLatency, STATGROUP_RustyLakeOrrery);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Resident Rooms"), STAT_RLO_ResidentRooms, STATGROUP_RustyLakeOrrery);
+
+namespace
+{
+    /** 流式子关卡的房间名称（包名短名，去掉PIE前缀） */
+    FName GetStreamingLevelRoomName(const ULevelStreaming* StreamingLevel)
+    {
+        const FString ShortName = FPackageName::GetShortName(StreamingLevel->GetWorldAssetPackageName());
+        return FName(*UWorld::RemovePIEPrefix(ShortName));
+    }
+}
+
+URoomStreamingSubsystem* URoomStreamingSubsystem::Get(const UObject* WorldContextObject)
+{
+    UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+    return World ? World->GetSubsystem<URoomStreamingSubsystem>() : nullptr;
+}
+
+bool URoomStreamingSubsystem::PreloadRoom(FName RoomName)
+{
+    ULevelStreaming* Room = FindOrCreateRoom(RoomName);
+    if (!Room)
+    {
+        return false;
+    }
+
+    if (!Room->ShouldBeLoaded())
+    {
+        Room->SetShouldBeLoaded(true);
+        UE_LOG(LogRLO, Log, TEXT("RoomStreamingSubsystem: Preloading room %s"), *RoomName.ToString());
+    }
+
+    TouchRoom(RoomName);
+    EnforceResidentLimit();
+    return true;
+}
+
+bool URoomStreamingSubsystem::NavigateToRoom(FName RoomName, float TransitionDuration, const AActor* FromActor)
+{
+    if (bTransitioning || RoomName == CurrentRoom)
+    {
+        return false;
+    }
+
+    ULevelStreaming* Room = FindOrCreateRoom(RoomName);
+    if (!Room)
+    {
+        return false;
+    }
+
+    // 还没有记录当前房间时，以发起者所在的子关卡作为当前房间
+    if (CurrentRoom.IsNone() && FromActor)
+    {
+        for (ULevelStreaming* StreamingLevel : GetWorld()->GetStreamingLevels())
+        {
+            if (StreamingLevel && StreamingLevel->GetLoadedLevel() == FromActor->GetLevel())
+            {
+                CurrentRoom = GetStreamingLevelRoomName(StreamingLevel);
+                Rooms.Add(CurrentRoom, StreamingLevel);
+                TouchRoom(CurrentRoom);
+                break;
+            }
+        }
+    }
+
+    bTransitioning = true;
+    bShowRequested = false;
+    bTargetWasPreloaded = Room->IsLevelLoaded();
+    TransitionFromRoom = CurrentRoom;
+    TransitionToRoom = RoomName;
+    TransitionFadeDuration = FMath::Max(TransitionDuration * 0.5f, 0.0f);
+    TransitionStartTime = FPlatformTime::Seconds();
+
+    Room->SetShouldBeLoaded(true);
+    TouchRoom(RoomName);
+
+    // 淡出的同时加载新房间，两者都完成后再显示
+    if (TransitionFadeDuration > 0.0f)
+    {
+        bFadedOut = false;
+        FadeCamera(0.0f, 1.0f, TransitionFadeDuration, true);
+        GetWorld()->GetTimerManager().SetTimer(FadeTimerHandle, this, &URoomStreamingSubsystem::OnFadeOutFinished, TransitionFadeDuration, false);
+    }
+    else
+    {
+        bFadedOut = true;
+    }
+
+    // 房间一直加载不出来时不能永远停在切换中（之后的 NavigateToRoom 都会被拒绝）
+    if (TransitionTimeout > 0.0f)
+    {
+        GetWorld()->GetTimerManager().SetTimer(TransitionTimeoutHandle, this, &URoomStreamingSubsystem::OnTransitionTimedOut,
+                                               FMath::Max(TransitionTimeout, TransitionFadeDuration), false);
+    }
+
+    UE_LOG(LogRLO, Log, TEXT("RoomStreamingSubsystem: Navigating %s -> %s (%s)"),
+           *TransitionFromRoom.ToString(), *RoomName.ToString(), bTargetWasPreloaded ? TEXT("preloaded") : TEXT("cold"));
+
+    TryAdvanceTransition();
+    return true;
+}
+
+void URoomStreamingSubsystem::Deinitialize()
+{
+    if (UWorld* World = GetWorld())
+    {
+        World->GetTimerManager().ClearTimer(FadeTimerHandle);
+        World->GetTimerManager().ClearTimer(TransitionTimeoutHandle);
+    }
+
+    Rooms.Reset();
+    ResidentRooms.Reset();
+    bTransitioning = false;
+
+    Super::Deinitialize();
+}
+
+ULevelStreaming* URoomStreamingSubsystem::FindOrCreateRoom(FName RoomName)
+{
+    if (RoomName.IsNone())
+    {
+        return nullptr;
+    }
+
+    if (ULevelStreaming* Room = FindRoom(RoomName))
+    {
+        return Room;
+    }
+
+    UWorld* World = GetWorld();
+    ULevelStreaming* Room = nullptr;
+
+    // 先在持久关卡的子关卡中查找
+    for (ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
+    {
+        if (StreamingLevel && GetStreamingLevelRoomName(StreamingLevel) == RoomName)
+        {
+            Room = StreamingLevel;
+            break;
+        }
+    }
+
+    // 再在房间目录下创建动态关卡实例
+    if (!Room)
+    {
+        const FString RoomString = RoomName.ToString();
+        const FString PackageName = RoomString.StartsWith(TEXT("/")) ? RoomString : FString::Printf(TEXT("%s/%s"), *RoomPackagePath, *RoomString);
+        if (!FPackageName::DoesPackageExist(PackageName))
+        {
+            UE_LOG(LogRLO, Warning, TEXT("RoomStreamingSubsystem: Room %s is not a sublevel and %s does not exist"), *RoomString, *PackageName);
+            return nullptr;
+        }
+
+        bool bSuccess = false;
+        ULevelStreamingDynamic* Instance = ULevelStreamingDynamic::LoadLevelInstance(World, PackageName, FVector::ZeroVector, FRotator::ZeroRotator, bSuccess);
+        if (!bSuccess || !Instance)
+        {
+            UE_LOG(LogRLO, Warning, TEXT("RoomStreamingSubsystem: Failed to create level instance for %s"), *PackageName);
+            return nullptr;
+        }
+
+        // 动态实例默认加载后立即显示，房间只在切换时显示
+        Instance->SetShouldBeVisible(false);
+        Room = Instance;
+    }
+
+    Room->OnLevelLoaded.AddUniqueDynamic(this, &URoomStreamingSubsystem::OnRoomStreamingStateChanged);
+    Room->OnLevelShown.AddUniqueDynamic(this, &URoomStreamingSubsystem::OnRoomStreamingStateChanged);
+    Rooms.Add(RoomName, Room);
+
+    return Room;
+}
+
+ULevelStreaming* URoomStreamingSubsystem::FindRoom(FName RoomName) const
+{
+    ULevelStreaming* const* Room = Rooms.Find(RoomName);
+    return Room ? *Room : nullptr;
+}
+
+FName URoomStreamingSubsystem::FindRoomInstanceName(const ULevel* Level) const
+{
+    if (!Level)
+    {
+        return NAME_None;
+    }
+
+    for (const TPair<FName, ULevelStreaming*>& Pair : Rooms)
+    {
+        if (Pair.Value && Pair.Value->IsA<ULevelStreamingDynamic>() && Pair.Value->GetLoadedLevel() == Level)
+        {
+            return Pair.Key;
+        }
+    }
+    return NAME_None;
+}
+
+void URoomStreamingSubsystem::TouchRoom(FName RoomName)
+{
+    ResidentRooms.Remove(RoomName);
+    ResidentRooms.Add(RoomName);
+}
+
+void URoomStreamingSubsystem::EnforceResidentLimit()
+{
+    const int32 Limit = FMath::Max(MaxResidentRooms, 1);
+
+    // 从最久未使用的房间开始卸载，当前房间和切换目标保留
+    for (int32 Index = 0; Index < ResidentRooms.Num() && ResidentRooms.Num() > Limit; )
+    {
+        const FName RoomName = ResidentRooms[Index];
+        const bool bInUse = RoomName == CurrentRoom || (bTransitioning && (RoomName == TransitionToRoom || RoomName == TransitionFromRoom));
+        if (bInUse)
+        {
+            ++Index;
+            continue;
+        }
+
+        if (ULevelStreaming* Room = FindRoom(RoomName))
+        {
+            Room->SetShouldBeVisible(false);
+            Room->SetShouldBeLoaded(false);
+        }
+
+        ResidentRooms.RemoveAt(Index);
+        UE_LOG(LogRLO, Log, TEXT("RoomStreamingSubsystem: Unloading room %s (limit %d)"), *RoomName.ToString(), Limit);
+    }
+
+    SET_DWORD_STAT(STAT_RLO_ResidentRooms, ResidentRooms.Num());
+}
+
+void URoomStreamingSubsystem::OnRoomStreamingStateChanged()
+{
+    TryAdvanceTransition();
+}
+
+void URoomStreamingSubsystem::OnFadeOutFinished()
+{
+    bFadedOut = true;
+    TryAdvanceTransition();
+}
+
+void URoomStreamingSubsystem::TryAdvanceTransition()
+{
+    if (!bTransitioning)
+    {
+        return;
+    }
+
+    ULevelStreaming* Room = FindRoom(TransitionToRoom);
+    if (!Room)
+    {
+        AbortTransition(TEXT("room is no longer registered"));
+        return;
+    }
+
+    if (Room->GetCurrentState() == ULevelStreaming::ECurrentState::FailedToLoad)
+    {
+        AbortTransition(TEXT("room failed to load"));
+        return;
+    }
+
+    if (!bShowRequested)
+    {
+        if (!bFadedOut || !Room->IsLevelLoaded())
+        {
+            return;
+        }
+
+        Room->SetShouldBeVisible(true);
+        bShowRequested = true;
+    }
+
+    if (!Room->IsLevelVisible())
+    {
+        return;
+    }
+
+    // 新房间已可见，同帧隐藏旧房间，不会出现空白帧
+    if (ULevelStreaming* OldRoom = FindRoom(TransitionFromRoom))
+    {
+        OldRoom->SetShouldBeVisible(false);
+    }
+
+    CurrentRoom = TransitionToRoom;
+    bTransitioning = false;
+    GetWorld()->GetTimerManager().ClearTimer(TransitionTimeoutHandle);
+    EnforceResidentLimit();
+
+    LastTransitionLatency = static_cast<float>(FPlatformTime::Seconds() - TransitionStartTime);
+    SET_FLOAT_STAT(STAT_RLO_RoomTransitionLatency, LastTransitionLatency * 1000.0f);
+
+    UE_LOG(LogRLO, Log, TEXT("RoomStreamingSubsystem: Entered room %s in %.1f ms (%s, fade %.2f s)"),
+           *CurrentRoom.ToString(), LastTransitionLatency * 1000.0f,
+           bTargetWasPreloaded ? TEXT("preloaded") : TEXT("cold"), TransitionFadeDuration);
+
+    FadeCamera(1.0f, 0.0f, TransitionFadeDuration, false);
+    OnRoomTransitionCompleted.Broadcast(TransitionFromRoom, CurrentRoom, LastTransitionLatency);
+}
+
+void URoomStreamingSubsystem::OnTransitionTimedOut()
+{
+    if (!bTransitioning)
+    {
+        return;
+    }
+
+    // 最后检查一次，状态可能已经就绪但没有收到回调
+    TryAdvanceTransition();
+    if (bTransitioning)
+    {
+        AbortTransition(TEXT("timed out"));
+    }
+}
+
+void URoomStreamingSubsystem::AbortTransition(const TCHAR* Reason)
+{
+    UWorld* World = GetWorld();
+    World->GetTimerManager().ClearTimer(FadeTimerHandle);
+    World->GetTimerManager().ClearTimer(TransitionTimeoutHandle);
+
+    // 加载慢的新房间继续加载（相当于预加载），但不显示，避免之后突然出现在当前房间上；加载失败的房间不再保留
+    if (ULevelStreaming* Room = FindRoom(TransitionToRoom))
+    {
+        Room->SetShouldBeVisible(false);
+        if (Room->GetCurrentState() == ULevelStreaming::ECurrentState::FailedToLoad)
+        {
+            Room->SetShouldBeLoaded(false);
+            ResidentRooms.Remove(TransitionToRoom);
+        }
+    }
+
+    bTransitioning = false;
+    bShowRequested = false;
+    EnforceResidentLimit();
+
+    UE_LOG(LogRLO, Warning, TEXT("RoomStreamingSubsystem: Navigation %s -> %s aborted after %.1f ms: %s"),
+           *TransitionFromRoom.ToString(), *TransitionToRoom.ToString(),
+           (FPlatformTime::Seconds() - TransitionStartTime) * 1000.0, Reason);
+
+    // 淡出可能还没完成，从当前透明度淡入
+    FadeCamera(-1.0f, 0.0f, TransitionFadeDuration, false);
+    OnRoomTransitionFailed.Broadcast(TransitionFromRoom, TransitionToRoom);
+}
+
+void URoomStreamingSubsystem::FadeCamera(float FromAlpha, float ToAlpha, float Duration, bool bHoldWhenFinished)
+{
+    if (Duration <= 0.0f)
+    {
+        return;
+    }
+
+    if (APlayerCameraManager* CameraManager = UGameplayStatics::GetPlayerCameraManager(this, 0))
+    {
+        const float StartAlpha = FromAlpha < 0.0f ? CameraManager->FadeAmount : FromAlpha;
+        CameraManager->StartCameraFade(StartAlpha, ToAlpha, Duration, FLinearColor::Black, false, bHoldWhenFinished);
+    }
+}
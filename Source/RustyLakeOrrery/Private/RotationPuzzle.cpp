@@ -1,17 +1,23 @@
 // RotationPuzzle.cpp
 
 #include "RotationPuzzle.h"
+#include "RustyLakeOrrery.h"
+#include "RLOPerf.h"
+#include "SaveSubsystem.h"
 #include "Components/SceneComponent.h"
+#include "TimerManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Rotation Puzzle Update"), STAT_RLO_RotationPuzzleUpdate, STATGROUP_RustyLakeOrrery);
 
 ARotationPuzzle::ARotationPuzzle()
 {
-    PrimaryActorTick.bCanEverTick = true;
+    // 由旋转事件和保持定时器驱动,不需要Tick
+    PrimaryActorTick.bCanEverTick = false;
 
     TargetRotation = 0.0f;
     AngleTolerance = 5.0f;
     HoldTime = 0.5f;
     CurrentRotation = 0.0f;
-    HoldTimer = 0.0f;
     bIsAtCorrectAngle = false;
 
     // 创建根组件
@@ -19,75 +25,70 @@ ARotationPuzzle::ARotationPuzzle()
     SetRootComponent(Root);
 }
 
-void ARotationPuzzle::BeginPlay()
+void ARotationPuzzle::PostInitializeComponents()
 {
-    Super::BeginPlay();
+    Super::PostInitializeComponents();
 
-    // 如果没有指定可旋转组件,使用根组件
+    // 如果没有指定可旋转组件,使用根组件(基类在BeginPlay中恢复存档时需要)
     if (!RotatableComponent)
     {
         RotatableComponent = GetRootComponent();
     }
+}
 
-    // 获取初始旋转
+void ARotationPuzzle::BeginPlay()
+{
+    Super::BeginPlay();
+
+    // 监听蓝图或动画等其他途径造成的旋转
     if (RotatableComponent)
     {
-        CurrentRotation = RotatableComponent->GetComponentRotation().Yaw;
+        RotatableComponent->TransformUpdated.AddUObject(this, &ARotationPuzzle::OnRotatableTransformUpdated);
     }
 
-    UE_LOG(LogTemp, Log, TEXT("RotationPuzzle: Initialized with target %.2f, tolerance %.2f"), 
+    // 获取初始旋转(bAutoActivate时谜题已经激活,可能一开始就在正确角度)
+    RefreshRotationFromComponent();
+
+    UE_LOG(LogRLOPuzzle, Log, TEXT("RotationPuzzle: Initialized with target %.2f, tolerance %.2f"), 
            TargetRotation, AngleTolerance);
 }
 
-void ARotationPuzzle::Tick(float DeltaTime)
+void ARotationPuzzle::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-    Super::Tick(DeltaTime);
-
-    // 只在激活状态下检查
-    if (!IsActive())
+    if (RotatableComponent)
     {
-        return;
+        RotatableComponent->TransformUpdated.RemoveAll(this);
     }
+    GetWorldTimerManager().ClearTimer(HoldTimerHandle);
 
-    UpdateRotationState();
-
-    // 如果在正确角度,增加计时器
-    if (bIsAtCorrectAngle)
-    {
-        HoldTimer += DeltaTime;
-
-        // 如果保持足够长时间,完成谜题
-        if (HoldTimer >= HoldTime)
-        {
-            CompletePuzzle();
-        }
-    }
-    else
-    {
-        // 重置计时器
-        HoldTimer = 0.0f;
-    }
+    Super::EndPlay(EndPlayReason);
 }
 
 void ARotationPuzzle::SetRotation(float NewRotation)
 {
     if (!RotatableComponent)
     {
-        UE_LOG(LogTemp, Warning, TEXT("RotationPuzzle: No rotatable component set"));
+        UE_LOG(LogRLOPuzzle, Warning, TEXT("RotationPuzzle: No rotatable component set"));
         return;
     }
 
     CurrentRotation = NormalizeAngle(NewRotation);
 
-    // 应用旋转
+    // 应用旋转,角度已知,不需要在变换回调中再读回
     FRotator NewRotator = RotatableComponent->GetComponentRotation();
     NewRotator.Yaw = CurrentRotation;
-    RotatableComponent->SetWorldRotation(NewRotator);
+    {
+        TGuardValue<bool> ApplyingGuard(bApplyingRotation, true);
+        RotatableComponent->SetWorldRotation(NewRotator);
+    }
+
+    UpdateRotationState();
+    USaveSubsystem::MarkDirty(this);
 
     // 触发旋转改变事件
     OnRotationChanged.Broadcast(CurrentRotation, TargetRotation);
 
-    UE_LOG(LogTemp, Verbose, TEXT("RotationPuzzle: Rotation set to %.2f"), CurrentRotation);
+    UE_LOG(LogRLOPuzzle, Verbose, TEXT("RotationPuzzle: Rotation set to %.2f"), CurrentRotation);
 }
 
 void ARotationPuzzle::AddRotation(float DeltaRotation)
@@ -113,6 +114,18 @@ float ARotationPuzzle::GetAngleDifference() const
     return Diff;
 }
 
+float ARotationPuzzle::GetHoldTimeElapsed() const
+{
+    if (!bIsAtCorrectAngle)
+    {
+        return 0.0f;
+    }
+
+    // 定时器已到期或未启动(HoldTime为0)时视为保持完成
+    const float Elapsed = GetWorldTimerManager().GetTimerElapsed(HoldTimerHandle);
+    return Elapsed >= 0.0f ? Elapsed : HoldTime;
+}
+
 float ARotationPuzzle::GetProgress_Implementation() const
 {
     if (IsCompleted())
@@ -133,7 +146,7 @@ float ARotationPuzzle::GetProgress_Implementation() const
     // 如果在正确角度,根据保持时间增加进度
     if (bIsAtCorrectAngle && HoldTime > 0.0f)
     {
-        float HoldProgress = HoldTimer / HoldTime;
+        float HoldProgress = GetHoldTimeElapsed() / HoldTime;
         Progress = FMath::Lerp(0.9f, 1.0f, HoldProgress);
     }
 
@@ -144,10 +157,10 @@ void ARotationPuzzle::OnPuzzleActivatedEvent_Implementation()
 {
     Super::OnPuzzleActivatedEvent_Implementation();
 
-    // 启用Tick
-    SetActorTickEnabled(true);
+    // 激活前可能已经在正确角度
+    RefreshRotationFromComponent();
 
-    UE_LOG(LogTemp, Log, TEXT("RotationPuzzle: Activated"));
+    UE_LOG(LogRLOPuzzle, Log, TEXT("RotationPuzzle: Activated"));
 }
 
 void ARotationPuzzle::OnPuzzleResetEvent_Implementation()
@@ -155,21 +168,23 @@ void ARotationPuzzle::OnPuzzleResetEvent_Implementation()
     Super::OnPuzzleResetEvent_Implementation();
 
     // 重置状态
-    HoldTimer = 0.0f;
+    GetWorldTimerManager().ClearTimer(HoldTimerHandle);
     bIsAtCorrectAngle = false;
 
     // 重置旋转到初始值(可选)
     // SetRotation(0.0f);
 
-    UE_LOG(LogTemp, Log, TEXT("RotationPuzzle: Reset"));
+    UE_LOG(LogRLOPuzzle, Log, TEXT("RotationPuzzle: Reset"));
 }
 
 void ARotationPuzzle::UpdateRotationState()
 {
-    // 获取当前旋转
-    if (RotatableComponent)
+    RLO_SCOPE_CYCLE(Puzzle, STAT_RLO_RotationPuzzleUpdate);
+
+    // 只在激活状态下检查
+    if (!IsActive())
     {
-        CurrentRotation = RotatableComponent->GetComponentRotation().Yaw;
+        return;
     }
 
     // 检查是否在正确角度
@@ -177,11 +192,83 @@ void ARotationPuzzle::UpdateRotationState()
     bool bWasAtCorrectAngle = bIsAtCorrectAngle;
     bIsAtCorrectAngle = (AngleDiff <= AngleTolerance);
 
-    // 如果刚到达正确角度,触发事件
-    if (bIsAtCorrectAngle && !bWasAtCorrectAngle)
+    if (bIsAtCorrectAngle == bWasAtCorrectAngle)
+    {
+        return;
+    }
+
+    FTimerManager& TimerManager = GetWorldTimerManager();
+    if (!bIsAtCorrectAngle)
+    {
+        // 离开正确角度,取消保持计时
+        TimerManager.ClearTimer(HoldTimerHandle);
+        return;
+    }
+
+    // 刚到达正确角度,触发事件并开始保持计时
+    OnCorrectAngleReached.Broadcast(CurrentRotation);
+    UE_LOG(LogRLOPuzzle, Log, TEXT("RotationPuzzle: Reached correct angle (diff: %.2f)"), AngleDiff);
+
+    // 回调中可能已经改变了状态
+    if (!bIsAtCorrectAngle || !IsActive())
     {
-        OnCorrectAngleReached.Broadcast(CurrentRotation);
-        UE_LOG(LogTemp, Log, TEXT("RotationPuzzle: Reached correct angle (diff: %.2f)"), AngleDiff);
+        return;
+    }
+
+    if (HoldTime > 0.0f)
+    {
+        TimerManager.SetTimer(HoldTimerHandle, this, &ARotationPuzzle::OnHoldTimeElapsed, HoldTime, false);
+    }
+    else
+    {
+        CompletePuzzle();
+    }
+}
+
+void ARotationPuzzle::RefreshRotationFromComponent()
+{
+    // 没有根组件时RotatableComponent可能为空
+    if (!RotatableComponent)
+    {
+        return;
+    }
+
+    CurrentRotation = RotatableComponent->GetComponentRotation().Yaw;
+    UpdateRotationState();
+}
+
+void ARotationPuzzle::OnRotatableTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+    if (bApplyingRotation || !IsActive())
+    {
+        return;
+    }
+
+    RefreshRotationFromComponent();
+    USaveSubsystem::MarkDirty(this);
+}
+
+void ARotationPuzzle::OnHoldTimeElapsed()
+{
+    if (IsActive() && bIsAtCorrectAngle)
+    {
+        CompletePuzzle();
+    }
+}
+
+void ARotationPuzzle::SerializePuzzleSaveState(FArchive& Ar)
+{
+    Ar << CurrentRotation;
+
+    // 恢复时只应用角度,BeginPlay随后从组件读回角度并更新状态
+    if (Ar.IsLoading() && RotatableComponent)
+    {
+        CurrentRotation = NormalizeAngle(CurrentRotation);
+
+        FRotator NewRotator = RotatableComponent->GetComponentRotation();
+        NewRotator.Yaw = CurrentRotation;
+        TGuardValue<bool> ApplyingGuard(bApplyingRotation, true);
+        RotatableComponent->SetWorldRotation(NewRotator);
     }
 }
 
@@ -0,0 +1,717 @@
+// SaveSubsystem.cpp
+
+#include "SaveSubsystem.h"
+#include "RustyLakeOrrery.h"
+#include "RLOPerf.h"
+#include "RoomStreamingSubsystem.h"
+#include "Async/Async.h"
+#include "Engine/GameInstance.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+DECLARE_CYCLE_STAT(TEXT("Save Capture"), STAT_RLO_SaveCapture, STATGROUP_RustyLakeOrrery);
+DECLARE_CYCLE_STAT(TEXT("Save Restore"), STAT_RLO_SaveRestore, STATGROUP_RustyLakeOrrery);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Save Records"), STAT_RLO_SaveRecords, STATGROUP_RustyLakeOrrery);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Save Journal Bytes"), STAT_RLO_SaveJournalBytes, STATGROUP_RustyLakeOrrery);
+
+namespace
+{
+    /**
+     * 文件格式(小端):
+     * 快照: [Magic 'RLOS'][Version][Generation][NumRecords]{[Key][DataSize][Data]}*[CRC32]
+     * 日志: [Magic 'RLOJ'][Version][Generation]{[PayloadSize][PayloadCRC32][Key][DataSize][Data]}*
+     */
+    constexpr uint32 SnapshotMagic = 0x534F4C52;
+    constexpr uint32 JournalMagic = 0x4A4F4C52;
+
+    /** 日志每条记录在负载之外的大小(长度+CRC) */
+    constexpr int64 JournalEntryHeaderSize = sizeof(int32) + sizeof(uint32);
+
+    const TCHAR* SnapshotExtension = TEXT(".rlosave");
+    const TCHAR* JournalExtension = TEXT(".rlojournal");
+    const TCHAR* TempExtension = TEXT(".tmp");
+
+    void WriteRecord(FArchive& Ar, const FString& Key, const TArray<uint8>& Data)
+    {
+        FString KeyCopy = Key;
+        int32 DataSize = Data.Num();
+        Ar << KeyCopy;
+        Ar << DataSize;
+        Ar.Serialize(const_cast<uint8*>(Data.GetData()), DataSize);
+    }
+
+    bool ReadRecord(FArchive& Ar, FString& OutKey, TArray<uint8>& OutData)
+    {
+        Ar << OutKey;
+        Ar << OutData;
+        return !Ar.IsError() && !OutKey.IsEmpty();
+    }
+
+    bool IsSupportedVersion(uint32 Version)
+    {
+        return Version >= static_cast<uint32>(ERLOSaveVersion::Initial) && Version <= static_cast<uint32>(ERLOSaveVersion::Latest);
+    }
+
+    FAutoConsoleCommandWithWorld SaveNowCommand(
+        TEXT("RLO.Save.Now"),
+        TEXT("Capture every registered saveable and write it to the autosave slot."),
+        FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+        {
+            if (USaveSubsystem* Subsystem = USaveSubsystem::Get(World))
+            {
+                Subsystem->SaveNow(true);
+                Subsystem->WaitForPendingWrites();
+                UE_LOG(LogRLOSave, Display, TEXT("Save: Captured in %.3f ms"), Subsystem->GetLastCaptureMs());
+            }
+        }));
+
+    FAutoConsoleCommandWithWorld DeleteSaveCommand(
+        TEXT("RLO.Save.Delete"),
+        TEXT("Delete the autosave slot (the next autosave starts a new one)."),
+        FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+        {
+            if (USaveSubsystem* Subsystem = USaveSubsystem::Get(World))
+            {
+                Subsystem->DeleteSave();
+            }
+        }));
+}
+
+// ========================================================================
+// IRLOSaveable
+// ========================================================================
+
+FString IRLOSaveable::GetSaveKey() const
+{
+    const UObject* Object = Cast<UObject>(this);
+    if (!Object)
+    {
+        return FString();
+    }
+
+    // 动态房间实例的包名每次运行都不同,改用房间名加对象在关卡中的路径
+    const ULevel* Level = Object->GetTypedOuter<ULevel>();
+    const URoomStreamingSubsystem* RoomStreaming = Level ? URoomStreamingSubsystem::Get(Object) : nullptr;
+    const FName RoomName = RoomStreaming ? RoomStreaming->FindRoomInstanceName(Level) : NAME_None;
+    if (!RoomName.IsNone())
+    {
+        return FString::Printf(TEXT("Room.%s:%s"), *RoomName.ToString(), *Object->GetPathName(Level));
+    }
+
+    return UWorld::RemovePIEPrefix(Object->GetPathName());
+}
+
+// ========================================================================
+// USaveSubsystem
+// ========================================================================
+
+USaveSubsystem* USaveSubsystem::Get(const UObject* WorldContextObject)
+{
+    UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContextObject);
+    return GameInstance ? GameInstance->GetSubsystem<USaveSubsystem>() : nullptr;
+}
+
+void USaveSubsystem::MarkDirty(UObject* Saveable)
+{
+    USaveSubsystem* Subsystem = Saveable ? Get(Saveable) : nullptr;
+    if (!Subsystem || Subsystem->RestoringObject == Saveable)
+    {
+        return;
+    }
+
+    // 未注册的对象(BeginPlay之前的初始化)不需要存档
+    const TWeakObjectPtr<UObject> Key(Saveable);
+    if (Subsystem->RegisteredKeys.Contains(Key))
+    {
+        Subsystem->DirtyObjects.Add(Key);
+    }
+}
+
+void USaveSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    LoadFromDisk();
+
+    if (AutosaveInterval > 0.0f)
+    {
+        AutosaveTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &USaveSubsystem::HandleAutosaveTick), AutosaveInterval);
+    }
+
+    WillDeactivateHandle = FCoreDelegates::ApplicationWillDeactivateDelegate.AddUObject(this, &USaveSubsystem::HandleApplicationWillDeactivate);
+    WillEnterBackgroundHandle = FCoreDelegates::ApplicationWillEnterBackgroundDelegate.AddUObject(this, &USaveSubsystem::HandleApplicationWillDeactivate);
+    WillTerminateHandle = FCoreDelegates::ApplicationWillTerminateDelegate.AddUObject(this, &USaveSubsystem::HandleApplicationWillDeactivate);
+    WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddUObject(this, &USaveSubsystem::HandleWorldCleanup);
+}
+
+void USaveSubsystem::Deinitialize()
+{
+    FTicker::GetCoreTicker().RemoveTicker(AutosaveTickerHandle);
+    FCoreDelegates::ApplicationWillDeactivateDelegate.Remove(WillDeactivateHandle);
+    FCoreDelegates::ApplicationWillEnterBackgroundDelegate.Remove(WillEnterBackgroundHandle);
+    FCoreDelegates::ApplicationWillTerminateDelegate.Remove(WillTerminateHandle);
+    FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+
+    // 关卡中的对象已在 EndPlay 时注销并捕获,这里写入剩余的变化
+    SaveNow(true);
+    WaitForPendingWrites();
+
+    RegisteredKeys.Reset();
+    DirtyObjects.Reset();
+
+    Super::Deinitialize();
+}
+
+// ========================================================================
+// 注册
+// ========================================================================
+
+void USaveSubsystem::RegisterSaveable(UObject* Saveable)
+{
+    IRLOSaveable* SaveInterface = Cast<IRLOSaveable>(Saveable);
+    if (!SaveInterface)
+    {
+        UE_LOG(LogRLOSave, Warning, TEXT("Save: %s does not implement IRLOSaveable"), *GetNameSafe(Saveable));
+        return;
+    }
+
+    const FString Key = SaveInterface->GetSaveKey();
+    if (Key.IsEmpty())
+    {
+        return;
+    }
+    RegisteredKeys.Add(TWeakObjectPtr<UObject>(Saveable), Key);
+
+    const FRecordRef* FoundRecord = Records.Find(Key);
+    if (!FoundRecord)
+    {
+        return;
+    }
+
+    // 持有记录的引用,恢复过程中其他对象的捕获可能修改 Records
+    const FRecordRef Record = *FoundRecord;
+
+    RLO_SCOPE_CYCLE(Save, STAT_RLO_SaveRestore);
+
+    // 恢复过程中对象调用 MarkDirty 不会把刚读取的记录再写一遍
+    TGuardValue<UObject*> RestoreGuard(RestoringObject, Saveable);
+    FMemoryReader Reader(*Record);
+    SaveInterface->SerializeSaveRecord(Reader);
+
+    if (Reader.IsError())
+    {
+        UE_LOG(LogRLOSave, Warning, TEXT("Save: Record %s could not be read, object keeps its default state"), *Key);
+    }
+    else
+    {
+        UE_LOG(LogRLOSave, Verbose, TEXT("Save: Restored %s (%d bytes)"), *Key, Record->Num());
+    }
+}
+
+void USaveSubsystem::UnregisterSaveable(UObject* Saveable)
+{
+    const TWeakObjectPtr<UObject> WeakSaveable(Saveable);
+
+    FString Key;
+    if (!RegisteredKeys.RemoveAndCopyValue(WeakSaveable, Key))
+    {
+        return;
+    }
+
+    // 对象即将销毁(切换关卡、拾取),在下次存档时写入
+    if (DirtyObjects.Remove(WeakSaveable) > 0)
+    {
+        RLO_SCOPE_CYCLE(Save, STAT_RLO_SaveCapture);
+        CaptureRecord(Saveable, Key);
+    }
+}
+
+// ========================================================================
+// 存档
+// ========================================================================
+
+void USaveSubsystem::CaptureRecord(UObject* Saveable, const FString& Key)
+{
+    IRLOSaveable* SaveInterface = Cast<IRLOSaveable>(Saveable);
+    if (!SaveInterface)
+    {
+        return;
+    }
+
+    TArray<uint8> Data;
+    FMemoryWriter Writer(Data);
+    SaveInterface->SerializeSaveRecord(Writer);
+
+    // 内容没有变化(如物品加入后又被使用掉)时不写入
+    const FRecordRef* Existing = Records.Find(Key);
+    if (Existing && **Existing == Data)
+    {
+        return;
+    }
+
+    FRecordRef Record = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>(MoveTemp(Data));
+    Records.Add(Key, Record);
+    UnsavedEntries.Emplace(Key, Record);
+}
+
+void USaveSubsystem::SaveNow(bool bCaptureAll)
+{
+    RLO_SCOPE_CYCLE(Save, STAT_RLO_SaveCapture);
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    if (bCaptureAll)
+    {
+        for (const TPair<TWeakObjectPtr<UObject>, FString>& Pair : RegisteredKeys)
+        {
+            if (UObject* Saveable = Pair.Key.Get())
+            {
+                CaptureRecord(Saveable, Pair.Value);
+            }
+        }
+    }
+    else
+    {
+        for (const TWeakObjectPtr<UObject>& WeakSaveable : DirtyObjects)
+        {
+            UObject* Saveable = WeakSaveable.Get();
+            const FString* Key = Saveable ? RegisteredKeys.Find(WeakSaveable) : nullptr;
+            if (Key)
+            {
+                CaptureRecord(Saveable, *Key);
+            }
+        }
+    }
+    DirtyObjects.Reset();
+
+    // 写入线程失败后日志可能不完整,重新写入完整快照;
+    // 失败的快照没有落盘,代数回退到磁盘上的快照,重试的快照仍接在它之后
+    if (bWriteFailed.AtomicSet(false))
+    {
+        bSnapshotRequired = true;
+        Generation = static_cast<uint32>(DiskSnapshotGeneration.GetValue());
+    }
+
+    if (UnsavedEntries.Num() == 0 && !bSnapshotRequired)
+    {
+        LastCaptureMs = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+        return;
+    }
+
+    for (const TPair<FString, FRecordRef>& Entry : UnsavedEntries)
+    {
+        JournalBytes += JournalEntryHeaderSize + Entry.Key.Len() + Entry.Value->Num() + 2 * sizeof(int32);
+    }
+
+    FWriteJob Job;
+    if (bSnapshotRequired || JournalBytes > MaxJournalBytes)
+    {
+        // 快照包含所有记录,日志从新的一代重新开始
+        Generation++;
+        Job.bWriteSnapshot = true;
+        Job.Snapshot = Records;
+        UnsavedEntries.Reset();
+        JournalBytes = 0;
+        bSnapshotRequired = false;
+    }
+    else
+    {
+        Job.Entries = MoveTemp(UnsavedEntries);
+        UnsavedEntries.Reset();
+    }
+    Job.Generation = Generation;
+
+    const int32 NumEntries = Job.bWriteSnapshot ? Job.Snapshot.Num() : Job.Entries.Num();
+    const bool bWriteSnapshot = Job.bWriteSnapshot;
+    EnqueueWrite(MoveTemp(Job));
+
+    SET_DWORD_STAT(STAT_RLO_SaveRecords, Records.Num());
+    SET_DWORD_STAT(STAT_RLO_SaveJournalBytes, static_cast<uint32>(JournalBytes));
+
+    LastCaptureMs = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+    if (LastCaptureMs > FRLOPerf::GetBudgetMs(ERLOPerfSubsystem::Save))
+    {
+        UE_LOG(LogRLOSave, Warning, TEXT("Save: Capturing %d records took %.3f ms on the game thread (budget %.2f ms)"),
+               NumEntries, LastCaptureMs, FRLOPerf::GetBudgetMs(ERLOPerfSubsystem::Save));
+    }
+    else
+    {
+        UE_LOG(LogRLOSave, Verbose, TEXT("Save: Queued %s with %d records (%.3f ms)"),
+               bWriteSnapshot ? TEXT("snapshot") : TEXT("journal entries"), NumEntries, LastCaptureMs);
+    }
+}
+
+void USaveSubsystem::WaitForPendingWrites()
+{
+    if (WriterFuture.IsValid())
+    {
+        WriterFuture.Wait();
+    }
+}
+
+void USaveSubsystem::DeleteSave()
+{
+    WaitForPendingWrites();
+
+    IFileManager& FileManager = IFileManager::Get();
+    FileManager.Delete(*GetSnapshotPath(), false, true, true);
+    FileManager.Delete(*(GetSnapshotPath() + TempExtension), false, true, true);
+    FileManager.Delete(*GetJournalPath(), false, true, true);
+
+    Records.Reset();
+    UnsavedEntries.Reset();
+    DirtyObjects.Reset();
+    Generation = 0;
+    JournalBytes = 0;
+    bSnapshotRequired = false;
+    LoadedVersion = ERLOSaveVersion::Latest;
+
+    // 写入线程已停止,下次写入时重新创建日志
+    WrittenJournalGeneration = INDEX_NONE;
+    FailedSnapshotGeneration = INDEX_NONE;
+    DiskSnapshotGeneration.Reset();
+
+    SET_DWORD_STAT(STAT_RLO_SaveRecords, 0);
+    SET_DWORD_STAT(STAT_RLO_SaveJournalBytes, 0);
+
+    UE_LOG(LogRLOSave, Log, TEXT("Save: Deleted slot %s"), *SlotName);
+}
+
+bool USaveSubsystem::HandleAutosaveTick(float DeltaTime)
+{
+    SaveNow(false);
+    return true;
+}
+
+void USaveSubsystem::HandleApplicationWillDeactivate()
+{
+    // 切到后台后进程随时可能被杀,等待写入完成
+    SaveNow(true);
+    WaitForPendingWrites();
+}
+
+void USaveSubsystem::HandleWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+    // 旧关卡的对象已在 EndPlay 时注销并捕获,此时写入才包含它们的最终状态
+    if (World && World->GetGameInstance() == GetGameInstance())
+    {
+        SaveNow(false);
+    }
+}
+
+FString USaveSubsystem::GetSnapshotPath() const
+{
+    return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("SaveGames"), SlotName + SnapshotExtension);
+}
+
+FString USaveSubsystem::GetJournalPath() const
+{
+    return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("SaveGames"), SlotName + JournalExtension);
+}
+
+// ========================================================================
+// 读取
+// ========================================================================
+
+void USaveSubsystem::LoadFromDisk()
+{
+    const double StartTime = FPlatformTime::Seconds();
+
+    const FString SnapshotPath = GetSnapshotPath();
+    const FString TempPath = SnapshotPath + TempExtension;
+
+    // 替换快照时先删除旧文件再重命名,两步之间被杀时只剩下临时文件
+    if (!IFileManager::Get().FileExists(*SnapshotPath) && IFileManager::Get().FileExists(*TempPath))
+    {
+        IFileManager::Get().Move(*SnapshotPath, *TempPath, true, true);
+    }
+
+    bool bHasSnapshot = false;
+    TArray<uint8> FileData;
+    if (FFileHelper::LoadFileToArray(FileData, *SnapshotPath, FILEREAD_Silent))
+    {
+        const int32 BodySize = FileData.Num() - static_cast<int32>(sizeof(uint32));
+        uint32 StoredCrc = 0;
+        if (BodySize > 0)
+        {
+            FMemory::Memcpy(&StoredCrc, FileData.GetData() + BodySize, sizeof(uint32));
+        }
+
+        if (BodySize <= 0 || FCrc::MemCrc32(FileData.GetData(), BodySize) != StoredCrc)
+        {
+            UE_LOG(LogRLOSave, Error, TEXT("Save: Snapshot %s is corrupt, starting a new save"), *SnapshotPath);
+        }
+        else
+        {
+            FMemoryReader Reader(FileData);
+            uint32 Magic = 0;
+            uint32 Version = 0;
+            uint32 SnapshotGeneration = 0;
+            int32 NumRecords = 0;
+            Reader << Magic << Version << SnapshotGeneration << NumRecords;
+
+            if (Magic != SnapshotMagic || !IsSupportedVersion(Version))
+            {
+                UE_LOG(LogRLOSave, Error, TEXT("Save: Snapshot %s has bad magic or unsupported version %u"), *SnapshotPath, Version);
+            }
+            else
+            {
+                Records.Reserve(NumRecords);
+                for (int32 Index = 0; Index < NumRecords && Reader.Tell() < BodySize; Index++)
+                {
+                    FString Key;
+                    TArray<uint8> Data;
+                    if (!ReadRecord(Reader, Key, Data))
+                    {
+                        break;
+                    }
+                    Records.Add(Key, MakeShared<TArray<uint8>, ESPMode::ThreadSafe>(MoveTemp(Data)));
+                }
+
+                bHasSnapshot = true;
+                Generation = SnapshotGeneration;
+                LoadedVersion = static_cast<ERLOSaveVersion>(Version);
+            }
+        }
+    }
+
+    if (!bHasSnapshot && IFileManager::Get().FileExists(*SnapshotPath))
+    {
+        // 快照损坏:下次存档写入新的快照
+        bSnapshotRequired = true;
+    }
+
+    // 重放同一代的日志,遇到不完整或损坏的记录时停止(之后的记录来自被中断的写入)
+    FileData.Reset();
+    int32 NumJournalEntries = 0;
+    if (FFileHelper::LoadFileToArray(FileData, *GetJournalPath(), FILEREAD_Silent))
+    {
+        FMemoryReader Reader(FileData);
+        uint32 Magic = 0;
+        uint32 Version = 0;
+        uint32 JournalGeneration = 0;
+        Reader << Magic << Version << JournalGeneration;
+
+        if (Reader.IsError() || Magic != JournalMagic || !IsSupportedVersion(Version))
+        {
+            UE_LOG(LogRLOSave, Warning, TEXT("Save: Journal has bad magic or unsupported version %u, ignored"), Version);
+        }
+        else if (JournalGeneration != Generation || bSnapshotRequired)
+        {
+            // 快照已替换但新日志还没创建时被中断,旧日志的内容都已在快照中
+            UE_LOG(LogRLOSave, Log, TEXT("Save: Journal generation %u does not match snapshot %u, ignored"), JournalGeneration, Generation);
+        }
+        else
+        {
+            bool bTorn = false;
+            while (Reader.Tell() < FileData.Num())
+            {
+                const int64 EntryStart = Reader.Tell();
+                if (FileData.Num() - EntryStart < JournalEntryHeaderSize)
+                {
+                    bTorn = true;
+                    break;
+                }
+
+                int32 PayloadSize = 0;
+                uint32 PayloadCrc = 0;
+                Reader << PayloadSize << PayloadCrc;
+
+                const int64 PayloadStart = Reader.Tell();
+                if (PayloadSize <= 0 || PayloadSize > FileData.Num() - PayloadStart
+                    || FCrc::MemCrc32(FileData.GetData() + PayloadStart, PayloadSize) != PayloadCrc)
+                {
+                    bTorn = true;
+                    break;
+                }
+
+                FString Key;
+                TArray<uint8> Data;
+                if (!ReadRecord(Reader, Key, Data) || Reader.Tell() != PayloadStart + PayloadSize)
+                {
+                    bTorn = true;
+                    break;
+                }
+
+                Records.Add(Key, MakeShared<TArray<uint8>, ESPMode::ThreadSafe>(MoveTemp(Data)));
+                NumJournalEntries++;
+            }
+
+            if (bTorn)
+            {
+                // 不能在损坏的记录之后继续追加,下次存档写入快照并开始新的日志
+                UE_LOG(LogRLOSave, Warning, TEXT("Save: Journal ends with an incomplete entry after %d entries, compacting on next save"), NumJournalEntries);
+                bSnapshotRequired = true;
+            }
+            else
+            {
+                // 日志完好,写入线程继续追加
+                WrittenJournalGeneration = Generation;
+                JournalBytes = FileData.Num();
+            }
+        }
+    }
+
+    DiskSnapshotGeneration.Set(static_cast<int32>(Generation));
+
+    SET_DWORD_STAT(STAT_RLO_SaveRecords, Records.Num());
+    SET_DWORD_STAT(STAT_RLO_SaveJournalBytes, static_cast<uint32>(JournalBytes));
+
+    UE_LOG(LogRLOSave, Log, TEXT("Save: Loaded %d records (generation %u, %d journal entries) from slot %s in %.2f ms"),
+           Records.Num(), Generation, NumJournalEntries, *SlotName, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+// ========================================================================
+// 写入线程
+// ========================================================================
+
+void USaveSubsystem::EnqueueWrite(FWriteJob&& Job)
+{
+    FScopeLock Lock(&WriteQueueLock);
+    PendingJobs.Add(MoveTemp(Job));
+
+    if (!bWriterRunning)
+    {
+        bWriterRunning = true;
+        WriterFuture = Async(EAsyncExecution::ThreadPool, [this]()
+        {
+            RunWriter();
+        });
+    }
+}
+
+void USaveSubsystem::RunWriter()
+{
+    for (;;)
+    {
+        TArray<FWriteJob> Jobs;
+        {
+            FScopeLock Lock(&WriteQueueLock);
+            if (PendingJobs.Num() == 0)
+            {
+                bWriterRunning = false;
+                return;
+            }
+            Jobs = MoveTemp(PendingJobs);
+            PendingJobs.Reset();
+        }
+
+        // 按加入顺序写入,快照之前的日志记录先落盘
+        for (const FWriteJob& Job : Jobs)
+        {
+            WriteJob(Job);
+        }
+    }
+}
+
+void USaveSubsystem::WriteJob(const FWriteJob& Job)
+{
+    const FString SnapshotPath = GetSnapshotPath();
+    const FString JournalPath = GetJournalPath();
+    IFileManager& FileManager = IFileManager::Get();
+
+    if (Job.bWriteSnapshot)
+    {
+        TArray<uint8> Buffer;
+        FMemoryWriter Writer(Buffer);
+
+        uint32 Magic = SnapshotMagic;
+        uint32 Version = static_cast<uint32>(ERLOSaveVersion::Latest);
+        uint32 SnapshotGeneration = Job.Generation;
+        int32 NumRecords = Job.Snapshot.Num();
+        Writer << Magic << Version << SnapshotGeneration << NumRecords;
+
+        for (const TPair<FString, FRecordRef>& Pair : Job.Snapshot)
+        {
+            WriteRecord(Writer, Pair.Key, *Pair.Value);
+        }
+
+        uint32 Crc = FCrc::MemCrc32(Buffer.GetData(), Buffer.Num());
+        Writer << Crc;
+
+        // 先完整写入临时文件再替换,写入过程中被杀不会损坏已有的快照
+        const FString TempPath = SnapshotPath + TempExtension;
+        if (!FFileHelper::SaveArrayToFile(Buffer, *TempPath) || !FileManager.Move(*SnapshotPath, *TempPath, true, true))
+        {
+            // 旧快照和旧一代的日志仍然有效,删除临时文件以免读取时把它当作快照恢复
+            UE_LOG(LogRLOSave, Error, TEXT("Save: Failed to write snapshot %s"), *SnapshotPath);
+            FileManager.Delete(*TempPath, false, true, true);
+            FailedSnapshotGeneration = Job.Generation;
+            bWriteFailed = true;
+            return;
+        }
+
+        FailedSnapshotGeneration = INDEX_NONE;
+        DiskSnapshotGeneration.Set(static_cast<int32>(SnapshotGeneration));
+        UE_LOG(LogRLOSave, Log, TEXT("Save: Wrote snapshot with %d records (%d bytes, generation %u)"), NumRecords, Buffer.Num(), SnapshotGeneration);
+    }
+
+    if (Job.Generation == FailedSnapshotGeneration)
+    {
+        // 这一代的快照写入失败,游戏线程发现之前已排队的日志任务:重新创建日志会截断仍与旧快照匹配的日志,
+        // 改为追加到旧一代的日志(记录是完整内容,重放时覆盖旧值);没有完好的日志时跳过,记录会包含在重试的快照中
+        if (WrittenJournalGeneration == INDEX_NONE)
+        {
+            UE_LOG(LogRLOSave, Warning, TEXT("Save: Skipped %d journal entries of generation %u until a snapshot succeeds"), Job.Entries.Num(), Job.Generation);
+            return;
+        }
+    }
+    else if (WrittenJournalGeneration != Job.Generation)
+    {
+        TArray<uint8> Header;
+        FMemoryWriter Writer(Header);
+
+        uint32 Magic = JournalMagic;
+        uint32 Version = static_cast<uint32>(ERLOSaveVersion::Latest);
+        uint32 JournalGeneration = Job.Generation;
+        Writer << Magic << Version << JournalGeneration;
+
+        if (!FFileHelper::SaveArrayToFile(Header, *JournalPath))
+        {
+            UE_LOG(LogRLOSave, Error, TEXT("Save: Failed to create journal %s"), *JournalPath);
+            bWriteFailed = true;
+            return;
+        }
+        WrittenJournalGeneration = Job.Generation;
+    }
+
+    if (Job.Entries.Num() == 0)
+    {
+        return;
+    }
+
+    TArray<uint8> Buffer;
+    FMemoryWriter Writer(Buffer);
+    TArray<uint8> Payload;
+
+    for (const TPair<FString, FRecordRef>& Entry : Job.Entries)
+    {
+        Payload.Reset();
+        FMemoryWriter PayloadWriter(Payload);
+        WriteRecord(PayloadWriter, Entry.Key, *Entry.Value);
+
+        int32 PayloadSize = Payload.Num();
+        uint32 PayloadCrc = FCrc::MemCrc32(Payload.GetData(), PayloadSize);
+        Writer << PayloadSize << PayloadCrc;
+        Writer.Serialize(Payload.GetData(), PayloadSize);
+    }
+
+    if (!FFileHelper::SaveArrayToFile(Buffer, *JournalPath, &FileManager, FILEWRITE_Append))
+    {
+        UE_LOG(LogRLOSave, Error, TEXT("Save: Failed to append %d entries to journal %s"), Job.Entries.Num(), *JournalPath);
+        bWriteFailed = true;
+        return;
+    }
+
+    UE_LOG(LogRLOSave, Verbose, TEXT("Save: Appended %d entries (%d bytes) to journal"), Job.Entries.Num(), Buffer.Num());
+}
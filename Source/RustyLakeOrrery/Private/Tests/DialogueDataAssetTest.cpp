@@ -0,0 +1,140 @@
+// DialogueDataAssetTest.cpp
+
+#include "DialogueDataAsset.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    /** 发行数据中每章的对话数（约40条）的几倍，覆盖索引扩容 */
+    const int32 NumTestLines = 200;
+
+    FName MakeIndexedName(const TCHAR* Prefix, int32 Index)
+    {
+        return FName(*FString::Printf(TEXT("%s_%d"), Prefix, Index));
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLODialogueLookupTest, "RLO.Dialogue.Lookup",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLODialogueLookupTest::RunTest(const FString& Parameters)
+{
+    UDialogueDataAsset* Asset = NewObject<UDialogueDataAsset>(GetTransientPackage());
+    for (int32 Index = 0; Index < NumTestLines; Index++)
+    {
+        FDialogueEntry& Entry = Asset->DialogueEntries.AddDefaulted_GetRef();
+        Entry.DialogueID = MakeIndexedName(TEXT("Line"), Index);
+        Entry.TriggerEvent = MakeIndexedName(TEXT("OnTrigger"), Index);
+    }
+    Asset->RebuildLookupIndex();
+
+    // 每个ID和触发事件都能找到对应条目
+    for (int32 Index = 0; Index < NumTestLines; Index++)
+    {
+        const FName ID = MakeIndexedName(TEXT("Line"), Index);
+        const FName Trigger = MakeIndexedName(TEXT("OnTrigger"), Index);
+        const FDialogueEntry* ByID = Asset->FindDialogueEntry(ID);
+        const FDialogueEntry* ByTrigger = Asset->FindDialogueByTrigger(Trigger);
+        if (!TestTrue(FString::Printf(TEXT("Entry %d found by ID"), Index), ByID && ByID->DialogueID == ID)
+            || !TestTrue(FString::Printf(TEXT("Entry %d found by trigger"), Index), ByTrigger && ByTrigger->TriggerEvent == Trigger))
+        {
+            return false;
+        }
+    }
+
+    // 不存在的ID返回空
+    TestNull(TEXT("Unknown ID"), Asset->FindDialogueEntry(TEXT("Missing_Line")));
+    TestNull(TEXT("Unknown trigger"), Asset->FindDialogueByTrigger(TEXT("OnMissingTrigger")));
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLODialogueLookupAfterEditTest, "RLO.Dialogue.LookupAfterInPlaceEdit",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLODialogueLookupAfterEditTest::RunTest(const FString& Parameters)
+{
+    UDialogueDataAsset* Asset = NewObject<UDialogueDataAsset>(GetTransientPackage());
+    for (int32 Index = 0; Index < NumTestLines; Index++)
+    {
+        FDialogueEntry& Entry = Asset->DialogueEntries.AddDefaulted_GetRef();
+        Entry.DialogueID = MakeIndexedName(TEXT("Line"), Index);
+        Entry.TriggerEvent = MakeIndexedName(TEXT("OnTrigger"), Index);
+    }
+    Asset->RebuildLookupIndex();
+
+    // 条目数量不变,原地改名且不重建索引
+    FDialogueEntry& Edited = Asset->DialogueEntries[NumTestLines / 2];
+    Edited.DialogueID = TEXT("Line_Renamed");
+    Edited.TriggerEvent = TEXT("OnRenamedTrigger");
+
+    // 旧键命中校验失败,重建索引后返回空,新键也随之可以找到
+    TestNull(TEXT("Old ID"), Asset->FindDialogueEntry(MakeIndexedName(TEXT("Line"), NumTestLines / 2)));
+    TestNull(TEXT("Old trigger"), Asset->FindDialogueByTrigger(MakeIndexedName(TEXT("OnTrigger"), NumTestLines / 2)));
+    const FDialogueEntry* ByID = Asset->FindDialogueEntry(TEXT("Line_Renamed"));
+    const FDialogueEntry* ByTrigger = Asset->FindDialogueByTrigger(TEXT("OnRenamedTrigger"));
+    TestTrue(TEXT("Renamed entry found by ID"), ByID == &Edited);
+    TestTrue(TEXT("Renamed entry found by trigger"), ByTrigger == &Edited);
+
+    // 未命中不重建索引:只改新键时查不到,需要调用RebuildLookupIndex
+    Edited.DialogueID = TEXT("Line_RenamedAgain");
+    TestNull(TEXT("New ID is a clean miss before rebuilding"), Asset->FindDialogueEntry(TEXT("Line_RenamedAgain")));
+    Asset->RebuildLookupIndex();
+    ByID = Asset->FindDialogueEntry(TEXT("Line_RenamedAgain"));
+    TestTrue(TEXT("New ID found after rebuilding"), ByID == &Edited);
+
+    // 其余条目不受影响
+    const FName OtherID = MakeIndexedName(TEXT("Line"), 0);
+    const FDialogueEntry* Other = Asset->FindDialogueEntry(OtherID);
+    TestTrue(TEXT("Other entry found by ID"), Other && Other->DialogueID == OtherID);
+
+    return true;
+}
+
+#if WITH_EDITOR
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLODialogueCSVImportTest, "RLO.Dialogue.CSVImport",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FRLODialogueCSVImportTest::RunTest(const FString& Parameters)
+{
+    // 与发行表格相同的表头和引号、逗号写法
+    FString CSV = TEXT("RowName,DialogueID,Speaker,SpeakerEN,DialogueText,DialogueTextEN,TriggerEvent,DialogueType,AudioPath,Duration\n");
+    for (int32 Index = 0; Index < NumTestLines; Index++)
+    {
+        CSV += FString::Printf(TEXT("%d,Line_%d,主角,Protagonist,\"第%d句,星盘缓缓转动。\",\"Line %d, the orrery slowly turns.\",OnTrigger_%d,Monologue,/Game/Audio/VO/Line_%d,3.0\n"),
+                               Index + 1, Index, Index, Index, Index, Index);
+    }
+
+    const FString FilePath = FPaths::AutomationTransientDir() / TEXT("Dialogue.csv");
+    if (!TestTrue(TEXT("CSV written"), FFileHelper::SaveStringToFile(CSV, *FilePath, FFileHelper::EEncodingOptions::ForceUTF8)))
+    {
+        return false;
+    }
+
+    UDialogueDataAsset* Asset = NewObject<UDialogueDataAsset>(GetTransientPackage());
+    TestTrue(TEXT("Import succeeded"), Asset->ImportFromCSV(FilePath));
+    IFileManager::Get().Delete(*FilePath);
+    TestEqual(TEXT("Imported rows"), Asset->DialogueEntries.Num(), NumTestLines);
+
+    const FDialogueEntry* Last = Asset->FindDialogueEntry(MakeIndexedName(TEXT("Line"), NumTestLines - 1));
+    if (!TestNotNull(TEXT("Last row found"), Last))
+    {
+        return false;
+    }
+    TestEqual(TEXT("Quoted text with a comma"), Last->TextEN.ToString(), FString::Printf(TEXT("Line %d, the orrery slowly turns."), NumTestLines - 1));
+    TestEqual(TEXT("Chinese text with a comma"), Last->TextCN.ToString(), FString::Printf(TEXT("第%d句,星盘缓缓转动。"), NumTestLines - 1));
+    TestEqual(TEXT("Duration"), Last->Duration, 3.0f);
+
+    const FDialogueEntry* ByTrigger = Asset->FindDialogueByTrigger(MakeIndexedName(TEXT("OnTrigger"), 0));
+    TestTrue(TEXT("Trigger index rebuilt after import"), ByTrigger && ByTrigger->DialogueID == MakeIndexedName(TEXT("Line"), 0));
+
+    return true;
+}
+#endif
+
+#endif
@@ -0,0 +1,180 @@
+// InteractableComponentTest.cpp
+
+#include "RLOTestWorld.h"
+#include "InteractableComponent.h"
+#include "InventoryComponent.h"
+#include "ItemDataAsset.h"
+#include "Components/StaticMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLOInteractableSwipeValidationTest, "RLO.Interaction.SwipeValidation",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLOInteractableSwipeValidationTest::RunTest(const FString& Parameters)
+{
+    UInteractableComponent* Interactable = NewObject<UInteractableComponent>(GetTransientPackage());
+    Interactable->MinSwipeDistance = 50.0f;
+    Interactable->SwipeAngleTolerance = 30.0f;
+
+    // 距离阈值、角度容差、跨越0度
+    struct FCase
+    {
+        ESwipeDirection Direction;
+        FVector2D Vector;
+        bool bExpected;
+    };
+    const FCase Cases[] =
+    {
+        { ESwipeDirection::Right, FVector2D(100.0f, 0.0f), true },
+        { ESwipeDirection::Right, FVector2D(10.0f, 0.0f), false },
+        { ESwipeDirection::Right, FVector2D(100.0f, 100.0f), false },
+        { ESwipeDirection::Right, FVector2D(100.0f, -40.0f), true },
+        { ESwipeDirection::Right, FVector2D(-100.0f, 0.0f), false },
+        { ESwipeDirection::Left, FVector2D(-100.0f, 20.0f), true },
+        { ESwipeDirection::Up, FVector2D(0.0f, 100.0f), true },
+        { ESwipeDirection::Down, FVector2D(0.0f, -100.0f), true },
+        { ESwipeDirection::Any, FVector2D(0.0f, 60.0f), true },
+        { ESwipeDirection::Any, FVector2D(0.0f, 10.0f), false },
+    };
+    for (const FCase& Case : Cases)
+    {
+        Interactable->RequiredSwipeDirection = Case.Direction;
+        TestEqual(FString::Printf(TEXT("Direction %d, vector %s"), static_cast<int32>(Case.Direction), *Case.Vector.ToString()),
+                  Interactable->IsSwipeDirectionValid(Case.Vector), Case.bExpected);
+    }
+
+    return true;
+}
+
+namespace
+{
+    /** 在测试世界中生成一个带网格体的可交互对象（注册后与关卡中放置的对象相同） */
+    UInteractableComponent* SpawnInteractable(UWorld* World, EInteractionType Type, EInteractionMode Mode)
+    {
+        AActor* Actor = World->SpawnActor<AActor>();
+        UStaticMeshComponent* Mesh = NewObject<UStaticMeshComponent>(Actor, TEXT("Mesh"));
+        Actor->SetRootComponent(Mesh);
+        Mesh->RegisterComponent();
+
+        UInteractableComponent* Interactable = NewObject<UInteractableComponent>(Actor);
+        Interactable->InteractionType = Type;
+        Interactable->InteractionMode = Mode;
+        Interactable->RegisterComponent();
+        return Interactable;
+    }
+
+    /** Tick函数是否执行过（从未执行时上次Tick时间为负） */
+    bool HasTicked(const UInteractableComponent* Interactable)
+    {
+        return Interactable->PrimaryComponentTick.GetLastTickGameTime() >= 0.0f;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLOInteractableIdleTickTest, "RLO.Interaction.IdleTick",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLOInteractableIdleTickTest::RunTest(const FString& Parameters)
+{
+    FRLOScopedTestWorld World;
+    if (!TestTrue(TEXT("Test world created"), static_cast<bool>(World)))
+    {
+        return false;
+    }
+
+    // 一个房间中各种模式的可交互对象，空闲时都不Tick
+    TArray<UInteractableComponent*> Interactables;
+    const EInteractionMode Modes[] = { EInteractionMode::Tap, EInteractionMode::Swipe, EInteractionMode::Rotate, EInteractionMode::LongPress };
+    for (const EInteractionMode Mode : Modes)
+    {
+        Interactables.Add(SpawnInteractable(World.Get(), EInteractionType::Custom, Mode));
+    }
+    UInteractableComponent* Dial = SpawnInteractable(World.Get(), EInteractionType::RotateObject, EInteractionMode::Rotate);
+    Dial->TargetRotationAngle = 90.0f;
+    Interactables.Add(Dial);
+
+    World.Tick(10);
+    for (const UInteractableComponent* Interactable : Interactables)
+    {
+        const FString Mode = StaticEnum<EInteractionMode>()->GetNameStringByValue(static_cast<int64>(Interactable->InteractionMode));
+        TestFalse(FString::Printf(TEXT("Idle %s interactable tick disabled"), *Mode), Interactable->IsComponentTickEnabled());
+        TestFalse(FString::Printf(TEXT("Idle %s interactable never ticked"), *Mode), HasTicked(Interactable));
+    }
+
+    // 旋转到目标角度在 UpdateRotation 中检查，不需要Tick
+    Dial->BeginRotation();
+    Dial->UpdateRotation(45.0f);
+    World.Tick(5);
+    Dial->UpdateRotation(45.0f);
+    Dial->EndRotation();
+    World.Tick(5);
+    TestEqual(TEXT("Dial reached the target angle"), Dial->GetCurrentRotationAngle(), 90.0f, KINDA_SMALL_NUMBER);
+    TestFalse(TEXT("Rotating never enables the tick"), HasTicked(Dial));
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLOInteractableLongPressTimingTest, "RLO.Interaction.LongPressTiming",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLOInteractableLongPressTimingTest::RunTest(const FString& Parameters)
+{
+    FRLOScopedTestWorld World;
+    if (!TestTrue(TEXT("Test world created"), static_cast<bool>(World)))
+    {
+        return false;
+    }
+
+    APlayerController* PlayerController = World->SpawnActor<APlayerController>();
+    UInventoryComponent* Inventory = NewObject<UInventoryComponent>(PlayerController, TEXT("Inventory"));
+    Inventory->bPlayPickupSound = false;
+    Inventory->RegisterComponent();
+
+    UItemDataAsset* Item = NewObject<UItemDataAsset>(GetTransientPackage());
+    Item->ItemID = TEXT("LongPressTimingItem");
+    Item->ItemName = FText::FromString(TEXT("Long Press Timing Item"));
+
+    UInteractableComponent* Interactable = SpawnInteractable(World.Get(), EInteractionType::Pickup, EInteractionMode::LongPress);
+    Interactable->LongPressDuration = 0.5f;
+    Interactable->PickupItemData = Item;
+    Interactable->bDestroyAfterPickup = false;
+
+    // 长按期间才Tick
+    Interactable->BeginLongPress(PlayerController);
+    TestTrue(TEXT("Tick enabled while long pressing"), Interactable->IsComponentTickEnabled());
+
+    // 零时长的帧（暂停、加载卡顿后的首帧）不推进计时
+    World.Tick(10, 0.0f);
+    TestEqual(TEXT("Zero-delta frames keep progress at zero"), Interactable->GetLongPressProgress(), 0.0f);
+    TestTrue(TEXT("Still ticking after zero-delta frames"), Interactable->IsComponentTickEnabled());
+    TestEqual(TEXT("No pickup after zero-delta frames"), Inventory->GetItemQuantity(Item), 0);
+
+    // 按实际经过的时间推进：0.4秒未完成，0.5秒完成且只触发一次
+    World.Tick(4, 0.1f);
+    TestEqual(TEXT("Progress after 0.4 seconds"), Interactable->GetLongPressProgress(), 0.8f, KINDA_SMALL_NUMBER);
+    TestEqual(TEXT("No pickup before the duration"), Inventory->GetItemQuantity(Item), 0);
+    World.Tick(1, 0.1f);
+    TestEqual(TEXT("Pickup after the duration"), Inventory->GetItemQuantity(Item), 1);
+    TestFalse(TEXT("Tick disabled after completion"), Interactable->IsComponentTickEnabled());
+
+    // 完成后不再Tick
+    const float LastTickTime = Interactable->PrimaryComponentTick.GetLastTickGameTime();
+    World.Tick(10);
+    TestEqual(TEXT("No ticks after completion"), Interactable->PrimaryComponentTick.GetLastTickGameTime(), LastTickTime);
+    TestEqual(TEXT("Pickup fired once"), Inventory->GetItemQuantity(Item), 1);
+
+    // 取消后同样停止Tick
+    Interactable->BeginLongPress(PlayerController);
+    World.Tick(2, 0.1f);
+    Interactable->CancelLongPress();
+    TestFalse(TEXT("Tick disabled after cancel"), Interactable->IsComponentTickEnabled());
+    TestEqual(TEXT("Progress reset after cancel"), Interactable->GetLongPressProgress(), 0.0f);
+    World.Tick(10, 0.1f);
+    TestEqual(TEXT("Cancelled press does not fire"), Inventory->GetItemQuantity(Item), 1);
+
+    return true;
+}
+
+#endif
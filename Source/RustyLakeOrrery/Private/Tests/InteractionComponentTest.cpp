@@ -0,0 +1,133 @@
+// InteractionComponentTest.cpp
+
+#include "RLOTestWorld.h"
+#include "InteractionComponent.h"
+#include "InteractableComponent.h"
+#include "InventoryComponent.h"
+#include "ItemDataAsset.h"
+#include "Components/BoxComponent.h"
+#include "Components/InputComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "GameFramework/WorldSettings.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    /** 虚拟视口尺寸，镜头位于原点朝向+X（FOV 90），视口中心对准 TargetLocation */
+    const FVector2D ViewportSize(1920.0f, 1080.0f);
+    const FVector2D ViewportCenter = ViewportSize * 0.5f;
+    const FVector TargetLocation(1000.0f, 0.0f, 0.0f);
+
+    /** 玩家控制器、背包和位于视口中心的长按拾取对象 */
+    struct FLongPressScene
+    {
+        UInteractionComponent* Interaction = nullptr;
+        UInteractableComponent* Interactable = nullptr;
+        UInventoryComponent* Inventory = nullptr;
+        UItemDataAsset* Item = nullptr;
+
+        explicit FLongPressScene(UWorld* World)
+        {
+            APlayerController* PlayerController = World->SpawnActor<APlayerController>();
+            PlayerController->InputComponent = NewObject<UInputComponent>(PlayerController, TEXT("PC_InputComponent0"));
+            PlayerController->InputComponent->RegisterComponent();
+
+            Interaction = NewObject<UInteractionComponent>(PlayerController, TEXT("InteractionComponent"));
+            Interaction->SetSyntheticViewportSize(ViewportSize);
+            Interaction->RegisterComponent();
+
+            Inventory = NewObject<UInventoryComponent>(PlayerController, TEXT("Inventory"));
+            Inventory->bPlayPickupSound = false;
+            Inventory->RegisterComponent();
+
+            Item = NewObject<UItemDataAsset>(GetTransientPackage());
+            Item->ItemID = TEXT("LongPressItem");
+            Item->ItemName = FText::FromString(TEXT("Long Press Item"));
+
+            AActor* Target = World->SpawnActor<AActor>();
+            UBoxComponent* Box = NewObject<UBoxComponent>(Target, TEXT("Box"));
+            Box->SetBoxExtent(FVector(50.0f));
+            Box->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+            Target->SetRootComponent(Box);
+            Box->SetWorldLocation(TargetLocation);
+            Box->RegisterComponent();
+
+            Interactable = NewObject<UInteractableComponent>(Target, TEXT("Interactable"));
+            Interactable->InteractionType = EInteractionType::Pickup;
+            Interactable->InteractionMode = EInteractionMode::LongPress;
+            Interactable->LongPressDuration = 0.5f;
+            Interactable->PickupItemData = Item;
+            Interactable->bDestroyAfterPickup = false;
+            Interactable->RegisterComponent();
+        }
+
+        void Touch(UWorld* World, ERLOTouchPhase Phase) const
+        {
+            Interaction->InjectTouchSample(FRLOTouchSample(0, Phase, ViewportCenter, World->GetRealTimeSeconds()));
+        }
+    };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLOInteractionLongPressTest, "RLO.Interaction.LongPress",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLOInteractionLongPressTest::RunTest(const FString& Parameters)
+{
+    FRLOScopedTestWorld World;
+    if (!TestTrue(TEXT("Test world created"), static_cast<bool>(World)))
+    {
+        return false;
+    }
+
+    const FLongPressScene Scene(World.Get());
+    const float Tolerance = 0.1f;
+
+    // 按住一半时间：只有识别器计时，可交互对象镜像其进度，交互尚未触发
+    Scene.Touch(World.Get(), ERLOTouchPhase::Began);
+    TestFalse(TEXT("Interactable runs no clock of its own"), Scene.Interactable->IsComponentTickEnabled());
+    World.Tick(15);
+    TestEqual(TEXT("Recognizer progress at half duration"), Scene.Interaction->GetLongPressProgress(), 0.5f, Tolerance);
+    TestEqual(TEXT("Interactable progress at half duration"), Scene.Interactable->GetLongPressProgress(), 0.5f, Tolerance);
+    TestEqual(TEXT("No pickup before the duration"), Scene.Inventory->GetItemQuantity(Scene.Item), 0);
+
+    // 按满时长：交互只触发一次，松手后不再重复
+    World.Tick(20);
+    TestEqual(TEXT("Interactable progress after the duration"), Scene.Interactable->GetLongPressProgress(), 1.0f);
+    TestEqual(TEXT("Pickup fired once"), Scene.Inventory->GetItemQuantity(Scene.Item), 1);
+    TestFalse(TEXT("Interactable stops ticking after completion"), Scene.Interactable->IsComponentTickEnabled());
+    Scene.Touch(World.Get(), ERLOTouchPhase::Ended);
+    World.Tick(1);
+    TestEqual(TEXT("Release does not fire again"), Scene.Inventory->GetItemQuantity(Scene.Item), 1);
+
+    // 提前松手：取消长按，之后不会触发
+    Scene.Touch(World.Get(), ERLOTouchPhase::Began);
+    World.Tick(12);
+    Scene.Touch(World.Get(), ERLOTouchPhase::Ended);
+    TestEqual(TEXT("Interactable progress resets on early release"), Scene.Interactable->GetLongPressProgress(), 0.0f);
+    TestFalse(TEXT("Interactable stops ticking on early release"), Scene.Interactable->IsComponentTickEnabled());
+    World.Tick(60);
+    TestEqual(TEXT("Early release does not fire"), Scene.Inventory->GetItemQuantity(Scene.Item), 1);
+
+    // 时间膨胀：游戏时间加速4倍，触发时刻仍只由识别器的真实时间决定
+    AWorldSettings* WorldSettings = World->GetWorldSettings();
+    if (!TestNotNull(TEXT("World settings"), WorldSettings))
+    {
+        return false;
+    }
+    WorldSettings->TimeDilation = 4.0f;
+    Scene.Touch(World.Get(), ERLOTouchPhase::Began);
+    World.Tick(15);
+    TestEqual(TEXT("Dilated progress follows real time"), Scene.Interactable->GetLongPressProgress(), 0.5f, Tolerance);
+    TestEqual(TEXT("Dilated game time does not fire early"), Scene.Inventory->GetItemQuantity(Scene.Item), 1);
+    World.Tick(20);
+    TestEqual(TEXT("Dilated long press fires once"), Scene.Inventory->GetItemQuantity(Scene.Item), 2);
+    Scene.Touch(World.Get(), ERLOTouchPhase::Ended);
+    WorldSettings->TimeDilation = 1.0f;
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,247 @@
+// InventoryComponentTest.cpp
+
+#include "InventoryComponent.h"
+#include "ItemDataAsset.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** 访问背包组件的私有状态（只在自动化测试中使用） */
+struct FRLOInventoryComponentTestAccess
+{
+    static FInventoryDelta ConsumePendingChanges(UInventoryComponent& Inventory) { return Inventory.ConsumePendingChanges(); }
+};
+
+namespace
+{
+    /** 创建测试物品（ID和名称为 TestItem_<序号>） */
+    TArray<UItemDataAsset*> CreateTestItems(int32 NumItems)
+    {
+        TArray<UItemDataAsset*> Items;
+        for (int32 Index = 0; Index < NumItems; Index++)
+        {
+            UItemDataAsset* Item = NewObject<UItemDataAsset>(GetTransientPackage());
+            Item->ItemID = FName(*FString::Printf(TEXT("TestItem_%d"), Index));
+            Item->ItemName = FText::FromName(Item->ItemID);
+            Items.Add(Item);
+        }
+        return Items;
+    }
+
+    /** 创建不在世界中的背包（不播放拾取音效） */
+    UInventoryComponent* CreateTestInventory(int32 MaxCapacity)
+    {
+        UInventoryComponent* Inventory = NewObject<UInventoryComponent>(GetTransientPackage());
+        Inventory->MaxCapacity = MaxCapacity;
+        Inventory->bPlayPickupSound = false;
+        return Inventory;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLOInventoryOperationsTest, "RLO.Inventory.Operations",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLOInventoryOperationsTest::RunTest(const FString& Parameters)
+{
+    const int32 NumItems = 32;
+    const TArray<UItemDataAsset*> Items = CreateTestItems(NumItems);
+    UInventoryComponent* Inventory = CreateTestInventory(NumItems);
+
+    // 添加全部物品，背包已满
+    for (UItemDataAsset* Item : Items)
+    {
+        if (!TestTrue(FString::Printf(TEXT("Add %s"), *Item->ItemID.ToString()), Inventory->AddItem(Item, 1)))
+        {
+            return false;
+        }
+    }
+    TestTrue(TEXT("Inventory full"), Inventory->IsFull());
+    TestTrue(TEXT("Slot indices after adds"), Inventory->VerifySlotIndices());
+
+    // 无效物品不能添加
+    AddExpectedError(TEXT("ItemData is not valid"), EAutomationExpectedErrorFlags::Contains, 1);
+    TestFalse(TEXT("Invalid item rejected"), Inventory->AddItem(NewObject<UItemDataAsset>(GetTransientPackage()), 1));
+
+    // 移除一半后，索引仍一致，查找结果正确
+    for (int32 Index = 0; Index < NumItems; Index += 2)
+    {
+        TestTrue(FString::Printf(TEXT("Remove item %d"), Index), Inventory->RemoveItem(Items[Index], 1));
+    }
+    TestTrue(TEXT("Slot indices after removals"), Inventory->VerifySlotIndices());
+    for (int32 Index = 0; Index < NumItems; Index++)
+    {
+        const bool bShouldExist = (Index % 2) == 1;
+        TestEqual(FString::Printf(TEXT("Item %d found by ID"), Index), Inventory->FindItemByID(Items[Index]->ItemID) == Items[Index], bShouldExist);
+        TestEqual(FString::Printf(TEXT("Item %d quantity"), Index), Inventory->GetItemQuantity(Items[Index]), bShouldExist ? 1 : 0);
+    }
+
+    // 按拾取顺序全部移除（后面的槽位都要前移）
+    for (int32 Index = 1; Index < NumItems; Index += 2)
+    {
+        Inventory->RemoveItem(Items[Index], 1);
+    }
+    TestTrue(TEXT("Inventory empty"), Inventory->IsEmpty());
+    TestTrue(TEXT("Slot indices when empty"), Inventory->VerifySlotIndices());
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLOInventoryRandomOperationsTest, "RLO.Inventory.RandomOperations",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLOInventoryRandomOperationsTest::RunTest(const FString& Parameters)
+{
+    const int32 NumSeeds = 8;
+    const int32 NumSteps = 500;
+    const int32 MaxCapacity = 6;
+    const int32 MaxStackSize = 5;
+
+    // 随机序列中必然出现的失败操作
+    AddExpectedError(TEXT("Inventory is full"), EAutomationExpectedErrorFlags::Contains, 0);
+    AddExpectedError(TEXT("is not stackable"), EAutomationExpectedErrorFlags::Contains, 0);
+    AddExpectedError(TEXT("reached max stack size"), EAutomationExpectedErrorFlags::Contains, 0);
+    AddExpectedError(TEXT("RemoveItem failed"), EAutomationExpectedErrorFlags::Contains, 0);
+    AddExpectedError(TEXT("SwapItems failed"), EAutomationExpectedErrorFlags::Contains, 0);
+
+    // 物品比容量多，一半可堆叠，类型和名称各不相同（排序会真正移动槽位）
+    const TArray<UItemDataAsset*> Items = CreateTestItems(10);
+    for (int32 Index = 0; Index < Items.Num(); Index++)
+    {
+        Items[Index]->bStackable = (Index % 2) == 0;
+        Items[Index]->MaxStackSize = MaxStackSize;
+        Items[Index]->ItemType = static_cast<EItemType>(Index % 5);
+        Items[Index]->ItemName = FText::FromString(FString::Printf(TEXT("%c_Item"), TEXT('J') - Index));
+    }
+
+    for (int32 Seed = 0; Seed < NumSeeds; Seed++)
+    {
+        FRandomStream Stream(Seed);
+        UInventoryComponent* Inventory = CreateTestInventory(MaxCapacity);
+
+        // 参照模型：物品 -> 数量
+        TMap<UItemDataAsset*, int32> Expected;
+
+        for (int32 Step = 0; Step < NumSteps; Step++)
+        {
+            UItemDataAsset* Item = Items[Stream.RandHelper(Items.Num())];
+            const int32 Quantity = Stream.RandRange(1, 3);
+            const int32 Operation = Stream.RandHelper(100);
+            FString Description;
+
+            if (Operation < 40)
+            {
+                Description = FString::Printf(TEXT("Add %s x%d"), *Item->ItemID.ToString(), Quantity);
+                int32* Existing = Expected.Find(Item);
+                const bool bExpectAdded = Existing ? Item->bStackable : Expected.Num() < MaxCapacity;
+                TestEqual(FString::Printf(TEXT("Seed %d step %d: %s result"), Seed, Step, *Description), Inventory->AddItem(Item, Quantity), bExpectAdded);
+                if (bExpectAdded)
+                {
+                    const int32 NewQuantity = (Existing ? *Existing : 0) + Quantity;
+                    Expected.Add(Item, Item->bStackable ? FMath::Min(NewQuantity, MaxStackSize) : NewQuantity);
+                }
+            }
+            else if (Operation < 70)
+            {
+                Description = FString::Printf(TEXT("Remove %s x%d"), *Item->ItemID.ToString(), Quantity);
+                int32* Existing = Expected.Find(Item);
+                const bool bExpectRemoved = Existing && *Existing >= Quantity;
+                TestEqual(FString::Printf(TEXT("Seed %d step %d: %s result"), Seed, Step, *Description), Inventory->RemoveItem(Item, Quantity), bExpectRemoved);
+                if (bExpectRemoved && (*Existing -= Quantity) == 0)
+                {
+                    Expected.Remove(Item);
+                }
+            }
+            else if (Operation < 90)
+            {
+                // 偶尔使用越界的索引
+                const int32 IndexA = Stream.RandRange(-1, MaxCapacity);
+                const int32 IndexB = Stream.RandRange(0, MaxCapacity - 1);
+                Description = FString::Printf(TEXT("Swap %d %d"), IndexA, IndexB);
+                const bool bExpectSwapped = IndexA >= 0 && IndexA < Expected.Num() && IndexB < Expected.Num();
+                TestEqual(FString::Printf(TEXT("Seed %d step %d: %s result"), Seed, Step, *Description), Inventory->SwapItems(IndexA, IndexB), bExpectSwapped);
+            }
+            else if (Operation < 98)
+            {
+                const bool bSortByType = Stream.FRand() < 0.5f;
+                Description = bSortByType ? TEXT("Sort by type") : TEXT("Sort by name");
+                Inventory->SortInventory(bSortByType);
+            }
+            else
+            {
+                Description = TEXT("Clear");
+                Inventory->ClearInventory();
+                Expected.Reset();
+            }
+
+            // 每步之后索引与槽位一致，查找结果与参照模型相同
+            const FString Context = FString::Printf(TEXT("Seed %d step %d (%s)"), Seed, Step, *Description);
+            bool bConsistent = Inventory->VerifySlotIndices() && Inventory->GetItemCount() == Expected.Num();
+            for (UItemDataAsset* Checked : Items)
+            {
+                const int32* ExpectedQuantity = Expected.Find(Checked);
+                bConsistent &= Inventory->GetItemQuantity(Checked) == (ExpectedQuantity ? *ExpectedQuantity : 0);
+                bConsistent &= (Inventory->FindItemByID(Checked->ItemID) == Checked) == (ExpectedQuantity != nullptr);
+            }
+            if (!TestTrue(FString::Printf(TEXT("%s: inventory matches the model"), *Context), bConsistent))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLOInventoryRestoreTest, "RLO.Inventory.RestoreFromSave",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLOInventoryRestoreTest::RunTest(const FString& Parameters)
+{
+    const TArray<UItemDataAsset*> Items = CreateTestItems(3);
+    UInventoryComponent* Saved = CreateTestInventory(0);
+    for (int32 Index = 0; Index < Items.Num(); Index++)
+    {
+        Saved->AddItem(Items[Index], 1);
+    }
+
+    TArray<uint8> Record;
+    FMemoryWriter Writer(Record);
+    Saved->SerializeSaveRecord(Writer);
+
+    // 在事务中恢复，变化不广播，留给测试读取
+    UInventoryComponent* Restored = CreateTestInventory(0);
+    Restored->BeginTransaction();
+    FMemoryReader Reader(Record);
+    Restored->SerializeSaveRecord(Reader);
+    const FInventoryDelta Delta = FRLOInventoryComponentTestAccess::ConsumePendingChanges(*Restored);
+    Restored->EndTransaction();
+
+    for (UItemDataAsset* Item : Items)
+    {
+        TestEqual(FString::Printf(TEXT("%s restored"), *Item->ItemID.ToString()), Restored->GetItemQuantity(Item), 1);
+    }
+
+    // 恢复作为整体刷新广播，任何物品都不算拾取（不弹出获得提示）
+    TestTrue(TEXT("Delta marked as restored"), Delta.bRestored);
+    TestEqual(TEXT("Restore refreshes every slot"), Delta.FirstMovedSlot, 0);
+    TestEqual(TEXT("Restored items reported"), Delta.ChangedItems.Num(), Items.Num());
+    for (const FInventoryItemChange& Change : Delta.ChangedItems)
+    {
+        TestFalse(TEXT("Restored item is not a pickup"), Delta.IsPickup(Change));
+    }
+
+    // 之后的拾取照常报告
+    UItemDataAsset* NewItem = CreateTestItems(4).Last();
+    Restored->BeginTransaction();
+    Restored->AddItem(NewItem, 1);
+    const FInventoryDelta PickupDelta = FRLOInventoryComponentTestAccess::ConsumePendingChanges(*Restored);
+    Restored->EndTransaction();
+    TestFalse(TEXT("Pickup delta not marked as restored"), PickupDelta.bRestored);
+    TestTrue(TEXT("Pickup reported"), PickupDelta.ChangedItems.Num() == 1 && PickupDelta.IsPickup(PickupDelta.ChangedItems[0]));
+
+    return true;
+}
+
+#endif
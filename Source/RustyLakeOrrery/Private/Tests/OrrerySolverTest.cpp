@@ -0,0 +1,208 @@
+// OrrerySolverTest.cpp
+
+#include "RLOTestWorld.h"
+#include "RLOOrrerySolver.h"
+#include "OrreryPuzzle.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    int32 WrapStep(int64 Step, int32 NumSteps)
+    {
+        const int32 Result = static_cast<int32>(Step % NumSteps);
+        return Result < 0 ? Result + NumSteps : Result;
+    }
+
+    /** 随机生成一个状态数不超过广度优先搜索上限的谜题 */
+    FRLOOrreryDefinition MakeRandomDefinition(FRandomStream& Stream)
+    {
+        FRLOOrreryDefinition Definition;
+        const int32 NumRings = Stream.RandRange(1, 5);
+        for (int32 Ring = 0; Ring < NumRings; Ring++)
+        {
+            Definition.NumSteps.Add(Stream.RandRange(2, 12));
+            Definition.Turnable.Add(Stream.FRand() < 0.8f);
+        }
+        for (int32 Ring = 0; Ring < NumRings; Ring++)
+        {
+            for (int32 Other = 0; Other < NumRings; Other++)
+            {
+                const bool bCoupled = Ring == Other || Stream.FRand() < 0.4f;
+                Definition.Coupling.Add(bCoupled ? Stream.RandRange(-3, 3) : 0);
+            }
+        }
+        Definition.bAllowReverse = Stream.FRand() < 0.7f;
+        return Definition;
+    }
+
+    /**
+     * @brief 检查解是否合法:按转动次数转动后到达目标,且只转动可转动的环
+     * @return 不合法时的原因,合法时为空
+     */
+    FString CheckSolution(const FRLOOrreryDefinition& Definition, const TArray<int32>& FromSteps, const TArray<int32>& ToSteps,
+                          const TArray<int32>& Turns, int32 NumMoves)
+    {
+        const int32 NumRings = Definition.GetNumRings();
+        if (Turns.Num() != NumRings)
+        {
+            return FString::Printf(TEXT("%d turn counts for %d rings"), Turns.Num(), NumRings);
+        }
+
+        TArray<int32> Steps = FromSteps;
+        int32 TotalTurns = 0;
+        for (int32 Ring = 0; Ring < NumRings; Ring++)
+        {
+            if (Turns[Ring] != 0 && !Definition.Turnable[Ring])
+            {
+                return FString::Printf(TEXT("ring %d is not turnable"), Ring);
+            }
+            if (Turns[Ring] < 0 && !Definition.bAllowReverse)
+            {
+                return FString::Printf(TEXT("ring %d turned in reverse"), Ring);
+            }
+            TotalTurns += FMath::Abs(Turns[Ring]);
+            for (int32 Other = 0; Other < NumRings; Other++)
+            {
+                Steps[Other] = WrapStep(Steps[Other] + static_cast<int64>(Turns[Ring]) * Definition.Coupling[Ring * NumRings + Other], Definition.NumSteps[Other]);
+            }
+        }
+
+        if (TotalTurns != NumMoves)
+        {
+            return FString::Printf(TEXT("%d turns reported as %d moves"), TotalTurns, NumMoves);
+        }
+        for (int32 Ring = 0; Ring < NumRings; Ring++)
+        {
+            if (Steps[Ring] != WrapStep(ToSteps[Ring], Definition.NumSteps[Ring]))
+            {
+                return FString::Printf(TEXT("ring %d ends at step %d, expected %d"), Ring, Steps[Ring], ToSteps[Ring]);
+            }
+        }
+        return FString();
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLOOrrerySolverCrossCheckTest, "RLO.Puzzle.OrrerySolverCrossCheck",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLOOrrerySolverCrossCheckTest::RunTest(const FString& Parameters)
+{
+    // 广度优先搜索和中间相遇求解同一个随机谜题,结果和最少操作数必须相同
+    const int32 NumPuzzles = 500;
+    FRandomStream Stream(20261017);
+    int32 NumSolved = 0;
+    int32 NumUnsolvable = 0;
+
+    for (int32 Puzzle = 0; Puzzle < NumPuzzles; Puzzle++)
+    {
+        const FRLOOrreryDefinition Definition = MakeRandomDefinition(Stream);
+        TArray<int32> FromSteps;
+        TArray<int32> ToSteps;
+        for (const int32 NumSteps : Definition.NumSteps)
+        {
+            FromSteps.Add(Stream.RandHelper(NumSteps));
+            ToSteps.Add(Stream.RandHelper(NumSteps));
+        }
+
+        TArray<int32> BreadthFirstTurns;
+        int32 BreadthFirstMoves = 0;
+        const ERLOOrrerySolveResult BreadthFirstResult = FRLOOrrerySolver::Solve(Definition, FromSteps, ToSteps, BreadthFirstTurns, BreadthFirstMoves,
+                                                                                  ERLOOrrerySolveMethod::BreadthFirst);
+
+        TArray<int32> MeetInTheMiddleTurns;
+        int32 MeetInTheMiddleMoves = 0;
+        const ERLOOrrerySolveResult MeetInTheMiddleResult = FRLOOrrerySolver::Solve(Definition, FromSteps, ToSteps, MeetInTheMiddleTurns, MeetInTheMiddleMoves,
+                                                                                     ERLOOrrerySolveMethod::MeetInTheMiddle);
+
+        const FString Context = FString::Printf(TEXT("Puzzle %d (%d rings)"), Puzzle, Definition.GetNumRings());
+        if (!TestEqual(FString::Printf(TEXT("%s: same result"), *Context),
+                       FString(FRLOOrrerySolver::GetResultName(MeetInTheMiddleResult)), FString(FRLOOrrerySolver::GetResultName(BreadthFirstResult))))
+        {
+            return false;
+        }
+
+        if (BreadthFirstResult == ERLOOrrerySolveResult::Unsolvable)
+        {
+            NumUnsolvable++;
+            continue;
+        }
+        if (!TestEqual(FString::Printf(TEXT("%s: solved"), *Context), FString(FRLOOrrerySolver::GetResultName(BreadthFirstResult)), FString(TEXT("Solved"))))
+        {
+            return false;
+        }
+        NumSolved++;
+
+        const FString BreadthFirstError = CheckSolution(Definition, FromSteps, ToSteps, BreadthFirstTurns, BreadthFirstMoves);
+        const FString MeetInTheMiddleError = CheckSolution(Definition, FromSteps, ToSteps, MeetInTheMiddleTurns, MeetInTheMiddleMoves);
+        if (!TestTrue(FString::Printf(TEXT("%s: breadth-first solution valid (%s)"), *Context, *BreadthFirstError), BreadthFirstError.IsEmpty())
+            || !TestTrue(FString::Printf(TEXT("%s: meet-in-the-middle solution valid (%s)"), *Context, *MeetInTheMiddleError), MeetInTheMiddleError.IsEmpty())
+            || !TestEqual(FString::Printf(TEXT("%s: same minimal move count"), *Context), MeetInTheMiddleMoves, BreadthFirstMoves))
+        {
+            return false;
+        }
+    }
+
+    // 随机谜题中两种情况都应该出现,否则生成器需要调整
+    TestTrue(TEXT("Some random puzzles are solvable"), NumSolved > 0);
+    TestTrue(TEXT("Some random puzzles are unsolvable"), NumUnsolvable > 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLOOrreryAsyncSolveTest, "RLO.Puzzle.OrreryAsyncSolve",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLOOrreryAsyncSolveTest::RunTest(const FString& Parameters)
+{
+    FRLOScopedTestWorld World;
+    if (!TestTrue(TEXT("Test world created"), static_cast<bool>(World)))
+    {
+        return false;
+    }
+
+    // 两个独立的环:环0离目标3步,环1离目标2步
+    AOrreryPuzzle* Puzzle = World->SpawnActorDeferred<AOrreryPuzzle>(AOrreryPuzzle::StaticClass(), FTransform::Identity);
+    Puzzle->bAutoActivate = false;
+    for (const int32 TargetStep : { 3, 2 })
+    {
+        FOrreryRing& Ring = Puzzle->Rings.AddDefaulted_GetRef();
+        Ring.NumSteps = 12;
+        Ring.TargetStep = TargetStep;
+    }
+    Puzzle->FinishSpawning(FTransform::Identity);
+
+    // 激活时在后台求解,完成前没有提示
+    Puzzle->ActivatePuzzle();
+    TestTrue(TEXT("Solving after activation"), Puzzle->IsSolving());
+    int32 RingIndex = INDEX_NONE;
+    bool bReverse = false;
+    TestFalse(TEXT("No hint while solving"), Puzzle->GetNextMove(RingIndex, bReverse));
+    TestEqual(TEXT("No progress while solving"), Puzzle->GetProgress(), 0.0f);
+
+    Puzzle->WaitForSolution();
+    TestFalse(TEXT("Solved after waiting"), Puzzle->IsSolving());
+    TestEqual(TEXT("Remaining moves after activation"), Puzzle->GetRemainingMoveCount(), 5);
+    TestTrue(TEXT("Hint after solving"), Puzzle->GetNextMove(RingIndex, bReverse));
+
+    // 沿最优解走一步不需要重新求解
+    Puzzle->TurnRing(RingIndex, bReverse);
+    TestFalse(TEXT("Following the hint does not re-solve"), Puzzle->IsSolving());
+    TestEqual(TEXT("Remaining moves after following the hint"), Puzzle->GetRemainingMoveCount(), 4);
+    TestEqual(TEXT("Progress after following the hint"), Puzzle->GetProgress(), 0.2f, KINDA_SMALL_NUMBER);
+
+    // 走偏后在后台重新求解,完成前保留上一次的进度
+    Puzzle->TurnRing(1, true);
+    TestTrue(TEXT("Solving after a wrong turn"), Puzzle->IsSolving());
+    TestEqual(TEXT("Cached progress while solving"), Puzzle->GetProgress(), 0.2f, KINDA_SMALL_NUMBER);
+
+    // 求解期间再转动:取回的结果已过期,按最新状态重新求解
+    Puzzle->TurnRing(1, true);
+    Puzzle->WaitForSolution();
+    TestEqual(TEXT("Remaining moves after two wrong turns"), Puzzle->GetRemainingMoveCount(), 6);
+    TestTrue(TEXT("Progress after two wrong turns"), Puzzle->GetProgress() < 0.2f);
+
+    return true;
+}
+
+#endif
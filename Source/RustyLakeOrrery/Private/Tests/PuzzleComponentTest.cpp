@@ -0,0 +1,113 @@
+// PuzzleComponentTest.cpp
+
+#include "RLOTestWorld.h"
+#include "PuzzleComponent.h"
+#include "RotationPuzzle.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    UPuzzleComponent* CreatePart(APuzzleBase* Owner, const TCHAR* Name)
+    {
+        UPuzzleComponent* Part = NewObject<UPuzzleComponent>(Owner, Name);
+        Part->RegisterComponent();
+        return Part;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLOPuzzleLateAssignedComponentTest, "RLO.Puzzle.LateAssignedComponent",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLOPuzzleLateAssignedComponentTest::RunTest(const FString& Parameters)
+{
+    FRLOScopedTestWorld World;
+    if (!TestTrue(TEXT("Test world created"), static_cast<bool>(World)))
+    {
+        return false;
+    }
+
+    // 完成：PuzzleActor 在开始游戏后直接赋值（蓝图中的写法），完成时才登记
+    ARotationPuzzle* Puzzle = World->SpawnActor<ARotationPuzzle>();
+    Puzzle->ActivatePuzzle();
+
+    UPuzzleComponent* Linked = CreatePart(Puzzle, TEXT("Linked"));
+    Linked->SetPuzzleActor(Puzzle);
+    UPuzzleComponent* Late = CreatePart(Puzzle, TEXT("Late"));
+    Late->PuzzleActor = Puzzle;
+    TestEqual(TEXT("Late part is not counted before it changes"), Puzzle->GetRequiredComponentCount(), 1);
+
+    Late->CompleteComponent();
+    TestEqual(TEXT("Required count after late completion"), Puzzle->GetRequiredComponentCount(), 2);
+    TestEqual(TEXT("Completed count after late completion"), Puzzle->GetCompletedComponentCount(), 1);
+    TestFalse(TEXT("Puzzle waits for the linked part"), Puzzle->IsCompleted());
+
+    Linked->CompleteComponent();
+    TestEqual(TEXT("Completed count after all parts"), Puzzle->GetCompletedComponentCount(), 2);
+    TestTrue(TEXT("Puzzle completes after all parts"), Puzzle->IsCompleted());
+
+    // 重置：部件先在没有谜题时完成，之后才赋值 PuzzleActor
+    ARotationPuzzle* ResetPuzzle = World->SpawnActor<ARotationPuzzle>();
+    ResetPuzzle->ActivatePuzzle();
+
+    UPuzzleComponent* Detached = CreatePart(ResetPuzzle, TEXT("Detached"));
+    AddExpectedError(TEXT("No PuzzleActor set"), EAutomationExpectedErrorFlags::Contains, 0);
+    Detached->CompleteComponent();
+    Detached->PuzzleActor = ResetPuzzle;
+
+    Detached->ResetComponent();
+    TestEqual(TEXT("Required count after late reset"), ResetPuzzle->GetRequiredComponentCount(), 1);
+    TestEqual(TEXT("Completed count after late reset"), ResetPuzzle->GetCompletedComponentCount(), 0);
+
+    Detached->CompleteComponent();
+    TestEqual(TEXT("Completed count after completing again"), ResetPuzzle->GetCompletedComponentCount(), 1);
+    TestTrue(TEXT("Reset puzzle completes"), ResetPuzzle->IsCompleted());
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLOPuzzleCompletionTest, "RLO.Puzzle.Completion",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLOPuzzleCompletionTest::RunTest(const FString& Parameters)
+{
+    FRLOScopedTestWorld World;
+    if (!TestTrue(TEXT("Test world created"), static_cast<bool>(World)))
+    {
+        return false;
+    }
+
+    ARotationPuzzle* Puzzle = World->SpawnActor<ARotationPuzzle>();
+    TArray<UPuzzleComponent*> Parts;
+    for (int32 Index = 0; Index < 8; Index++)
+    {
+        UPuzzleComponent* Part = CreatePart(Puzzle, *FString::Printf(TEXT("Part_%d"), Index));
+        Part->SetPuzzleActor(Puzzle);
+        Parts.Add(Part);
+    }
+    Puzzle->ActivatePuzzle();
+
+    // 最后一个必需部件完成时谜题才完成，可选部件不影响
+    Parts.Last()->SetRequired(false);
+    TestEqual(TEXT("Required count excludes the optional part"), Puzzle->GetRequiredComponentCount(), Parts.Num() - 1);
+    for (int32 Index = 0; Index < Parts.Num() - 2; Index++)
+    {
+        Parts[Index]->CompleteComponent();
+        TestFalse(FString::Printf(TEXT("Not completed after part %d"), Index), Puzzle->IsCompleted());
+    }
+
+    // 同一部件重复完成不重复计数
+    AddExpectedError(TEXT("is already completed"), EAutomationExpectedErrorFlags::Contains, 1);
+    Parts[0]->CompleteComponent();
+    TestEqual(TEXT("Completed count after completing a part twice"), Puzzle->GetCompletedComponentCount(), Parts.Num() - 2);
+    TestFalse(TEXT("Not completed after completing a part twice"), Puzzle->IsCompleted());
+
+    Parts[Parts.Num() - 2]->CompleteComponent();
+    TestTrue(TEXT("Completed after all required parts"), Puzzle->IsCompleted());
+
+    return true;
+}
+
+#endif
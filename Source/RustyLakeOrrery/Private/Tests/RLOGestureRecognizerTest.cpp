@@ -0,0 +1,374 @@
+// RLOGestureRecognizerTest.cpp
+
+#include "RLOGestureRecognizer.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    /** 触摸采样间隔（约120Hz，与常见触摸屏的上报频率相同） */
+    const double TouchSampleInterval = 1.0 / 120.0;
+
+    /** 采样时间抖动（按序号循环，模拟真实录制中不均匀的上报间隔） */
+    const double TouchSampleJitter[] = { 0.0, 0.0015, -0.001, 0.002, -0.0015 };
+
+    /** 按下/抬起时相邻手指之间的间隔 */
+    const double PointerStagger = 0.01;
+
+    /** 屏幕中心 */
+    const FVector2D ScreenCenter(960.0f, 540.0f);
+
+    /** 手指轨迹：Alpha为0-1的移动进度 */
+    typedef TFunctionRef<FVector2D(int32 Pointer, float Alpha)> FPathFunction;
+
+    /** 一段录制的触摸序列 */
+    struct FGestureRecording
+    {
+        FString Name;
+        TArray<FRLOTouchSample> Samples;
+    };
+
+    /**
+     * @brief 录制一段手势
+     *
+     * 手指依次按下，之后按采样间隔同时沿轨迹移动，持续 Duration 后依次抬起。
+     * @param Out 触摸事件追加到此数组
+     * @param NumPointers 手指数量
+     * @param StartTime 第一根手指按下的时间
+     * @param Duration 移动（或按住）的时长
+     * @param Path 手指轨迹
+     */
+    void RecordGesture(TArray<FRLOTouchSample>& Out, int32 NumPointers, double StartTime, double Duration, FPathFunction Path)
+    {
+        for (int32 Pointer = 0; Pointer < NumPointers; Pointer++)
+        {
+            Out.Emplace(Pointer, ERLOTouchPhase::Began, Path(Pointer, 0.0f), StartTime + Pointer * PointerStagger);
+        }
+
+        const double MoveStart = StartTime + (NumPointers - 1) * PointerStagger;
+        const double MoveEnd = MoveStart + Duration;
+        for (int32 Step = 1; ; Step++)
+        {
+            const double Time = MoveStart + Step * TouchSampleInterval + TouchSampleJitter[Step % UE_ARRAY_COUNT(TouchSampleJitter)];
+            if (Time >= MoveEnd)
+            {
+                break;
+            }
+
+            const float Alpha = static_cast<float>((Time - MoveStart) / Duration);
+            for (int32 Pointer = 0; Pointer < NumPointers; Pointer++)
+            {
+                Out.Emplace(Pointer, ERLOTouchPhase::Moved, Path(Pointer, Alpha), Time);
+            }
+        }
+
+        for (int32 Pointer = 0; Pointer < NumPointers; Pointer++)
+        {
+            Out.Emplace(Pointer, ERLOTouchPhase::Ended, Path(Pointer, 1.0f), MoveEnd + Pointer * PointerStagger);
+        }
+    }
+
+    /** 单指直线移动 */
+    FGestureRecording RecordStroke(const TCHAR* Name, const FVector2D& Offset, double Duration)
+    {
+        FGestureRecording Recording;
+        Recording.Name = Name;
+        RecordGesture(Recording.Samples, 1, 0.02, Duration, [&Offset](int32, float Alpha)
+        {
+            return ScreenCenter + Offset * Alpha;
+        });
+        return Recording;
+    }
+
+    /** 单指按住，带小于TapSlop的抖动 */
+    FGestureRecording RecordHold(const TCHAR* Name, double Duration)
+    {
+        FGestureRecording Recording;
+        Recording.Name = Name;
+        RecordGesture(Recording.Samples, 1, 0.02, Duration, [](int32, float Alpha)
+        {
+            return ScreenCenter + FVector2D(FMath::Sin(Alpha * 40.0f) * 3.0f, FMath::Cos(Alpha * 25.0f) * 2.0f);
+        });
+        return Recording;
+    }
+
+    /** 双指以中心对称，两指连线角度和间距随进度变化 */
+    FGestureRecording RecordTwoFinger(const TCHAR* Name, float FromDistance, float ToDistance, float FromDegrees, float ToDegrees, double Duration)
+    {
+        FGestureRecording Recording;
+        Recording.Name = Name;
+        RecordGesture(Recording.Samples, 2, 0.02, Duration, [=](int32 Pointer, float Alpha)
+        {
+            const float Radians = FMath::DegreesToRadians(FMath::Lerp(FromDegrees, ToDegrees, Alpha));
+            const FVector2D HalfSpan = FVector2D(FMath::Cos(Radians), FMath::Sin(Radians)) * FMath::Lerp(FromDistance, ToDistance, Alpha) * 0.5f;
+            return Pointer == 0 ? ScreenCenter - HalfSpan : ScreenCenter + HalfSpan;
+        });
+        return Recording;
+    }
+
+    /** 十根手指同时按下，前两根不动，其余上下移动；另有一个超出范围的手指索引 */
+    FGestureRecording RecordTenPointers()
+    {
+        FGestureRecording Recording;
+        Recording.Name = TEXT("TenPointers");
+        RecordGesture(Recording.Samples, FRLOGestureRecognizer::MaxPointers, 0.02, 0.5, [](int32 Pointer, float Alpha)
+        {
+            const FVector2D Base(200.0f + Pointer * 150.0f, 540.0f);
+            return Pointer < 2 ? Base : Base + FVector2D(0.0f, 80.0f * Alpha);
+        });
+
+        const int32 OutOfRangePointer = FRLOGestureRecognizer::MaxPointers;
+        Recording.Samples.Emplace(OutOfRangePointer, ERLOTouchPhase::Began, ScreenCenter, 0.3);
+        Recording.Samples.Emplace(OutOfRangePointer, ERLOTouchPhase::Ended, ScreenCenter, 0.35);
+        Recording.Samples.StableSort([](const FRLOTouchSample& A, const FRLOTouchSample& B)
+        {
+            return A.Timestamp < B.Timestamp;
+        });
+        return Recording;
+    }
+
+    /** 所有录制的手势 */
+    TArray<FGestureRecording> BuildRecordings()
+    {
+        TArray<FGestureRecording> Recordings;
+        Recordings.Add(RecordStroke(TEXT("Tap"), FVector2D(4.0f, 0.0f), 0.12));
+        Recordings.Add(RecordStroke(TEXT("TapWithinSlop"), FVector2D(15.0f, 0.0f), 0.1));
+        Recordings.Add(RecordStroke(TEXT("SlowSwipe"), FVector2D(60.0f, 0.0f), 0.4));
+        Recordings.Add(RecordStroke(TEXT("Fling"), FVector2D(0.0f, -400.0f), 0.15));
+        Recordings.Add(RecordHold(TEXT("LongPress"), 1.2));
+        Recordings.Add(RecordHold(TEXT("HoldTooShort"), 0.5));
+        Recordings.Add(RecordTwoFinger(TEXT("Pinch"), 200.0f, 400.0f, 0.0f, 0.0f, 0.4));
+        Recordings.Add(RecordTwoFinger(TEXT("Rotate"), 300.0f, 300.0f, 120.0f, 240.0f, 0.6));
+        Recordings.Add(RecordTenPointers());
+        return Recordings;
+    }
+
+    /** 连续变化的事件（Pan/Pinch/Rotate）数量取决于采样数，不计入手势序列 */
+    bool IsContinuousEvent(ERLOGestureType Type)
+    {
+        return Type == ERLOGestureType::PanChanged || Type == ERLOGestureType::PinchChanged || Type == ERLOGestureType::RotateChanged;
+    }
+
+    /** 手势序列（不含连续变化的事件），如 "0,1,12" */
+    FString DescribeGestures(const TArray<FRLOGestureEvent>& Events)
+    {
+        TArray<FString> Types;
+        for (const FRLOGestureEvent& Event : Events)
+        {
+            if (!IsContinuousEvent(Event.Type))
+            {
+                Types.Add(FString::FromInt(static_cast<int32>(Event.Type)));
+            }
+        }
+        return FString::Join(Types, TEXT(","));
+    }
+
+    FString DescribeGestures(std::initializer_list<ERLOGestureType> Types)
+    {
+        TArray<FString> Strings;
+        for (ERLOGestureType Type : Types)
+        {
+            Strings.Add(FString::FromInt(static_cast<int32>(Type)));
+        }
+        return FString::Join(Strings, TEXT(","));
+    }
+
+    /** 第一个指定类型的事件 */
+    const FRLOGestureEvent* FindGesture(const TArray<FRLOGestureEvent>& Events, ERLOGestureType Type)
+    {
+        return Events.FindByPredicate([Type](const FRLOGestureEvent& Event) { return Event.Type == Type; });
+    }
+
+    /** 指定类型的事件数量 */
+    int32 CountGestures(const TArray<FRLOGestureEvent>& Events, ERLOGestureType Type)
+    {
+        return Events.FilterByPredicate([Type](const FRLOGestureEvent& Event) { return Event.Type == Type; }).Num();
+    }
+
+    /**
+     * @brief 按帧回放：每帧开始时送达此前产生的触摸事件（保留原始时间戳），然后推进到帧时间
+     * @param Samples 按时间排序的触摸事件
+     * @param FrameDelta 第N帧的时长
+     * @param OutEvents 识别出的手势
+     */
+    void ReplayAtFrames(TArrayView<const FRLOTouchSample> Samples, TFunctionRef<double(int32 Frame)> FrameDelta, TArray<FRLOGestureEvent>& OutEvents)
+    {
+        FRLOGestureRecognizer Recognizer;
+        double Now = 0.0;
+        int32 NextSample = 0;
+        for (int32 Frame = 0; NextSample < Samples.Num(); Frame++)
+        {
+            Now += FrameDelta(Frame);
+            while (NextSample < Samples.Num() && Samples[NextSample].Timestamp <= Now)
+            {
+                Recognizer.ProcessSample(Samples[NextSample++], OutEvents);
+            }
+            Recognizer.Advance(Now, OutEvents);
+        }
+    }
+
+    /** 两个事件的类型、时间和参数是否相同 */
+    bool GesturesMatch(const FRLOGestureEvent& A, const FRLOGestureEvent& B)
+    {
+        const float Tolerance = 1.e-4f;
+        return A.Type == B.Type
+            && A.Timestamp == B.Timestamp
+            && A.PointerCount == B.PointerCount
+            && A.Position.Equals(B.Position, Tolerance)
+            && A.StartPosition.Equals(B.StartPosition, Tolerance)
+            && A.Delta.Equals(B.Delta, Tolerance)
+            && A.Velocity.Equals(B.Velocity, Tolerance)
+            && FMath::IsNearlyEqual(A.Duration, B.Duration, Tolerance)
+            && FMath::IsNearlyEqual(A.Scale, B.Scale, Tolerance)
+            && FMath::IsNearlyEqual(A.ScaleDelta, B.ScaleDelta, Tolerance)
+            && FMath::IsNearlyEqual(A.RotationDegrees, B.RotationDegrees, Tolerance)
+            && FMath::IsNearlyEqual(A.RotationDelta, B.RotationDelta, Tolerance);
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLOGestureRecordingsTest, "RLO.Gesture.Recordings",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLOGestureRecordingsTest::RunTest(const FString& Parameters)
+{
+    const FRLOGestureConfig Config;
+    TMap<FString, TArray<FRLOGestureEvent>> Results;
+    for (const FGestureRecording& Recording : BuildRecordings())
+    {
+        FRLOGestureRecognizer::Replay(Config, Recording.Samples, Results.Add(Recording.Name));
+    }
+
+    // 点击：移动不超过TapSlop
+    const TArray<FRLOGestureEvent>& Tap = Results[TEXT("Tap")];
+    TestEqual(TEXT("Tap gestures"), DescribeGestures(Tap), DescribeGestures({ ERLOGestureType::Down, ERLOGestureType::Tap, ERLOGestureType::Up }));
+    TestEqual(TEXT("TapWithinSlop gestures"), DescribeGestures(Results[TEXT("TapWithinSlop")]), DescribeGestures({ ERLOGestureType::Down, ERLOGestureType::Tap, ERLOGestureType::Up }));
+    if (const FRLOGestureEvent* Event = FindGesture(Tap, ERLOGestureType::Tap))
+    {
+        TestEqual(TEXT("Tap duration"), Event->Duration, 0.12f, 1.e-3f);
+    }
+
+    // 慢速滑动：超过TapSlop后开始拖动，抬起时是滑动但速度不足以甩动
+    const TArray<FRLOGestureEvent>& SlowSwipe = Results[TEXT("SlowSwipe")];
+    TestEqual(TEXT("SlowSwipe gestures"), DescribeGestures(SlowSwipe),
+              DescribeGestures({ ERLOGestureType::Down, ERLOGestureType::PanBegan, ERLOGestureType::PanEnded, ERLOGestureType::Swipe, ERLOGestureType::Up }));
+    TestTrue(TEXT("SlowSwipe pans continuously"), CountGestures(SlowSwipe, ERLOGestureType::PanChanged) > 10);
+    if (const FRLOGestureEvent* Event = FindGesture(SlowSwipe, ERLOGestureType::Swipe))
+    {
+        TestEqual(TEXT("Swipe distance"), Event->Delta.X, 60.0f, 0.5f);
+        TestEqual(TEXT("Swipe speed"), Event->Velocity.X, 150.0f, 15.0f);
+    }
+
+    // 甩动：抬起时速度超过FlingMinVelocity
+    const TArray<FRLOGestureEvent>& Fling = Results[TEXT("Fling")];
+    TestEqual(TEXT("Fling gestures"), DescribeGestures(Fling),
+              DescribeGestures({ ERLOGestureType::Down, ERLOGestureType::PanBegan, ERLOGestureType::PanEnded, ERLOGestureType::Swipe, ERLOGestureType::Fling, ERLOGestureType::Up }));
+    if (const FRLOGestureEvent* Event = FindGesture(Fling, ERLOGestureType::Fling))
+    {
+        TestTrue(TEXT("Fling velocity"), -Event->Velocity.Y >= Config.FlingMinVelocity);
+        TestEqual(TEXT("Fling direction"), Event->Velocity.GetSafeNormal().Y, -1.0f, 1.e-3f);
+    }
+
+    // 长按：按住时的抖动不取消长按，在精确的到达时刻报告，抬起时不再报告点击
+    const TArray<FRLOGestureEvent>& LongPress = Results[TEXT("LongPress")];
+    TestEqual(TEXT("LongPress gestures"), DescribeGestures(LongPress), DescribeGestures({ ERLOGestureType::Down, ERLOGestureType::LongPress, ERLOGestureType::Up }));
+    if (const FRLOGestureEvent* Event = FindGesture(LongPress, ERLOGestureType::LongPress))
+    {
+        TestEqual(TEXT("LongPress timestamp"), Event->Timestamp, 0.02 + Config.LongPressDuration, 1.e-9);
+    }
+
+    // 按住超过TapMaxDuration但不到长按时间：既不是点击也不是长按
+    TestEqual(TEXT("HoldTooShort gestures"), DescribeGestures(Results[TEXT("HoldTooShort")]), DescribeGestures({ ERLOGestureType::Down, ERLOGestureType::Up }));
+
+    // 缩放：间距加倍，没有旋转
+    const TArray<FRLOGestureEvent>& Pinch = Results[TEXT("Pinch")];
+    TestEqual(TEXT("Pinch gestures"), DescribeGestures(Pinch),
+              DescribeGestures({ ERLOGestureType::Down, ERLOGestureType::TwoFingerBegan, ERLOGestureType::TwoFingerEnded, ERLOGestureType::Up }));
+    TestTrue(TEXT("Pinch reports scale changes"), CountGestures(Pinch, ERLOGestureType::PinchChanged) > 0);
+    TestEqual(TEXT("Pinch reports no rotation"), CountGestures(Pinch, ERLOGestureType::RotateChanged), 0);
+    if (const FRLOGestureEvent* Event = FindGesture(Pinch, ERLOGestureType::TwoFingerEnded))
+    {
+        // 抬起事件的位置不参与计算，最后一次移动略早于轨迹终点
+        TestEqual(TEXT("Pinch final scale"), Event->Scale, 2.0f, 0.05f);
+    }
+
+    // 双指旋转：跨越±180度时累计角度不跳变，间距不变时没有缩放
+    const TArray<FRLOGestureEvent>& Rotate = Results[TEXT("Rotate")];
+    TestEqual(TEXT("Rotate gestures"), DescribeGestures(Rotate),
+              DescribeGestures({ ERLOGestureType::Down, ERLOGestureType::TwoFingerBegan, ERLOGestureType::TwoFingerEnded, ERLOGestureType::Up }));
+    TestTrue(TEXT("Rotate reports rotation changes"), CountGestures(Rotate, ERLOGestureType::RotateChanged) > 0);
+    TestEqual(TEXT("Rotate reports no scale"), CountGestures(Rotate, ERLOGestureType::PinchChanged), 0);
+    if (const FRLOGestureEvent* Event = FindGesture(Rotate, ERLOGestureType::TwoFingerEnded))
+    {
+        TestEqual(TEXT("Rotate final angle"), Event->RotationDegrees, 120.0f, 3.0f);
+    }
+
+    // 十根手指：全部被跟踪，第三根及以后的手指不产生手势，超出范围的索引被忽略
+    const TArray<FRLOGestureEvent>& TenPointers = Results[TEXT("TenPointers")];
+    TestEqual(TEXT("TenPointers gestures"), DescribeGestures(TenPointers),
+              DescribeGestures({ ERLOGestureType::Down, ERLOGestureType::TwoFingerBegan, ERLOGestureType::TwoFingerEnded, ERLOGestureType::Up }));
+    if (const FRLOGestureEvent* Event = FindGesture(TenPointers, ERLOGestureType::TwoFingerEnded))
+    {
+        const int32 MaxPointers = FRLOGestureRecognizer::MaxPointers;
+        TestEqual(TEXT("All pointers down when the pair ends"), Event->PointerCount, MaxPointers);
+    }
+    if (TenPointers.Num() > 0)
+    {
+        TestEqual(TEXT("Last pointer up"), TenPointers.Last().PointerCount, 0);
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLOGestureFrameRateTest, "RLO.Gesture.FrameRateIndependence",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLOGestureFrameRateTest::RunTest(const FString& Parameters)
+{
+    // 帧长为固定帧率或不规则卡顿（单帧最长0.35秒，跨过长按到达时刻）
+    const double HitchPattern[] = { 1.0 / 60.0, 1.0 / 60.0, 0.2, 1.0 / 120.0, 1.0 / 30.0, 0.35, 1.0 / 60.0, 0.05 };
+    struct FCadence
+    {
+        const TCHAR* Name;
+        double FrameRate;
+    };
+    const FCadence Cadences[] = { { TEXT("15Hz"), 15.0 }, { TEXT("30Hz"), 30.0 }, { TEXT("60Hz"), 60.0 }, { TEXT("120Hz"), 120.0 }, { TEXT("Hitches"), 0.0 } };
+
+    for (const FGestureRecording& Recording : BuildRecordings())
+    {
+        // 不经过帧循环、直接回放的结果作为基准
+        TArray<FRLOGestureEvent> Expected;
+        FRLOGestureRecognizer::Replay(FRLOGestureConfig(), Recording.Samples, Expected);
+
+        for (const FCadence& Cadence : Cadences)
+        {
+            TArray<FRLOGestureEvent> Actual;
+            ReplayAtFrames(Recording.Samples, [&Cadence, &HitchPattern](int32 Frame)
+            {
+                return Cadence.FrameRate > 0.0 ? 1.0 / Cadence.FrameRate : HitchPattern[Frame % UE_ARRAY_COUNT(HitchPattern)];
+            }, Actual);
+
+            const FString What = FString::Printf(TEXT("%s at %s"), *Recording.Name, Cadence.Name);
+            if (!TestEqual(What + TEXT(" gesture count"), Actual.Num(), Expected.Num()))
+            {
+                TestEqual(What + TEXT(" gestures"), DescribeGestures(Actual), DescribeGestures(Expected));
+                continue;
+            }
+
+            for (int32 Index = 0; Index < Expected.Num(); Index++)
+            {
+                if (!GesturesMatch(Actual[Index], Expected[Index]))
+                {
+                    AddError(FString::Printf(TEXT("%s: gesture %d (type %d at %.4f) differs from the unframed replay (type %d at %.4f)"),
+                             *What, Index, static_cast<int32>(Actual[Index].Type), Actual[Index].Timestamp,
+                             static_cast<int32>(Expected[Index].Type), Expected[Index].Timestamp));
+                    break;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+#endif
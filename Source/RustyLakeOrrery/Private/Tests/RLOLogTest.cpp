@@ -0,0 +1,57 @@
+// RLOLogTest.cpp
+
+#include "RustyLakeOrrery.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    /**
+     * @brief 检查一个日志分类的编译期上限，以及运行时调高详细级别时会被上限截断
+     *
+     * Shipping 版本的上限另由 RustyLakeOrrery.cpp 中的 static_assert 在编译期保证
+     */
+    template <typename CategoryType>
+    void TestVerbosityCap(FAutomationTestBase& Test, CategoryType& Category)
+    {
+        const FString Name = Category.GetCategoryName().ToString();
+        const ELogVerbosity::Type Cap = static_cast<ELogVerbosity::Type>(CategoryType::CompileTimeVerbosity);
+
+        Test.TestEqual(FString::Printf(TEXT("%s compile-time cap"), *Name),
+                       static_cast<int32>(Cap), static_cast<int32>(ELogVerbosity::RLO_LOG_COMPILE_VERBOSITY));
+#if UE_BUILD_SHIPPING
+        Test.TestTrue(FString::Printf(TEXT("%s compiles out Log in Shipping"), *Name), Cap < ELogVerbosity::Log);
+#endif
+
+        // 运行时请求 VeryVerbose（相当于 -LogCmds="LogRLOxxx VeryVerbose"），实际级别不能超过编译期上限
+        const ELogVerbosity::Type SavedVerbosity = Category.GetVerbosity();
+        Category.SetVerbosity(ELogVerbosity::VeryVerbose);
+
+        Test.TestEqual(FString::Printf(TEXT("%s runtime verbosity is capped"), *Name),
+                       static_cast<int32>(Category.GetVerbosity()), static_cast<int32>(FMath::Min(ELogVerbosity::VeryVerbose, Cap)));
+        Test.TestEqual(FString::Printf(TEXT("%s suppresses Verbose above the cap"), *Name),
+                       Category.IsSuppressed(ELogVerbosity::Verbose), Cap < ELogVerbosity::Verbose);
+        Test.TestFalse(FString::Printf(TEXT("%s keeps Warning"), *Name), Category.IsSuppressed(ELogVerbosity::Warning));
+
+        Category.SetVerbosity(SavedVerbosity);
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLOLogVerbosityCapsTest, "RLO.Log.VerbosityCaps",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLOLogVerbosityCapsTest::RunTest(const FString& Parameters)
+{
+    TestVerbosityCap(*this, LogRLO);
+    TestVerbosityCap(*this, LogRLODialogue);
+    TestVerbosityCap(*this, LogRLOInteraction);
+    TestVerbosityCap(*this, LogRLOInventory);
+    TestVerbosityCap(*this, LogRLOPuzzle);
+    TestVerbosityCap(*this, LogRLOUI);
+    TestVerbosityCap(*this, LogRLOSave);
+
+    return true;
+}
+
+#endif
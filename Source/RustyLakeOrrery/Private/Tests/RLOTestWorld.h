@@ -0,0 +1,57 @@
+// RLOTestWorld.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RLOBenchmarkCommandlet.h"
+#include "Engine/World.h"
+#include "Misc/App.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * @brief 自动化测试用的临时世界，析构时销毁
+ *
+ * 与基准测试相同：没有GameMode，已开始游戏，之后生成的Actor立即BeginPlay。
+ */
+class FRLOScopedTestWorld
+{
+public:
+    FRLOScopedTestWorld()
+        : World(URLOBenchmarkCommandlet::CreateBenchmarkWorld())
+    {
+    }
+
+    ~FRLOScopedTestWorld()
+    {
+        URLOBenchmarkCommandlet::DestroyBenchmarkWorld(World);
+    }
+
+    FRLOScopedTestWorld(const FRLOScopedTestWorld&) = delete;
+    FRLOScopedTestWorld& operator=(const FRLOScopedTestWorld&) = delete;
+
+    /**
+     * @brief 按固定帧长推进世界（与基准测试的帧循环相同）
+     * @param NumFrames 帧数
+     * @param DeltaTime 每帧时长（秒）
+     */
+    void Tick(int32 NumFrames, float DeltaTime = 1.0f / 60.0f)
+    {
+        for (int32 Frame = 0; Frame < NumFrames; Frame++)
+        {
+            FApp::SetDeltaTime(DeltaTime);
+            FApp::SetCurrentTime(FApp::GetCurrentTime() + DeltaTime);
+            World->Tick(LEVELTICK_All, DeltaTime);
+            GFrameCounter++;
+        }
+    }
+
+    UWorld* Get() const { return World; }
+    UWorld* operator->() const { return World; }
+    explicit operator bool() const { return World != nullptr; }
+
+private:
+    UWorld* World;
+};
+
+#endif
@@ -0,0 +1,289 @@
+// SaveSubsystemTest.cpp
+
+#include "RLOTestWorld.h"
+#include "SaveSubsystem.h"
+#include "InteractableComponent.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** 访问存档子系统的私有状态（只在自动化测试中使用） */
+struct FRLOSaveSubsystemTestAccess
+{
+    static void LoadFromDisk(USaveSubsystem& Subsystem) { Subsystem.LoadFromDisk(); }
+    static uint32 GetGeneration(const USaveSubsystem& Subsystem) { return Subsystem.Generation; }
+    static FString GetSnapshotPath(const USaveSubsystem& Subsystem) { return Subsystem.GetSnapshotPath(); }
+    static FString GetJournalPath(const USaveSubsystem& Subsystem) { return Subsystem.GetJournalPath(); }
+    static FCriticalSection& GetWriteQueueLock(USaveSubsystem& Subsystem) { return Subsystem.WriteQueueLock; }
+};
+
+namespace
+{
+    /** 测试专用的存档槽，不影响玩家的自动存档 */
+    const TCHAR* TestSlotName = TEXT("RLOAutomationTest");
+
+    /**
+     * @brief 打开测试存档槽（相当于重新启动游戏后的读取）
+     *
+     * 不调用 Initialize，没有自动存档和应用生命周期回调，只通过 SaveNow 写入。
+     */
+    USaveSubsystem* OpenTestSlot()
+    {
+        USaveSubsystem* Subsystem = NewObject<USaveSubsystem>(GetTransientPackage());
+        Subsystem->SlotName = TestSlotName;
+        Subsystem->AutosaveInterval = 0.0f;
+        Subsystem->MaxJournalBytes = 64 * 1024;
+        FRLOSaveSubsystemTestAccess::LoadFromDisk(*Subsystem);
+        return Subsystem;
+    }
+
+    /** 删除测试存档槽（不读取，之前失败的测试留下的文件不会产生警告） */
+    void DeleteTestSlot()
+    {
+        USaveSubsystem* Subsystem = NewObject<USaveSubsystem>(GetTransientPackage());
+        Subsystem->SlotName = TestSlotName;
+        Subsystem->DeleteSave();
+    }
+
+    /** 修改状态并写入（测试世界没有GameInstance，MarkDirty 不生效，捕获所有已注册对象） */
+    void SaveInteractable(USaveSubsystem* Subsystem, UInteractableComponent* Interactable, bool bInteractable)
+    {
+        Interactable->SetInteractable(bInteractable);
+        Subsystem->SaveNow(true);
+        Subsystem->WaitForPendingWrites();
+    }
+
+    /**
+     * @brief 重新打开存档槽并注册对象（有存档记录时恢复）
+     * @param Interactable 可交互对象
+     * @param OldSubsystem 之前打开的存档子系统，对象先从中注销
+     * @param bResetInteractable 注册前对象的状态，与期望恢复的状态相反才能确认确实从存档恢复
+     * @return 新的存档子系统
+     */
+    USaveSubsystem* ReloadInteractable(UInteractableComponent* Interactable, USaveSubsystem* OldSubsystem, bool bResetInteractable)
+    {
+        if (OldSubsystem)
+        {
+            OldSubsystem->UnregisterSaveable(Interactable);
+        }
+
+        USaveSubsystem* Subsystem = OpenTestSlot();
+        Interactable->SetInteractable(bResetInteractable);
+        Subsystem->RegisterSaveable(Interactable);
+        return Subsystem;
+    }
+
+    /** 在测试世界中生成一个可存档的可交互对象 */
+    UInteractableComponent* SpawnInteractable(UWorld* World)
+    {
+        AActor* Actor = World->SpawnActor<AActor>();
+        UInteractableComponent* Interactable = NewObject<UInteractableComponent>(Actor, TEXT("SaveTestLever"));
+        Interactable->RegisterComponent();
+        return Interactable;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLOSaveJournalReplayTest, "RLO.Save.JournalReplay",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLOSaveJournalReplayTest::RunTest(const FString& Parameters)
+{
+    FRLOScopedTestWorld World;
+    if (!TestTrue(TEXT("Test world created"), static_cast<bool>(World)))
+    {
+        return false;
+    }
+    DeleteTestSlot();
+
+    UInteractableComponent* Interactable = SpawnInteractable(World.Get());
+
+    // 第一次存档只写日志（没有快照）
+    USaveSubsystem* Subsystem = ReloadInteractable(Interactable, nullptr, true);
+    TestFalse(TEXT("New slot has no data"), Subsystem->HasSaveData());
+    SaveInteractable(Subsystem, Interactable, false);
+    TestFalse(TEXT("First save writes no snapshot"), IFileManager::Get().FileExists(*FRLOSaveSubsystemTestAccess::GetSnapshotPath(*Subsystem)));
+    TestTrue(TEXT("First save writes the journal"), IFileManager::Get().FileExists(*FRLOSaveSubsystemTestAccess::GetJournalPath(*Subsystem)));
+
+    // 重新读取时重放日志
+    Subsystem = ReloadInteractable(Interactable, Subsystem, true);
+    TestTrue(TEXT("Replayed slot has data"), Subsystem->HasSaveData());
+    TestFalse(TEXT("First entry restored"), Interactable->CanInteract());
+
+    // 读取后继续追加到同一份日志，最后一条生效
+    SaveInteractable(Subsystem, Interactable, true);
+    Subsystem = ReloadInteractable(Interactable, Subsystem, false);
+    TestTrue(TEXT("Appended entry restored"), Interactable->CanInteract());
+    TestEqual(TEXT("Journal stays in the first generation"), FRLOSaveSubsystemTestAccess::GetGeneration(*Subsystem), 0u);
+
+    DeleteTestSlot();
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLOSaveTornJournalTest, "RLO.Save.TornJournal",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLOSaveTornJournalTest::RunTest(const FString& Parameters)
+{
+    FRLOScopedTestWorld World;
+    if (!TestTrue(TEXT("Test world created"), static_cast<bool>(World)))
+    {
+        return false;
+    }
+    DeleteTestSlot();
+
+    UInteractableComponent* Interactable = SpawnInteractable(World.Get());
+
+    // 两条日志记录：false，然后 true
+    USaveSubsystem* Subsystem = ReloadInteractable(Interactable, nullptr, true);
+    SaveInteractable(Subsystem, Interactable, false);
+    SaveInteractable(Subsystem, Interactable, true);
+    const FString SnapshotPath = FRLOSaveSubsystemTestAccess::GetSnapshotPath(*Subsystem);
+    const FString JournalPath = FRLOSaveSubsystemTestAccess::GetJournalPath(*Subsystem);
+
+    TArray<uint8> Journal;
+    if (!TestTrue(TEXT("Journal written"), FFileHelper::LoadFileToArray(Journal, *JournalPath)))
+    {
+        return false;
+    }
+
+    AddExpectedError(TEXT("Journal ends with an incomplete entry"), EAutomationExpectedErrorFlags::Contains, 2);
+
+    // 写入最后一条记录时被杀：截断的记录被丢弃，之前的记录保留
+    TArray<uint8> Truncated = Journal;
+    Truncated.SetNum(Journal.Num() - 3);
+    FFileHelper::SaveArrayToFile(Truncated, *JournalPath);
+    Subsystem = ReloadInteractable(Interactable, Subsystem, true);
+    TestFalse(TEXT("Entry before the truncated tail restored"), Interactable->CanInteract());
+
+    // 损坏的日志之后不能再追加，下次存档改写快照并开始新的日志
+    Subsystem->SaveNow(false);
+    Subsystem->WaitForPendingWrites();
+    TestTrue(TEXT("Snapshot written after a torn journal"), IFileManager::Get().FileExists(*SnapshotPath));
+    TestEqual(TEXT("Journal starts a new generation"), FRLOSaveSubsystemTestAccess::GetGeneration(*Subsystem), 1u);
+    Subsystem = ReloadInteractable(Interactable, Subsystem, true);
+    TestFalse(TEXT("Compacted snapshot restored"), Interactable->CanInteract());
+
+    // 最后一条记录CRC错误：同样丢弃
+    Subsystem->DeleteSave();
+    TArray<uint8> Corrupt = Journal;
+    Corrupt.Last() ^= 0xFF;
+    FFileHelper::SaveArrayToFile(Corrupt, *JournalPath);
+    Subsystem = ReloadInteractable(Interactable, Subsystem, true);
+    TestFalse(TEXT("Entry before the corrupt tail restored"), Interactable->CanInteract());
+
+    DeleteTestSlot();
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLOSaveSnapshotRolloverTest, "RLO.Save.SnapshotRollover",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLOSaveSnapshotRolloverTest::RunTest(const FString& Parameters)
+{
+    FRLOScopedTestWorld World;
+    if (!TestTrue(TEXT("Test world created"), static_cast<bool>(World)))
+    {
+        return false;
+    }
+    DeleteTestSlot();
+
+    UInteractableComponent* Interactable = SpawnInteractable(World.Get());
+
+    // 第0代日志：false，然后 true
+    USaveSubsystem* Subsystem = ReloadInteractable(Interactable, nullptr, true);
+    SaveInteractable(Subsystem, Interactable, false);
+    SaveInteractable(Subsystem, Interactable, true);
+    const FString SnapshotPath = FRLOSaveSubsystemTestAccess::GetSnapshotPath(*Subsystem);
+    const FString JournalPath = FRLOSaveSubsystemTestAccess::GetJournalPath(*Subsystem);
+
+    TArray<uint8> StaleJournal;
+    FFileHelper::LoadFileToArray(StaleJournal, *JournalPath);
+
+    // 日志超过上限：写入快照（false），开始第1代日志
+    Subsystem->MaxJournalBytes = 1;
+    SaveInteractable(Subsystem, Interactable, false);
+    TestTrue(TEXT("Snapshot written on rollover"), IFileManager::Get().FileExists(*SnapshotPath));
+    TestEqual(TEXT("Generation after rollover"), FRLOSaveSubsystemTestAccess::GetGeneration(*Subsystem), 1u);
+    TestTrue(TEXT("New journal is only a header"), IFileManager::Get().FileSize(*JournalPath) < StaleJournal.Num());
+
+    // 第1代日志：true
+    Subsystem->MaxJournalBytes = 64 * 1024;
+    SaveInteractable(Subsystem, Interactable, true);
+    Subsystem = ReloadInteractable(Interactable, Subsystem, false);
+    TestTrue(TEXT("Snapshot plus journal restored"), Interactable->CanInteract());
+    TestEqual(TEXT("Loaded generation"), FRLOSaveSubsystemTestAccess::GetGeneration(*Subsystem), 1u);
+
+    // 快照替换后、新日志创建前被杀：上一代的日志不会覆盖快照
+    FFileHelper::SaveArrayToFile(StaleJournal, *JournalPath);
+    Subsystem = ReloadInteractable(Interactable, Subsystem, true);
+    TestFalse(TEXT("Stale journal ignored"), Interactable->CanInteract());
+
+    DeleteTestSlot();
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLOSaveSnapshotFailureTest, "RLO.Save.SnapshotFailure",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLOSaveSnapshotFailureTest::RunTest(const FString& Parameters)
+{
+    FRLOScopedTestWorld World;
+    if (!TestTrue(TEXT("Test world created"), static_cast<bool>(World)))
+    {
+        return false;
+    }
+    DeleteTestSlot();
+
+    UInteractableComponent* Interactable = SpawnInteractable(World.Get());
+
+    // 第0代日志：false
+    USaveSubsystem* Subsystem = ReloadInteractable(Interactable, nullptr, true);
+    SaveInteractable(Subsystem, Interactable, false);
+    const FString SnapshotPath = FRLOSaveSubsystemTestAccess::GetSnapshotPath(*Subsystem);
+
+    // 临时文件的位置被目录占用，快照写入失败（扩展名与 SaveSubsystem.cpp 中的临时文件相同）
+    const FString BlockedTempPath = SnapshotPath + TEXT(".tmp");
+    IFileManager::Get().MakeDirectory(*BlockedTempPath, true);
+    AddExpectedError(TEXT("Failed to write snapshot"), EAutomationExpectedErrorFlags::Contains, 1);
+
+    // 写入线程取任务前排队：第1代的快照（true），以及游戏线程发现失败之前的两个日志任务（false，然后 true）
+    Subsystem->MaxJournalBytes = 1;
+    {
+        FScopeLock Lock(&FRLOSaveSubsystemTestAccess::GetWriteQueueLock(*Subsystem));
+        Interactable->SetInteractable(true);
+        Subsystem->SaveNow(true);
+        Subsystem->MaxJournalBytes = 64 * 1024;
+        Interactable->SetInteractable(false);
+        Subsystem->SaveNow(true);
+        Interactable->SetInteractable(true);
+        Subsystem->SaveNow(true);
+    }
+    Subsystem->WaitForPendingWrites();
+    TestFalse(TEXT("Failed snapshot not written"), IFileManager::Get().FileExists(*SnapshotPath));
+
+    // 此时被杀：旧一代的日志没有被截断，之后的日志任务追加在其后
+    USaveSubsystem* Reloaded = OpenTestSlot();
+    Interactable->SetInteractable(false);
+    Reloaded->RegisterSaveable(Interactable);
+    TestTrue(TEXT("Entries queued after the failed snapshot restored"), Interactable->CanInteract());
+    TestEqual(TEXT("Journal stays in the old generation"), FRLOSaveSubsystemTestAccess::GetGeneration(*Reloaded), 0u);
+    Reloaded->UnregisterSaveable(Interactable);
+
+    // 恢复写入：下次存档回退代数并重试快照
+    IFileManager::Get().DeleteDirectory(*BlockedTempPath, false, true);
+    Subsystem->SaveNow(false);
+    Subsystem->WaitForPendingWrites();
+    TestTrue(TEXT("Snapshot written on retry"), IFileManager::Get().FileExists(*SnapshotPath));
+    TestEqual(TEXT("Retried snapshot follows the snapshot on disk"), FRLOSaveSubsystemTestAccess::GetGeneration(*Subsystem), 1u);
+
+    Subsystem = ReloadInteractable(Interactable, Subsystem, false);
+    TestTrue(TEXT("Retried snapshot restored"), Interactable->CanInteract());
+    TestEqual(TEXT("Loaded generation"), FRLOSaveSubsystemTestAccess::GetGeneration(*Subsystem), 1u);
+
+    DeleteTestSlot();
+    return true;
+}
+
+#endif
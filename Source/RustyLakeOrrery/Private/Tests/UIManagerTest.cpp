@@ -0,0 +1,72 @@
+// UIManagerTest.cpp
+
+#include "RLOTestWorld.h"
+#include "UIManager.h"
+#include "UIManagerSubsystem.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/ScopeExit.h"
+#include "UObject/UObjectGlobals.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRLOUIManagerWorldReloadTest, "RLO.UI.WorldReload",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRLOUIManagerWorldReloadTest::RunTest(const FString& Parameters)
+{
+    // 反复加载和卸载世界(两个世界同时存在,相当于两个PIE客户端),
+    // 每个世界只返回自己的UIManager,世界销毁后不会在新世界中返回旧的实例
+    const int32 NumWorldCycles = 20;
+    for (int32 Cycle = 0; Cycle < NumWorldCycles; Cycle++)
+    {
+        TWeakObjectPtr<AUIManager> DestroyedManager;
+        TWeakObjectPtr<UUIManagerSubsystem> DestroyedSubsystem;
+        {
+            // 第一个世界在循环中途卸载
+            UWorld* FirstWorld = URLOBenchmarkCommandlet::CreateBenchmarkWorld();
+            ON_SCOPE_EXIT
+            {
+                URLOBenchmarkCommandlet::DestroyBenchmarkWorld(FirstWorld);
+            };
+            FRLOScopedTestWorld SecondWorld;
+            if (!TestTrue(TEXT("Client worlds created"), FirstWorld && SecondWorld))
+            {
+                return false;
+            }
+
+            if (!TestNull(FString::Printf(TEXT("Cycle %d: no stale UIManager in the first new world"), Cycle), AUIManager::GetUIManager(FirstWorld))
+                || !TestNull(FString::Printf(TEXT("Cycle %d: no stale UIManager in the second new world"), Cycle), AUIManager::GetUIManager(SecondWorld.Get())))
+            {
+                return false;
+            }
+
+            AUIManager* FirstManager = FirstWorld->SpawnActor<AUIManager>();
+            AUIManager* SecondManager = SecondWorld->SpawnActor<AUIManager>();
+            DestroyedManager = FirstManager;
+            DestroyedSubsystem = UUIManagerSubsystem::Get(FirstWorld);
+
+            TestEqual(FString::Printf(TEXT("Cycle %d: first world returns its own UIManager"), Cycle), AUIManager::GetUIManager(FirstWorld), FirstManager);
+            TestEqual(FString::Printf(TEXT("Cycle %d: second world returns its own UIManager"), Cycle), AUIManager::GetUIManager(SecondWorld.Get()), SecondManager);
+
+            // 卸载第一个世界,第二个世界不受影响
+            URLOBenchmarkCommandlet::DestroyBenchmarkWorld(FirstWorld);
+            FirstWorld = nullptr;
+            TestEqual(FString::Printf(TEXT("Cycle %d: other world unaffected by unloading"), Cycle), AUIManager::GetUIManager(SecondWorld.Get()), SecondManager);
+
+            // UIManager先于世界销毁时注销
+            SecondManager->Destroy();
+            TestNull(FString::Printf(TEXT("Cycle %d: destroyed UIManager unregistered"), Cycle), AUIManager::GetUIManager(SecondWorld.Get()));
+        }
+
+        CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+        if (!TestFalse(FString::Printf(TEXT("Cycle %d: unloaded UIManager collected"), Cycle), DestroyedManager.IsValid())
+            || !TestFalse(FString::Printf(TEXT("Cycle %d: unloaded world's subsystem collected"), Cycle), DestroyedSubsystem.IsValid()))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+#endif
@@ -1,12 +1,52 @@
 // UIManager.cpp
 
 #include "UIManager.h"
+#include "RustyLakeOrrery.h"
+#include "RLOPerf.h"
+#include "DialogueWidgetBase.h"
+#include "DialogueComponent.h"
+#include "InventoryWidgetBase.h"
+#include "ItemPopupWidgetBase.h"
+#include "UIManagerSubsystem.h"
 #include "Blueprint/UserWidget.h"
 #include "Kismet/GameplayStatics.h"
 #include "TimerManager.h"
 
-// 静态实例初始化
-AUIManager* AUIManager::Instance = nullptr;
+DECLARE_CYCLE_STAT(TEXT("UI CreateWidget"), STAT_RLO_UICreateWidget, STATGROUP_RustyLakeOrrery);
+DECLARE_CYCLE_STAT(TEXT("UI ShowDialogue"), STAT_RLO_UIShowDialogue, STATGROUP_RustyLakeOrrery);
+DECLARE_CYCLE_STAT(TEXT("UI ShowInventory"), STAT_RLO_UIShowInventory, STATGROUP_RustyLakeOrrery);
+DECLARE_CYCLE_STAT(TEXT("UI RefreshInventory"), STAT_RLO_UIRefreshInventory, STATGROUP_RustyLakeOrrery);
+DECLARE_CYCLE_STAT(TEXT("UI RefreshInventorySlots"), STAT_RLO_UIRefreshInventorySlots, STATGROUP_RustyLakeOrrery);
+DECLARE_CYCLE_STAT(TEXT("UI ShowHint"), STAT_RLO_UIShowHint, STATGROUP_RustyLakeOrrery);
+DECLARE_CYCLE_STAT(TEXT("UI ShowItemPopup"), STAT_RLO_UIShowItemPopup, STATGROUP_RustyLakeOrrery);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("UI Widgets Created"), STAT_RLO_UIWidgetsCreated, STATGROUP_RustyLakeOrrery);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("UI Widgets Pooled"), STAT_RLO_UIWidgetsPooled, STATGROUP_RustyLakeOrrery);
+
+namespace
+{
+    // 视口中的层级
+    constexpr int32 InteractionPromptZOrder = 5;
+    constexpr int32 DialogueZOrder = 10;
+    constexpr int32 InventoryZOrder = 20;
+    constexpr int32 ItemPopupZOrder = 25;
+    constexpr int32 HintZOrder = 30;
+
+    bool IsWidgetShown(const UUserWidget* Widget)
+    {
+        return Widget && Widget->GetVisibility() == ESlateVisibility::Visible;
+    }
+
+    FAutoConsoleCommandWithWorld UIDumpCommand(
+        TEXT("RLO.UI.Dump"),
+        TEXT("Print the UI widgets created so far, their visibility and the transient widget pool."),
+        FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+        {
+            if (AUIManager* UIManager = AUIManager::GetUIManager(World))
+            {
+                UIManager->DumpWidgetStatus();
+            }
+        }));
+}
 
 AUIManager::AUIManager()
 {
@@ -17,88 +57,166 @@ void AUIManager::BeginPlay()
 {
     Super::BeginPlay();
 
-    // 设置单例
-    Instance = this;
-
-    // 创建UI Widgets
-    CreateUIWidgets();
+    // 注册到所在世界
+    if (UUIManagerSubsystem* Subsystem = UUIManagerSubsystem::Get(this))
+    {
+        Subsystem->RegisterUIManager(this);
+    }
 
-    // 初始状态隐藏所有UI
-    HideAllUI();
+    // Widget在第一次显示时才创建,不拖慢关卡开始
+    // 背包变化时弹窗提示并增量刷新
+    BindInventoryEvents();
 
-    UE_LOG(LogTemp, Log, TEXT("UIManager: Initialized"));
+    UE_LOG(LogRLOUI, Log, TEXT("UIManager: Initialized"));
 }
 
 void AUIManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
     Super::EndPlay(EndPlayReason);
 
-    // 清理单例
-    if (Instance == this)
+    if (UUIManagerSubsystem* Subsystem = UUIManagerSubsystem::Get(this))
     {
-        Instance = nullptr;
+        Subsystem->UnregisterUIManager(this);
     }
 
     // 清理计时器
     GetWorld()->GetTimerManager().ClearTimer(HintTimerHandle);
+    for (FTimerHandle& TimerHandle : ItemPopupTimerHandles)
+    {
+        GetWorld()->GetTimerManager().ClearTimer(TimerHandle);
+    }
+    ItemPopupTimerHandles.Reset();
+    ActiveItemPopups.Reset();
+
+    // Widget随世界销毁
+    DEC_DWORD_STAT_BY(STAT_RLO_UIWidgetsCreated, NumCreatedWidgets);
+    DEC_DWORD_STAT_BY(STAT_RLO_UIWidgetsPooled, WidgetPool.Num());
+    NumCreatedWidgets = 0;
+    WidgetPool.Reset();
+
+    if (UInventoryComponent* Inventory = BoundInventory.Get())
+    {
+        Inventory->OnInventoryChanged.RemoveDynamic(this, &AUIManager::HandleInventoryChanged);
+    }
+    BoundInventory.Reset();
 }
 
-void AUIManager::CreateUIWidgets()
+void AUIManager::BindInventoryEvents()
 {
     APlayerController* PC = UGameplayStatics::GetPlayerController(this, 0);
-    if (!PC)
+    UInventoryComponent* Inventory = PC ? PC->FindComponentByClass<UInventoryComponent>() : nullptr;
+    if (!Inventory)
     {
-        UE_LOG(LogTemp, Error, TEXT("UIManager: Failed to get PlayerController"));
+        UE_LOG(LogRLOUI, Warning, TEXT("UIManager: PlayerController has no InventoryComponent, inventory UI will not auto refresh"));
         return;
     }
 
-    // 创建对话UI
-    if (DialogueWidgetClass)
+    Inventory->OnInventoryChanged.AddUniqueDynamic(this, &AUIManager::HandleInventoryChanged);
+    BoundInventory = Inventory;
+}
+
+void AUIManager::HandleInventoryChanged(const FInventoryDelta& Delta)
+{
+    // 只有拾取弹出获得提示,读档恢复的物品不弹出
+    if (ItemPopupWidgetClass)
     {
-        DialogueWidget = CreateWidget<UUserWidget>(PC, DialogueWidgetClass);
-        if (DialogueWidget)
+        for (const FInventoryItemChange& Change : Delta.ChangedItems)
         {
-            DialogueWidget->AddToViewport(10); // 较高的Z-Order
-            DialogueWidget->SetVisibility(ESlateVisibility::Hidden);
-            UE_LOG(LogTemp, Log, TEXT("UIManager: Created Dialogue Widget"));
+            if (Delta.IsPickup(Change))
+            {
+                ShowItemPopup(Change.ItemData);
+            }
         }
     }
 
-    // 创建背包UI
-    if (InventoryWidgetClass)
+    RefreshInventorySlots(Delta);
+}
+
+// ========================================================================
+// Widget创建和池
+// ========================================================================
+
+UUserWidget* AUIManager::CreateUIWidget(TSubclassOf<UUserWidget> WidgetClass, int32 ZOrder)
+{
+    return CreateUIWidget(WidgetClass, ZOrder, [](UUserWidget*) {});
+}
+
+UUserWidget* AUIManager::CreateUIWidget(TSubclassOf<UUserWidget> WidgetClass, int32 ZOrder, TFunctionRef<void(UUserWidget*)> InitWidget)
+{
+    RLO_SCOPE_CYCLE(UI, STAT_RLO_UICreateWidget);
+
+    if (!WidgetClass)
+    {
+        return nullptr;
+    }
+
+    APlayerController* PC = UGameplayStatics::GetPlayerController(this, 0);
+    if (!PC)
     {
-        InventoryWidget = CreateWidget<UUserWidget>(PC, InventoryWidgetClass);
-        if (InventoryWidget)
-        {
-            InventoryWidget->AddToViewport(20); // 更高的Z-Order
-            InventoryWidget->SetVisibility(ESlateVisibility::Hidden);
-            UE_LOG(LogTemp, Log, TEXT("UIManager: Created Inventory Widget"));
-        }
+        UE_LOG(LogRLOUI, Error, TEXT("UIManager: Failed to get PlayerController"));
+        return nullptr;
     }
 
-    // 创建提示UI
-    if (HintWidgetClass)
+    UUserWidget* Widget = CreateWidget<UUserWidget>(PC, WidgetClass);
+    if (!Widget)
     {
-        HintWidget = CreateWidget<UUserWidget>(PC, HintWidgetClass);
-        if (HintWidget)
-        {
-            HintWidget->AddToViewport(30); // 最高的Z-Order
-            HintWidget->SetVisibility(ESlateVisibility::Hidden);
-            UE_LOG(LogTemp, Log, TEXT("UIManager: Created Hint Widget"));
-        }
+        return nullptr;
     }
 
-    // 创建交互提示UI
-    if (InteractionPromptWidgetClass)
+    // 空闲时Collapsed,不参与布局和Prepass(Hidden仍然参与)
+    Widget->SetVisibility(ESlateVisibility::Collapsed);
+    InitWidget(Widget);
+    Widget->AddToViewport(ZOrder);
+
+    NumCreatedWidgets++;
+    INC_DWORD_STAT(STAT_RLO_UIWidgetsCreated);
+
+    UE_LOG(LogRLOUI, Log, TEXT("UIManager: Created %s"), *WidgetClass->GetName());
+    return Widget;
+}
+
+UUserWidget* AUIManager::GetOrCreateWidget(UUserWidget*& Widget, TSubclassOf<UUserWidget> WidgetClass, int32 ZOrder)
+{
+    if (!Widget)
+    {
+        Widget = CreateUIWidget(WidgetClass, ZOrder);
+    }
+    return Widget;
+}
+
+UUserWidget* AUIManager::AcquirePooledWidget(TSubclassOf<UUserWidget> WidgetClass, int32 ZOrder)
+{
+    return AcquirePooledWidget(WidgetClass, ZOrder, [](UUserWidget*) {});
+}
+
+UUserWidget* AUIManager::AcquirePooledWidget(TSubclassOf<UUserWidget> WidgetClass, int32 ZOrder, TFunctionRef<void(UUserWidget*)> InitWidget)
+{
+    for (int32 Index = WidgetPool.Num() - 1; Index >= 0; Index--)
     {
-        InteractionPromptWidget = CreateWidget<UUserWidget>(PC, InteractionPromptWidgetClass);
-        if (InteractionPromptWidget)
+        UUserWidget* Widget = WidgetPool[Index];
+        if (Widget && Widget->GetClass() == WidgetClass)
         {
-            InteractionPromptWidget->AddToViewport(5); // 较低的Z-Order
-            InteractionPromptWidget->SetVisibility(ESlateVisibility::Hidden);
-            UE_LOG(LogTemp, Log, TEXT("UIManager: Created Interaction Prompt Widget"));
+            WidgetPool.RemoveAtSwap(Index);
+            DEC_DWORD_STAT(STAT_RLO_UIWidgetsPooled);
+            InitWidget(Widget);
+            return Widget;
         }
     }
+
+    return CreateUIWidget(WidgetClass, ZOrder, InitWidget);
+}
+
+void AUIManager::ReleasePooledWidget(UUserWidget* Widget)
+{
+    if (!Widget)
+    {
+        return;
+    }
+
+    // 留在视口中,下次取出时只需改回可见
+    Widget->SetVisibility(ESlateVisibility::Collapsed);
+    WidgetPool.Add(Widget);
+    INC_DWORD_STAT(STAT_RLO_UIWidgetsPooled);
 }
 
 // ========================================================================
@@ -107,9 +225,11 @@ void AUIManager::CreateUIWidgets()
 
 void AUIManager::ShowDialogue(const FDialogueEntry& DialogueEntry)
 {
-    if (!DialogueWidget)
+    RLO_SCOPE_CYCLE(UI, STAT_RLO_UIShowDialogue);
+
+    if (!GetOrCreateWidget(DialogueWidget, DialogueWidgetClass, DialogueZOrder))
     {
-        UE_LOG(LogTemp, Warning, TEXT("UIManager: Dialogue Widget not created"));
+        UE_LOG(LogRLOUI, Warning, TEXT("UIManager: Dialogue Widget not created"));
         return;
     }
 
@@ -117,39 +237,73 @@ void AUIManager::ShowDialogue(const FDialogueEntry& DialogueEntry)
 
     // TODO: 调用Widget的蓝图函数来设置对话内容
     // 这需要在Widget蓝图中实现对应的函数
-    UE_LOG(LogTemp, Log, TEXT("UIManager: Showing dialogue: %s"), *DialogueEntry.DialogueID.ToString());
+    UE_LOG(LogRLOUI, Log, TEXT("UIManager: Showing dialogue: %s"), *DialogueEntry.DialogueID.ToString());
+}
+
+void AUIManager::ShowDialogueFor(UDialogueComponent* DialogueComponent)
+{
+    RLO_SCOPE_CYCLE(UI, STAT_RLO_UIShowDialogue);
+
+    if (!DialogueComponent)
+    {
+        return;
+    }
+
+    if (!GetOrCreateWidget(DialogueWidget, DialogueWidgetClass, DialogueZOrder))
+    {
+        UE_LOG(LogRLOUI, Warning, TEXT("UIManager: Dialogue Widget not created"));
+        return;
+    }
+
+    UDialogueWidgetBase* BoundWidget = Cast<UDialogueWidgetBase>(DialogueWidget);
+    if (!BoundWidget)
+    {
+        UE_LOG(LogRLOUI, Warning, TEXT("UIManager: %s does not derive from UDialogueWidgetBase, use ShowDialogue/UpdateDialogueText"),
+               *GetNameSafe(DialogueWidget->GetClass()));
+        return;
+    }
+
+    BoundWidget->BindToDialogueComponent(DialogueComponent);
+    DialogueWidget->SetVisibility(ESlateVisibility::Visible);
+    UE_LOG(LogRLOUI, Log, TEXT("UIManager: Showing dialogue of %s"), *GetNameSafe(DialogueComponent->GetOwner()));
 }
 
 void AUIManager::UpdateDialogueText(const FText& DisplayText, float Progress)
 {
-    if (!DialogueWidget || DialogueWidget->GetVisibility() != ESlateVisibility::Visible)
+    if (!IsWidgetShown(DialogueWidget))
     {
         return;
     }
 
     // TODO: 调用Widget的蓝图函数来更新文本
-    // UE_LOG(LogTemp, Verbose, TEXT("UIManager: Updating dialogue text, progress: %.2f"), Progress);
+    // UE_LOG(LogRLOUI, Verbose, TEXT("UIManager: Updating dialogue text, progress: %.2f"), Progress);
 }
 
 void AUIManager::HideDialogue()
 {
     if (DialogueWidget)
     {
-        DialogueWidget->SetVisibility(ESlateVisibility::Hidden);
-        UE_LOG(LogTemp, Log, TEXT("UIManager: Hiding dialogue"));
+        DialogueWidget->SetVisibility(ESlateVisibility::Collapsed);
+
+        // 隐藏期间不再跟随对话组件更新
+        if (UDialogueWidgetBase* BoundWidget = Cast<UDialogueWidgetBase>(DialogueWidget))
+        {
+            BoundWidget->UnbindFromDialogueComponent();
+        }
+        UE_LOG(LogRLOUI, Log, TEXT("UIManager: Hiding dialogue"));
     }
 }
 
 void AUIManager::ShowDialogueChoices(const TArray<FString>& Choices)
 {
-    if (!DialogueWidget)
+    if (!GetOrCreateWidget(DialogueWidget, DialogueWidgetClass, DialogueZOrder))
     {
-        UE_LOG(LogTemp, Warning, TEXT("UIManager: Dialogue Widget not created"));
+        UE_LOG(LogRLOUI, Warning, TEXT("UIManager: Dialogue Widget not created"));
         return;
     }
 
     // TODO: 调用Widget的蓝图函数来显示选项
-    UE_LOG(LogTemp, Log, TEXT("UIManager: Showing %d dialogue choices"), Choices.Num());
+    UE_LOG(LogRLOUI, Log, TEXT("UIManager: Showing %d dialogue choices"), Choices.Num());
 }
 
 // ========================================================================
@@ -158,34 +312,95 @@ void AUIManager::ShowDialogueChoices(const TArray<FString>& Choices)
 
 void AUIManager::ShowInventory()
 {
-    if (!InventoryWidget)
+    RLO_SCOPE_CYCLE(UI, STAT_RLO_UIShowInventory);
+
+    if (!GetOrCreateWidget(InventoryWidget, InventoryWidgetClass, InventoryZOrder))
     {
-        UE_LOG(LogTemp, Warning, TEXT("UIManager: Inventory Widget not created"));
+        UE_LOG(LogRLOUI, Warning, TEXT("UIManager: Inventory Widget not created"));
         return;
     }
 
     InventoryWidget->SetVisibility(ESlateVisibility::Visible);
-    RefreshInventory();
-    UE_LOG(LogTemp, Log, TEXT("UIManager: Showing inventory"));
+
+    // 背包视图自己监听背包变化,只为可见条目加载图标
+    if (UInventoryWidgetBase* InventoryView = Cast<UInventoryWidgetBase>(InventoryWidget))
+    {
+        InventoryView->BindToInventory(BoundInventory.Get());
+    }
+    else
+    {
+        RefreshInventory();
+        PreloadInventoryIcons();
+    }
+    UE_LOG(LogRLOUI, Log, TEXT("UIManager: Showing inventory"));
 }
 
-void AUIManager::HideInventory()
+void AUIManager::PreloadInventoryIcons()
 {
-    if (InventoryWidget)
+    UInventoryComponent* Inventory = BoundInventory.Get();
+    if (!Inventory)
+    {
+        return;
+    }
+
+    TArray<UItemDataAsset*> Items;
+    for (const FInventorySlot& Slot : Inventory->GetAllItems())
     {
-        InventoryWidget->SetVisibility(ESlateVisibility::Hidden);
-        UE_LOG(LogTemp, Log, TEXT("UIManager: Hiding inventory"));
+        Items.Add(Slot.ItemData);
     }
+
+    // 已加载的图标直接显示,其余加载完成后再刷新一次
+    bool bAllLoaded = true;
+    for (const UItemDataAsset* Item : Items)
+    {
+        if (Item && !Item->AreAssetsLoaded(EItemAssetGroup::Icons))
+        {
+            bAllLoaded = false;
+            break;
+        }
+    }
+
+    FStreamableDelegate OnLoaded;
+    if (!bAllLoaded)
+    {
+        OnLoaded = FStreamableDelegate::CreateWeakLambda(this, [this]()
+        {
+            if (IsWidgetShown(InventoryWidget))
+            {
+                RefreshInventory();
+            }
+        });
+    }
+
+    // 新句柄包含当前所有物品,替换后旧句柄中已移出背包的图标可被回收
+    InventoryIconHandle = UItemDataAsset::PreloadAssetsForItems(Items, EItemAssetGroup::Icons, OnLoaded, FStreamableManager::AsyncLoadHighPriority);
 }
 
-void AUIManager::ToggleInventory()
+void AUIManager::HideInventory()
 {
-    if (!InventoryWidget)
+    if (InventoryWidget)
     {
-        return;
+        InventoryWidget->SetVisibility(ESlateVisibility::Collapsed);
+
+        // 隐藏期间不处理背包变化,再次显示时重新同步
+        if (UInventoryWidgetBase* InventoryView = Cast<UInventoryWidgetBase>(InventoryWidget))
+        {
+            InventoryView->UnbindFromInventory();
+        }
+        UE_LOG(LogRLOUI, Log, TEXT("UIManager: Hiding inventory"));
     }
 
-    if (InventoryWidget->GetVisibility() == ESlateVisibility::Visible)
+    // 释放图标引用,背包关闭后图标可被回收
+    if (InventoryIconHandle.IsValid())
+    {
+        InventoryIconHandle->ReleaseHandle();
+        InventoryIconHandle.Reset();
+    }
+}
+
+void AUIManager::ToggleInventory()
+{
+    if (IsWidgetShown(InventoryWidget))
     {
         HideInventory();
     }
@@ -197,14 +412,71 @@ void AUIManager::ToggleInventory()
 
 void AUIManager::RefreshInventory()
 {
+    RLO_SCOPE_CYCLE(UI, STAT_RLO_UIRefreshInventory);
+
     if (!InventoryWidget)
     {
         return;
     }
 
-    // TODO: 调用Widget的蓝图函数来刷新背包内容
-    // 需要从InventoryComponent获取物品列表
-    UE_LOG(LogTemp, Log, TEXT("UIManager: Refreshing inventory"));
+    if (UInventoryWidgetBase* InventoryView = Cast<UInventoryWidgetBase>(InventoryWidget))
+    {
+        InventoryView->RebuildFromInventory();
+        return;
+    }
+
+    UInventoryComponent* Inventory = BoundInventory.Get();
+    if (!Inventory)
+    {
+        return;
+    }
+
+    OnRefreshInventoryWidget(InventoryWidget, Inventory->GetAllItems());
+    UE_LOG(LogRLOUI, Verbose, TEXT("UIManager: Refreshed inventory with %d slots"), Inventory->GetAllItems().Num());
+}
+
+void AUIManager::RefreshInventorySlots(const FInventoryDelta& Delta)
+{
+    RLO_SCOPE_CYCLE(UI, STAT_RLO_UIRefreshInventorySlots);
+
+    // 背包未显示时不刷新,显示时ShowInventory会完整刷新
+    if (!IsWidgetShown(InventoryWidget))
+    {
+        return;
+    }
+
+    // 背包视图已绑定背包,自己通过 ApplyInventoryDelta 处理增量
+    if (InventoryWidget->IsA<UInventoryWidgetBase>())
+    {
+        return;
+    }
+
+    UInventoryComponent* Inventory = BoundInventory.Get();
+    if (!Inventory)
+    {
+        return;
+    }
+
+    // 新加入背包的物品需要加载图标
+    for (const FInventoryItemChange& Change : Delta.ChangedItems)
+    {
+        if (Change.OldQuantity == 0 && Change.ItemData && !Change.ItemData->AreAssetsLoaded(EItemAssetGroup::Icons))
+        {
+            PreloadInventoryIcons();
+            break;
+        }
+    }
+
+    // 从第一个槽位开始都移动了(排序、清空),直接完整刷新
+    if (Delta.FirstMovedSlot == 0)
+    {
+        RefreshInventory();
+        return;
+    }
+
+    OnRefreshInventoryWidgetSlots(InventoryWidget, Delta, Inventory->GetAllItems());
+    UE_LOG(LogRLOUI, Verbose, TEXT("UIManager: Refreshed %d changed inventory items, first moved slot %d"),
+           Delta.ChangedItems.Num(), Delta.FirstMovedSlot);
 }
 
 // ========================================================================
@@ -213,16 +485,22 @@ void AUIManager::RefreshInventory()
 
 void AUIManager::ShowHint(const FText& HintText, float Duration)
 {
+    RLO_SCOPE_CYCLE(UI, STAT_RLO_UIShowHint);
+
     if (!HintWidget)
     {
-        UE_LOG(LogTemp, Warning, TEXT("UIManager: Hint Widget not created"));
+        HintWidget = AcquirePooledWidget(HintWidgetClass, HintZOrder);
+    }
+    if (!HintWidget)
+    {
+        UE_LOG(LogRLOUI, Warning, TEXT("UIManager: Hint Widget not created"));
         return;
     }
 
     HintWidget->SetVisibility(ESlateVisibility::Visible);
 
     // TODO: 调用Widget的蓝图函数来设置提示文本
-    UE_LOG(LogTemp, Log, TEXT("UIManager: Showing hint: %s"), *HintText.ToString());
+    UE_LOG(LogRLOUI, Log, TEXT("UIManager: Showing hint: %s"), *HintText.ToString());
 
     // 清除之前的计时器
     GetWorld()->GetTimerManager().ClearTimer(HintTimerHandle);
@@ -244,37 +522,115 @@ void AUIManager::HideHint()
 {
     if (HintWidget)
     {
-        HintWidget->SetVisibility(ESlateVisibility::Hidden);
-        UE_LOG(LogTemp, Log, TEXT("UIManager: Hiding hint"));
+        ReleasePooledWidget(HintWidget);
+        HintWidget = nullptr;
+        UE_LOG(LogRLOUI, Log, TEXT("UIManager: Hiding hint"));
     }
 
     // 清除计时器
     GetWorld()->GetTimerManager().ClearTimer(HintTimerHandle);
 }
 
+// ========================================================================
+// 物品弹窗接口实现
+// ========================================================================
+
+void AUIManager::ShowItemPopup(UItemDataAsset* Item)
+{
+    RLO_SCOPE_CYCLE(UI, STAT_RLO_UIShowItemPopup);
+
+    if (!Item)
+    {
+        return;
+    }
+
+    // 物品名称和图标在显示之前设置(新建的弹窗在加入视口之前),不会先显示一帧空白弹窗
+    UUserWidget* Popup = AcquirePooledWidget(ItemPopupWidgetClass, ItemPopupZOrder, [this, Item](UUserWidget* Widget)
+    {
+        if (UItemPopupWidgetBase* ItemPopup = Cast<UItemPopupWidgetBase>(Widget))
+        {
+            ItemPopup->SetItem(Item);
+        }
+        else
+        {
+            OnInitItemPopup(Widget, Item);
+        }
+    });
+    if (!Popup)
+    {
+        UE_LOG(LogRLOUI, Warning, TEXT("UIManager: Item Popup Widget not created"));
+        return;
+    }
+
+    // 弹窗不拦截点击
+    Popup->SetVisibility(ESlateVisibility::HitTestInvisible);
+
+    UE_LOG(LogRLOUI, Log, TEXT("UIManager: Showing item popup: %s"), *Item->ItemName.ToString());
+
+    FTimerHandle TimerHandle;
+    GetWorld()->GetTimerManager().SetTimer(
+        TimerHandle,
+        FTimerDelegate::CreateUObject(this, &AUIManager::HideItemPopup, Popup),
+        ItemPopupDuration,
+        false
+    );
+
+    ActiveItemPopups.Add(Popup);
+    ItemPopupTimerHandles.Add(TimerHandle);
+}
+
+void AUIManager::HideItemPopup(UUserWidget* Popup)
+{
+    const int32 Index = ActiveItemPopups.Find(Popup);
+    if (Index == INDEX_NONE)
+    {
+        return;
+    }
+
+    GetWorld()->GetTimerManager().ClearTimer(ItemPopupTimerHandles[Index]);
+    ActiveItemPopups.RemoveAt(Index);
+    ItemPopupTimerHandles.RemoveAt(Index);
+
+    // 放回池中时释放图标
+    if (UItemPopupWidgetBase* ItemPopup = Cast<UItemPopupWidgetBase>(Popup))
+    {
+        ItemPopup->SetItem(nullptr);
+    }
+
+    ReleasePooledWidget(Popup);
+}
+
+void AUIManager::HideItemPopups()
+{
+    while (ActiveItemPopups.Num() > 0)
+    {
+        HideItemPopup(ActiveItemPopups.Last());
+    }
+}
+
 // ========================================================================
 // 交互提示UI接口实现
 // ========================================================================
 
 void AUIManager::ShowInteractionPrompt(const FText& PromptText)
 {
-    if (!InteractionPromptWidget)
+    if (!GetOrCreateWidget(InteractionPromptWidget, InteractionPromptWidgetClass, InteractionPromptZOrder))
     {
-        UE_LOG(LogTemp, Warning, TEXT("UIManager: Interaction Prompt Widget not created"));
+        UE_LOG(LogRLOUI, Warning, TEXT("UIManager: Interaction Prompt Widget not created"));
         return;
     }
 
     InteractionPromptWidget->SetVisibility(ESlateVisibility::Visible);
 
     // TODO: 调用Widget的蓝图函数来设置提示文本
-    UE_LOG(LogTemp, Log, TEXT("UIManager: Showing interaction prompt: %s"), *PromptText.ToString());
+    UE_LOG(LogRLOUI, Log, TEXT("UIManager: Showing interaction prompt: %s"), *PromptText.ToString());
 }
 
 void AUIManager::HideInteractionPrompt()
 {
     if (InteractionPromptWidget)
     {
-        InteractionPromptWidget->SetVisibility(ESlateVisibility::Hidden);
+        InteractionPromptWidget->SetVisibility(ESlateVisibility::Collapsed);
     }
 }
 
@@ -287,61 +643,55 @@ void AUIManager::HideAllUI()
     HideDialogue();
     HideInventory();
     HideHint();
+    HideItemPopups();
     HideInteractionPrompt();
 
-    UE_LOG(LogTemp, Log, TEXT("UIManager: Hiding all UI"));
+    UE_LOG(LogRLOUI, Log, TEXT("UIManager: Hiding all UI"));
 }
 
 bool AUIManager::IsAnyUIVisible() const
 {
-    bool bAnyVisible = false;
-
-    if (DialogueWidget && DialogueWidget->GetVisibility() == ESlateVisibility::Visible)
-    {
-        bAnyVisible = true;
-    }
-
-    if (InventoryWidget && InventoryWidget->GetVisibility() == ESlateVisibility::Visible)
-    {
-        bAnyVisible = true;
-    }
-
-    if (HintWidget && HintWidget->GetVisibility() == ESlateVisibility::Visible)
-    {
-        bAnyVisible = true;
-    }
-
-    return bAnyVisible;
+    return IsWidgetShown(DialogueWidget) || IsWidgetShown(InventoryWidget) || IsWidgetShown(HintWidget);
 }
 
 // ========================================================================
-// 单例访问
+// 实例访问
 // ========================================================================
 
 AUIManager* AUIManager::GetUIManager(const UObject* WorldContext)
 {
-    if (Instance)
+    UUIManagerSubsystem* Subsystem = UUIManagerSubsystem::Get(WorldContext);
+    AUIManager* UIManager = Subsystem ? Subsystem->GetUIManager() : nullptr;
+    if (!UIManager)
     {
-        return Instance;
+        UE_LOG(LogRLOUI, Warning, TEXT("UIManager: No UIManager registered in the world of %s"), *GetNameSafe(WorldContext));
     }
+    return UIManager;
+}
 
-    // 尝试在世界中查找UIManager
-    if (WorldContext)
+void AUIManager::DumpWidgetStatus() const
+{
+    UE_LOG(LogRLOUI, Log, TEXT("========== UI Widgets =========="));
+    UE_LOG(LogRLOUI, Log, TEXT("Created: %d, pooled: %d, item popups shown: %d"), NumCreatedWidgets, WidgetPool.Num(), ActiveItemPopups.Num());
+
+    auto DumpWidget = [](const TCHAR* Name, const UUserWidget* Widget)
     {
-        UWorld* World = WorldContext->GetWorld();
-        if (World)
+        if (Widget)
         {
-            TArray<AActor*> FoundActors;
-            UGameplayStatics::GetAllActorsOfClass(World, AUIManager::StaticClass(), FoundActors);
-            
-            if (FoundActors.Num() > 0)
-            {
-                Instance = Cast<AUIManager>(FoundActors[0]);
-                return Instance;
-            }
+            UE_LOG(LogRLOUI, Log, TEXT("  %s: %s"), Name, *UEnum::GetValueAsString(Widget->GetVisibility()));
         }
-    }
+        else
+        {
+            UE_LOG(LogRLOUI, Log, TEXT("  %s: not created"), Name);
+        }
+    };
+    DumpWidget(TEXT("Dialogue"), DialogueWidget);
+    DumpWidget(TEXT("Inventory"), InventoryWidget);
+    DumpWidget(TEXT("Hint"), HintWidget);
+    DumpWidget(TEXT("InteractionPrompt"), InteractionPromptWidget);
 
-    UE_LOG(LogTemp, Error, TEXT("UIManager: No UIManager instance found in the world"));
-    return nullptr;
+    for (const UUserWidget* Widget : WidgetPool)
+    {
+        UE_LOG(LogRLOUI, Log, TEXT("  Pooled: %s"), *GetNameSafe(Widget ? Widget->GetClass() : nullptr));
+    }
 }
@@ -0,0 +1,48 @@
+// UIManagerSubsystem.cpp
+
+#include "UIManagerSubsystem.h"
+#include "RustyLakeOrrery.h"
+#include "UIManager.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+UUIManagerSubsystem* UUIManagerSubsystem::Get(const UObject* WorldContextObject)
+{
+    UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+    return World ? World->GetSubsystem<UUIManagerSubsystem>() : nullptr;
+}
+
+bool UUIManagerSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    // 编辑器预览等世界没有UI
+    const UWorld* World = Cast<UWorld>(Outer);
+    return World && (World->WorldType == EWorldType::Game || World->WorldType == EWorldType::PIE);
+}
+
+void UUIManagerSubsystem::Deinitialize()
+{
+    UIManagers.Reset();
+
+    Super::Deinitialize();
+}
+
+void UUIManagerSubsystem::RegisterUIManager(AUIManager* UIManager)
+{
+    if (!UIManager)
+    {
+        return;
+    }
+
+    UIManagers.Remove(UIManager);
+    UIManagers.Add(UIManager);
+
+    if (UIManagers.Num() > 1)
+    {
+        UE_LOG(LogRLOUI, Log, TEXT("UIManagerSubsystem: %s overrides %s"), *UIManager->GetName(), *UIManagers[UIManagers.Num() - 2]->GetName());
+    }
+}
+
+void UUIManagerSubsystem::UnregisterUIManager(AUIManager* UIManager)
+{
+    UIManagers.Remove(UIManager);
+}
@@ -0,0 +1,217 @@
+// ChapterAssetSubsystem.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "ChapterAssetSubsystem.generated.h"
+
+class FDialogueBank;
+class UInteractableComponent;
+class UItemDataAsset;
+
+/**
+ * @brief 单个章节的资源配置（DefaultGame.ini）
+ */
+USTRUCT()
+struct FChapterAssetConfig
+{
+    GENERATED_BODY()
+
+    /** 章节序号（从1开始） */
+    UPROPERTY()
+    int32 Chapter = 0;
+
+    /** 属于本章节的关卡名称（未配置的关卡按名称中的 ChapterN 判断） */
+    UPROPERTY()
+    TArray<FName> Levels;
+
+    /** 表格之外需要预加载的资源（谜题资源、UI控件类等） */
+    UPROPERTY()
+    TArray<FSoftObjectPath> ExtraAssets;
+};
+
+/**
+ * @brief 章节资源管理器（游戏实例子系统）
+ *
+ * 为每个章节建立资源清单，按章节预加载和回收资源：
+ * - 清单来源：DT_Items_ChapterN.csv 的图标/模型、DT_Dialogue_ChapterN.csv 的语音、
+ *   Data/DialogueBanks/ChapterN.rldb 对话库、配置中的额外资源，
+ *   以及运行时注册的可交互对象引用的物品（拾取、使用、谜题奖励）
+ * - 进入章节时以高优先级加载本章资源，完成后在后台预加载下一章
+ * - 已完成的章节（以及更远的章节）释放引用，由GC回收
+ * - 每章驻留内存显示在 stat RustyLakeOrrery，RLO.Chapters.Dump 输出详细信息
+ *
+ * 关卡加载完成时按关卡名称自动切换当前章节，也可以手动调用 SetCurrentChapter()。
+ */
+UCLASS(Config = Game)
+class RUSTYLAKEORRERY_API UChapterAssetSubsystem : public UGameInstanceSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * @brief 获取章节资源管理器
+     * @param WorldContextObject 世界上下文对象
+     * @return 管理器，没有游戏实例时返回nullptr
+     */
+    static UChapterAssetSubsystem* Get(const UObject* WorldContextObject);
+
+    /**
+     * @brief 从名称中解析章节序号（如 DT_Items_Chapter2、Chapter3_CoreHall）
+     * @param Name 文件名或关卡名
+     * @return 章节序号，没有时返回0
+     */
+    static int32 ParseChapterNumber(const FString& Name);
+
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    // ========================================================================
+    // 配置
+    // ========================================================================
+
+    /** 章节数量 */
+    UPROPERTY(Config)
+    int32 NumChapters = 3;
+
+    /** 章节数据表所在目录（相对于Content目录） */
+    UPROPERTY(Config)
+    FString ChapterDataDirectory = TEXT("Data");
+
+    /** 对话库所在目录（相对于Content目录） */
+    UPROPERTY(Config)
+    FString DialogueBankDirectory = TEXT("Data/DialogueBanks");
+
+    /** 各章节的关卡和额外资源 */
+    UPROPERTY(Config)
+    TArray<FChapterAssetConfig> ChapterConfigs;
+
+    /** 是否在本章资源加载完成后后台预加载下一章 */
+    UPROPERTY(Config)
+    bool bPrefetchNextChapter = true;
+
+    // ========================================================================
+    // 章节切换
+    // ========================================================================
+
+    /**
+     * @brief 设置当前章节：加载本章资源，预加载下一章，回收其他章节
+     * @param Chapter 章节序号（从1开始）
+     */
+    UFUNCTION(BlueprintCallable, Category = "Chapter Assets")
+    void SetCurrentChapter(int32 Chapter);
+
+    /** 当前章节（0表示未进入任何章节） */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Chapter Assets")
+    int32 GetCurrentChapter() const { return CurrentChapter; }
+
+    /**
+     * @brief 获取关卡所属章节
+     * @param LevelName 关卡名称（不含路径）
+     * @return 章节序号，无法判断时返回0
+     */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Chapter Assets")
+    int32 GetChapterForLevel(FName LevelName) const;
+
+    /**
+     * @brief 即将切换到指定关卡时调用，提前以高优先级加载目标章节的资源
+     * @param LevelName 目标关卡名称
+     */
+    UFUNCTION(BlueprintCallable, Category = "Chapter Assets")
+    void PrepareForLevel(FName LevelName);
+
+    /**
+     * @brief 章节资源是否已全部加载
+     * @param Chapter 章节序号
+     */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Chapter Assets")
+    bool IsChapterLoaded(int32 Chapter) const;
+
+    // ========================================================================
+    // 资源清单
+    // ========================================================================
+
+    /**
+     * @brief 将可交互对象引用的物品资源加入其所在关卡章节的清单
+     *
+     * 由 UInteractableSubsystem 在可交互对象注册时调用；章节已在加载时立即加载新增的资源。
+     * @param Interactable 可交互组件
+     */
+    void RegisterPlacedInteractable(const UInteractableComponent* Interactable);
+
+    /**
+     * @brief 获取章节的资源清单
+     * @param Chapter 章节序号
+     * @return 资源路径列表，章节不存在时返回nullptr
+     */
+    const TArray<FSoftObjectPath>* GetChapterManifest(int32 Chapter) const;
+
+    /**
+     * @brief 获取章节当前驻留的内存（已加载的清单资源和对话库）
+     * @param Chapter 章节序号
+     * @return 字节数
+     */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Chapter Assets")
+    int64 GetChapterResidentBytes(int32 Chapter) const;
+
+    /** 输出各章节的清单大小、加载状态和驻留内存（控制台命令 RLO.Chapters.Dump） */
+    void DumpChapterStatus() const;
+
+private:
+    /** 单个章节的清单和加载状态 */
+    struct FChapterState
+    {
+        /** 资源清单 */
+        TArray<FSoftObjectPath> Assets;
+
+        /** 对话库文件路径 */
+        TArray<FString> DialogueBankPaths;
+
+        /** 加载句柄（清单在加载后新增资源时追加句柄） */
+        TArray<TSharedPtr<FStreamableHandle>> Handles;
+
+        /** 已加载的对话库 */
+        TArray<TSharedPtr<const FDialogueBank>> DialogueBanks;
+
+        /** 是否已请求加载 */
+        bool bRequested = false;
+    };
+
+    /** 从数据表和配置建立所有章节的清单 */
+    void BuildManifests();
+
+    /** 读取物品表中的图标和模型路径 */
+    void AddItemTableAssets(FChapterState& State, const FString& FilePath);
+
+    /** 读取对话表中的语音路径 */
+    void AddDialogueTableAssets(FChapterState& State, const FString& FilePath);
+
+    /** 将物品资产及其引用的资源加入章节清单 */
+    void AddItemAssets(int32 Chapter, const UItemDataAsset* Item);
+
+    /** 请求加载章节资源 */
+    void RequestChapter(int32 Chapter, TAsyncLoadPriority Priority);
+
+    /** 释放章节资源引用 */
+    void EvictChapter(int32 Chapter);
+
+    /** 本章资源加载完成 */
+    void OnChapterLoaded(int32 Chapter);
+
+    /** 更新每章驻留内存统计 */
+    void UpdateResidentStats() const;
+
+    /** 关卡加载完成后切换章节 */
+    void HandlePostLoadMap(UWorld* LoadedWorld);
+
+    /** 各章节状态 */
+    TMap<int32, FChapterState> Chapters;
+
+    /** 当前章节 */
+    int32 CurrentChapter = 0;
+
+    FDelegateHandle PostLoadMapHandle;
+    FDelegateHandle PostGarbageCollectHandle;
+};
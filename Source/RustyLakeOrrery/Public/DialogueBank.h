@@ -0,0 +1,204 @@
+// DialogueBank.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DialogueDataAsset.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * @brief 二进制对话库(.rldb)文件布局
+ *
+ * 由 UDialogueDataAsset 烘焙得到,运行时只需一次读取或内存映射即可使用:
+ *
+ *   [Header][Records x EntryCount][ID哈希槽 x HashSlotCount][Trigger哈希槽 x HashSlotCount][字符串表]
+ *
+ * - 所有字符串(ID、中英文文本、音频路径、选项)以UTF-8存放在字符串表中,记录只保存偏移和长度
+ * - 记录为定长结构,按下标直接访问
+ * - ID/触发事件哈希表为开放寻址(线性探测),槽位存放记录下标,空槽为 INDEX_NONE
+ * - 所有数值为小端序
+ */
+namespace DialogueBankFormat
+{
+    /** 文件标识 'RLDB' */
+    static constexpr uint32 Magic = 0x42444C52;
+
+    /** 当前版本 */
+    static constexpr uint16 Version = 1;
+
+    /** 空哈希槽 */
+    static constexpr uint32 EmptySlot = 0xFFFFFFFF;
+
+    /** 字符串表引用(UTF-8字节偏移和长度) */
+    struct FStringRef
+    {
+        uint32 Offset;
+        uint32 Length;
+    };
+
+    /** 文件头 */
+    struct FHeader
+    {
+        uint32 Magic;
+        uint16 Version;
+        uint16 Flags;
+        uint32 EntryCount;
+        uint32 HashSlotCount;
+        uint32 RecordsOffset;
+        uint32 IDHashOffset;
+        uint32 TriggerHashOffset;
+        uint32 StringTableOffset;
+        uint32 StringTableSize;
+    };
+
+    /** 定长对话记录 */
+    struct FRecord
+    {
+        FStringRef DialogueID;
+        FStringRef TriggerEvent;
+        FStringRef NextDialogueID;
+        FStringRef TextCN;
+        FStringRef TextEN;
+        FStringRef AudioPath;
+        FStringRef ChoiceOptions;
+        float Duration;
+        uint8 SpeakerType;
+        uint8 Padding[3];
+    };
+
+    static_assert(sizeof(FHeader) == 36, "Dialogue bank header layout changed");
+    static_assert(sizeof(FRecord) == 64, "Dialogue bank record layout changed");
+
+    /** ID哈希(不区分大小写,与FName比较规则一致) */
+    uint32 HashID(const TCHAR* Chars, int32 Len);
+}
+
+/**
+ * @brief 运行时对话库
+ *
+ * 只读、不创建任何UObject或FText。文本按需解码到调用者提供的FString中
+ * (复用容量,稳定播放时不产生分配)。同一文件的对话库在多个组件之间共享。
+ *
+ * 使用方法：
+ * 1. 在编辑器中对 DialogueDataAsset 调用 ExportToDialogueBank() 生成 .rldb 文件
+ * 2. 运行时 FDialogueBank::FindOrLoad() 加载(优先内存映射,失败则一次性读取)
+ * 3. 在 DialogueComponent 中设置 DialogueBankPath 或调用 SetDialogueBank()
+ */
+class RUSTYLAKEORRERY_API FDialogueBank
+{
+public:
+    ~FDialogueBank();
+
+    /**
+     * @brief 将对话数据资产烘焙为二进制对话库
+     * @param Asset 对话数据资产
+     * @param OutBytes 输出的文件内容
+     * @return 是否成功
+     */
+    static bool Cook(const UDialogueDataAsset& Asset, TArray<uint8>& OutBytes);
+
+    /**
+     * @brief 从文件加载对话库
+     * @param FilePath 文件路径
+     * @param bAllowMemoryMap 是否优先尝试内存映射
+     * @return 对话库,失败返回nullptr
+     */
+    static TSharedPtr<const FDialogueBank> LoadFromFile(const FString& FilePath, bool bAllowMemoryMap = true);
+
+    /**
+     * @brief 从内存加载对话库(接管数据)
+     * @param Bytes 文件内容
+     * @return 对话库,失败返回nullptr
+     */
+    static TSharedPtr<const FDialogueBank> LoadFromMemory(TArray<uint8>&& Bytes);
+
+    /**
+     * @brief 获取已加载的对话库,未加载则加载(按路径共享,所有引用释放后卸载)
+     * @param FilePath 文件路径
+     * @return 对话库,失败返回nullptr
+     */
+    static TSharedPtr<const FDialogueBank> FindOrLoad(const FString& FilePath);
+
+    /** 条目数量 */
+    int32 Num() const { return static_cast<int32>(Header->EntryCount); }
+
+    /** 按对话ID查找,返回记录下标或INDEX_NONE */
+    int32 FindByID(FName DialogueID) const;
+
+    /** 按触发事件查找,返回第一个匹配记录的下标或INDEX_NONE */
+    int32 FindByTrigger(FName TriggerEvent) const;
+
+    /** 对话ID */
+    FName GetDialogueID(int32 Index) const;
+
+    /** 下一条对话ID */
+    FName GetNextDialogueID(int32 Index) const;
+
+    /** 持续时间 */
+    float GetDuration(int32 Index) const { return Records[Index].Duration; }
+
+    /** 说话者类型 */
+    ESpeakerType GetSpeakerType(int32 Index) const { return static_cast<ESpeakerType>(Records[Index].SpeakerType); }
+
+    /**
+     * @brief 解码对话文本到调用者的字符串(复用其容量)
+     * @param Index 记录下标
+     * @param bChinese 是否中文
+     * @param OutText 输出字符串
+     */
+    void GetText(int32 Index, bool bChinese, FString& OutText) const;
+
+    /**
+     * @brief 填充对话条目中除文本以外的字段(ID、触发事件、下一条、时长、说话者、音频、选项)
+     * @param Index 记录下标
+     * @param OutEntry 输出条目,TextCN/TextEN被清空
+     */
+    void FillEntry(int32 Index, FDialogueEntry& OutEntry) const;
+
+    /** 对话库占用的字节数 */
+    int64 GetDataSize() const { return DataSize; }
+
+    /** 是否通过内存映射加载 */
+    bool IsMemoryMapped() const { return MappedRegion.IsValid(); }
+
+private:
+    FDialogueBank() = default;
+
+    /** 校验并建立指向数据的视图 */
+    bool Initialize(const uint8* InData, int64 InSize);
+
+    /** 在哈希表中查找 */
+    int32 FindInTable(const uint32* Slots, FName Key, DialogueBankFormat::FStringRef DialogueBankFormat::FRecord::* Field) const;
+
+    /** 字符串引用是否在字符串表范围内 */
+    bool IsValidStringRef(const DialogueBankFormat::FStringRef& Ref) const;
+
+    /** 将字符串引用解码为FName */
+    FName ToName(const DialogueBankFormat::FStringRef& Ref) const;
+
+    /** 将字符串引用解码到字符串 */
+    void DecodeString(const DialogueBankFormat::FStringRef& Ref, FString& Out) const;
+
+    /** 一次性读取时持有的数据 */
+    TArray<uint8> OwnedData;
+
+    /** 内存映射句柄 */
+    TUniquePtr<IMappedFileHandle> MappedHandle;
+
+    /** 内存映射区域 */
+    TUniquePtr<IMappedFileRegion> MappedRegion;
+
+    /** 数据视图 */
+    const uint8* Data = nullptr;
+    int64 DataSize = 0;
+    const DialogueBankFormat::FHeader* Header = nullptr;
+    const DialogueBankFormat::FRecord* Records = nullptr;
+    const uint32* IDSlots = nullptr;
+    const uint32* TriggerSlots = nullptr;
+    const ANSICHAR* Strings = nullptr;
+
+    /** 已计入内存统计的字节数 */
+    int64 ReportedMemory = 0;
+};
@@ -5,8 +5,11 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "DialogueDataAsset.h"
+#include "SaveSubsystem.h"
 #include "DialogueComponent.generated.h"
 
+class FDialogueBank;
+
 /**
  * @brief 对话播放状态枚举
  */
@@ -38,16 +41,22 @@ enum class EDialogueState : uint8
  * 
  * 使用方法：
  * 1. 将此组件添加到需要对话的Actor
- * 2. 设置 DialogueDataAsset
+ * 2. 设置 DialogueDataAsset,或设置 DialogueBankPath 使用烘焙后的二进制对话库
  * 3. 调用 PlayDialogue() 或 PlayDialogueByTrigger()
+ *
+ * 设置了对话库时优先从对话库播放:不复制数据资产中的条目,也不构造FText,
+ * CurrentDialogue中的TextCN/TextEN为空,文本请通过GetFullDisplayString()获取。
  * 
  * 事件：
  * - OnDialogueStarted: 对话开始时触发
  * - OnDialogueCompleted: 对话完成时触发
- * - OnDialogueTextChanged: 对话文本更新时触发
+ * - OnDialogueRevealChanged: 逐字显示的可见字符数变化时触发(无内存分配,推荐)
+ * - OnDialogueTextChanged: 对话文本更新时触发(每次构造新FText,仅在有监听者时广播)
+ *
+ * 已完成的对话ID由 USaveSubsystem 自动存档,可用 HasCompletedDialogue 判断剧情进度。
  */
 UCLASS(ClassGroup=(Dialogue), meta=(BlueprintSpawnableComponent))
-class RUSTYLAKEORRERY_API UDialogueComponent : public UActorComponent
+class RUSTYLAKEORRERY_API UDialogueComponent : public UActorComponent, public IRLOSaveable
 {
     GENERATED_BODY()
 
@@ -56,6 +65,7 @@ public:
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
 public:
@@ -67,6 +77,14 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue Config")
     UDialogueDataAsset* DialogueDataAsset = nullptr;
 
+    /** 二进制对话库路径(相对于Content目录,如 Data/DialogueBanks/Chapter1.rldb),BeginPlay时加载 */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue Config")
+    FString DialogueBankPath;
+
+    /** 从对话库播放时是否使用中文(false则使用英文) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue Config")
+    bool bUseChineseText = true;
+
     /** 是否自动播放下一条对话 */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue Config")
     bool bAutoPlayNext = true;
@@ -99,6 +117,18 @@ public:
     UPROPERTY(BlueprintReadOnly, Category = "Dialogue State")
     float TextProgress = 0.0f;
 
+    /** 当前可见的字符(字素)数量 */
+    UPROPERTY(BlueprintReadOnly, Category = "Dialogue State")
+    int32 VisibleCharacterCount = 0;
+
+    /** 当前对话文本的字符(字素)总数 */
+    UPROPERTY(BlueprintReadOnly, Category = "Dialogue State")
+    int32 TotalCharacterCount = 0;
+
+    /** 已播放完成的对话ID(写入存档) */
+    UPROPERTY(BlueprintReadOnly, Category = "Dialogue State")
+    TSet<FName> CompletedDialogueIDs;
+
     // ========================================================================
     // 委托事件
     // ========================================================================
@@ -113,7 +143,12 @@ public:
     UPROPERTY(BlueprintAssignable, Category = "Dialogue Events")
     FOnDialogueCompleted OnDialogueCompleted;
 
-    /** 对话文本更新事件 */
+    /** 逐字显示进度事件(可见字符数变化时触发,文本通过GetFullDisplayText获取) */
+    DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnDialogueRevealChanged, int32, VisibleCharacters, int32, TotalCharacters);
+    UPROPERTY(BlueprintAssignable, Category = "Dialogue Events")
+    FOnDialogueRevealChanged OnDialogueRevealChanged;
+
+    /** 对话文本更新事件(每次广播都会构造新的FText,新代码请使用OnDialogueRevealChanged) */
     DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnDialogueTextChanged, const FText&, DisplayText, float, Progress);
     UPROPERTY(BlueprintAssignable, Category = "Dialogue Events")
     FOnDialogueTextChanged OnDialogueTextChanged;
@@ -143,6 +178,23 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Dialogue")
     bool PlayDialogueByTrigger(FName TriggerEvent);
 
+    /**
+     * @brief 加载二进制对话库(同一文件在多个组件之间共享)
+     * @param BankPath 文件路径,相对路径基于Content目录
+     * @return 是否加载成功
+     */
+    UFUNCTION(BlueprintCallable, Category = "Dialogue")
+    bool LoadDialogueBank(const FString& BankPath);
+
+    /**
+     * @brief 设置已加载的对话库(传入nullptr则回退到DialogueDataAsset)
+     * @param InDialogueBank 对话库
+     */
+    void SetDialogueBank(TSharedPtr<const FDialogueBank> InDialogueBank);
+
+    /** 当前使用的对话库 */
+    const TSharedPtr<const FDialogueBank>& GetDialogueBank() const { return DialogueBank; }
+
     /**
      * @brief 停止当前对话
      */
@@ -175,6 +227,26 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Dialogue")
     FText GetCurrentDisplayText() const;
 
+    /**
+     * @brief 获取当前对话的完整文本(对话开始时缓存;从对话库播放时首次调用才构造)
+     * @return 完整的显示文本
+     */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Dialogue")
+    FText GetFullDisplayText() const;
+
+    /**
+     * @brief 获取完整文本的字符串形式(对话开始时缓存)
+     * @return 完整的显示字符串
+     */
+    const FString& GetFullDisplayString() const { return CachedDisplayString; }
+
+    /**
+     * @brief 获取前N个字符(字素)在完整字符串中对应的长度
+     * @param CharacterCount 字符(字素)数量
+     * @return TCHAR长度,可直接用于 GetFullDisplayString().Left() 或 FStringView
+     */
+    int32 GetDisplayStringLength(int32 CharacterCount) const;
+
     /**
      * @brief 是否正在播放对话
      * @return 是否正在播放
@@ -182,13 +254,39 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Dialogue")
     bool IsPlaying() const { return CurrentState == EDialogueState::Playing; }
 
+    /**
+     * @brief 对话是否已播放完成过(包括之前的游戏进度)
+     * @param DialogueID 对话ID
+     * @return 是否已完成
+     */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Dialogue")
+    bool HasCompletedDialogue(FName DialogueID) const { return CompletedDialogueIDs.Contains(DialogueID); }
+
+    // IRLOSaveable
+    virtual void SerializeSaveRecord(FArchive& Ar) override;
+
 private:
     /** 内部播放对话实现 */
     void PlayDialogueInternal(const FDialogueEntry& Entry);
 
+    /** 播放对话库中的记录 */
+    void PlayBankDialogue(int32 RecordIndex);
+
+    /** 开始播放CurrentDialogue(文本已缓存) */
+    void StartCurrentDialogue();
+
     /** 更新文本显示 */
     void UpdateTextDisplay(float DeltaTime);
 
+    /** 缓存当前对话的完整文本并统计字素边界 */
+    void CacheDisplayText(const FText& FullText);
+
+    /** 根据CachedDisplayString统计字素边界 */
+    void CacheGraphemeBoundaries();
+
+    /** 设置可见字符数,变化时广播显示事件 */
+    void SetVisibleCharacterCount(int32 NewCount, bool bForceBroadcast = false);
+
     /** 完成当前对话 */
     void CompleteCurrentDialogue();
 
@@ -210,4 +308,25 @@ private:
 
     /** 是否在间隔中 */
     bool bInInterval = false;
+
+    /** 已显示的字符数(浮点累计,按TextDisplaySpeed推进) */
+    float RevealedCharacters = 0.0f;
+
+    /** 当前对话的完整文本(从对话库播放时按需构造) */
+    mutable FText CachedDisplayText;
+
+    /** CachedDisplayText是否与CachedDisplayString一致 */
+    mutable bool bCachedDisplayTextValid = false;
+
+    /** 当前对话的完整字符串(复用容量,避免每条对话重新分配) */
+    FString CachedDisplayString;
+
+    /** 字素边界:第i项为前i个字素在CachedDisplayString中的TCHAR长度 */
+    TArray<int32> GraphemeBoundaries;
+
+    /** 复用的字素边界迭代器 */
+    TSharedPtr<class IBreakIterator> GraphemeIterator;
+
+    /** 二进制对话库(设置后优先于DialogueDataAsset) */
+    TSharedPtr<const FDialogueBank> DialogueBank;
 };
@@ -83,6 +83,7 @@ struct FDialogueEntry
  * - 分支对话(选项)
  * - 音频播放
  * - 从CSV导入
+ * - 烘焙为二进制对话库(见 FDialogueBank)
  * 
  * 使用方法：
  * 1. 在编辑器中创建 DialogueDataAsset
@@ -105,6 +106,27 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue")
     bool bUseChinese = true;
 
+    /**
+     * @brief 根据对话ID查找对话条目(O(1),不复制)
+     * @param DialogueID 对话ID
+     * @return 对话条目指针,未找到则返回nullptr。修改DialogueEntries后指针失效
+     */
+    const FDialogueEntry* FindDialogueEntry(FName DialogueID) const;
+
+    /**
+     * @brief 根据触发事件查找对话条目(O(1),不复制)
+     * @param TriggerEvent 触发事件名称
+     * @return 第一个匹配的对话条目指针,未找到则返回nullptr
+     */
+    const FDialogueEntry* FindDialogueByTrigger(FName TriggerEvent) const;
+
+    /**
+     * @brief 重建ID/触发事件查找索引
+     * 在直接修改DialogueEntries后调用;PostLoad和ImportFromCSV会自动调用。
+     * 查询只能发现条目数变化和已索引的键失效,原地改成新的ID/触发事件后必须调用
+     */
+    void RebuildLookupIndex();
+
     /**
      * @brief 根据对话ID获取对话条目
      * @param DialogueID 对话ID
@@ -131,7 +153,11 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Dialogue")
     FText GetDisplayText(const FDialogueEntry& Entry) const;
 
+    virtual void PostLoad() override;
+
 #if WITH_EDITOR
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+
     /**
      * @brief 从CSV文件导入对话数据
      * @param CSVFilePath CSV文件路径
@@ -139,5 +165,29 @@ public:
      */
     UFUNCTION(BlueprintCallable, Category = "Dialogue|Editor")
     bool ImportFromCSV(const FString& CSVFilePath);
+
+    /**
+     * @brief 将对话数据烘焙为二进制对话库(.rldb),供DialogueComponent运行时加载
+     * @param BankFilePath 输出文件路径(通常位于 Content/Data/DialogueBanks)
+     * @return 是否导出成功
+     */
+    UFUNCTION(BlueprintCallable, Category = "Dialogue|Editor")
+    bool ExportToDialogueBank(const FString& BankFilePath) const;
 #endif
+
+private:
+    /** 建立索引(索引为缓存数据,const查询在条目数变化或命中校验失败时也会调用) */
+    void BuildLookupIndex() const;
+
+    /** 在索引中查找下标并校验,失败时重建索引后再查一次 */
+    int32 FindIndexChecked(TMap<FName, int32>& Index, FName Key, FName FDialogueEntry::* Field) const;
+
+    /** DialogueID -> DialogueEntries下标 */
+    mutable TMap<FName, int32> DialogueIDIndex;
+
+    /** TriggerEvent -> 第一个匹配条目的下标 */
+    mutable TMap<FName, int32> TriggerEventIndex;
+
+    /** 建立索引时的条目数量 */
+    mutable int32 IndexedEntryCount = INDEX_NONE;
 };
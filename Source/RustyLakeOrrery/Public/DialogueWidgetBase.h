@@ -0,0 +1,205 @@
+// DialogueWidgetBase.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "DialogueDataAsset.h"
+#include "DialogueWidgetBase.generated.h"
+
+class UDialogueComponent;
+class UButton;
+class UTextBlock;
+class UPanelWidget;
+class UInvalidationBox;
+
+/**
+ * @brief 对话选项按钮
+ *
+ * 由 UDialogueWidgetBase 创建并复用,蓝图中需要包含名为 ChoiceButton 的按钮,
+ * 可选包含名为 ChoiceText 的文本。
+ */
+UCLASS(Abstract)
+class RUSTYLAKEORRERY_API UDialogueChoiceWidget : public UUserWidget
+{
+    GENERATED_BODY()
+
+public:
+    /** 选项被点击事件 */
+    DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnChoiceClicked, int32, ChoiceIndex);
+    UPROPERTY(BlueprintAssignable, Category = "Dialogue Choice")
+    FOnChoiceClicked OnChoiceClicked;
+
+    /**
+     * @brief 设置选项内容
+     * @param InChoiceIndex 选项索引
+     * @param ChoiceLabel 选项文本
+     */
+    UFUNCTION(BlueprintCallable, Category = "Dialogue Choice")
+    void SetChoice(int32 InChoiceIndex, const FText& ChoiceLabel);
+
+    /** 选项索引 */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Dialogue Choice")
+    int32 GetChoiceIndex() const { return ChoiceIndex; }
+
+protected:
+    virtual void NativeOnInitialized() override;
+
+    /** 选项内容更新后调用,可在蓝图中播放动画 */
+    UFUNCTION(BlueprintImplementableEvent, Category = "Dialogue Choice")
+    void OnChoiceSet(int32 InChoiceIndex, const FText& ChoiceLabel);
+
+    /** 选项按钮 */
+    UPROPERTY(BlueprintReadOnly, Category = "Dialogue Choice", meta = (BindWidget))
+    UButton* ChoiceButton = nullptr;
+
+    /** 选项文本 */
+    UPROPERTY(BlueprintReadOnly, Category = "Dialogue Choice", meta = (BindWidgetOptional))
+    UTextBlock* ChoiceText = nullptr;
+
+private:
+    UFUNCTION()
+    void HandleButtonClicked();
+
+    /** 选项索引 */
+    int32 ChoiceIndex = INDEX_NONE;
+};
+
+/**
+ * @brief 对话UI基类
+ *
+ * 绑定到 UDialogueComponent 的状态,只在数据变化时更新,不使用每帧的属性绑定:
+ * - 逐字显示由 OnDialogueRevealChanged 驱动,可见字符数变化时才更新文本
+ * - 文本放在 InvalidationBox 中时,Slate缓存其绘制结果,只在文本变化时重绘
+ * - 选项按钮(ChoiceWidgetClass)按需创建,之后的选项复用已有按钮
+ *
+ * 蓝图层级:
+ * - DialogueText(必需):对话文本
+ * - SpeakerText(可选):说话者
+ * - RevealInvalidationBox(可选):包住 DialogueText 的 InvalidationBox
+ * - ChoiceContainer(可选):放置选项按钮的面板
+ *
+ * 使用方法:
+ * 1. 创建继承此类的Widget蓝图,作为 AUIManager 的 DialogueWidgetClass
+ * 2. 通过 AUIManager::ShowDialogueFor 显示并绑定对话组件
+ */
+UCLASS(Abstract)
+class RUSTYLAKEORRERY_API UDialogueWidgetBase : public UUserWidget
+{
+    GENERATED_BODY()
+
+public:
+    // ========================================================================
+    // 配置
+    // ========================================================================
+
+    /** 选项按钮Widget类 */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dialogue Widget")
+    TSubclassOf<UDialogueChoiceWidget> ChoiceWidgetClass;
+
+    // ========================================================================
+    // 公共接口
+    // ========================================================================
+
+    /**
+     * @brief 绑定对话组件(替换之前绑定的组件),并立即显示组件的当前状态
+     * @param InDialogueComponent 对话组件,为空时只解除绑定
+     */
+    UFUNCTION(BlueprintCallable, Category = "Dialogue Widget")
+    void BindToDialogueComponent(UDialogueComponent* InDialogueComponent);
+
+    /**
+     * @brief 解除与对话组件的绑定
+     */
+    UFUNCTION(BlueprintCallable, Category = "Dialogue Widget")
+    void UnbindFromDialogueComponent();
+
+    /** 当前绑定的对话组件 */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Dialogue Widget")
+    UDialogueComponent* GetDialogueComponent() const { return DialogueComponent.Get(); }
+
+protected:
+    virtual void NativeOnInitialized() override;
+    virtual void NativeDestruct() override;
+
+    // ========================================================================
+    // 蓝图事件
+    // ========================================================================
+
+    /** 新对话开始时调用 */
+    UFUNCTION(BlueprintImplementableEvent, Category = "Dialogue Widget")
+    void OnDialogueEntryStarted(const FDialogueEntry& Dialogue);
+
+    /** 可见字符数变化、文本已更新后调用 */
+    UFUNCTION(BlueprintImplementableEvent, Category = "Dialogue Widget")
+    void OnRevealUpdated(int32 VisibleCharacters, int32 TotalCharacters);
+
+    /** 对话完成时调用(有选项时在显示选项之前) */
+    UFUNCTION(BlueprintImplementableEvent, Category = "Dialogue Widget")
+    void OnDialogueEntryCompleted(const FDialogueEntry& Dialogue);
+
+    /** 选项显示后调用 */
+    UFUNCTION(BlueprintImplementableEvent, Category = "Dialogue Widget")
+    void OnChoicesShown(int32 NumChoices);
+
+    // ========================================================================
+    // 绑定的控件
+    // ========================================================================
+
+    /** 对话文本 */
+    UPROPERTY(BlueprintReadOnly, Category = "Dialogue Widget", meta = (BindWidget))
+    UTextBlock* DialogueText = nullptr;
+
+    /** 说话者 */
+    UPROPERTY(BlueprintReadOnly, Category = "Dialogue Widget", meta = (BindWidgetOptional))
+    UTextBlock* SpeakerText = nullptr;
+
+    /** 包住 DialogueText 的 InvalidationBox */
+    UPROPERTY(BlueprintReadOnly, Category = "Dialogue Widget", meta = (BindWidgetOptional))
+    UInvalidationBox* RevealInvalidationBox = nullptr;
+
+    /** 选项按钮的容器 */
+    UPROPERTY(BlueprintReadOnly, Category = "Dialogue Widget", meta = (BindWidgetOptional))
+    UPanelWidget* ChoiceContainer = nullptr;
+
+private:
+    UFUNCTION()
+    void HandleDialogueStarted(const FDialogueEntry& Dialogue);
+
+    UFUNCTION()
+    void HandleRevealChanged(int32 VisibleCharacters, int32 TotalCharacters);
+
+    UFUNCTION()
+    void HandleDialogueCompleted(const FDialogueEntry& Dialogue);
+
+    UFUNCTION()
+    void HandleWaitingForChoice(const TArray<FString>& Choices);
+
+    UFUNCTION()
+    void HandleChoiceClicked(int32 ChoiceIndex);
+
+    /** 显示前N个字符,字符数未变化时不更新 */
+    void ApplyReveal(int32 VisibleCharacters, int32 TotalCharacters);
+
+    /** 显示选项,复用已有按钮 */
+    void ShowChoices(const TArray<FString>& Choices);
+
+    /** 隐藏所有选项按钮(按钮保留以便复用) */
+    void HideChoices();
+
+    /** 绑定的对话组件 */
+    TWeakObjectPtr<UDialogueComponent> DialogueComponent;
+
+    /** 已创建的选项按钮,前 NumVisibleChoices 个正在显示 */
+    UPROPERTY(Transient)
+    TArray<UDialogueChoiceWidget*> ChoiceWidgets;
+
+    /** 正在显示的选项数 */
+    int32 NumVisibleChoices = 0;
+
+    /** 上次显示的可见字符数,新对话开始时为-1 */
+    int32 DisplayedCharacterCount = INDEX_NONE;
+
+    /** 复用的可见文本缓冲区 */
+    FString RevealBuffer;
+};
@@ -6,6 +6,7 @@
 #include "Components/ActorComponent.h"
 #include "Engine/DataAsset.h"
 #include "ItemDataAsset.h"
+#include "SaveSubsystem.h"
 #include "InteractableComponent.generated.h"
 
 /**
@@ -100,7 +101,7 @@ enum class EInteractionType : uint8
  * - 触控优先：原生支持Android触控手势
  */
 UCLASS(ClassGroup=(Interaction), meta=(BlueprintSpawnableComponent))
-class RUSTYLAKEORRERY_API UInteractableComponent : public UActorComponent
+class RUSTYLAKEORRERY_API UInteractableComponent : public UActorComponent, public IRLOSaveable
 {
     GENERATED_BODY()
 
@@ -119,7 +120,7 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Interaction Config")
     EInteractionType InteractionType = EInteractionType::Observe;
 
-    /** 是否当前可交互（可在运行时动态修改） */
+    /** 是否当前可交互（运行时请通过 SetInteractable 修改，以便写入存档） */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction Config")
     bool bIsInteractable = true;
 
@@ -335,7 +336,7 @@ public:
     void BeginRotation();
 
     /**
-     * @brief 更新旋转（由InteractionComponent每帧调用）
+     * @brief 更新旋转（由InteractionComponent在触摸移动时调用，同时检查目标角度）
      * @param DeltaRotation 旋转增量（度数）
      */
     void UpdateRotation(float DeltaRotation);
@@ -347,21 +348,45 @@ public:
 
     /**
      * @brief 开始长按计时（由InteractionComponent自动调用）
+     * @param Interactor 交互者；不为空时组件在长按期间启用Tick，计时完成后自动执行交互。
+     *                   为空时由调用者通过UpdateLongPress推进
      */
-    void BeginLongPress();
+    void BeginLongPress(AActor* Interactor = nullptr);
 
     /**
-     * @brief 更新长按计时（由InteractionComponent每帧调用）
+     * @brief 手动推进长按计时（BeginLongPress未传入Interactor时使用）
      * @param DeltaTime 时间增量
      * @return 如果长按完成返回true
      */
     bool UpdateLongPress(float DeltaTime);
 
+    /**
+     * @brief 同步外部计时的长按进度（只用于显示，不会完成长按）
+     *
+     * InteractionComponent 的触摸长按由手势识别器计时并调用 CompleteLongPress，
+     * 这里只镜像识别器的进度，保证只有一个时钟决定触发时刻。
+     * @param Progress 0-1
+     */
+    void SetLongPressProgress(float Progress);
+
+    /**
+     * @brief 完成长按并执行交互（由InteractionComponent在手势识别器报告长按时调用）
+     * @param Interactor 交互者
+     */
+    void CompleteLongPress(AActor* Interactor);
+
     /**
      * @brief 取消长按（由InteractionComponent自动调用）
      */
     void CancelLongPress();
 
+    /**
+     * @brief 获取长按进度
+     * @return 0-1，未长按时为0
+     */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Interaction")
+    float GetLongPressProgress() const;
+
     /**
      * @brief 开始聚焦（由InteractionComponent自动调用）
      */
@@ -379,6 +404,13 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Interaction")
     bool CanInteract() const { return bIsInteractable; }
 
+    /**
+     * @brief 设置是否可交互（写入存档）
+     * @param bInteractable 是否可交互
+     */
+    UFUNCTION(BlueprintCallable, Category = "Interaction")
+    void SetInteractable(bool bInteractable);
+
     /**
      * @brief 获取交互提示文本
      * @return 交互提示文本
@@ -393,8 +425,19 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Interaction")
     float GetCurrentRotationAngle() const { return CurrentRotationAngle; }
 
+    /**
+     * @brief 检查滑动是否满足距离和方向要求
+     * @param SwipeVector 滑动向量（屏幕像素）
+     * @return 是否匹配 RequiredSwipeDirection
+     */
+    bool IsSwipeDirectionValid(const FVector2D& SwipeVector) const;
+
+    // IRLOSaveable
+    virtual void SerializeSaveRecord(FArchive& Ar) override;
+
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
 private:
@@ -423,12 +466,12 @@ private:
     /** 应用高亮效果 */
     void ApplyHighlight(bool bEnable);
 
-    /** 检查滑动方向是否匹配 */
-    bool IsSwipeDirectionValid(const FVector2D& SwipeVector) const;
-
     /** 检查是否达到目标旋转角度 */
     void CheckTargetRotation();
 
+    /** 按 CurrentRotationAngle 旋转网格体 */
+    void ApplyMeshRotation();
+
     /** 缓存的网格体组件（用于高亮和旋转） */
     UPROPERTY()
     class UMeshComponent* CachedMeshComponent = nullptr;
@@ -451,6 +494,12 @@ private:
     /** 是否正在长按 */
     bool bIsLongPressing = false;
 
+    /** 长按完成后执行交互的交互者（为空表示由调用者手动推进） */
+    TWeakObjectPtr<AActor> LongPressInteractor;
+
     /** 是否已触发目标角度事件 */
     bool bTargetAngleReached = false;
+
+    /** 是否已被拾取（读取存档时据此销毁Actor） */
+    bool bPickedUp = false;
 };
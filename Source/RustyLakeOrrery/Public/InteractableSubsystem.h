@@ -0,0 +1,113 @@
+// InteractableSubsystem.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "InteractableSubsystem.generated.h"
+
+class UInteractableComponent;
+class UPrimitiveComponent;
+
+/**
+ * @brief 可交互对象注册表（世界子系统）
+ *
+ * UInteractableComponent 在 BeginPlay 时注册、EndPlay 时注销。
+ * 提供从射线命中结果到可交互组件的O(1)查找，替代热路径上的 FindComponentByClass，
+ * 并允许其他系统遍历当前世界中的所有可交互对象。
+ *
+ * 使用方法：
+ * ```cpp
+ * if (UInteractableSubsystem* Registry = UInteractableSubsystem::Get(this))
+ * {
+ *     UInteractableComponent* Interactable = Registry->FindForHit(HitResult);
+ * }
+ * ```
+ */
+UCLASS()
+class RUSTYLAKEORRERY_API UInteractableSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * @brief 获取对象所在世界的注册表
+     * @param WorldContextObject 世界上下文对象
+     * @return 注册表，世界无效时返回nullptr
+     */
+    static UInteractableSubsystem* Get(const UObject* WorldContextObject);
+
+    /**
+     * @brief 注册可交互组件（同时登记其所属Actor和Actor上的所有图元组件）
+     * @param Interactable 可交互组件
+     */
+    void RegisterInteractable(UInteractableComponent* Interactable);
+
+    /**
+     * @brief 注销可交互组件
+     * @param Interactable 可交互组件
+     */
+    void UnregisterInteractable(UInteractableComponent* Interactable);
+
+    /**
+     * @brief 根据射线命中结果查找可交互组件（先按命中的图元组件，再按Actor）
+     * @param HitResult 命中结果
+     * @return 可交互组件，未注册则返回nullptr
+     */
+    UInteractableComponent* FindForHit(const FHitResult& HitResult) const;
+
+    /**
+     * @brief 根据Actor查找可交互组件
+     * @param Actor Actor
+     * @return 可交互组件，未注册则返回nullptr
+     */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Interaction")
+    UInteractableComponent* FindForActor(const AActor* Actor) const;
+
+    /**
+     * @brief 根据图元组件查找可交互组件
+     * @param Primitive 图元组件
+     * @return 可交互组件，未注册则返回nullptr
+     */
+    UInteractableComponent* FindForPrimitive(const UPrimitiveComponent* Primitive) const;
+
+    /**
+     * @brief 获取所有已注册的可交互组件
+     * @return 可交互组件列表（顺序不固定）
+     */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Interaction")
+    const TArray<UInteractableComponent*>& GetAllInteractables() const { return Interactables; }
+
+    /**
+     * @brief 遍历所有已注册的可交互组件
+     * @param Callback 回调，参数为 UInteractableComponent*
+     */
+    template<typename FunctorType>
+    void ForEachInteractable(FunctorType&& Callback) const
+    {
+        for (UInteractableComponent* Interactable : Interactables)
+        {
+            if (Interactable)
+            {
+                Callback(Interactable);
+            }
+        }
+    }
+
+    /** 已注册的可交互组件数量 */
+    int32 Num() const { return Interactables.Num(); }
+
+    virtual void Deinitialize() override;
+
+private:
+    /** 所有已注册的可交互组件 */
+    UPROPERTY(Transient)
+    TArray<UInteractableComponent*> Interactables;
+
+    /** Actor -> 可交互组件 */
+    TMap<TObjectKey<AActor>, TWeakObjectPtr<UInteractableComponent>> ActorMap;
+
+    /** 图元组件 -> 可交互组件 */
+    TMap<TObjectKey<UPrimitiveComponent>, TWeakObjectPtr<UInteractableComponent>> PrimitiveMap;
+};
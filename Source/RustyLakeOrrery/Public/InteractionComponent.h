@@ -4,25 +4,17 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "InputCoreTypes.h"
+#include "RLOGestureRecognizer.h"
 #include "InteractionComponent.generated.h"
 
-/**
- * @brief 触控状态枚举
- */
-UENUM()
-enum class ETouchState : uint8
-{
-    None,
-    Began,
-    Moved,
-    Ended
-};
-
 /**
  * @brief 玩家交互检测组件（黑盒设计 + 触控手势识别）
  * 
  * 附加在PlayerController上，自动处理所有交互检测和触发逻辑。
- * 支持Android触控手势识别（点击、滑动、旋转、长按）。
+ * 支持Android多点触控手势识别（点击、滑动、旋转、长按、甩动、双指缩放和旋转）。
+ * 触摸事件通过PlayerController的InputComponent按事件接收（带时间戳），
+ * 由 FRLOGestureRecognizer 识别，结果与帧率无关。
  * 
  * 蓝图开发者只需：
  * 1. 将此组件添加到BP_PlayerController
@@ -79,6 +71,74 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Touch Settings")
     float RotationSensitivity = 0.5f;
 
+    /** 滑动的最大持续时间（秒，超过此时间抬起不视为滑动） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Touch Settings", meta = (ClampMin = "0.0"))
+    float SwipeMaxDuration = 1.0f;
+
+    /** 甩动的最小速度（像素/秒） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Touch Settings", meta = (ClampMin = "0.0"))
+    float FlingMinVelocity = 1200.0f;
+
+    /** 双指缩放开始报告所需的比例变化（0.05表示5%） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Touch Settings", meta = (ClampMin = "0.0"))
+    float PinchThreshold = 0.05f;
+
+    /** 双指旋转开始报告所需的角度（度） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Touch Settings", meta = (ClampMin = "0.0"))
+    float TwoFingerRotateThreshold = 5.0f;
+
+    // ========================================================================
+    // 手势事件（供星盘等需要整屏手势的系统使用）
+    // ========================================================================
+
+    /** 双指缩放事件（Scale为累计比例，ScaleDelta为相对上一次的比例） */
+    DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnPinchGesture, float, Scale, float, ScaleDelta);
+    UPROPERTY(BlueprintAssignable, Category = "Touch Events")
+    FOnPinchGesture OnPinchGesture;
+
+    /** 双指旋转事件（角度，顺时针为正） */
+    DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnTwoFingerRotateGesture, float, TotalDegrees, float, DeltaDegrees);
+    UPROPERTY(BlueprintAssignable, Category = "Touch Events")
+    FOnTwoFingerRotateGesture OnTwoFingerRotateGesture;
+
+    /** 双指手势开始/结束事件 */
+    DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnTwoFingerGestureStateChanged, bool, bActive);
+    UPROPERTY(BlueprintAssignable, Category = "Touch Events")
+    FOnTwoFingerGestureStateChanged OnTwoFingerGestureStateChanged;
+
+    /** 甩动事件（速度为像素/秒） */
+    DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnFlingGesture, FVector2D, Velocity, FVector2D, ScreenPosition);
+    UPROPERTY(BlueprintAssignable, Category = "Touch Events")
+    FOnFlingGesture OnFlingGesture;
+
+    // ========================================================================
+    // 射线检测性能配置
+    // ========================================================================
+
+    /** 是否只在指针或视角变化时执行悬停射线检测（关闭则每帧检测） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction Performance")
+    bool bEventDrivenTrace = true;
+
+    /** 指针移动超过此距离（像素）才重新检测 */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction Performance", meta = (ClampMin = "0.0", EditCondition = "bEventDrivenTrace"))
+    float PointerMoveThreshold = 2.0f;
+
+    /** 相机位置变化超过此距离（厘米）才重新检测 */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction Performance", meta = (ClampMin = "0.0", EditCondition = "bEventDrivenTrace"))
+    float ViewLocationThreshold = 0.5f;
+
+    /** 相机旋转变化超过此角度（度）才重新检测 */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction Performance", meta = (ClampMin = "0.0", EditCondition = "bEventDrivenTrace"))
+    float ViewRotationThreshold = 0.1f;
+
+    /** 指针和视角都未变化时强制重新检测的间隔（秒，用于移动中的物体，0表示不强制） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction Performance", meta = (ClampMin = "0.0", EditCondition = "bEventDrivenTrace"))
+    float MaxTraceInterval = 0.5f;
+
+    /** 每帧最多执行的射线检测次数（超出的悬停检测推迟到下一帧，0表示不限制） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction Performance", meta = (ClampMin = "0"))
+    int32 MaxTracesPerFrame = 1;
+
     // ========================================================================
     // 只读状态（供UI系统读取）
     // ========================================================================
@@ -104,6 +164,35 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Interaction")
     float GetLongPressProgress() const;
 
+    /**
+     * @brief 请求在下一帧重新执行悬停检测（场景内容变化而指针和相机未动时调用）
+     */
+    UFUNCTION(BlueprintCallable, Category = "Interaction")
+    void RequestInteractionTrace() { bTraceRequested = true; }
+
+    /** 累计执行的射线检测次数 */
+    int32 GetTotalTracesPerformed() const { return TotalTracesPerformed; }
+
+    /** 累计因指针和视角未变化而省去的射线检测次数 */
+    int32 GetTotalTracesSaved() const { return TotalTracesSaved; }
+
+    /**
+     * @brief 注入一个原始触摸事件（用于回放录制的触摸序列和自动化测试）
+     * @param Sample 触摸事件，时间戳应与 GetWorld()->GetRealTimeSeconds() 同一时基
+     */
+    void InjectTouchSample(const FRLOTouchSample& Sample);
+
+    /** 手势识别器 */
+    const FRLOGestureRecognizer& GetGestureRecognizer() const { return GestureRecognizer; }
+
+    /**
+     * @brief 设置没有视口时使用的虚拟视口尺寸（-nullrhi 下的基准测试）
+     *
+     * 设置后，PlayerController无法反投影屏幕坐标时改用镜头POV和该尺寸计算射线。
+     * @param ViewportSize 视口尺寸（像素），零向量表示关闭
+     */
+    void SetSyntheticViewportSize(const FVector2D& ViewportSize) { SyntheticViewportSize = ViewportSize; }
+
 protected:
     virtual void BeginPlay() override;
     virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
@@ -116,8 +205,25 @@ private:
     /** 执行射线检测 */
     void PerformInteractionTrace();
 
-    /** 处理触控输入 */
-    void HandleTouchInput(float DeltaTime);
+    /** 悬停检测所需的视角快照 */
+    struct FTraceViewSnapshot
+    {
+        FVector2D PointerPosition = FVector2D::ZeroVector;
+        FVector ViewLocation = FVector::ZeroVector;
+        FRotator ViewRotation = FRotator::ZeroRotator;
+        float FOV = 0.0f;
+        float OrthoWidth = 0.0f;
+        FIntPoint ViewportSize = FIntPoint::ZeroValue;
+    };
+
+    /** 采集当前指针和视角 */
+    void CaptureTraceSnapshot(FTraceViewSnapshot& OutSnapshot) const;
+
+    /** 与上次检测相比，指针或视角是否超过阈值 */
+    bool HasTraceSnapshotChanged(const FTraceViewSnapshot& Snapshot) const;
+
+    /** 本帧是否还有检测预算（有则占用一次） */
+    bool ConsumeTraceBudget();
 
     /** 更新聚焦状态 */
     void UpdateFocusedActor(AActor* NewFocusedActor);
@@ -125,27 +231,54 @@ private:
     /** 绑定输入事件 */
     void BindInputActions();
 
-    /** 处理触摸开始 */
-    void OnTouchBegan(const FVector2D& TouchLocation);
+    /** 触摸按下（InputComponent回调） */
+    void HandleTouchPressed(ETouchIndex::Type FingerIndex, FVector Location);
+
+    /** 触摸移动（InputComponent回调） */
+    void HandleTouchMoved(ETouchIndex::Type FingerIndex, FVector Location);
+
+    /** 触摸抬起（InputComponent回调） */
+    void HandleTouchReleased(ETouchIndex::Type FingerIndex, FVector Location);
 
-    /** 处理触摸移动 */
-    void OnTouchMoved(const FVector2D& TouchLocation);
+    /** 把原始触摸事件交给识别器并处理识别结果 */
+    void FeedTouchSample(const FRLOTouchSample& Sample);
 
-    /** 处理触摸结束 */
-    void OnTouchEnded(const FVector2D& TouchLocation);
+    /** 同步识别参数 */
+    void ApplyGestureConfig();
+
+    /** 处理识别器输出的手势 */
+    void DispatchGestureEvents();
+
+    /** 处理单个手势 */
+    void HandleGesture(const FRLOGestureEvent& Event);
+
+    /** 处理触摸开始（序列中第一根手指按下） */
+    void OnTouchBegan(const FVector2D& TouchLocation);
 
-    /** 识别手势类型 */
-    void RecognizeGesture();
+    /** 取消作用于对象的单指手势（第二根手指按下时） */
+    void CancelTouchInteraction();
+
+    /** 处理触摸序列结束 */
+    void OnTouchEnded();
 
     /** 执行点击交互 */
     void ExecuteTapInteraction();
 
     /** 执行滑动交互 */
-    void ExecuteSwipeInteraction();
+    void ExecuteSwipeInteraction(const FVector2D& SwipeVector);
 
     /** 从屏幕坐标执行射线检测 */
     bool TraceFromScreenPosition(const FVector2D& ScreenPosition, FHitResult& OutHitResult);
 
+    /** 将屏幕坐标反投影为世界射线（没有视口时使用虚拟视口） */
+    bool DeprojectScreenPosition(const FVector2D& ScreenPosition, FVector& OutWorldLocation, FVector& OutWorldDirection) const;
+
+    /** 查找命中结果对应的可交互组件（优先使用注册表） */
+    class UInteractableComponent* FindInteractable(const FHitResult& HitResult) const;
+
+    /** 查找Actor上的可交互组件（优先使用注册表） */
+    class UInteractableComponent* FindInteractable(AActor* Actor) const;
+
     /** 当前聚焦的Actor */
     UPROPERTY()
     AActor* CurrentFocusedActor = nullptr;
@@ -158,33 +291,53 @@ private:
     UPROPERTY()
     class APlayerController* CachedPlayerController = nullptr;
 
+    /** 缓存的可交互对象注册表 */
+    UPROPERTY()
+    class UInteractableSubsystem* InteractableRegistry = nullptr;
+
     /** 输入是否已绑定 */
     bool bInputBound = false;
 
     // ========================================================================
-    // 触控手势状态
+    // 射线检测状态
     // ========================================================================
 
-    /** 当前触控状态 */
-    ETouchState CurrentTouchState = ETouchState::None;
+    /** 上次悬停检测时的指针和视角 */
+    FTraceViewSnapshot LastTraceSnapshot;
+
+    /** 是否已有有效的检测快照 */
+    bool bHasTraceSnapshot = false;
 
-    /** 触摸开始位置 */
-    FVector2D TouchStartPosition = FVector2D::ZeroVector;
+    /** 是否请求了重新检测（外部请求、触摸结束或预算不足推迟） */
+    bool bTraceRequested = true;
 
-    /** 当前触摸位置 */
-    FVector2D CurrentTouchPosition = FVector2D::ZeroVector;
+    /** 上次悬停检测的时间 */
+    float LastHoverTraceTime = 0.0f;
 
-    /** 触摸开始时间 */
-    float TouchStartTime = 0.0f;
+    /** 预算所属的帧号 */
+    uint64 TraceBudgetFrame = 0;
 
-    /** 触摸持续时间 */
-    float TouchDuration = 0.0f;
+    /** 本帧已执行的检测次数 */
+    int32 TracesThisFrame = 0;
+
+    /** 累计执行的检测次数 */
+    int32 TotalTracesPerformed = 0;
+
+    /** 累计省去的检测次数 */
+    int32 TotalTracesSaved = 0;
+
+    /** 没有视口时使用的虚拟视口尺寸 */
+    FVector2D SyntheticViewportSize = FVector2D::ZeroVector;
+
+    // ========================================================================
+    // 触控手势状态
+    // ========================================================================
 
-    /** 触摸移动的总距离 */
-    float TouchTotalMovement = 0.0f;
+    /** 手势识别器 */
+    FRLOGestureRecognizer GestureRecognizer;
 
-    /** 上一帧的触摸位置（用于计算旋转） */
-    FVector2D LastTouchPosition = FVector2D::ZeroVector;
+    /** 识别结果缓冲（复用容量） */
+    TArray<FRLOGestureEvent> PendingGestureEvents;
 
     /** 是否正在处理旋转手势 */
     bool bIsRotating = false;
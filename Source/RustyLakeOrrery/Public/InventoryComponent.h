@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "ItemDataAsset.h"
+#include "SaveSubsystem.h"
 #include "InventoryComponent.generated.h"
 
 /**
@@ -52,6 +53,66 @@ struct FInventorySlot
 	}
 };
 
+/**
+ * @brief 单个物品的数量变化
+ */
+USTRUCT(BlueprintType)
+struct FInventoryItemChange
+{
+	GENERATED_BODY()
+
+	/** 物品数据资产 */
+	UPROPERTY(BlueprintReadOnly, Category = "Inventory")
+	UItemDataAsset* ItemData = nullptr;
+	
+	/** 变化前的数量（0表示新增） */
+	UPROPERTY(BlueprintReadOnly, Category = "Inventory")
+	int32 OldQuantity = 0;
+	
+	/** 变化后的数量（0表示已移除） */
+	UPROPERTY(BlueprintReadOnly, Category = "Inventory")
+	int32 NewQuantity = 0;
+	
+	/** 当前所在槽位（已移除时为-1） */
+	UPROPERTY(BlueprintReadOnly, Category = "Inventory")
+	int32 SlotIndex = INDEX_NONE;
+};
+
+/**
+ * @brief 合并后的背包变化
+ * 
+ * 同一帧内的所有修改合并为一个变化，UI只需更新列出的物品和发生移动的槽位。
+ */
+USTRUCT(BlueprintType)
+struct FInventoryDelta
+{
+	GENERATED_BODY()
+
+	/** 数量发生变化的物品（新增、移除、堆叠数量变化） */
+	UPROPERTY(BlueprintReadOnly, Category = "Inventory")
+	TArray<FInventoryItemChange> ChangedItems;
+	
+	/** 从此槽位开始的所有槽位内容可能已移动（移除、交换、排序），-1表示没有槽位移动 */
+	UPROPERTY(BlueprintReadOnly, Category = "Inventory")
+	int32 FirstMovedSlot = INDEX_NONE;
+	
+	/** 是否由读档恢复引起（恢复的物品不是拾取，不应弹出获得提示） */
+	UPROPERTY(BlueprintReadOnly, Category = "Inventory")
+	bool bRestored = false;
+	
+	/** 是否没有任何变化 */
+	bool IsEmpty() const
+	{
+		return ChangedItems.Num() == 0 && FirstMovedSlot == INDEX_NONE;
+	}
+	
+	/** 物品变化是否为拾取（新获得，读档恢复不算） */
+	bool IsPickup(const FInventoryItemChange& Change) const
+	{
+		return !bRestored && Change.OldQuantity == 0 && Change.NewQuantity > 0;
+	}
+};
+
 /**
  * @brief 背包组件类
  * 
@@ -60,14 +121,16 @@ struct FInventorySlot
  * 设计原则：
  * - 高度集成的黑盒组件
  * - 自动处理物品堆叠
- * - 自动触发UI更新事件
- * - 为SaveSystem预留序列化接口
+ * - 自动触发UI更新事件（同一帧内的修改合并为一次OnInventoryChanged）
+ * - 支持事务：多个修改原子地提交或回滚
+ * - 物品和ItemID到槽位的哈希索引，HasItem等查询为O(1)
+ * - 物品和数量由 USaveSubsystem 自动存档（固定的键，每个游戏只有一个玩家背包）
  * 
  * 使用方法：
  * 1. 将此组件添加到PlayerController蓝图
  * 2. 配置背包容量（可选）
  * 3. 使用AddItem/RemoveItem/HasItem等函数管理物品
- * 4. 监听OnInventoryUpdated事件刷新UI
+ * 4. 监听OnInventoryChanged事件增量刷新UI
  * 
  * 示例：
  * ```cpp
@@ -77,10 +140,19 @@ struct FInventorySlot
  * {
  *     Inventory->AddItem(PickupItemData);
  * }
+ * 
+ * // 谜题奖励多个物品（全部成功才生效，UI只刷新一次）
+ * {
+ *     FScopedInventoryTransaction Transaction(Inventory);
+ *     if (!Inventory->AddItem(RewardA) || !Inventory->AddItem(RewardB))
+ *     {
+ *         Transaction.Cancel();
+ *     }
+ * }
  * ```
  */
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
-class RUSTYLAKEORRERY_API UInventoryComponent : public UActorComponent
+class RUSTYLAKEORRERY_API UInventoryComponent : public UActorComponent, public IRLOSaveable
 {
 	GENERATED_BODY()
 
@@ -93,8 +165,13 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
+	// IRLOSaveable
+	virtual FString GetSaveKey() const override { return TEXT("Player.Inventory"); }
+	virtual void SerializeSaveRecord(FArchive& Ar) override;
+	
 	// ========================================================================
 	// 配置属性
 	// ========================================================================
@@ -128,9 +205,15 @@ public:
 	// ========================================================================
 	
 private:
-	/** 背包物品槽数组 */
+	/** 背包物品槽数组（保持顺序，供UI显示） */
 	UPROPERTY(VisibleAnywhere, Category = "Inventory")
 	TArray<FInventorySlot> InventorySlots;
+	
+	/** 物品 -> 槽位索引（与InventorySlots同步维护） */
+	TMap<UItemDataAsset*, int32> ItemSlotIndices;
+	
+	/** ItemID -> 槽位索引（ItemID重复时指向第一个槽位） */
+	TMap<FName, int32> ItemIDSlotIndices;
 
 public:
 	// ========================================================================
@@ -250,21 +333,62 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Inventory")
 	void SortInventory(bool bSortByType = true);
 	
+	/**
+	 * @brief 一次添加多个物品（在一个事务中执行）
+	 * @param Items 要添加的物品和数量
+	 * @param bAllOrNothing 为true时任一物品添加失败则全部回滚
+	 * @return 是否全部添加成功
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	bool AddItems(const TArray<FInventorySlot>& Items, bool bAllOrNothing = true);
+	
+	// ========================================================================
+	// 事务
+	// ========================================================================
+	
+	/**
+	 * @brief 开始事务（可嵌套）
+	 * 
+	 * 事务期间的修改立即生效，但物品事件和音效推迟到最外层事务提交时触发，
+	 * 回滚时恢复到事务开始前的状态且不触发任何事件。建议使用 FScopedInventoryTransaction。
+	 */
+	void BeginTransaction();
+	
+	/**
+	 * @brief 结束事务
+	 * @param bCommit 是否提交；任一层事务回滚时，最外层结束时整体回滚
+	 */
+	void EndTransaction(bool bCommit = true);
+	
+	/** 是否在事务中 */
+	bool IsInTransaction() const { return TransactionDepth > 0; }
+	
+	/**
+	 * @brief 立即广播尚未广播的背包变化（通常由组件在下一帧自动调用）
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inventory")
+	void FlushInventoryChanges();
+	
 	// ========================================================================
 	// 事件委托
 	// ========================================================================
 	
-	/** 当背包内容更新时广播（添加/移除/使用物品） */
+	/** 当背包内容更新时广播（同一帧内的修改只广播一次） */
 	DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnInventoryUpdated);
 	UPROPERTY(BlueprintAssignable, Category = "Inventory Events")
 	FOnInventoryUpdated OnInventoryUpdated;
 	
-	/** 当添加物品时广播 */
+	/** 当背包内容更新时广播合并后的变化（与OnInventoryUpdated同时广播） */
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnInventoryChanged, const FInventoryDelta&, Delta);
+	UPROPERTY(BlueprintAssignable, Category = "Inventory Events")
+	FOnInventoryChanged OnInventoryChanged;
+	
+	/** 当添加物品时广播（事务中的添加在提交时广播） */
 	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnItemAdded, UItemDataAsset*, ItemData, int32, Quantity);
 	UPROPERTY(BlueprintAssignable, Category = "Inventory Events")
 	FOnItemAdded OnItemAdded;
 	
-	/** 当移除物品时广播 */
+	/** 当移除物品时广播（事务中的移除在提交时广播） */
 	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnItemRemoved, UItemDataAsset*, ItemData, int32, Quantity);
 	UPROPERTY(BlueprintAssignable, Category = "Inventory Events")
 	FOnItemRemoved OnItemRemoved;
@@ -292,27 +416,161 @@ public:
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Debug")
 	void PrintInventoryToLog() const;
+	
+	/**
+	 * @brief 校验槽位索引与物品槽数组是否一致（调试用）
+	 * @return 是否一致，不一致时输出错误日志
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Debug")
+	bool VerifySlotIndices() const;
 
 private:
+	/** 自动化测试读取尚未广播的变化 */
+	friend struct FRLOInventoryComponentTestAccess;
+	
 	// ========================================================================
 	// 内部辅助函数
 	// ========================================================================
 	
 	/**
-	 * @brief 查找物品槽索引
+	 * @brief 查找物品槽索引（O(1)）
 	 * @param ItemData 要查找的物品数据
 	 * @return 槽位索引（如果没有则返回-1）
 	 */
 	int32 FindSlotIndex(UItemDataAsset* ItemData) const;
 	
 	/**
-	 * @brief 播放物品音效
+	 * @brief 更新从指定位置开始的所有槽位的索引（槽位增删、交换、排序后调用）
+	 * @param FirstIndex 第一个位置发生变化的槽位
+	 */
+	void UpdateSlotIndices(int32 FirstIndex);
+	
+	/**
+	 * @brief 移除槽位并更新索引（保持其余槽位顺序）
+	 * @param SlotIndex 槽位索引
+	 */
+	void RemoveSlotAt(int32 SlotIndex);
+	
+	/**
+	 * @brief 播放物品音效（事务中推迟到提交时，未加载时异步加载后播放）
 	 * @param Sound 要播放的音效
 	 */
-	void PlayItemSound(USoundBase* Sound);
+	void PlayItemSound(const TSoftObjectPtr<USoundBase>& Sound);
+	
+	/**
+	 * @brief 记录物品数量即将变化（记录本帧第一次变化前的数量）
+	 * @param ItemData 物品数据
+	 */
+	void RecordItemChange(UItemDataAsset* ItemData);
 	
 	/**
-	 * @brief 广播背包更新事件
+	 * @brief 记录槽位移动
+	 * @param FirstIndex 第一个发生移动的槽位
+	 */
+	void RecordSlotsMoved(int32 FirstIndex);
+	
+	/**
+	 * @brief 取出本帧记录的变化并清空记录
+	 * @return 变化（没有净变化时为空）
+	 */
+	FInventoryDelta ConsumePendingChanges();
+	
+	/**
+	 * @brief 广播物品添加/移除事件（事务中推迟到提交时）
+	 * @param ItemData 物品数据
+	 * @param Quantity 数量
+	 * @param bAdded 是否为添加
+	 */
+	void BroadcastItemEvent(UItemDataAsset* ItemData, int32 Quantity, bool bAdded);
+	
+	/**
+	 * @brief 广播背包更新事件（事务中或同一帧内合并，下一帧统一广播）
 	 */
 	void BroadcastInventoryUpdated();
+	
+	// ========================================================================
+	// 变化记录和事务状态
+	// ========================================================================
+	
+	/** 推迟到事务提交时广播的物品事件 */
+	struct FPendingItemEvent
+	{
+		UItemDataAsset* ItemData;
+		int32 Quantity;
+		bool bAdded;
+	};
+	
+	/** 本帧变化的物品 -> 变化前的数量 */
+	TMap<TWeakObjectPtr<UItemDataAsset>, int32> PendingOldQuantities;
+	
+	/** 本帧第一个发生移动的槽位 */
+	int32 PendingFirstMovedSlot = INDEX_NONE;
+	
+	/** 本帧是否从存档恢复过 */
+	bool bPendingRestored = false;
+	
+	/** 是否已安排下一帧广播 */
+	bool bFlushScheduled = false;
+	
+	/** 事务嵌套深度 */
+	int32 TransactionDepth = 0;
+	
+	/** 事务是否需要回滚 */
+	bool bTransactionCancelled = false;
+	
+	/** 事务开始前的物品槽 */
+	TArray<FInventorySlot> TransactionSlots;
+	
+	/** 事务开始前的变化记录 */
+	TMap<TWeakObjectPtr<UItemDataAsset>, int32> TransactionOldQuantities;
+	int32 TransactionFirstMovedSlot = INDEX_NONE;
+	bool bTransactionRestored = false;
+	
+	/** 事务中推迟的物品事件 */
+	TArray<FPendingItemEvent> TransactionItemEvents;
+	
+	/** 事务中推迟的音效（只播放第一个） */
+	TSoftObjectPtr<USoundBase> TransactionSound;
+	
+	/** 事务开始前的音效加载句柄（事务期间移出背包的物品音效保持加载，回滚时恢复） */
+	TMap<TWeakObjectPtr<UItemDataAsset>, TSharedPtr<FStreamableHandle>> TransactionSoundHandles;
+	
+	/** 背包中物品的音效加载句柄（物品移出背包时释放） */
+	TMap<TWeakObjectPtr<UItemDataAsset>, TSharedPtr<FStreamableHandle>> ItemSoundHandles;
+};
+
+/**
+ * @brief 背包事务作用域
+ * 
+ * 构造时开始事务，析构时提交；调用 Cancel() 后析构时回滚。
+ */
+class RUSTYLAKEORRERY_API FScopedInventoryTransaction
+{
+public:
+	explicit FScopedInventoryTransaction(UInventoryComponent* InInventory)
+		: Inventory(InInventory)
+	{
+		if (Inventory)
+		{
+			Inventory->BeginTransaction();
+		}
+	}
+	
+	~FScopedInventoryTransaction()
+	{
+		if (Inventory)
+		{
+			Inventory->EndTransaction(!bCancelled);
+		}
+	}
+	
+	/** 回滚此事务中的所有修改 */
+	void Cancel() { bCancelled = true; }
+	
+private:
+	UInventoryComponent* Inventory;
+	bool bCancelled = false;
+	
+	FScopedInventoryTransaction(const FScopedInventoryTransaction&) = delete;
+	FScopedInventoryTransaction& operator=(const FScopedInventoryTransaction&) = delete;
 };
@@ -0,0 +1,199 @@
+// InventoryWidgetBase.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "Blueprint/IUserObjectListEntry.h"
+#include "Engine/StreamableManager.h"
+#include "InventoryComponent.h"
+#include "InventoryWidgetBase.generated.h"
+
+class UItemDataAsset;
+class UListView;
+class UImage;
+class UTextBlock;
+class UTexture2D;
+
+/**
+ * @brief 背包视图中的一项(列表视图的数据对象)
+ *
+ * 按物品复用:同一物品在背包中期间始终对应同一个对象,数量变化时只更新该对象。
+ */
+UCLASS(BlueprintType)
+class RUSTYLAKEORRERY_API UInventoryListItem : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    /** 物品数据资产 */
+    UPROPERTY(BlueprintReadOnly, Category = "Inventory View")
+    UItemDataAsset* ItemData = nullptr;
+
+    /** 数量 */
+    UPROPERTY(BlueprintReadOnly, Category = "Inventory View")
+    int32 Quantity = 0;
+
+    /** 所在槽位 */
+    UPROPERTY(BlueprintReadOnly, Category = "Inventory View")
+    int32 SlotIndex = INDEX_NONE;
+};
+
+/**
+ * @brief 背包视图的条目Widget
+ *
+ * 由列表视图创建并在滚动时复用。图标只为正在显示的条目异步加载,
+ * 条目被回收时释放加载句柄。
+ *
+ * 蓝图层级:
+ * - IconImage(必需):物品图标
+ * - QuantityText(可选):数量,为1时隐藏
+ * - NameText(可选):物品名称
+ */
+UCLASS(Abstract)
+class RUSTYLAKEORRERY_API UInventoryEntryWidget : public UUserWidget, public IUserObjectListEntry
+{
+    GENERATED_BODY()
+
+public:
+    /** 图标加载完成前显示的图标(可为空) */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Inventory View")
+    UTexture2D* PlaceholderIcon = nullptr;
+
+    /**
+     * @brief 按当前数据对象刷新显示(数量变化时由背包视图调用)
+     */
+    UFUNCTION(BlueprintCallable, Category = "Inventory View")
+    void RefreshEntry();
+
+    /** 当前显示的数据对象 */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Inventory View")
+    UInventoryListItem* GetInventoryItem() const { return ListItem; }
+
+protected:
+    // IUserObjectListEntry
+    virtual void NativeOnListItemObjectSet(UObject* ListItemObject) override;
+    virtual void NativeOnEntryReleased() override;
+
+    /** 显示内容更新后调用,可在蓝图中添加高亮等效果 */
+    UFUNCTION(BlueprintImplementableEvent, Category = "Inventory View")
+    void OnEntryRefreshed(UInventoryListItem* Item);
+
+    /** 物品图标 */
+    UPROPERTY(BlueprintReadOnly, Category = "Inventory View", meta = (BindWidget))
+    UImage* IconImage = nullptr;
+
+    /** 数量 */
+    UPROPERTY(BlueprintReadOnly, Category = "Inventory View", meta = (BindWidgetOptional))
+    UTextBlock* QuantityText = nullptr;
+
+    /** 物品名称 */
+    UPROPERTY(BlueprintReadOnly, Category = "Inventory View", meta = (BindWidgetOptional))
+    UTextBlock* NameText = nullptr;
+
+private:
+    /** 显示图标,未加载时异步加载 */
+    void RequestIcon();
+
+    /** 释放图标加载句柄 */
+    void ReleaseIconHandle();
+
+    /** 当前显示的数据对象 */
+    UPROPERTY(Transient)
+    UInventoryListItem* ListItem = nullptr;
+
+    /** 图标所属的物品(条目被复用后忽略旧物品的加载回调) */
+    UPROPERTY(Transient)
+    UItemDataAsset* IconItem = nullptr;
+
+    /** 图标加载句柄 */
+    TSharedPtr<FStreamableHandle> IconHandle;
+};
+
+/**
+ * @brief 背包视图基类
+ *
+ * 使用列表视图(ListView 或 TileView)显示背包,只为可见的物品创建条目Widget并在滚动时复用。
+ * 绑定背包后监听 OnInventoryChanged,按物品增量更新:
+ * - 只有数量变化时,只刷新该物品正在显示的条目
+ * - 物品增减或槽位移动时,从第一个变化的槽位开始更新列表顺序
+ * 背包有上百个收藏品时,打开背包和每次变化的开销都与可见条目数相关,而不是物品总数。
+ *
+ * 蓝图层级:
+ * - ItemListView(必需):ListView 或 TileView,EntryWidgetClass 继承 UInventoryEntryWidget
+ *
+ * 使用方法:
+ * 1. 创建继承此类的Widget蓝图,作为 AUIManager 的 InventoryWidgetClass
+ * 2. AUIManager 显示背包时自动绑定玩家背包,隐藏时解除绑定
+ */
+UCLASS(Abstract)
+class RUSTYLAKEORRERY_API UInventoryWidgetBase : public UUserWidget
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * @brief 绑定背包并完整刷新一次
+     * @param InInventory 背包组件,为空时只解除绑定
+     */
+    UFUNCTION(BlueprintCallable, Category = "Inventory View")
+    void BindToInventory(UInventoryComponent* InInventory);
+
+    /**
+     * @brief 解除与背包的绑定(保留数据对象,重新绑定同一背包时复用)
+     */
+    UFUNCTION(BlueprintCallable, Category = "Inventory View")
+    void UnbindFromInventory();
+
+    /**
+     * @brief 按背包的当前内容完整刷新
+     */
+    UFUNCTION(BlueprintCallable, Category = "Inventory View")
+    void RebuildFromInventory();
+
+    /**
+     * @brief 按背包变化增量刷新
+     * @param Delta 合并后的背包变化
+     */
+    UFUNCTION(BlueprintCallable, Category = "Inventory View")
+    void ApplyInventoryDelta(const FInventoryDelta& Delta);
+
+    /** 当前绑定的背包 */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Inventory View")
+    UInventoryComponent* GetInventory() const { return Inventory.Get(); }
+
+protected:
+    virtual void NativeDestruct() override;
+
+    /** 列表内容(顺序或物品)变化后调用 */
+    UFUNCTION(BlueprintImplementableEvent, Category = "Inventory View")
+    void OnInventoryViewUpdated(int32 NumItems);
+
+    /** 物品列表视图 */
+    UPROPERTY(BlueprintReadOnly, Category = "Inventory View", meta = (BindWidget))
+    UListView* ItemListView = nullptr;
+
+private:
+    /** 获取物品的数据对象,没有时创建 */
+    UInventoryListItem* FindOrAddListItem(UItemDataAsset* ItemData);
+
+    /**
+     * @brief 从指定槽位开始按背包顺序重排列表
+     * @param FirstSlot 第一个需要更新的槽位
+     */
+    void SyncListOrder(int32 FirstSlot);
+
+    /** 刷新物品正在显示的条目(不可见时什么都不做) */
+    void RefreshVisibleEntry(UInventoryListItem* Item);
+
+    /** 绑定的背包 */
+    TWeakObjectPtr<UInventoryComponent> Inventory;
+
+    /** 按背包槽位顺序排列的数据对象 */
+    UPROPERTY(Transient)
+    TArray<UInventoryListItem*> ListItems;
+
+    /** 物品 -> 数据对象 */
+    UPROPERTY(Transient)
+    TMap<UItemDataAsset*, UInventoryListItem*> ItemsByData;
+};
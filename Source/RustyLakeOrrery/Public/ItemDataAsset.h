@@ -4,8 +4,13 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DataAsset.h"
+#include "Engine/StreamableManager.h"
 #include "ItemDataAsset.generated.h"
 
+class UTexture2D;
+class UStaticMesh;
+class USoundBase;
+
 /**
  * @brief 物品类型枚举
  * 
@@ -30,12 +35,39 @@ enum class EItemType : uint8
 	Document UMETA(DisplayName = "Document")
 };
 
+/**
+ * @brief 物品引用的资源分组（用于按需异步加载）
+ */
+enum class EItemAssetGroup : uint8
+{
+	None = 0,
+	
+	/** 图标和缩略图（背包UI） */
+	Icons = 1 << 0,
+	
+	/** 3D模型 */
+	Mesh = 1 << 1,
+	
+	/** 拾取、使用、丢弃音效 */
+	Sounds = 1 << 2,
+	
+	/** 文档插图 */
+	Document = 1 << 3,
+	
+	All = Icons | Mesh | Sounds | Document
+};
+ENUM_CLASS_FLAGS(EItemAssetGroup);
+
 /**
  * @brief 物品数据资产类
  * 
  * 定义游戏中每个物品的静态数据。
  * 这是一个纯数据类，不包含运行时逻辑。
  * 
+ * 图标、模型和音效均为软引用，加载物品数据时不会加载这些资源。
+ * 使用前通过 PreloadAssets()/PreloadAssetsForItems() 异步加载，
+ * 加载完成后用 ItemIcon.Get() 等获取（未加载时返回nullptr）。
+ * 
  * 使用方法：
  * 1. 在Content Browser中创建此类的Data Asset
  * 2. 配置物品属性（名称、描述、图标等）
@@ -72,21 +104,25 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Basic")
 	EItemType ItemType = EItemType::Key;
 	
+	/** 所属章节（0表示未分配，从DT_Items_Chapter*.csv导入时自动设置，用于内存统计） */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Basic", meta = (ClampMin = "0"))
+	int32 Chapter = 0;
+	
 	// ========================================================================
 	// 视觉资源
 	// ========================================================================
 	
 	/** 物品图标（用于UI显示） */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Visual")
-	UTexture2D* ItemIcon = nullptr;
+	TSoftObjectPtr<UTexture2D> ItemIcon;
 	
 	/** 物品3D模型（可选，用于场景中显示） */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Visual")
-	UStaticMesh* ItemMesh = nullptr;
+	TSoftObjectPtr<UStaticMesh> ItemMesh;
 	
 	/** 物品缩略图（用于背包详情显示） */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Visual")
-	UTexture2D* ItemThumbnail = nullptr;
+	TSoftObjectPtr<UTexture2D> ItemThumbnail;
 	
 	// ========================================================================
 	// 游戏逻辑属性
@@ -118,15 +154,15 @@ public:
 	
 	/** 拾取时播放的音效 */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Audio")
-	USoundBase* PickupSound = nullptr;
+	TSoftObjectPtr<USoundBase> PickupSound;
 	
 	/** 使用时播放的音效 */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Audio")
-	USoundBase* UseSound = nullptr;
+	TSoftObjectPtr<USoundBase> UseSound;
 	
 	/** 丢弃时播放的音效 */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Audio")
-	USoundBase* DropSound = nullptr;
+	TSoftObjectPtr<USoundBase> DropSound;
 	
 	// ========================================================================
 	// 文档类型专用属性
@@ -138,7 +174,7 @@ public:
 	
 	/** 文档图片（可选，用于显示插图） */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Document", meta = (EditCondition = "ItemType == EItemType::Document", EditConditionHides))
-	UTexture2D* DocumentImage = nullptr;
+	TSoftObjectPtr<UTexture2D> DocumentImage;
 	
 	// ========================================================================
 	// 调试和开发
@@ -173,8 +209,68 @@ public:
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Item")
 	FText GetItemTypeName() const;
+	
+	// ========================================================================
+	// 资源加载
+	// ========================================================================
+	
+	/**
+	 * @brief 获取指定分组引用的资源路径
+	 * @param Groups 资源分组
+	 * @param OutPaths 资源路径追加到此数组（跳过未设置的引用）
+	 */
+	void GetAssetPaths(EItemAssetGroup Groups, TArray<FSoftObjectPath>& OutPaths) const;
+	
+	/**
+	 * @brief 指定分组的资源是否都已加载
+	 * @param Groups 资源分组
+	 * @return 是否都已加载（没有引用任何资源时也返回true）
+	 */
+	bool AreAssetsLoaded(EItemAssetGroup Groups) const;
+	
+	/**
+	 * @brief 异步加载指定分组的资源
+	 * 
+	 * 资源在返回的句柄释放之前保持加载。没有引用任何资源时直接调用回调并返回nullptr。
+	 * @param Groups 资源分组
+	 * @param OnLoaded 加载完成回调
+	 * @param Priority 加载优先级
+	 * @return 加载句柄
+	 */
+	TSharedPtr<FStreamableHandle> PreloadAssets(EItemAssetGroup Groups, FStreamableDelegate OnLoaded = FStreamableDelegate(), TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority) const;
+	
+	/**
+	 * @brief 一次异步加载多个物品的资源（合并为一个加载请求）
+	 * @param Items 物品列表
+	 * @param Groups 资源分组
+	 * @param OnLoaded 加载完成回调
+	 * @param Priority 加载优先级
+	 * @return 加载句柄，没有引用任何资源时直接调用回调并返回nullptr
+	 */
+	static TSharedPtr<FStreamableHandle> PreloadAssetsForItems(TArrayView<UItemDataAsset* const> Items, EItemAssetGroup Groups, FStreamableDelegate OnLoaded = FStreamableDelegate(), TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority);
+	
+	/**
+	 * @brief 输出每章物品资源的内存统计（已加载 / 按需加载节省的内存）
+	 * 
+	 * 资源大小在资源加载时记录；尚未加载过的资源计为"未测量"，
+	 * bMeasureUnloaded为true时同步加载它们以测量大小（仅用于开发）。
+	 * 控制台命令：RLO.Items.MemoryReport [measure]
+	 * @param bMeasureUnloaded 是否同步加载未加载的资源来测量
+	 */
+	static void ReportAssetMemory(bool bMeasureUnloaded = false);
 
 #if WITH_EDITOR
+	/**
+	 * @brief 从物品CSV表(DT_Items_Chapter*.csv)导入此物品的数据
+	 * 
+	 * 按ItemID查找对应行(ItemID为空时从资产名称生成),按表头名称映射列,兼容各章节的表结构。
+	 * @param CSVFilePath CSV文件路径
+	 * @param bUseChinese 名称和描述使用中文列(否则使用英文列)
+	 * @return 是否找到并导入
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Item|Editor")
+	bool ImportFromCSV(const FString& CSVFilePath, bool bUseChinese = true);
+
 	/**
 	 * @brief 编辑器中的属性变更回调
 	 * 用于验证数据完整性
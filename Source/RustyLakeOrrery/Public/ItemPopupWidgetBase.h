@@ -0,0 +1,74 @@
+// ItemPopupWidgetBase.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "Engine/StreamableManager.h"
+#include "ItemPopupWidgetBase.generated.h"
+
+class UItemDataAsset;
+class UImage;
+class UTextBlock;
+class UTexture2D;
+
+/**
+ * @brief 获得物品弹窗基类
+ *
+ * AUIManager 从池中取出弹窗后、显示之前调用 SetItem,新建的弹窗在加入视口之前设置。
+ * 图标未加载时先显示占位图标并异步加载,弹窗被复用或销毁时释放加载句柄。
+ *
+ * 蓝图层级:
+ * - NameText(可选):物品名称
+ * - IconImage(可选):物品图标
+ */
+UCLASS(Abstract)
+class RUSTYLAKEORRERY_API UItemPopupWidgetBase : public UUserWidget
+{
+    GENERATED_BODY()
+
+public:
+    /** 图标加载完成前显示的图标(可为空) */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Popup")
+    UTexture2D* PlaceholderIcon = nullptr;
+
+    /**
+     * @brief 设置弹窗显示的物品
+     * @param InItem 获得的物品
+     */
+    UFUNCTION(BlueprintCallable, Category = "Item Popup")
+    void SetItem(UItemDataAsset* InItem);
+
+    /** 当前显示的物品 */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Item Popup")
+    UItemDataAsset* GetItem() const { return Item; }
+
+protected:
+    virtual void NativeDestruct() override;
+
+    /** 物品设置后调用,可在蓝图中播放出现动画等(弹窗关闭放回池中时物品为空) */
+    UFUNCTION(BlueprintImplementableEvent, Category = "Item Popup")
+    void OnItemSet(UItemDataAsset* NewItem);
+
+    /** 物品名称 */
+    UPROPERTY(BlueprintReadOnly, Category = "Item Popup", meta = (BindWidgetOptional))
+    UTextBlock* NameText = nullptr;
+
+    /** 物品图标 */
+    UPROPERTY(BlueprintReadOnly, Category = "Item Popup", meta = (BindWidgetOptional))
+    UImage* IconImage = nullptr;
+
+private:
+    /** 显示图标,未加载时异步加载 */
+    void RequestIcon();
+
+    /** 释放图标加载句柄 */
+    void ReleaseIconHandle();
+
+    /** 当前显示的物品 */
+    UPROPERTY(Transient)
+    UItemDataAsset* Item = nullptr;
+
+    /** 图标加载句柄 */
+    TSharedPtr<FStreamableHandle> IconHandle;
+};
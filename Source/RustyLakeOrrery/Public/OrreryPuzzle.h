@@ -0,0 +1,257 @@
+// OrreryPuzzle.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PuzzleBase.h"
+#include "RLOOrrerySolver.h"
+#include "Async/Future.h"
+#include "OrreryPuzzle.generated.h"
+
+/**
+ * @brief 星盘上的一个环
+ */
+USTRUCT(BlueprintType)
+struct FOrreryRing
+{
+    GENERATED_BODY()
+
+    /** 提示中显示的名称 */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Orrery")
+    FText DisplayName;
+
+    /** 环的可视组件(绕Yaw旋转,可为空) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Orrery")
+    class USceneComponent* RingComponent = nullptr;
+
+    /** 转一圈的步数,每步转动 360/NumSteps 度 */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Orrery", meta = (ClampMin = "2", ClampMax = "64"))
+    int32 NumSteps = 24;
+
+    /** 初始步 */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Orrery", meta = (ClampMin = "0"))
+    int32 InitialStep = 0;
+
+    /** 目标步 */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Orrery", meta = (ClampMin = "0"))
+    int32 TargetStep = 0;
+
+    /** 玩家是否可以直接转动此环(否则只能被其他环带动) */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Orrery")
+    bool bCanTurn = true;
+
+    /**
+     * 耦合矩阵的一行:转动此环一步时,各环(按下标)转动的步数,负数为反向。
+     * 缺省的下标为0;整行为空时只转动此环自身一步。
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Orrery")
+    TArray<int32> Coupling;
+};
+
+/**
+ * @brief 多环星盘谜题
+ *
+ * 多个按齿轮比联动的旋转环,转动一个环会按耦合矩阵带动其他环,
+ * 所有环都转到目标步时谜题完成。
+ *
+ * 特性:
+ * - 可配置的耦合矩阵和每环步数(最多8环×64步)
+ * - 内置求解器(FRLOOrrerySolver),报告最少操作数;激活和状态偏离最优解时在线程池中求解,
+ *   不占用游戏线程,求解完成前查询返回上一次的结果
+ * - ShowNextHint 给出最优解的下一步
+ * - 编辑器中和烘焙时检查是否可解,不可解时烘焙报错
+ * - 不需要Tick
+ *
+ * 使用方法:
+ * 1. 在关卡中放置 BP_OrreryPuzzle
+ * 2. 配置 Rings(步数、初始步、目标步、耦合行),在构造脚本中设置 RingComponent
+ * 3. 在蓝图中把点击/滑动交互转发给 TurnRing
+ */
+UCLASS()
+class RUSTYLAKEORRERY_API AOrreryPuzzle : public APuzzleBase
+{
+    GENERATED_BODY()
+
+public:
+    AOrreryPuzzle();
+
+    virtual void OnConstruction(const FTransform& Transform) override;
+    virtual void PostInitializeComponents() override;
+
+#if WITH_EDITOR
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+    virtual void PreSave(const class ITargetPlatform* TargetPlatform) override;
+    virtual EDataValidationResult IsDataValid(TArray<FText>& ValidationErrors) override;
+#endif
+
+    // ========================================================================
+    // 星盘配置
+    // ========================================================================
+
+    /** 星盘的环 */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Orrery Puzzle")
+    TArray<FOrreryRing> Rings;
+
+    /** 是否允许反向转动 */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Orrery Puzzle")
+    bool bAllowReverse = true;
+
+    /** 提示格式,可用 {Ring} {Direction} {Remaining} */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Orrery Puzzle|Hints")
+    FText MoveHintFormat = FText::FromString(TEXT("Turn {Ring} {Direction} ({Remaining} moves left)"));
+
+    /** 正向转动的提示文本 */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Orrery Puzzle|Hints")
+    FText ForwardText = FText::FromString(TEXT("clockwise"));
+
+    /** 反向转动的提示文本 */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Orrery Puzzle|Hints")
+    FText ReverseText = FText::FromString(TEXT("counter-clockwise"));
+
+    /** 从初始状态到目标的最少操作数(编辑器和烘焙时求解,-1表示不可解) */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Orrery Puzzle")
+    int32 MinimalMoveCount = INDEX_NONE;
+
+    // ========================================================================
+    // 运行时状态
+    // ========================================================================
+
+    /** 每个环当前所在的步 */
+    UPROPERTY(BlueprintReadOnly, Category = "Orrery Puzzle State")
+    TArray<int32> CurrentSteps;
+
+    /** 玩家已操作的次数 */
+    UPROPERTY(BlueprintReadOnly, Category = "Orrery Puzzle State")
+    int32 MoveCount = 0;
+
+    // ========================================================================
+    // 委托事件
+    // ========================================================================
+
+    /** 转动环事件 */
+    DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnRingTurned, int32, RingIndex, bool, bReverse);
+    UPROPERTY(BlueprintAssignable, Category = "Orrery Puzzle Events")
+    FOnRingTurned OnRingTurned;
+
+    // ========================================================================
+    // 公共接口
+    // ========================================================================
+
+    /**
+     * @brief 把一个环转动一步,并按耦合矩阵带动其他环
+     * @param RingIndex 环下标
+     * @param bReverse 是否反向
+     * @return 是否转动
+     */
+    UFUNCTION(BlueprintCallable, Category = "Orrery Puzzle")
+    bool TurnRing(int32 RingIndex, bool bReverse = false);
+
+    /**
+     * @brief 所有环是否都在目标步
+     * @return 是否已解开
+     */
+    UFUNCTION(BlueprintCallable, Category = "Orrery Puzzle")
+    bool IsSolved() const;
+
+    /**
+     * @brief 从当前状态到目标的最少操作数(后台求解完成前为上一次求解的结果)
+     * @return 操作数,不可解或尚未求解时返回-1
+     */
+    UFUNCTION(BlueprintCallable, Category = "Orrery Puzzle")
+    int32 GetRemainingMoveCount() const;
+
+    /**
+     * @brief 最优解的下一步
+     * @param OutRingIndex 要转动的环
+     * @param bOutReverse 是否反向
+     * @return 是否有下一步(已解开、不可解或当前状态还在求解时返回false)
+     */
+    UFUNCTION(BlueprintCallable, Category = "Orrery Puzzle")
+    bool GetNextMove(int32& OutRingIndex, bool& bOutReverse) const;
+
+    /** 当前状态是否还在后台求解 */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Orrery Puzzle")
+    bool IsSolving() const { return bSolutionDirty && bValidDefinition; }
+
+    /**
+     * @brief 阻塞等待后台求解完成并取回结果(自动化测试和编辑器工具使用,游戏中不要调用)
+     */
+    void WaitForSolution();
+
+    // ========================================================================
+    // 重写基类方法
+    // ========================================================================
+
+    virtual float GetProgress_Implementation() const override;
+    virtual void OnPuzzleActivatedEvent_Implementation() override;
+    virtual void OnPuzzleResetEvent_Implementation() override;
+
+protected:
+    virtual bool HasNextHint() const override;
+    virtual FText GetNextHintText() const override;
+
+    /** 存档每个环的当前步和操作数 */
+    virtual void SerializePuzzleSaveState(FArchive& Ar) override;
+
+private:
+    /** 由 Rings 生成求解器使用的定义 */
+    void BuildDefinition(FRLOOrreryDefinition& OutDefinition, TArray<int32>& OutInitialSteps, TArray<int32>& OutTargetSteps) const;
+
+    /** 按步数设置环组件的Yaw */
+    void ApplyRingRotation(int32 RingIndex, int32 Step);
+
+    /** 后台求解的结果 */
+    struct FOrrerySolution
+    {
+        /** 求解时各环的步 */
+        TArray<int32> Steps;
+
+        ERLOOrrerySolveResult Result = ERLOOrrerySolveResult::Unsolvable;
+        TArray<int32> Turns;
+        int32 NumMoves = 0;
+    };
+
+    /** 当前状态需要重新求解:没有正在进行的求解时在线程池中开始求解 */
+    void RequestSolution();
+
+    /** 取回已完成的求解结果(游戏线程),求解期间状态又变化时按新状态重新求解 */
+    void ApplySolution();
+
+    /** 按剩余操作数更新进度 */
+    void UpdateCachedProgress();
+
+#if WITH_EDITOR
+    /** 求解初始状态并更新 MinimalMoveCount */
+    ERLOOrrerySolveResult UpdateMinimalMoveCount(FString& OutError);
+#endif
+
+    /** 求解器使用的定义 */
+    FRLOOrreryDefinition Definition;
+
+    /** Definition 是否通过了检查 */
+    bool bValidDefinition = false;
+
+    /** 每个环的目标步(已取模) */
+    TArray<int32> TargetSteps;
+
+    /** 激活时的最少操作数,用于计算进度 */
+    int32 StartMoveCount = 0;
+
+    /** 激活后的第一次求解完成时记录 StartMoveCount */
+    bool bStartMoveCountPending = false;
+
+    /** 当前状态的最优解:每个环还需转动的次数 */
+    TArray<int32> SolutionTurns;
+
+    /** 当前状态的最少操作数,不可解时为-1 */
+    int32 SolutionMoveCount = INDEX_NONE;
+
+    /** 当前状态改变后需要重新求解 */
+    bool bSolutionDirty = true;
+
+    /** 最近一次求解得到的进度,求解期间 GetProgress 返回此值 */
+    float CachedProgress = 0.0f;
+
+    /** 正在线程池中进行的求解 */
+    TFuture<FOrrerySolution> PendingSolution;
+};
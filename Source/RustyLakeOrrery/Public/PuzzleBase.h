@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "SaveSubsystem.h"
 #include "PuzzleBase.generated.h"
 
 /**
@@ -38,7 +39,7 @@ enum class EPuzzleState : uint8
  * - 提示系统
  * - 重置功能
  * - 事件广播
- * - 保存/加载支持
+ * - 保存/加载支持(状态和提示进度由 USaveSubsystem 自动存档,子类重写 SerializePuzzleSaveState 添加自己的状态)
  * 
  * 使用方法:
  * 1. 继承此类创建具体的谜题类(如 ARotationPuzzle)
@@ -52,7 +53,7 @@ enum class EPuzzleState : uint8
  * - 物理谜题(PhysicsPuzzle): 利用物理规则
  */
 UCLASS(Abstract, Blueprintable)
-class RUSTYLAKEORRERY_API APuzzleBase : public AActor
+class RUSTYLAKEORRERY_API APuzzleBase : public AActor, public IRLOSaveable
 {
     GENERATED_BODY()
 
@@ -61,6 +62,7 @@ public:
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
     // ========================================================================
@@ -214,6 +216,49 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Puzzle")
     bool IsActive() const { return CurrentState == EPuzzleState::Active || CurrentState == EPuzzleState::Solving; }
 
+    // ========================================================================
+    // 谜题组件计数
+    // ========================================================================
+
+    /**
+     * @brief 登记关联的谜题组件(由UPuzzleComponent调用)
+     * @param Component 谜题组件
+     */
+    void RegisterPuzzleComponent(const class UPuzzleComponent* Component);
+
+    /**
+     * @brief 注销关联的谜题组件(由UPuzzleComponent调用)
+     * @param Component 谜题组件
+     */
+    void UnregisterPuzzleComponent(const class UPuzzleComponent* Component);
+
+    /**
+     * @brief 已登记组件的完成状态改变(由UPuzzleComponent调用)
+     * @param Component 谜题组件
+     */
+    void NotifyPuzzleComponentChanged(const class UPuzzleComponent* Component);
+
+    /**
+     * @brief 所有必需组件是否都已完成(至少有一个必需组件)
+     * @return 是否全部完成
+     */
+    UFUNCTION(BlueprintCallable, Category = "Puzzle")
+    bool AreRequiredComponentsCompleted() const { return RequiredComponentCount > 0 && CompletedComponentCount == RequiredComponentCount; }
+
+    /**
+     * @brief 获取必需组件数量
+     * @return 必需组件数量
+     */
+    UFUNCTION(BlueprintCallable, Category = "Puzzle")
+    int32 GetRequiredComponentCount() const { return RequiredComponentCount; }
+
+    /**
+     * @brief 获取已完成的必需组件数量
+     * @return 已完成数量
+     */
+    UFUNCTION(BlueprintCallable, Category = "Puzzle")
+    int32 GetCompletedComponentCount() const { return CompletedComponentCount; }
+
     // ========================================================================
     // 蓝图可重写事件
     // ========================================================================
@@ -242,7 +287,44 @@ public:
     UFUNCTION(BlueprintNativeEvent, Category = "Puzzle")
     void OnPuzzleResetEvent();
 
+    /**
+     * @brief 从存档恢复状态后调用(蓝图可重写,用于恢复已完成谜题的外观)
+     */
+    UFUNCTION(BlueprintImplementableEvent, Category = "Puzzle")
+    void OnPuzzleStateRestored();
+
+    // IRLOSaveable
+    virtual void SerializeSaveRecord(FArchive& Ar) override;
+
 protected:
+    /**
+     * @brief 读写子类的存档状态(在基类状态之后,子类状态变化时调用 USaveSubsystem::MarkDirty)
+     * @param Ar 存档记录读写器
+     */
+    virtual void SerializePuzzleSaveState(FArchive& Ar) {}
+
     /** 给予奖励物品 */
     void GiveReward();
+
+    /**
+     * @brief 是否还有下一条提示(默认按HintTexts顺序,子类可重写以生成动态提示)
+     * @return 是否还有提示
+     */
+    virtual bool HasNextHint() const;
+
+    /**
+     * @brief 生成下一条提示,只在HasNextHint为true时调用
+     * @return 提示文本
+     */
+    virtual FText GetNextHintText() const;
+
+private:
+    /** 已登记的必需组件数量 */
+    int32 RequiredComponentCount = 0;
+
+    /** 已完成的必需组件数量 */
+    int32 CompletedComponentCount = 0;
+
+    /** 最近一次显示的提示 */
+    FText CurrentHintText;
 };
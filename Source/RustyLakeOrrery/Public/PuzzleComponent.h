@@ -39,6 +39,7 @@ public:
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
     // ========================================================================
@@ -53,12 +54,12 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Puzzle Config")
     FName ComponentID;
 
-    /** 是否是必需的(必须完成才能解决谜题) */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Puzzle Config")
+    /** 是否是必需的(必须完成才能解决谜题),运行时通过SetRequired修改 */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Puzzle Config")
     bool bIsRequired = true;
 
-    /** 是否已完成 */
-    UPROPERTY(BlueprintReadWrite, Category = "Puzzle State")
+    /** 是否已完成,通过CompleteComponent/ResetComponent修改 */
+    UPROPERTY(BlueprintReadOnly, Category = "Puzzle State")
     bool bIsCompleted = false;
 
     // ========================================================================
@@ -103,7 +104,14 @@ public:
     void ResetComponent();
 
     /**
-     * @brief 检查谜题是否完成(检查所有必需组件)
+     * @brief 设置是否为必需组件
+     * @param bRequired 是否必需
+     */
+    UFUNCTION(BlueprintCallable, Category = "Puzzle")
+    void SetRequired(bool bRequired);
+
+    /**
+     * @brief 检查谜题是否完成(读取谜题Actor的必需组件计数)
      */
     UFUNCTION(BlueprintCallable, Category = "Puzzle")
     void CheckPuzzleCompletion();
@@ -121,4 +129,12 @@ public:
      */
     UFUNCTION(BlueprintCallable, Category = "Puzzle")
     void SetPuzzleActor(APuzzleBase* NewPuzzleActor);
+
+private:
+    /** 让计数登记与PuzzleActor保持一致 */
+    void SyncPuzzleRegistration();
+
+    /** 当前登记了计数的谜题Actor */
+    UPROPERTY(Transient)
+    APuzzleBase* RegisteredPuzzle = nullptr;
 };
@@ -0,0 +1,96 @@
+// RLOBenchmarkCommandlet.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "RLOBenchmarkCommandlet.generated.h"
+
+class UInteractionComponent;
+class ARotationPuzzle;
+class UDialogueComponent;
+
+/**
+ * @brief 基准测试期间把 LogRLO* 日志降到 Warning，析构时恢复原级别
+ */
+class RUSTYLAKEORRERY_API FRLOScopedBenchmarkLogs
+{
+public:
+    /** @param bKeepLogs 为true时不修改日志级别 */
+    explicit FRLOScopedBenchmarkLogs(bool bKeepLogs);
+    ~FRLOScopedBenchmarkLogs();
+
+private:
+    TArray<ELogVerbosity::Type> SavedVerbosity;
+};
+
+/**
+ * @brief 无界面的游戏逻辑基准测试
+ *
+ * 在临时世界中生成 N 个可交互对象、M 个旋转谜题和一条循环对话链，
+ * 通过 UInteractionComponent::InjectTouchSample 注入点击和滑动，逐帧 Tick 世界，
+ * 输出每个子系统的 毫秒/帧、内存分配次数/帧 和 射线检测次数/帧（JSON）。
+ *
+ * 用法（Linux）：
+ *   UE4Editor-Cmd RustyLakeOrrery.uproject -run=RLOBenchmark -nullrhi -unattended
+ *       [-Interactables=200] [-Puzzles=20] [-Dialogues=16] [-Frames=600] [-Warmup=60]
+ *       [-Output=Saved/Benchmarks/RLOBenchmark.json] [-KeepLogs]
+ *
+ * 默认把 LogRLO* 日志降到 Warning，避免日志输出计入耗时；-KeepLogs 保留原级别。
+ * 分配次数通过临时替换 GMalloc 统计，按 RLO_SCOPE_CYCLE 的当前子系统归类。
+ */
+UCLASS()
+class RUSTYLAKEORRERY_API URLOBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    URLOBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+    /**
+     * @brief 创建已开始游戏的临时世界（没有GameMode，之后生成的Actor立即BeginPlay）
+     * @return 世界，创建失败时返回nullptr
+     */
+    static UWorld* CreateBenchmarkWorld();
+
+    /** 销毁 CreateBenchmarkWorld 创建的世界 */
+    static void DestroyBenchmarkWorld(UWorld* World);
+
+private:
+    /** 生成玩家控制器、可交互对象、谜题和对话 */
+    void SpawnScenario(UWorld* World);
+
+    /** 注入当前帧的触摸事件 */
+    void DriveInput(int32 Frame, double Timestamp);
+
+    /** 推动谜题旋转 */
+    void DrivePuzzles(int32 Frame);
+
+    /** 屏幕坐标对应的世界位置（镜头位于原点朝向+X） */
+    FVector ScreenToWorld(const FVector2D& ScreenPosition, float Distance) const;
+
+    /** 基准测试参数 */
+    int32 NumInteractables = 200;
+    int32 NumPuzzles = 20;
+    int32 NumDialogues = 16;
+    int32 NumFrames = 600;
+    int32 NumWarmupFrames = 60;
+
+    /** 虚拟视口 */
+    FVector2D ViewportSize = FVector2D(1920.0f, 1080.0f);
+    float FieldOfView = 90.0f;
+
+    /** 可交互对象的屏幕位置 */
+    TArray<FVector2D> TargetScreenPositions;
+
+    UPROPERTY(Transient)
+    UInteractionComponent* Interaction = nullptr;
+
+    UPROPERTY(Transient)
+    TArray<ARotationPuzzle*> Puzzles;
+
+    UPROPERTY(Transient)
+    UDialogueComponent* Dialogue = nullptr;
+};
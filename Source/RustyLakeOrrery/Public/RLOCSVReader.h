@@ -0,0 +1,164 @@
+// RLOCSVReader.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <initializer_list>
+
+/**
+ * @brief 单次扫描的CSV读取器(RFC 4180)
+ *
+ * 直接在文件缓冲区上逐字符扫描,不做按行拆分和逐行FString复制。支持：
+ * - 双引号包裹的字段(字段内可包含逗号、换行和 "" 转义的引号)
+ * - LF / CRLF / CR 换行,UTF-8 BOM
+ * - 按表头名称(可带多个别名)映射列,兼容不同章节的表结构
+ * - 逐行错误报告(行号 + 原因),出错后自动跳到下一行继续读取
+ *
+ * 字段存储在读取器内部复用的数组中,只在 ReadRow() 之后、下一次读取之前有效。
+ *
+ * 使用方法：
+ * ```cpp
+ * FRLOCSVReader Reader(FileContent);
+ * Reader.ReadHeader();
+ * const int32 IDColumn = Reader.FindColumn({ TEXT("ItemID") });
+ * while (true)
+ * {
+ *     const FRLOCSVReader::EReadResult Result = Reader.ReadRow();
+ *     if (Result == FRLOCSVReader::EReadResult::EndOfFile) break;
+ *     if (Result == FRLOCSVReader::EReadResult::Error) { 记录 Reader.GetLastError(); continue; }
+ *     const FString& ItemID = Reader.GetField(IDColumn);
+ * }
+ * ```
+ */
+class RUSTYLAKEORRERY_API FRLOCSVReader
+{
+public:
+    /** ReadRow 的结果 */
+    enum class EReadResult : uint8
+    {
+        /** 成功读取一行 */
+        Row,
+
+        /** 已到达文件末尾 */
+        EndOfFile,
+
+        /** 当前行格式错误(详见 GetLastError),已跳到下一行 */
+        Error
+    };
+
+    /**
+     * @brief 在字符串缓冲区上构造读取器
+     * @param InBuffer CSV内容,生命周期必须长于读取器
+     */
+    explicit FRLOCSVReader(const FString& InBuffer);
+
+    /**
+     * @brief 在字符数组上构造读取器
+     * @param InData CSV内容,生命周期必须长于读取器
+     * @param InLength 字符数
+     */
+    FRLOCSVReader(const TCHAR* InData, int32 InLength);
+
+    /** 是否去除未加引号字段首尾的空白(默认开启,与旧导入器行为一致) */
+    bool bTrimUnquotedFields = true;
+
+    /** 是否要求每行字段数与表头一致(默认开启) */
+    bool bRequireHeaderFieldCount = true;
+
+    /**
+     * @brief 读取第一行作为表头
+     * @return 是否成功
+     */
+    bool ReadHeader();
+
+    /**
+     * @brief 读取下一行(自动跳过空行)
+     * @return 读取结果
+     */
+    EReadResult ReadRow();
+
+    /**
+     * @brief 按列名查找列索引(不区分大小写,按顺序尝试别名)
+     * @param Names 列名及其别名
+     * @return 列索引,未找到返回INDEX_NONE
+     */
+    int32 FindColumn(std::initializer_list<const TCHAR*> Names) const;
+
+    /**
+     * @brief 获取当前行的字段
+     * @param Column 列索引
+     * @return 字段内容,列不存在时返回空字符串
+     */
+    const FString& GetField(int32 Column) const;
+
+    /** 当前行是否包含指定列且不为空 */
+    bool HasField(int32 Column) const { return Column >= 0 && Column < NumFields && !Fields[Column].IsEmpty(); }
+
+    /** 当前行的字段数 */
+    int32 GetNumFields() const { return NumFields; }
+
+    /** 表头列数 */
+    int32 GetNumColumns() const { return HeaderColumns.Num(); }
+
+    /** 表头列名 */
+    const TArray<FString>& GetColumnNames() const { return HeaderColumns; }
+
+    /** 当前行(或出错行)在文件中的起始行号(从1开始) */
+    int32 GetRowLineNumber() const { return RowLineNumber; }
+
+    /** 最近一次错误的描述 */
+    const FString& GetLastError() const { return LastError; }
+
+    /**
+     * @brief 将表格中的资源路径(如 /Game/Textures/Items/T_Item_Ring 或 .../Seed_Rose.png)转换为对象路径
+     * @param AssetPath 表格中的资源路径
+     * @return 对象路径(如 /Game/Textures/Items/T_Item_Ring.T_Item_Ring),路径为空时返回空字符串
+     */
+    static FString ToObjectPath(const FString& AssetPath);
+
+private:
+    /** 扫描一条记录的所有字段 */
+    EReadResult ScanRecord();
+
+    /** 取得下一个可复用的字段槽 */
+    FString& NextFieldSlot();
+
+    /** 出错后跳到下一行开头 */
+    void SkipToNextLine();
+
+    /** 在当前位置消费一个换行符 */
+    bool ConsumeLineBreak();
+
+    /** 当前位置是否为行尾或文件尾 */
+    bool IsAtLineEnd() const;
+
+    /** 扫描的数据 */
+    const TCHAR* Data = nullptr;
+
+    /** 数据长度 */
+    int32 Length = 0;
+
+    /** 当前位置 */
+    int32 Position = 0;
+
+    /** 当前行号(从1开始) */
+    int32 LineNumber = 1;
+
+    /** 当前记录的起始行号 */
+    int32 RowLineNumber = 0;
+
+    /** 复用的字段存储 */
+    TArray<FString> Fields;
+
+    /** 当前记录的有效字段数 */
+    int32 NumFields = 0;
+
+    /** 表头列名 */
+    TArray<FString> HeaderColumns;
+
+    /** 列名 -> 列索引(FString比较不区分大小写) */
+    TMap<FString, int32> ColumnIndex;
+
+    /** 最近一次错误 */
+    FString LastError;
+};
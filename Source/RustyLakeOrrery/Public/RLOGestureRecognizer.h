@@ -0,0 +1,321 @@
+// RLOGestureRecognizer.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @brief 原始触摸事件阶段
+ */
+enum class ERLOTouchPhase : uint8
+{
+    /** 手指按下 */
+    Began,
+
+    /** 手指移动 */
+    Moved,
+
+    /** 手指抬起 */
+    Ended,
+
+    /** 系统取消（如来电、失去焦点） */
+    Cancelled
+};
+
+/**
+ * @brief 带时间戳的原始触摸事件（也用作录制/回放的数据格式）
+ */
+struct FRLOTouchSample
+{
+    /** 手指索引（0 ~ FRLOGestureRecognizer::MaxPointers-1，对应ETouchIndex::Touch1~Touch10） */
+    int32 PointerIndex = 0;
+
+    /** 事件阶段 */
+    ERLOTouchPhase Phase = ERLOTouchPhase::Began;
+
+    /** 屏幕坐标（像素） */
+    FVector2D Position = FVector2D::ZeroVector;
+
+    /** 时间戳（秒，单调递增） */
+    double Timestamp = 0.0;
+
+    FRLOTouchSample() = default;
+
+    FRLOTouchSample(int32 InPointerIndex, ERLOTouchPhase InPhase, const FVector2D& InPosition, double InTimestamp)
+        : PointerIndex(InPointerIndex)
+        , Phase(InPhase)
+        , Position(InPosition)
+        , Timestamp(InTimestamp)
+    {
+    }
+};
+
+/**
+ * @brief 识别出的手势类型
+ */
+enum class ERLOGestureType : uint8
+{
+    /** 一次触摸序列中的第一根手指按下 */
+    Down,
+
+    /** 点击（移动不超过TapSlop且时长不超过TapMaxDuration） */
+    Tap,
+
+    /** 长按（按住不动达到LongPressDuration，时间戳为精确的到达时刻） */
+    LongPress,
+
+    /** 单指拖动开始（移动超过TapSlop） */
+    PanBegan,
+
+    /** 单指拖动中 */
+    PanChanged,
+
+    /** 单指拖动结束（抬起、取消或第二根手指按下） */
+    PanEnded,
+
+    /** 滑动（拖动后抬起，距离和时长满足条件） */
+    Swipe,
+
+    /** 甩动（抬起时速度超过FlingMinVelocity） */
+    Fling,
+
+    /** 双指手势开始 */
+    TwoFingerBegan,
+
+    /** 双指缩放变化（缩放比例超过PinchThreshold后开始报告） */
+    PinchChanged,
+
+    /** 双指旋转变化（旋转角度超过RotateThresholdDegrees后开始报告） */
+    RotateChanged,
+
+    /** 双指手势结束 */
+    TwoFingerEnded,
+
+    /** 触摸序列结束（所有手指抬起） */
+    Up
+};
+
+/**
+ * @brief 手势事件
+ */
+struct FRLOGestureEvent
+{
+    /** 手势类型 */
+    ERLOGestureType Type = ERLOGestureType::Down;
+
+    /** 事件时间戳（秒） */
+    double Timestamp = 0.0;
+
+    /** 当前位置（单指为手指位置，双指为两指中点） */
+    FVector2D Position = FVector2D::ZeroVector;
+
+    /** 手势开始位置 */
+    FVector2D StartPosition = FVector2D::ZeroVector;
+
+    /** 相对上一个同类事件的位移（Pan） */
+    FVector2D Delta = FVector2D::ZeroVector;
+
+    /** 速度（像素/秒，PanEnded/Swipe/Fling） */
+    FVector2D Velocity = FVector2D::ZeroVector;
+
+    /** 手势持续时间（秒） */
+    float Duration = 0.0f;
+
+    /** 双指累计缩放比例（1表示未缩放） */
+    float Scale = 1.0f;
+
+    /** 相对上一次PinchChanged的缩放比例 */
+    float ScaleDelta = 1.0f;
+
+    /** 双指累计旋转角度（度，顺时针为正） */
+    float RotationDegrees = 0.0f;
+
+    /** 相对上一次RotateChanged的旋转角度（度） */
+    float RotationDelta = 0.0f;
+
+    /** 当前按下的手指数量 */
+    int32 PointerCount = 0;
+};
+
+/**
+ * @brief 手势识别参数
+ */
+struct FRLOGestureConfig
+{
+    /** 点击允许的最大移动距离（像素），超过则开始拖动 */
+    float TapSlop = 20.0f;
+
+    /** 点击的最大持续时间（秒） */
+    float TapMaxDuration = 0.3f;
+
+    /** 长按时间（秒，0表示不识别长按） */
+    float LongPressDuration = 1.0f;
+
+    /** 滑动的最小距离（像素） */
+    float SwipeMinDistance = 20.0f;
+
+    /** 滑动的最大持续时间（秒） */
+    float SwipeMaxDuration = 1.0f;
+
+    /** 甩动的最小速度（像素/秒） */
+    float FlingMinVelocity = 1200.0f;
+
+    /** 计算抬起速度时使用的时间窗口（秒） */
+    float VelocityWindow = 0.1f;
+
+    /** 开始报告缩放所需的比例变化（如0.05表示5%） */
+    float PinchThreshold = 0.05f;
+
+    /** 开始报告旋转所需的角度（度） */
+    float RotateThresholdDegrees = 5.0f;
+};
+
+/**
+ * @brief 事件驱动的多点触控手势识别器
+ *
+ * 输入为带时间戳的原始触摸事件，识别结果只取决于事件序列和时间戳，与帧率无关：
+ * - 单指：按下、点击、长按、拖动、滑动、甩动（抬起时按时间窗口估算速度）
+ * - 双指：缩放和旋转（用于星盘），第二根手指按下时取消单指手势
+ * - 最多同时跟踪 MaxPointers 根手指，第三根及以后的手指只跟踪不参与识别
+ *
+ * 长按等依赖时间的手势需要调用 Advance() 推进时间；ProcessSample() 会先推进到事件时间戳。
+ * 识别器不依赖UObject，可直接用 Replay() 回放录制的触摸序列验证识别结果。
+ *
+ * 使用方法：
+ * ```cpp
+ * TArray<FRLOGestureEvent> Events;
+ * Recognizer.ProcessSample(FRLOTouchSample(0, ERLOTouchPhase::Began, Position, Now), Events);
+ * Recognizer.Advance(Now, Events);   // 每帧调用
+ * for (const FRLOGestureEvent& Event : Events) { ... }
+ * ```
+ */
+class RUSTYLAKEORRERY_API FRLOGestureRecognizer
+{
+public:
+    /** 最多跟踪的手指数量 */
+    static constexpr int32 MaxPointers = 10;
+
+    /** 识别参数 */
+    FRLOGestureConfig Config;
+
+    /**
+     * @brief 处理一个原始触摸事件
+     * @param Sample 触摸事件（时间戳不得早于之前的事件）
+     * @param OutEvents 识别出的手势追加到此数组
+     */
+    void ProcessSample(const FRLOTouchSample& Sample, TArray<FRLOGestureEvent>& OutEvents);
+
+    /**
+     * @brief 推进时间，识别长按等依赖时间的手势
+     * @param Now 当前时间（与事件时间戳同一时基）
+     * @param OutEvents 识别出的手势追加到此数组
+     */
+    void Advance(double Now, TArray<FRLOGestureEvent>& OutEvents);
+
+    /** 清除所有手指和手势状态（不产生事件） */
+    void Reset();
+
+    /**
+     * @brief 设置当前触摸序列的长按时间（如按下时根据命中的对象设置，序列结束后恢复为Config值）
+     * @param Duration 长按时间（秒，0表示不识别长按）
+     */
+    void SetLongPressDuration(float Duration) { SequenceLongPressDuration = Duration; }
+
+    /**
+     * @brief 获取当前长按进度
+     * @param Now 当前时间
+     * @return 0-1，没有进行中的长按时为0
+     */
+    float GetLongPressProgress(double Now) const;
+
+    /** 当前按下的手指数量 */
+    int32 GetActivePointerCount() const { return ActivePointerCount; }
+
+    /** 是否有手指按下 */
+    bool IsTouching() const { return ActivePointerCount > 0; }
+
+    /**
+     * @brief 回放触摸序列（使用全新的识别器）
+     * @param InConfig 识别参数
+     * @param Samples 按时间排序的触摸事件
+     * @param OutEvents 识别出的手势
+     * @param EndTime 回放结束时推进到的时间（小于最后一个事件的时间戳时使用最后的时间戳）
+     */
+    static void Replay(const FRLOGestureConfig& InConfig, TArrayView<const FRLOTouchSample> Samples, TArray<FRLOGestureEvent>& OutEvents, double EndTime = 0.0);
+
+private:
+    /** 速度估算保留的历史采样数 */
+    static constexpr int32 HistorySize = 8;
+
+    /** 识别状态 */
+    enum class EMode : uint8
+    {
+        /** 无手指 */
+        Idle,
+
+        /** 单指手势 */
+        Single,
+
+        /** 双指手势 */
+        TwoFinger,
+
+        /** 手势已结束或已取消，等待所有手指抬起 */
+        Finished
+    };
+
+    /** 单根手指的状态 */
+    struct FPointer
+    {
+        bool bActive = false;
+        FVector2D StartPosition = FVector2D::ZeroVector;
+        FVector2D Position = FVector2D::ZeroVector;
+        double StartTime = 0.0;
+        FVector2D HistoryPositions[HistorySize];
+        double HistoryTimes[HistorySize];
+        int32 HistoryCount = 0;
+        int32 HistoryHead = 0;
+
+        void AddHistory(const FVector2D& InPosition, double Time);
+        FVector2D EstimateVelocity(double Now, float Window) const;
+    };
+
+    void OnPointerDown(int32 Index, const FRLOTouchSample& Sample, TArray<FRLOGestureEvent>& OutEvents);
+    void OnPointerMove(int32 Index, const FRLOTouchSample& Sample, TArray<FRLOGestureEvent>& OutEvents);
+    void OnPointerUp(int32 Index, const FRLOTouchSample& Sample, bool bCancelled, TArray<FRLOGestureEvent>& OutEvents);
+
+    /** 开始双指手势 */
+    void BeginTwoFinger(int32 IndexA, int32 IndexB, double Timestamp, TArray<FRLOGestureEvent>& OutEvents);
+
+    /** 双指中任一手指移动后更新缩放和旋转 */
+    void UpdateTwoFinger(double Timestamp, TArray<FRLOGestureEvent>& OutEvents);
+
+    /** 构造事件并填充通用字段 */
+    FRLOGestureEvent& AddEvent(TArray<FRLOGestureEvent>& OutEvents, ERLOGestureType Type, double Timestamp) const;
+
+    /** 当前长按时间 */
+    float GetLongPressDuration() const { return SequenceLongPressDuration >= 0.0f ? SequenceLongPressDuration : Config.LongPressDuration; }
+
+    FPointer Pointers[MaxPointers];
+    int32 ActivePointerCount = 0;
+    EMode Mode = EMode::Idle;
+
+    /** 单指手势 */
+    int32 PrimaryIndex = INDEX_NONE;
+    bool bPanning = false;
+    bool bLongPressFired = false;
+    FVector2D LastPanPosition = FVector2D::ZeroVector;
+    float SequenceLongPressDuration = -1.0f;
+
+    /** 双指手势 */
+    int32 PairIndexA = INDEX_NONE;
+    int32 PairIndexB = INDEX_NONE;
+    float PairStartDistance = 0.0f;
+    float PairLastAngle = 0.0f;
+    float PairRotation = 0.0f;
+    float LastReportedScale = 1.0f;
+    float LastReportedRotation = 0.0f;
+    bool bPinching = false;
+    bool bTwoFingerRotating = false;
+    FVector2D PairStartCentroid = FVector2D::ZeroVector;
+    double PairStartTime = 0.0;
+};
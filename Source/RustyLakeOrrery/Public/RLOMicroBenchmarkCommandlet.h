@@ -0,0 +1,68 @@
+// RLOMicroBenchmarkCommandlet.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "RLOMicroBenchmarkCommandlet.generated.h"
+
+/**
+ * @brief 数据资产和核心逻辑的微基准测试
+ *
+ * 覆盖 UDialogueDataAsset 查找和CSV导入（仅编辑器版本）、UInventoryComponent 增删查、
+ * UInteractableComponent::IsSwipeDirectionValid、UPuzzleComponent::CheckPuzzleCompletion、
+ * AUIManager::GetUIManager。
+ * 正确性由 Private/Tests 中的自动化测试(RLO.*)检查,这里只确认计时的运行确实完成了工作。
+ * 每项以发行数据规模的 10×、100×、1000× 计时（取多次运行的最小值），
+ * 与 DefaultGame.ini [RLO.MicroBenchmarkBaselines] 中的基线比较，超出基线×(1+Tolerance) 即失败。
+ *
+ * 用法：
+ *   UE4Editor-Cmd RustyLakeOrrery.uproject -run=RLOMicroBenchmark -nullrhi -unattended
+ *       [-Filter=Dialogue] [-Repeats=5] [-Output=Saved/Benchmarks/RLOMicroBenchmarks.json] [-KeepLogs]
+ *
+ * 任一检查失败或超出基线时返回1。日志末尾输出本机测得的基线，可直接粘贴到配置中更新。
+ */
+UCLASS()
+class RUSTYLAKEORRERY_API URLOMicroBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    URLOMicroBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+private:
+    /** 单项测试：计时的运行结果正确时返回true并输出最短耗时 */
+    typedef bool (URLOMicroBenchmarkCommandlet::*FBenchmarkFunction)(int32 Size, double& OutMs);
+
+    /** 对话ID/触发事件查找 */
+    bool RunDialogueLookup(int32 Size, double& OutMs);
+
+#if WITH_EDITOR
+    /** 对话CSV导入（仅编辑器） */
+    bool RunDialogueCSVImport(int32 Size, double& OutMs);
+#endif
+
+    /** 背包添加、按ID查找、移除 */
+    bool RunInventoryOperations(int32 Size, double& OutMs);
+
+    /** 滑动方向判定 */
+    bool RunSwipeValidation(int32 Size, double& OutMs);
+
+    /** 多部件谜题逐个完成 */
+    bool RunPuzzleCompletion(int32 Size, double& OutMs);
+
+    /** 按世界查找UIManager */
+    bool RunUIManagerLookup(int32 Size, double& OutMs);
+
+    /** 记录检查失败 */
+    bool Fail(const TCHAR* Benchmark, const FString& Message);
+
+    /** 每项计时重复次数 */
+    int32 Repeats = 5;
+
+    /** 谜题测试使用的世界 */
+    UPROPERTY(Transient)
+    UWorld* World = nullptr;
+};
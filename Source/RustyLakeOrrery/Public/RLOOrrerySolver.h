@@ -0,0 +1,98 @@
+// RLOOrrerySolver.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @brief 多环星盘谜题的定义
+ *
+ * 每次操作把一个环转动一步,同时通过耦合矩阵带动其他环:
+ * 转动环i一步时,环j转动 Coupling[i * NumRings + j] 步(按环j的步数取模,负数为反向)。
+ */
+struct RUSTYLAKEORRERY_API FRLOOrreryDefinition
+{
+    /** 每个环转一圈的步数 */
+    TArray<int32> NumSteps;
+
+    /** 耦合矩阵,行主序 NumRings×NumRings */
+    TArray<int32> Coupling;
+
+    /** 玩家可以直接转动的环(不可转动的环只能被其他环带动) */
+    TArray<bool> Turnable;
+
+    /** 是否允许反向转动 */
+    bool bAllowReverse = true;
+
+    int32 GetNumRings() const { return NumSteps.Num(); }
+};
+
+/** 求解结果 */
+enum class ERLOOrrerySolveResult : uint8
+{
+    Solved,
+    Unsolvable,
+    InvalidDefinition,
+    TooLarge,
+};
+
+/** 求解方法 */
+enum class ERLOOrrerySolveMethod : uint8
+{
+    /** 状态数不超过 MaxBreadthFirstStates 时广度优先搜索,否则中间相遇 */
+    Auto,
+    BreadthFirst,
+    MeetInTheMiddle,
+};
+
+/**
+ * @brief 多环星盘谜题的求解器
+ *
+ * 状态打包为uint64(每环8位)。状态总数不超过 MaxBreadthFirstStates 时直接广度优先搜索。
+ *
+ * 更大的谜题(如8环×24步,约1.1e11个状态)利用操作可以交换顺序:
+ * 谜题状态只取决于每个环被转动的净次数,所以在"各环转动次数"上搜索。
+ * 把可转动的环分成两半,各自枚举转动次数得到的状态偏移,
+ * 一半存入哈希表,另一半查找互补的偏移,在中间相遇,得到总操作数最少的解。
+ * 8环×24步时每半约33万种组合;先只枚举操作数较少的组合,
+ * 接近完成时的提示查询通常不到1毫秒,离目标很远时才做完整枚举。
+ */
+class RUSTYLAKEORRERY_API FRLOOrrerySolver
+{
+public:
+    /** 最多环数(打包状态每环占8位) */
+    static constexpr int32 MaxRings = 8;
+
+    /** 每环最多步数 */
+    static constexpr int32 MaxSteps = 64;
+
+    /** 状态总数不超过此值时直接广度优先搜索 */
+    static constexpr uint64 MaxBreadthFirstStates = 1 << 20;
+
+    /** 中间相遇时每一半最多枚举的组合数 */
+    static constexpr uint64 MaxCombinationsPerHalf = 1 << 20;
+
+    /**
+     * @brief 检查定义是否有效
+     * @param Definition 谜题定义
+     * @param OutError 无效时的原因
+     * @return 是否有效
+     */
+    static bool Validate(const FRLOOrreryDefinition& Definition, FString* OutError = nullptr);
+
+    /**
+     * @brief 求从起始状态到目标状态的最少操作
+     * @param Definition 谜题定义
+     * @param FromSteps 每个环的起始步
+     * @param ToSteps 每个环的目标步
+     * @param OutTurns 每个环需要转动的次数,负数为反向
+     * @param OutNumMoves 最少操作数(OutTurns绝对值之和)
+     * @param Method 求解方法(自动化测试中指定,用两种方法互相校验)
+     * @return 求解结果
+     */
+    static ERLOOrrerySolveResult Solve(const FRLOOrreryDefinition& Definition, const TArray<int32>& FromSteps, const TArray<int32>& ToSteps,
+                                       TArray<int32>& OutTurns, int32& OutNumMoves, ERLOOrrerySolveMethod Method = ERLOOrrerySolveMethod::Auto);
+
+    /** 求解结果的名称(用于日志) */
+    static const TCHAR* GetResultName(ERLOOrrerySolveResult Result);
+};
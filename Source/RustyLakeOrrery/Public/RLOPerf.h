@@ -0,0 +1,119 @@
+// RLOPerf.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/** 非Shipping版本统计各子系统每帧耗时并与预算比较 */
+#define RLO_PERF_BUDGETS !UE_BUILD_SHIPPING
+
+/**
+ * @brief 参与帧预算统计的游戏子系统
+ */
+enum class ERLOPerfSubsystem : uint8
+{
+    Interaction,
+    Dialogue,
+    Puzzle,
+    Inventory,
+    UI,
+    Save,
+
+    Count
+};
+
+/**
+ * @brief 子系统帧预算统计
+ *
+ * RLO_SCOPE_CYCLE 在 stat RustyLakeOrrery 的周期计数器和 Unreal Insights 的CPU事件之外，
+ * 把耗时累加到所属子系统；同一子系统嵌套的作用域只计算最外层，不会重复累加。
+ * 只在游戏线程使用。
+ *
+ * 预算（毫秒/帧）在 DefaultGame.ini 的 [RLO.Budgets] 中配置，控制台命令：
+ * - RLO.Budget.Dump：输出各子系统的平均、峰值、最近一帧耗时和预算
+ * - RLO.Budget.Reset：重新开始统计
+ */
+class RUSTYLAKEORRERY_API FRLOPerf
+{
+public:
+    /** 单个子系统的统计结果 */
+    struct FSubsystemStats
+    {
+        /** 统计窗口内的平均每帧耗时（毫秒） */
+        double AverageMs = 0.0;
+
+        /** 单帧最大耗时（毫秒） */
+        double PeakMs = 0.0;
+
+        /** 最近一个有耗时的帧的耗时（毫秒） */
+        double LastFrameMs = 0.0;
+
+        /** 统计窗口内进入作用域的次数 */
+        uint64 NumCalls = 0;
+
+        /** 每帧预算（毫秒） */
+        float BudgetMs = 0.0f;
+    };
+
+    /** 累加子系统在当前帧的耗时 */
+    static void AddCycles(ERLOPerfSubsystem Subsystem, uint64 Cycles);
+
+    /** 获取子系统统计 */
+    static FSubsystemStats GetStats(ERLOPerfSubsystem Subsystem);
+
+    /** 统计窗口包含的帧数 */
+    static uint64 GetNumFrames();
+
+    /** 子系统名称 */
+    static const TCHAR* GetSubsystemName(ERLOPerfSubsystem Subsystem);
+
+    /** 子系统每帧预算（毫秒） */
+    static float GetBudgetMs(ERLOPerfSubsystem Subsystem);
+
+    /** 游戏线程上最内层正在计时的子系统，不在任何作用域内时返回 Count */
+    static ERLOPerfSubsystem GetActiveSubsystem() { return ActiveSubsystem; }
+
+    /** 清空统计，从当前帧重新开始 */
+    static void Reset();
+
+    /** 输出各子系统的耗时和预算 */
+    static void DumpBudgets(FOutputDevice& Ar);
+
+    /**
+     * @brief 作用域计时器，析构时把耗时累加到子系统
+     */
+    class FScope
+    {
+    public:
+        explicit FScope(ERLOPerfSubsystem InSubsystem);
+        ~FScope();
+
+    private:
+        ERLOPerfSubsystem Subsystem;
+        ERLOPerfSubsystem PreviousSubsystem;
+        uint64 StartCycles;
+        bool bOutermost;
+    };
+
+private:
+    /** 同一子系统的嵌套深度 */
+    static int32 ScopeDepth[static_cast<int32>(ERLOPerfSubsystem::Count)];
+
+    /** 最内层正在计时的子系统 */
+    static ERLOPerfSubsystem ActiveSubsystem;
+
+    friend class FScope;
+};
+
+#if RLO_PERF_BUDGETS
+#define RLO_SCOPE_CYCLE(Subsystem, Stat) \
+    SCOPE_CYCLE_COUNTER(Stat); \
+    TRACE_CPUPROFILER_EVENT_SCOPE(Stat); \
+    FRLOPerf::FScope ANONYMOUS_VARIABLE(RLOPerfScope_)(ERLOPerfSubsystem::Subsystem)
+#else
+#define RLO_SCOPE_CYCLE(Subsystem, Stat) \
+    SCOPE_CYCLE_COUNTER(Stat); \
+    TRACE_CPUPROFILER_EVENT_SCOPE(Stat)
+#endif
@@ -0,0 +1,165 @@
+// RoomStreamingSubsystem.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "RoomStreamingSubsystem.generated.h"
+
+class ULevel;
+class ULevelStreaming;
+
+/**
+ * @brief 房间流式加载管理器（世界子系统）
+ *
+ * 每个房间是一个流式子关卡，切换房间不重新加载整个关卡：
+ * - PreloadRoom()：后台加载房间但不显示（Navigate交互对象获得焦点时调用）
+ * - NavigateToRoom()：淡出 -> 新房间加载完成后显示 -> 新房间可见后同帧隐藏旧房间 -> 淡入，
+ *   子关卡的显示由引擎分帧完成，不会出现 OpenLevel 的整帧卡顿
+ * - 最多保留 MaxResidentRooms 个已加载的房间，超出时卸载最久未使用的房间
+ * - 记录每次切换的延迟（请求到新房间可见），显示在 stat RustyLakeOrrery
+ * - 新房间加载失败或超过 TransitionTimeout 仍未显示时放弃切换，留在当前房间并淡入
+ *
+ * 房间优先在持久关卡的流式子关卡中按名称查找，找不到时在 RoomPackagePath 下动态创建关卡实例。
+ */
+UCLASS(Config = Game)
+class RUSTYLAKEORRERY_API URoomStreamingSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * @brief 获取对象所在世界的房间管理器
+     * @param WorldContextObject 世界上下文对象
+     * @return 管理器，世界无效时返回nullptr
+     */
+    static URoomStreamingSubsystem* Get(const UObject* WorldContextObject);
+
+    /** 最多同时保持加载的房间数量（包括当前房间） */
+    UPROPERTY(Config)
+    int32 MaxResidentRooms = 3;
+
+    /** 不在持久关卡子关卡列表中的房间所在的目录 */
+    UPROPERTY(Config)
+    FString RoomPackagePath = TEXT("/Game/Maps");
+
+    /** 切换超时（秒，从请求到新房间可见），超时后放弃切换，0表示不限制 */
+    UPROPERTY(Config)
+    float TransitionTimeout = 10.0f;
+
+    /**
+     * @brief 后台加载房间（不显示）
+     * @param RoomName 房间关卡名称
+     * @return 房间是否可以流式加载
+     */
+    UFUNCTION(BlueprintCallable, Category = "Room Streaming")
+    bool PreloadRoom(FName RoomName);
+
+    /**
+     * @brief 切换到房间
+     * @param RoomName 目标房间关卡名称
+     * @param TransitionDuration 过渡时间（秒，淡出和淡入各一半，0表示不淡入淡出）
+     * @param FromActor 发起切换的Actor，尚未记录当前房间时用它所在的子关卡作为当前房间
+     * @return 是否开始切换（房间无法流式加载或正在切换时返回false）
+     */
+    UFUNCTION(BlueprintCallable, Category = "Room Streaming")
+    bool NavigateToRoom(FName RoomName, float TransitionDuration = 1.0f, const AActor* FromActor = nullptr);
+
+    /** 当前房间 */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Room Streaming")
+    FName GetCurrentRoom() const { return CurrentRoom; }
+
+    /** 是否正在切换房间 */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Room Streaming")
+    bool IsTransitioning() const { return bTransitioning; }
+
+    /** 最近一次切换的延迟（秒，从请求到新房间可见） */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Room Streaming")
+    float GetLastTransitionLatency() const { return LastTransitionLatency; }
+
+    /** 当前已加载的房间数量 */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Room Streaming")
+    int32 GetNumResidentRooms() const { return ResidentRooms.Num(); }
+
+    /**
+     * @brief 查找动态创建的房间实例对应的房间名称
+     *
+     * 动态实例的包名带有每次运行递增的 _LevelInstance_N 后缀，需要固定名称的地方（如存档键）用房间名称代替。
+     * @param Level 已加载的关卡
+     * @return 房间名称，不是动态房间实例时返回 NAME_None
+     */
+    FName FindRoomInstanceName(const ULevel* Level) const;
+
+    /** 房间切换完成时广播 */
+    DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnRoomTransitionCompleted, FName, FromRoom, FName, ToRoom, float, LatencySeconds);
+    UPROPERTY(BlueprintAssignable, Category = "Room Streaming")
+    FOnRoomTransitionCompleted OnRoomTransitionCompleted;
+
+    /** 房间切换失败（新房间加载失败或超时）时广播，仍留在 FromRoom */
+    DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnRoomTransitionFailed, FName, FromRoom, FName, ToRoom);
+    UPROPERTY(BlueprintAssignable, Category = "Room Streaming")
+    FOnRoomTransitionFailed OnRoomTransitionFailed;
+
+    virtual void Deinitialize() override;
+
+private:
+    /** 查找房间，找不到时创建动态关卡实例 */
+    ULevelStreaming* FindOrCreateRoom(FName RoomName);
+
+    /** 查找已知的房间 */
+    ULevelStreaming* FindRoom(FName RoomName) const;
+
+    /** 记录房间最近被使用 */
+    void TouchRoom(FName RoomName);
+
+    /** 卸载超出数量限制的房间 */
+    void EnforceResidentLimit();
+
+    /** 子关卡加载或显示完成 */
+    UFUNCTION()
+    void OnRoomStreamingStateChanged();
+
+    /** 淡出完成 */
+    void OnFadeOutFinished();
+
+    /** 推进房间切换 */
+    void TryAdvanceTransition();
+
+    /** 切换超时 */
+    void OnTransitionTimedOut();
+
+    /**
+     * @brief 放弃切换：隐藏新房间，留在当前房间并淡入
+     * @param Reason 日志中的原因
+     */
+    void AbortTransition(const TCHAR* Reason);
+
+    /** 玩家镜头淡入淡出（FromAlpha 小于0时从当前透明度开始） */
+    void FadeCamera(float FromAlpha, float ToAlpha, float Duration, bool bHoldWhenFinished);
+
+    /** 房间名称 -> 流式子关卡 */
+    UPROPERTY(Transient)
+    TMap<FName, ULevelStreaming*> Rooms;
+
+    /** 已加载的房间（最近使用的在最后） */
+    TArray<FName> ResidentRooms;
+
+    /** 当前房间 */
+    FName CurrentRoom;
+
+    /** 进行中的切换 */
+    bool bTransitioning = false;
+    bool bFadedOut = false;
+    bool bShowRequested = false;
+    bool bTargetWasPreloaded = false;
+    FName TransitionFromRoom;
+    FName TransitionToRoom;
+    float TransitionFadeDuration = 0.0f;
+    double TransitionStartTime = 0.0;
+
+    /** 最近一次切换的延迟 */
+    float LastTransitionLatency = 0.0f;
+
+    FTimerHandle FadeTimerHandle;
+    FTimerHandle TransitionTimeoutHandle;
+};
@@ -16,6 +16,7 @@
  * - 角度容差设置
  * - 可视化反馈
  * - 自动检测完成
+ * - 不需要Tick:只在旋转改变时检查角度,保持时间用一次性定时器
  * 
  * 使用场景:
  * - 旋转雕像/画框到正确角度
@@ -37,8 +38,9 @@ public:
     ARotationPuzzle();
 
 protected:
+    virtual void PostInitializeComponents() override;
     virtual void BeginPlay() override;
-    virtual void Tick(float DeltaTime) override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
     // ========================================================================
@@ -69,10 +71,6 @@ public:
     UPROPERTY(BlueprintReadOnly, Category = "Rotation Puzzle State")
     float CurrentRotation = 0.0f;
 
-    /** 保持正确角度的计时器 */
-    UPROPERTY(BlueprintReadOnly, Category = "Rotation Puzzle State")
-    float HoldTimer = 0.0f;
-
     /** 是否在正确角度 */
     UPROPERTY(BlueprintReadOnly, Category = "Rotation Puzzle State")
     bool bIsAtCorrectAngle = false;
@@ -123,6 +121,13 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Rotation Puzzle")
     float GetAngleDifference() const;
 
+    /**
+     * @brief 获取已在正确角度保持的时间
+     * @return 保持时间(秒),不在正确角度时为0
+     */
+    UFUNCTION(BlueprintCallable, Category = "Rotation Puzzle")
+    float GetHoldTimeElapsed() const;
+
     // ========================================================================
     // 重写基类方法
     // ========================================================================
@@ -131,10 +136,29 @@ public:
     virtual void OnPuzzleActivatedEvent_Implementation() override;
     virtual void OnPuzzleResetEvent_Implementation() override;
 
+protected:
+    /** 存档当前角度 */
+    virtual void SerializePuzzleSaveState(FArchive& Ar) override;
+
 private:
-    /** 更新旋转状态 */
+    /** 更新旋转状态,到达或离开正确角度时启动或取消保持定时器 */
     void UpdateRotationState();
 
+    /** 从可旋转组件读取当前角度并更新状态 */
+    void RefreshRotationFromComponent();
+
+    /** 可旋转组件的变换更新回调(处理SetRotation以外的移动) */
+    void OnRotatableTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+    /** 保持定时器到期 */
+    void OnHoldTimeElapsed();
+
+    /** 保持正确角度的一次性定时器 */
+    FTimerHandle HoldTimerHandle;
+
+    /** SetRotation正在应用旋转,忽略由此触发的变换回调 */
+    bool bApplyingRotation = false;
+
     /** 标准化角度到0-360范围 */
     float NormalizeAngle(float Angle) const;
 };
@@ -0,0 +1,283 @@
+// SaveSubsystem.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Async/Future.h"
+#include "Containers/Ticker.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "SaveSubsystem.generated.h"
+
+/**
+ * @brief 存档格式版本
+ *
+ * 修改任何 SerializeSaveRecord 的数据布局时新增一项,读取时用 USaveSubsystem::GetLoadedVersion() 兼容旧存档。
+ */
+enum class ERLOSaveVersion : uint32
+{
+    Initial = 1,
+
+    LatestPlusOne,
+    Latest = LatestPlusOne - 1
+};
+
+UINTERFACE(MinimalAPI, meta = (CannotImplementInterfaceInBlueprint))
+class URLOSaveable : public UInterface
+{
+    GENERATED_BODY()
+};
+
+/**
+ * @brief 可存档对象
+ *
+ * 实现者在 BeginPlay 中调用 USaveSubsystem::RegisterSaveable(恢复已存档的状态),
+ * 在 EndPlay 中调用 UnregisterSaveable,状态变化时调用 USaveSubsystem::MarkDirty。
+ */
+class RUSTYLAKEORRERY_API IRLOSaveable
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * @brief 存档记录的键
+     *
+     * 默认使用去掉PIE前缀的对象路径,关卡中放置的对象每次运行都相同;
+     * 动态创建的房间实例(URoomStreamingSubsystem)中的对象使用房间名加对象在关卡中的路径。
+     * 运行时生成的对象(如 PlayerController 上的组件)需要重写为固定的键。
+     */
+    virtual FString GetSaveKey() const;
+
+    /**
+     * @brief 读写存档记录(Ar.IsLoading() 时恢复状态)
+     * @param Ar 记录的内存读写器
+     */
+    virtual void SerializeSaveRecord(FArchive& Ar) = 0;
+};
+
+/**
+ * @brief 存档子系统
+ *
+ * 只写入变化的记录,写文件不占用游戏线程:
+ * - 可存档对象状态变化时 MarkDirty,自动存档时只序列化脏对象,与上次内容相同的记录直接跳过
+ * - 游戏线程只把脏对象序列化到内存,文件写入在线程池中按顺序执行
+ * - 变化的记录追加到日志文件(每条带长度和CRC),进程被杀时最多丢失最后一条不完整的记录
+ * - 日志超过 MaxJournalBytes 时写入完整快照:先写临时文件再替换,最后开始新的日志
+ * - 快照和日志带版本号和代数,启动时读取快照并重放同一代的日志
+ * - 应用切到后台或退出时,捕获所有已注册对象并等待写入完成(Android经常直接杀进程)
+ *
+ * 自动存档的游戏线程耗时计入 RLO.Budget.Dump 的 Save 预算(1毫秒),超出时输出警告。
+ * 控制台命令:RLO.Save.Now、RLO.Save.Delete
+ */
+UCLASS(Config = Game)
+class RUSTYLAKEORRERY_API USaveSubsystem : public UGameInstanceSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * @brief 获取存档子系统
+     * @param WorldContextObject 世界上下文对象
+     * @return 子系统,没有GameInstance时返回nullptr
+     */
+    static USaveSubsystem* Get(const UObject* WorldContextObject);
+
+    /**
+     * @brief 标记对象的存档状态已变化(没有存档子系统时什么都不做)
+     * @param Saveable 实现 IRLOSaveable 的对象
+     */
+    static void MarkDirty(UObject* Saveable);
+
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    // ========================================================================
+    // 配置
+    // ========================================================================
+
+    /** 存档槽名称(文件位于 Saved/SaveGames) */
+    UPROPERTY(Config)
+    FString SlotName = TEXT("Autosave");
+
+    /** 自动存档间隔(秒,0表示只在切到后台、切换关卡和退出时存档) */
+    UPROPERTY(Config)
+    float AutosaveInterval = 5.0f;
+
+    /** 日志超过此大小(字节)时写入完整快照 */
+    UPROPERTY(Config)
+    int32 MaxJournalBytes = 64 * 1024;
+
+    // ========================================================================
+    // 注册
+    // ========================================================================
+
+    /**
+     * @brief 注册可存档对象,有存档记录时立即恢复
+     * @param Saveable 实现 IRLOSaveable 的对象
+     */
+    void RegisterSaveable(UObject* Saveable);
+
+    /**
+     * @brief 注销可存档对象,未保存的变化先捕获到内存中
+     * @param Saveable 实现 IRLOSaveable 的对象
+     */
+    void UnregisterSaveable(UObject* Saveable);
+
+    // ========================================================================
+    // 存档
+    // ========================================================================
+
+    /**
+     * @brief 立即存档(游戏线程只序列化记录,写文件在后台完成)
+     * @param bCaptureAll 是否捕获所有已注册对象(否则只捕获标记为脏的对象)
+     */
+    UFUNCTION(BlueprintCallable, Category = "Save")
+    void SaveNow(bool bCaptureAll = false);
+
+    /**
+     * @brief 等待所有后台写入完成
+     */
+    UFUNCTION(BlueprintCallable, Category = "Save")
+    void WaitForPendingWrites();
+
+    /**
+     * @brief 删除存档(新游戏),已注册对象的当前状态不受影响
+     */
+    UFUNCTION(BlueprintCallable, Category = "Save")
+    void DeleteSave();
+
+    /** 是否有存档记录 */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Save")
+    bool HasSaveData() const { return Records.Num() > 0; }
+
+    /** 读取的存档版本(没有存档时为 Latest) */
+    ERLOSaveVersion GetLoadedVersion() const { return LoadedVersion; }
+
+    /** 最近一次存档在游戏线程上的耗时(毫秒) */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Save")
+    float GetLastCaptureMs() const { return LastCaptureMs; }
+
+private:
+    /** 自动化测试读取文件路径并直接从磁盘加载 */
+    friend struct FRLOSaveSubsystemTestAccess;
+
+    /** 记录内容(捕获后不再修改,在游戏线程和写入线程之间共享) */
+    typedef TSharedRef<const TArray<uint8>, ESPMode::ThreadSafe> FRecordRef;
+
+    /** 一次写入任务 */
+    struct FWriteJob
+    {
+        /** 追加到日志的记录 */
+        TArray<TPair<FString, FRecordRef>> Entries;
+
+        /** 写入完整快照时的所有记录 */
+        TMap<FString, FRecordRef> Snapshot;
+
+        /** 是否写入快照(之后开始新一代日志) */
+        bool bWriteSnapshot = false;
+
+        /** 日志/快照的代数 */
+        uint32 Generation = 0;
+    };
+
+    /** 读取快照并重放日志 */
+    void LoadFromDisk();
+
+    /**
+     * @brief 序列化对象,内容变化时更新 Records 并加入 UnsavedEntries
+     * @param Saveable 可存档对象
+     * @param Key 记录的键
+     */
+    void CaptureRecord(UObject* Saveable, const FString& Key);
+
+    /** 把任务加入写入队列,没有写入线程在运行时启动 */
+    void EnqueueWrite(FWriteJob&& Job);
+
+    /** 写入线程:按顺序执行队列中的任务 */
+    void RunWriter();
+
+    /** 执行一个写入任务 */
+    void WriteJob(const FWriteJob& Job);
+
+    /** 自动存档计时 */
+    bool HandleAutosaveTick(float DeltaTime);
+
+    /** 切到后台、退出时存档 */
+    void HandleApplicationWillDeactivate();
+
+    /** 切换关卡时,旧关卡 EndPlay 之后存档 */
+    void HandleWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+    FString GetSnapshotPath() const;
+    FString GetJournalPath() const;
+
+    // ========================================================================
+    // 游戏线程状态
+    // ========================================================================
+
+    /** 键 -> 最近一次捕获或读取的记录 */
+    TMap<FString, FRecordRef> Records;
+
+    /** 已注册的对象 -> 键 */
+    TMap<TWeakObjectPtr<UObject>, FString> RegisteredKeys;
+
+    /** 状态已变化的对象 */
+    TSet<TWeakObjectPtr<UObject>> DirtyObjects;
+
+    /** 已捕获但还没有交给写入线程的记录 */
+    TArray<TPair<FString, FRecordRef>> UnsavedEntries;
+
+    /** 正在恢复的对象(恢复期间不标记为脏) */
+    UObject* RestoringObject = nullptr;
+
+    /** 当前日志的代数 */
+    uint32 Generation = 0;
+
+    /** 当前日志的大致大小(字节) */
+    int64 JournalBytes = 0;
+
+    /** 下次存档是否必须写入快照(日志损坏或被删除后) */
+    bool bSnapshotRequired = false;
+
+    /** 读取的存档版本 */
+    ERLOSaveVersion LoadedVersion = ERLOSaveVersion::Latest;
+
+    /** 最近一次存档在游戏线程上的耗时(毫秒) */
+    float LastCaptureMs = 0.0f;
+
+    FDelegateHandle AutosaveTickerHandle;
+    FDelegateHandle WillDeactivateHandle;
+    FDelegateHandle WillEnterBackgroundHandle;
+    FDelegateHandle WillTerminateHandle;
+    FDelegateHandle WorldCleanupHandle;
+
+    // ========================================================================
+    // 写入线程状态
+    // ========================================================================
+
+    /** 保护 PendingJobs 和 bWriterRunning */
+    FCriticalSection WriteQueueLock;
+
+    /** 等待写入的任务 */
+    TArray<FWriteJob> PendingJobs;
+
+    /** 写入线程是否在运行 */
+    bool bWriterRunning = false;
+
+    /** 最近启动的写入线程 */
+    TFuture<void> WriterFuture;
+
+    /** 写入失败(下次存档时改为写入快照) */
+    FThreadSafeBool bWriteFailed;
+
+    /** 日志文件当前的代数(只在写入线程中访问),与任务不同时重新创建日志 */
+    int64 WrittenJournalGeneration = INDEX_NONE;
+
+    /** 写入失败的快照的代数(只在写入线程中访问),这一代的日志任务追加到旧一代的日志 */
+    int64 FailedSnapshotGeneration = INDEX_NONE;
+
+    /** 磁盘上快照的代数(写入失败后游戏线程回退到此代) */
+    FThreadSafeCounter DiskSnapshotGeneration;
+};
@@ -6,8 +6,11 @@
 #include "GameFramework/Actor.h"
 #include "DialogueDataAsset.h"
 #include "ItemDataAsset.h"
+#include "InventoryComponent.h"
 #include "UIManager.generated.h"
 
+class UUserWidget;
+
 /**
  * @brief UI管理器
  * 
@@ -17,7 +20,11 @@
  * - 提示UI
  * - 交互提示UI
  * 
- * 设计为单例模式,通过 GetUIManager() 获取实例
+ * 每个世界一个,在 UUIManagerSubsystem 中注册,通过 GetUIManager() 获取当前世界的实例
+ * 
+ * Widget在第一次显示时才创建,空闲时设为 Collapsed(不参与布局和Prepass)。
+ * 提示和物品弹窗这类短暂显示的Widget关闭后放回池中重复使用。
+ * 控制台命令 RLO.UI.Dump 输出已创建的Widget和池的状态。
  * 
  * 使用方法:
  * 1. 在关卡中放置 BP_UIManager
@@ -57,8 +64,16 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UI Config")
     TSubclassOf<class UUserWidget> InteractionPromptWidgetClass;
 
+    /** 获得物品弹窗Widget类(为空时不显示弹窗,继承 UItemPopupWidgetBase 时自动设置物品名称和图标,否则在 OnInitItemPopup 中设置) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UI Config")
+    TSubclassOf<class UUserWidget> ItemPopupWidgetClass;
+
+    /** 获得物品弹窗显示时长(秒) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UI Config", meta = (ClampMin = "0.1"))
+    float ItemPopupDuration = 2.0f;
+
     // ========================================================================
-    // UI Widget 实例
+    // UI Widget 实例(第一次显示前为空)
     // ========================================================================
 
     /** 对话UI实例 */
@@ -69,7 +84,7 @@ public:
     UPROPERTY(BlueprintReadOnly, Category = "UI State")
     class UUserWidget* InventoryWidget = nullptr;
 
-    /** 提示UI实例 */
+    /** 提示UI实例(隐藏时放回池中,为空) */
     UPROPERTY(BlueprintReadOnly, Category = "UI State")
     class UUserWidget* HintWidget = nullptr;
 
@@ -89,7 +104,17 @@ public:
     void ShowDialogue(const FDialogueEntry& DialogueEntry);
 
     /**
-     * @brief 更新对话文本
+     * @brief 显示对话UI并绑定对话组件
+     *
+     * DialogueWidgetClass 继承 UDialogueWidgetBase 时,Widget直接跟随组件的逐字显示和选项,
+     * 不需要再调用 UpdateDialogueText / ShowDialogueChoices。
+     * @param DialogueComponent 对话组件
+     */
+    UFUNCTION(BlueprintCallable, Category = "UI|Dialogue")
+    void ShowDialogueFor(class UDialogueComponent* DialogueComponent);
+
+    /**
+     * @brief 更新对话文本(未继承 UDialogueWidgetBase 的对话UI使用)
      * @param DisplayText 显示的文本
      * @param Progress 文本显示进度(0-1)
      */
@@ -97,7 +122,7 @@ public:
     void UpdateDialogueText(const FText& DisplayText, float Progress);
 
     /**
-     * @brief 隐藏对话UI
+     * @brief 隐藏对话UI(并解除与对话组件的绑定)
      */
     UFUNCTION(BlueprintCallable, Category = "UI|Dialogue")
     void HideDialogue();
@@ -133,10 +158,53 @@ public:
 
     /**
      * @brief 刷新背包UI(更新物品列表)
+     *
+     * InventoryWidgetClass 继承 UInventoryWidgetBase 时,显示期间背包视图自己按增量更新,
+     * 不需要调用此函数和 RefreshInventorySlots;否则由蓝图在 OnRefreshInventoryWidget 中更新Widget。
      */
     UFUNCTION(BlueprintCallable, Category = "UI|Inventory")
     void RefreshInventory();
 
+    /**
+     * @brief 按背包变化增量刷新背包UI(只更新变化的物品和移动过的槽位)
+     *
+     * 背包视图继承 UInventoryWidgetBase 时它自己监听背包并调用 ApplyInventoryDelta,否则由蓝图在 OnRefreshInventoryWidgetSlots 中更新。
+     * @param Delta 合并后的背包变化
+     */
+    UFUNCTION(BlueprintCallable, Category = "UI|Inventory")
+    void RefreshInventorySlots(const FInventoryDelta& Delta);
+
+protected:
+    /**
+     * @brief 完整刷新背包Widget(InventoryWidgetClass 未继承 UInventoryWidgetBase 时调用)
+     * @param Widget 背包Widget
+     * @param Slots 背包当前的所有槽位
+     */
+    UFUNCTION(BlueprintImplementableEvent, Category = "UI|Inventory")
+    void OnRefreshInventoryWidget(UUserWidget* Widget, const TArray<FInventorySlot>& Slots);
+
+    /**
+     * @brief 增量刷新背包Widget(InventoryWidgetClass 未继承 UInventoryWidgetBase 时调用)
+     *
+     * 1. ChangedItems 中 SlotIndex 有效的物品更新对应槽位的数量
+     * 2. FirstMovedSlot 之后的槽位按 Slots 重新绑定物品,并移除多余的槽位
+     * @param Widget 背包Widget
+     * @param Delta 合并后的背包变化
+     * @param Slots 背包当前的所有槽位
+     */
+    UFUNCTION(BlueprintImplementableEvent, Category = "UI|Inventory")
+    void OnRefreshInventoryWidgetSlots(UUserWidget* Widget, const FInventoryDelta& Delta, const TArray<FInventorySlot>& Slots);
+
+    /**
+     * @brief 设置物品弹窗的内容(ItemPopupWidgetClass 未继承 UItemPopupWidgetBase 时调用,在弹窗显示之前)
+     * @param Popup 弹窗Widget
+     * @param Item 获得的物品
+     */
+    UFUNCTION(BlueprintImplementableEvent, Category = "UI|Inventory")
+    void OnInitItemPopup(UUserWidget* Popup, UItemDataAsset* Item);
+
+public:
+
     // ========================================================================
     // 提示UI接口
     // ========================================================================
@@ -155,6 +223,23 @@ public:
     UFUNCTION(BlueprintCallable, Category = "UI|Hint")
     void HideHint();
 
+    // ========================================================================
+    // 物品弹窗接口
+    // ========================================================================
+
+    /**
+     * @brief 显示获得物品弹窗,ItemPopupDuration 秒后自动关闭
+     * @param Item 获得的物品
+     */
+    UFUNCTION(BlueprintCallable, Category = "UI|Inventory")
+    void ShowItemPopup(UItemDataAsset* Item);
+
+    /**
+     * @brief 关闭所有物品弹窗
+     */
+    UFUNCTION(BlueprintCallable, Category = "UI|Inventory")
+    void HideItemPopups();
+
     // ========================================================================
     // 交互提示UI接口
     // ========================================================================
@@ -190,24 +275,91 @@ public:
     bool IsAnyUIVisible() const;
 
     // ========================================================================
-    // 单例访问
+    // 实例访问
     // ========================================================================
 
     /**
-     * @brief 获取UIManager实例
+     * @brief 获取上下文对象所在世界的UIManager(通过 UUIManagerSubsystem,O(1))
      * @param WorldContext 世界上下文对象
-     * @return UIManager实例
+     * @return UIManager实例,世界中没有时返回nullptr
      */
     UFUNCTION(BlueprintCallable, Category = "UI", meta = (WorldContext = "WorldContext"))
     static AUIManager* GetUIManager(const UObject* WorldContext);
 
+    /**
+     * @brief 输出已创建的Widget和池的状态(RLO.UI.Dump)
+     */
+    void DumpWidgetStatus() const;
+
 private:
-    /** 创建UI Widget */
-    void CreateUIWidgets();
+    /**
+     * @brief 创建Widget并加入视口,初始为 Collapsed
+     * @param WidgetClass Widget类
+     * @param ZOrder 视口中的层级
+     * @param InitWidget 加入视口之前设置Widget的内容
+     * @return 创建的Widget,类为空或创建失败时返回nullptr
+     */
+    UUserWidget* CreateUIWidget(TSubclassOf<UUserWidget> WidgetClass, int32 ZOrder, TFunctionRef<void(UUserWidget*)> InitWidget);
+    UUserWidget* CreateUIWidget(TSubclassOf<UUserWidget> WidgetClass, int32 ZOrder);
+
+    /**
+     * @brief 获取常驻Widget,第一次调用时创建
+     * @param Widget 保存实例的成员
+     * @param WidgetClass Widget类
+     * @param ZOrder 视口中的层级
+     * @return Widget,类为空或创建失败时返回nullptr
+     */
+    UUserWidget* GetOrCreateWidget(UUserWidget*& Widget, TSubclassOf<UUserWidget> WidgetClass, int32 ZOrder);
+
+    /**
+     * @brief 从池中取出一个Widget,池中没有同类Widget时创建
+     * @param WidgetClass Widget类
+     * @param ZOrder 新建时视口中的层级
+     * @param InitWidget 显示之前设置Widget的内容(新建的Widget在加入视口之前调用)
+     * @return Widget,类为空或创建失败时返回nullptr
+     */
+    UUserWidget* AcquirePooledWidget(TSubclassOf<UUserWidget> WidgetClass, int32 ZOrder, TFunctionRef<void(UUserWidget*)> InitWidget);
+    UUserWidget* AcquirePooledWidget(TSubclassOf<UUserWidget> WidgetClass, int32 ZOrder);
+
+    /**
+     * @brief 隐藏Widget并放回池中
+     * @param Widget 由 AcquirePooledWidget 取出的Widget
+     */
+    void ReleasePooledWidget(UUserWidget* Widget);
+
+    /** 关闭一个物品弹窗 */
+    void HideItemPopup(UUserWidget* Popup);
+
+    /** 背包变化时显示新物品弹窗并增量刷新背包UI */
+    UFUNCTION()
+    void HandleInventoryChanged(const FInventoryDelta& Delta);
+
+    /** 绑定玩家背包的变化事件 */
+    void BindInventoryEvents();
+
+    /** 已绑定的玩家背包 */
+    TWeakObjectPtr<UInventoryComponent> BoundInventory;
+
+    /** 异步加载背包中所有物品的图标,加载完成后刷新背包UI */
+    void PreloadInventoryIcons();
+
+    /** 背包图标加载句柄(背包打开期间保持图标加载,关闭时释放) */
+    TSharedPtr<FStreamableHandle> InventoryIconHandle;
 
     /** 提示计时器句柄 */
     FTimerHandle HintTimerHandle;
 
-    /** 单例实例 */
-    static AUIManager* Instance;
+    /** 正在显示的物品弹窗 */
+    UPROPERTY(Transient)
+    TArray<UUserWidget*> ActiveItemPopups;
+
+    /** 物品弹窗的自动关闭计时器(与 ActiveItemPopups 一一对应) */
+    TArray<FTimerHandle> ItemPopupTimerHandles;
+
+    /** 空闲的短暂Widget(已在视口中,Collapsed) */
+    UPROPERTY(Transient)
+    TArray<UUserWidget*> WidgetPool;
+
+    /** 已创建的Widget总数 */
+    int32 NumCreatedWidgets = 0;
 };
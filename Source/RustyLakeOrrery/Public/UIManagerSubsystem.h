@@ -0,0 +1,61 @@
+// UIManagerSubsystem.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UIManagerSubsystem.generated.h"
+
+class AUIManager;
+
+/**
+ * @brief 每个世界的UI管理器注册表(世界子系统)
+ *
+ * AUIManager 在 BeginPlay 时注册、EndPlay 时注销,AUIManager::GetUIManager 通过它O(1)获取当前世界的管理器:
+ * - 生命周期与世界一致,世界销毁(切换关卡、PIE结束)后不会留下悬空指针
+ * - 多个PIE客户端各有自己的世界,互不干扰
+ * - 流式子关卡中的UIManager在加载期间覆盖常驻关卡中的,卸载后恢复
+ */
+UCLASS()
+class RUSTYLAKEORRERY_API UUIManagerSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * @brief 获取对象所在世界的UI子系统
+     * @param WorldContextObject 世界上下文对象
+     * @return 子系统,世界无效时返回nullptr
+     */
+    static UUIManagerSubsystem* Get(const UObject* WorldContextObject);
+
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Deinitialize() override;
+
+    /**
+     * @brief 注册UI管理器(最后注册的生效)
+     * @param UIManager UI管理器
+     */
+    void RegisterUIManager(AUIManager* UIManager);
+
+    /**
+     * @brief 注销UI管理器
+     * @param UIManager UI管理器
+     */
+    void UnregisterUIManager(AUIManager* UIManager);
+
+    /**
+     * @brief 当前生效的UI管理器
+     * @return UI管理器,没有注册时返回nullptr
+     */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "UI")
+    AUIManager* GetUIManager() const { return UIManagers.Num() > 0 ? UIManagers.Last() : nullptr; }
+
+    /** 已注册的UI管理器数量 */
+    int32 GetNumRegisteredUIManagers() const { return UIManagers.Num(); }
+
+private:
+    /** 已注册的UI管理器,按注册顺序 */
+    UPROPERTY(Transient)
+    TArray<AUIManager*> UIManagers;
+};
@@ -21,7 +21,7 @@ public class RustyLakeOrrery : ModuleRules
 
 		PrivateDependencyModuleNames.AddRange(new string[] 
 		{
-			// Add private dependencies here
+			"Json"
 		});
 
 		// Uncomment if you are using online features
@@ -4,3 +4,23 @@
 #include "Modules/ModuleManager.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE(FDefaultGameModuleImpl, RustyLakeOrrery, "RustyLakeOrrery");
+
+DEFINE_LOG_CATEGORY(LogRLO);
+DEFINE_LOG_CATEGORY(LogRLODialogue);
+DEFINE_LOG_CATEGORY(LogRLOInteraction);
+DEFINE_LOG_CATEGORY(LogRLOInventory);
+DEFINE_LOG_CATEGORY(LogRLOPuzzle);
+DEFINE_LOG_CATEGORY(LogRLOUI);
+DEFINE_LOG_CATEGORY(LogRLOSave);
+
+#if UE_BUILD_SHIPPING
+// UE_LOG 对高于 CompileTimeVerbosity 的级别在编译期丢弃整条语句（包括参数求值和格式化），
+// 这里保证 Shipping 版本中逐帧的 Log/Verbose 日志不会产生任何开销
+static_assert(FLogCategoryLogRLO::CompileTimeVerbosity < ELogVerbosity::Log, "LogRLO must compile out Log/Verbose in Shipping");
+static_assert(FLogCategoryLogRLODialogue::CompileTimeVerbosity < ELogVerbosity::Log, "LogRLODialogue must compile out Log/Verbose in Shipping");
+static_assert(FLogCategoryLogRLOInteraction::CompileTimeVerbosity < ELogVerbosity::Log, "LogRLOInteraction must compile out Log/Verbose in Shipping");
+static_assert(FLogCategoryLogRLOInventory::CompileTimeVerbosity < ELogVerbosity::Log, "LogRLOInventory must compile out Log/Verbose in Shipping");
+static_assert(FLogCategoryLogRLOPuzzle::CompileTimeVerbosity < ELogVerbosity::Log, "LogRLOPuzzle must compile out Log/Verbose in Shipping");
+static_assert(FLogCategoryLogRLOUI::CompileTimeVerbosity < ELogVerbosity::Log, "LogRLOUI must compile out Log/Verbose in Shipping");
+static_assert(FLogCategoryLogRLOSave::CompileTimeVerbosity < ELogVerbosity::Log, "LogRLOSave must compile out Log/Verbose in Shipping");
+#endif
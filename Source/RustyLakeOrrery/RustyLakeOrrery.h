@@ -3,3 +3,40 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+/** 项目统计分组（stat RustyLakeOrrery） */
+DECLARE_STATS_GROUP(TEXT("RustyLakeOrrery"), STATGROUP_RustyLakeOrrery, STATCAT_Advanced);
+
+/**
+ * @brief 日志编译期详细级别上限
+ *
+ * Shipping 版本只编译 Warning 及以上的日志，Log/Verbose 调用连同参数格式化一起被编译掉；
+ * 其他版本保留全部级别，运行时用 -LogCmds="LogRLOPuzzle Verbose" 或 Log 控制台命令调整。
+ */
+#if UE_BUILD_SHIPPING
+#define RLO_LOG_COMPILE_VERBOSITY Warning
+#else
+#define RLO_LOG_COMPILE_VERBOSITY All
+#endif
+
+/** 项目通用日志（章节资源、房间流式加载等） */
+RUSTYLAKEORRERY_API DECLARE_LOG_CATEGORY_EXTERN(LogRLO, Log, RLO_LOG_COMPILE_VERBOSITY);
+
+/** 对话系统日志 */
+RUSTYLAKEORRERY_API DECLARE_LOG_CATEGORY_EXTERN(LogRLODialogue, Log, RLO_LOG_COMPILE_VERBOSITY);
+
+/** 交互系统日志（触摸、手势、焦点） */
+RUSTYLAKEORRERY_API DECLARE_LOG_CATEGORY_EXTERN(LogRLOInteraction, Log, RLO_LOG_COMPILE_VERBOSITY);
+
+/** 物品栏日志 */
+RUSTYLAKEORRERY_API DECLARE_LOG_CATEGORY_EXTERN(LogRLOInventory, Log, RLO_LOG_COMPILE_VERBOSITY);
+
+/** 谜题日志 */
+RUSTYLAKEORRERY_API DECLARE_LOG_CATEGORY_EXTERN(LogRLOPuzzle, Log, RLO_LOG_COMPILE_VERBOSITY);
+
+/** UI日志 */
+RUSTYLAKEORRERY_API DECLARE_LOG_CATEGORY_EXTERN(LogRLOUI, Log, RLO_LOG_COMPILE_VERBOSITY);
+
+/** 存档日志 */
+RUSTYLAKEORRERY_API DECLARE_LOG_CATEGORY_EXTERN(LogRLOSave, Log, RLO_LOG_COMPILE_VERBOSITY);